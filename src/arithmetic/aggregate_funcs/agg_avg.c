@@ -41,11 +41,6 @@ AggregateResult AGG_AVG
 	AggregateCtx *ctx = private_data;
 	AvgCtx *avg_ctx = ctx->private_data;
 
-	// On the first invocation, initialize the context.
-	if(ctx->private_data == NULL) {
-		avg_ctx = ctx->private_data = rm_calloc(1, sizeof(AvgCtx));
-	}
-
 	// check input
 	if(SI_TYPE(val) == T_NULL) return AGGREGATE_OK;
 
@@ -100,14 +95,52 @@ void Avg_Finalize
 	}
 }
 
-AggregateCtx *Avg_PrivateData(void)
-{
-	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
+// returns the average tracked by ctx
+static inline long double _Avg_Mean
+(
+	const AvgCtx *ctx
+) {
+	// under overflow 'total' is the average
+	if(ctx->overflow) return ctx->total;
+	return ctx->total / (long double)ctx->count;
+}
 
-	ctx->result = SI_NullVal();  // avg default value is NULL
-	ctx->private_data = rm_calloc(1, sizeof(AvgCtx));
+// merge partial averages
+void Avg_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	AvgCtx *a = dst->private_data;
+	AvgCtx *b = src->private_data;
 
-	return ctx;
+	if(b->count == 0) return;
+	if(a->count == 0) {
+		*a = *b;
+		return;
+	}
+
+	if(!a->overflow && !b->overflow && !ABOUT_TO_OVERFLOW(a->total, b->total)) {
+		a->total += b->total;
+		a->count += b->count;
+		return;
+	}
+
+	// switch to the incremental representation
+	// weight each partial average by its share of the total count
+	long double count = (long double)a->count + (long double)b->count;
+	a->total = _Avg_Mean(a) * (a->count / count) +
+		_Avg_Mean(b) * (b->count / count);
+	a->count += b->count;
+	a->overflow = true;
+}
+
+void Avg_Init
+(
+	AggregateCtx *ctx
+) {
+	// private data is zeroed by the caller
+	ctx->result = SI_NullVal();  // avg default value is NULL
 }
 
 void Register_AVG(void) {
@@ -119,7 +152,8 @@ void Register_AVG(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("avg", AGG_AVG, 1, 1, types, ret_type,
-			rm_free, Avg_Finalize, Avg_PrivateData);
+			NULL, Avg_Finalize, Avg_Init, sizeof(AvgCtx));
+	AR_AggFuncSetCombine(func_desc, Avg_Combine);
 
 	AR_RegFunc(func_desc);
 }
@@ -27,14 +27,23 @@ AggregateResult AGG_COLLECT(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
-AggregateCtx *Collect_PrivateData(void)
-{
-	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
-
+void Collect_Init
+(
+	AggregateCtx *ctx
+) {
 	ctx->result = SI_Array(0);  // collect default value is an empty array
-	ctx->private_data = NULL;
+}
 
-	return ctx;
+// merge partial collections
+void Collect_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	u_int32_t n = SIArray_Length(src->result);
+	for(u_int32_t i = 0; i < n; i++) {
+		SIArray_Append(&dst->result, SIArray_Get(src->result, i));
+	}
 }
 
 void Register_COLLECT(void) {
@@ -46,7 +55,8 @@ void Register_COLLECT(void) {
 	array_append(types, SI_ALL);
 	ret_type = T_NULL | T_ARRAY;
 	func_desc = AR_AggFuncDescNew("collect", AGG_COLLECT, 1, 1, types, ret_type,
-			NULL, NULL, Collect_PrivateData);
+			NULL, NULL, Collect_Init, 0);
+	AR_AggFuncSetCombine(func_desc, Collect_Combine);
 	AR_RegFunc(func_desc);
 }
 
@@ -25,14 +25,20 @@ AggregateResult AGG_COUNT(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
-AggregateCtx *Count_PrivateData(void)
-{
-	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
-
+void Count_Init
+(
+	AggregateCtx *ctx
+) {
 	ctx->result = SI_LongVal(0);  // count default value is 0
-	ctx->private_data = NULL;
+}
 
-	return ctx;
+// merge partial counts
+void Count_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	dst->result.longval += src->result.longval;
 }
 
 void Register_COUNT(void) {
@@ -44,7 +50,8 @@ void Register_COUNT(void) {
 	array_append(types, SI_ALL);
 	ret_type = T_INT64;
 	func_desc = AR_AggFuncDescNew("count", AGG_COUNT, 1, 1, types, ret_type,
-			NULL, NULL, Count_PrivateData);
+			NULL, NULL, Count_Init, 0);
+	AR_AggFuncSetCombine(func_desc, Count_Combine);
 	AR_RegFunc(func_desc);
 }
 
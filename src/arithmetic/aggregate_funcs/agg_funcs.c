@@ -9,19 +9,25 @@
 #include "../../value.h"
 #include "../../util/rmalloc.h"
 
+// private data is placed right after the context, 16 bytes aligned
+#define AGG_CTX_HEADER_SIZE ((sizeof(AggregateCtx) + 15) & ~(size_t)15)
+
 // create a new aggregation function descriptor
 AR_FuncDesc *AR_AggFuncDescNew
 (
-	const char *name,                   // function name
-	AR_Func func,                       // pointer to function
-	uint min_argc,                      // minimum number of arguments
-	uint max_argc,                      // maximum number of arguments
-	SIType *types,                      // acceptable types
-	SIType ret_type,                    // return type
-	AR_Func_Free free,                  // free aggregation callback
-	AR_Func_Finalize finalize,          // finalize aggregation callback
-	AR_Func_PrivateData private_data    // generate private data
+	const char *name,           // function name
+	AR_Func func,               // pointer to function
+	uint min_argc,              // minimum number of arguments
+	uint max_argc,              // maximum number of arguments
+	SIType *types,              // acceptable types
+	SIType ret_type,            // return type
+	AR_Func_Free free,          // [optional] release private data callback
+	AR_Func_Finalize finalize,  // [optional] finalize aggregation callback
+	AR_Func_AggInit init,       // initialize aggregation context
+	size_t private_size         // size of private data
 ) {
+	ASSERT(init != NULL);
+
 	AR_FuncDesc *desc = rm_calloc(1, sizeof(AR_FuncDesc));
 
 	desc->name                    =  name;
@@ -34,12 +40,110 @@ AR_FuncDesc *AR_AggFuncDescNew
 	desc->aggregate               =  true;
 	desc->reducible               =  false;
 	desc->callbacks.free          =  free;
+	desc->callbacks.init          =  init;
 	desc->callbacks.finalize      =  finalize;
-	desc->callbacks.private_data  =  private_data;
+	desc->callbacks.private_size  =  private_size;
 
 	return desc;
 }
 
+// set the routine merging partial aggregation contexts
+void AR_AggFuncSetCombine
+(
+	AR_FuncDesc *func_desc,     // aggregation function
+	AR_Func_AggCombine combine  // combine callback
+) {
+	ASSERT(func_desc != NULL);
+	ASSERT(func_desc->aggregate);
+
+	func_desc->callbacks.combine = combine;
+}
+
+// returns the number of bytes required by an aggregation context
+size_t Aggregate_CtxSize
+(
+	const AR_FuncDesc *func_desc  // aggregation function
+) {
+	ASSERT(func_desc != NULL);
+	ASSERT(func_desc->aggregate);
+
+	size_t private_size = func_desc->callbacks.private_size;
+	if(private_size == 0) return sizeof(AggregateCtx);
+	return AGG_CTX_HEADER_SIZE + private_size;
+}
+
+// initialize an aggregation context in place
+void Aggregate_InitCtx
+(
+	const AR_FuncDesc *func_desc,  // aggregation function
+	AggregateCtx *ctx              // context to initialize
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(func_desc != NULL);
+
+	size_t private_size = func_desc->callbacks.private_size;
+
+	ctx->result       = SI_NullVal();
+	ctx->private_data = NULL;
+
+	if(private_size > 0) {
+		ctx->private_data = ((char *)ctx) + AGG_CTX_HEADER_SIZE;
+		memset(ctx->private_data, 0, private_size);
+	}
+
+	func_desc->callbacks.init(ctx);
+}
+
+// create a new aggregation context
+AggregateCtx *Aggregate_NewCtx
+(
+	const AR_FuncDesc *func_desc  // aggregation function
+) {
+	AggregateCtx *ctx = rm_malloc(Aggregate_CtxSize(func_desc));
+	Aggregate_InitCtx(func_desc, ctx);
+	return ctx;
+}
+
+// release resources held by an aggregation context
+void Aggregate_ReleaseCtx
+(
+	const AR_FuncDesc *func_desc,  // aggregation function
+	AggregateCtx *ctx              // context to release
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(func_desc != NULL);
+
+	SIValue_Free(ctx->result);
+	ctx->result = SI_NullVal();
+
+	if(ctx->private_data && func_desc->callbacks.free) {
+		func_desc->callbacks.free(ctx->private_data);
+	}
+}
+
+// returns true if partial aggregations of func_desc can be combined
+bool Aggregate_Combinable
+(
+	const AR_FuncDesc *func_desc  // aggregation function
+) {
+	ASSERT(func_desc != NULL);
+	return func_desc->callbacks.combine != NULL;
+}
+
+// merge partial aggregation context src into dst
+void Aggregate_Combine
+(
+	const AR_FuncDesc *func_desc,  // aggregation function
+	AggregateCtx *dst,             // context to merge into
+	AggregateCtx *src              // context to merge
+) {
+	ASSERT(dst != NULL);
+	ASSERT(src != NULL);
+	ASSERT(Aggregate_Combinable(func_desc));
+
+	func_desc->callbacks.combine(dst, src);
+}
+
 // TODO: might be deprecated?
 // routine for cloning a generic aggregate function context
 void *Aggregate_Clone(void *orig) {
@@ -114,13 +218,7 @@ void Aggregate_Free
 ) {
 	if(ctx == NULL) return;
 
-	SIValue_Free(ctx->result);
-
-	if(ctx->private_data) {
-		ASSERT(agg_func->callbacks.free != NULL);
-		agg_func->callbacks.free(ctx->private_data);
-	}
-
+	Aggregate_ReleaseCtx(agg_func, ctx);
 	rm_free(ctx);
 }
 
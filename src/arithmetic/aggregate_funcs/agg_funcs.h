@@ -14,22 +14,78 @@ typedef SIValue AggregateResult;
 AggregateResult AGGREGATE_OK;
 
 // create a new aggregation function descriptor
+// an aggregation context is allocated as a single block
+// holding both the context and its private data
+// as such the free callback should only release resources referenced by
+// the private data, not the private data itself
 AR_FuncDesc *AR_AggFuncDescNew
 (
-	const char *name,                   // function name
-	AR_Func func,                       // pointer to function
-	uint min_argc,                      // minimum number of arguments
-	uint max_argc,                      // maximum number of arguments
-	SIType *types,                      // acceptable types
-	SIType ret_type,                    // return type
-	AR_Func_Free free,                  // free aggregation callback
-	AR_Func_Finalize finalize,          // finalize aggregation callback
-	AR_Func_PrivateData private_data    // generate private data
+	const char *name,           // function name
+	AR_Func func,               // pointer to function
+	uint min_argc,              // minimum number of arguments
+	uint max_argc,              // maximum number of arguments
+	SIType *types,              // acceptable types
+	SIType ret_type,            // return type
+	AR_Func_Free free,          // [optional] release private data callback
+	AR_Func_Finalize finalize,  // [optional] finalize aggregation callback
+	AR_Func_AggInit init,       // initialize aggregation context
+	size_t private_size         // size of private data
 );
 
 // register all aggregation funcitons
 void Register_AggFuncs(void);
 
+// set the routine merging partial aggregation contexts
+void AR_AggFuncSetCombine
+(
+	AR_FuncDesc *func_desc,     // aggregation function
+	AR_Func_AggCombine combine  // combine callback
+);
+
+// returns the number of bytes required by an aggregation context
+// of the given function, including its private data
+size_t Aggregate_CtxSize
+(
+	const AR_FuncDesc *func_desc  // aggregation function
+);
+
+// initialize an aggregation context in place
+// ctx must be of at least Aggregate_CtxSize bytes
+void Aggregate_InitCtx
+(
+	const AR_FuncDesc *func_desc,  // aggregation function
+	AggregateCtx *ctx              // context to initialize
+);
+
+// create a new aggregation context
+AggregateCtx *Aggregate_NewCtx
+(
+	const AR_FuncDesc *func_desc  // aggregation function
+);
+
+// release resources held by an aggregation context
+// without freeing the context itself
+void Aggregate_ReleaseCtx
+(
+	const AR_FuncDesc *func_desc,  // aggregation function
+	AggregateCtx *ctx              // context to release
+);
+
+// returns true if partial aggregations of func_desc can be combined
+bool Aggregate_Combinable
+(
+	const AR_FuncDesc *func_desc  // aggregation function
+);
+
+// merge partial aggregation context src into dst
+// src should be released by the caller
+void Aggregate_Combine
+(
+	const AR_FuncDesc *func_desc,  // aggregation function
+	AggregateCtx *dst,             // context to merge into
+	AggregateCtx *src              // context to merge
+);
+
 // get computed aggregated value
 SIValue Aggregate_GetResult
 (
@@ -29,14 +29,29 @@ AggregateResult AGG_MAX(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
-AggregateCtx *Max_PrivateData(void)
-{
-	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
-
+void Max_Init
+(
+	AggregateCtx *ctx
+) {
 	ctx->result = SI_NullVal();  // max default value is NULL
-	ctx->private_data = NULL;
+}
+
+// merge partial maximums
+void Max_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	SIValue v = src->result;
+	if(SI_TYPE(v) == T_NULL) return;
 
-	return ctx;
+	// take src's result if it is greater
+	int compared_null;
+	if((SIValue_Compare(dst->result, v, &compared_null) < 0) ||
+	   (compared_null == COMPARED_NULL)) {
+		SIValue_Free(dst->result);
+		dst->result = SI_TransferOwnership(&src->result);
+	}
 }
 
 void Register_MAX(void) {
@@ -48,7 +63,8 @@ void Register_MAX(void) {
 	array_append(types, SI_ALL);
 	ret_type = SI_ALL;
 	func_desc = AR_AggFuncDescNew("max", AGG_MAX, 1, 1, types, ret_type, NULL,
-			NULL, Max_PrivateData);
+			NULL, Max_Init, 0);
+	AR_AggFuncSetCombine(func_desc, Max_Combine);
 	AR_RegFunc(func_desc);
 }
 
@@ -29,14 +29,29 @@ AggregateResult AGG_MIN(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
-AggregateCtx *Min_PrivateData(void)
-{
-	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
-
+void Min_Init
+(
+	AggregateCtx *ctx
+) {
 	ctx->result = SI_NullVal();  // min default value is NULL
-	ctx->private_data = NULL;
+}
+
+// merge partial minimums
+void Min_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	SIValue v = src->result;
+	if(SI_TYPE(v) == T_NULL) return;
 
-	return ctx;
+	// take src's result if it is lesser
+	int compared_null;
+	if((SIValue_Compare(dst->result, v, &compared_null) > 0) ||
+	   (compared_null == COMPARED_NULL)) {
+		SIValue_Free(dst->result);
+		dst->result = SI_TransferOwnership(&src->result);
+	}
 }
 
 void Register_MIN(void) {
@@ -48,7 +63,8 @@ void Register_MIN(void) {
 	array_append(types, SI_ALL);
 	ret_type = SI_ALL;
 	func_desc = AR_AggFuncDescNew("min", AGG_MIN, 1, 1, types, ret_type, NULL,
-			NULL, Min_PrivateData);
+			NULL, Min_Init, 0);
+	AR_AggFuncSetCombine(func_desc, Min_Combine);
 	AR_RegFunc(func_desc);
 }
 
@@ -117,24 +117,46 @@ void Percentile_Free(void *pdata) {
 	_agg_PercCtx *ctx = pdata;
 	if(ctx->values != NULL) {
 		array_free(ctx->values);
+		ctx->values = NULL;
 	}
-	rm_free(ctx);
 }
 
-AggregateCtx *Precentile_PrivateData(void)
-{
-	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
+// merge partial percentile contexts
+void Percentile_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	_agg_PercCtx *a = dst->private_data;
+	_agg_PercCtx *b = src->private_data;
+
+	// src didn't aggregate any value
+	if(b->values == NULL) return;
+
+	if(a->values == NULL) {
+		// take over src's values
+		a->values     = b->values;
+		a->percentile = b->percentile;
+		b->values     = NULL;
+		return;
+	}
+
+	uint n = array_len(b->values);
+	for(uint i = 0; i < n; i++) {
+		array_append(a->values, b->values[i]);
+	}
+}
 
+void Precentile_Init
+(
+	AggregateCtx *ctx
+) {
 	ctx->result = SI_NullVal();  // precentile default value is NULL
 
 	// initialize private data
-	_agg_PercCtx *pdata = rm_calloc(1, sizeof(_agg_PercCtx));
-	pdata->percentile= -1; // invalid precentile value
+	_agg_PercCtx *pdata = ctx->private_data;
+	pdata->percentile = -1; // invalid precentile value
 	pdata->values = NULL;
-
-	ctx->private_data = pdata;
-
-	return ctx;
 }
 
 void Register_PRECENTILE(void) {
@@ -147,7 +169,9 @@ void Register_PRECENTILE(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("percentileDisc", AGG_PERC, 2, 2, types, ret_type,
-			Percentile_Free, PercDiscFinalize, Precentile_PrivateData);
+			Percentile_Free, PercDiscFinalize, Precentile_Init,
+			sizeof(_agg_PercCtx));
+	AR_AggFuncSetCombine(func_desc, Percentile_Combine);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 3);
@@ -155,7 +179,9 @@ void Register_PRECENTILE(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("percentileCont", AGG_PERC, 2, 2, types, ret_type,
-			Percentile_Free, PercContFinalize, Precentile_PrivateData);
+			Percentile_Free, PercContFinalize, Precentile_Init,
+			sizeof(_agg_PercCtx));
+	AR_AggFuncSetCombine(func_desc, Percentile_Combine);
 	AR_RegFunc(func_desc);
 }
 
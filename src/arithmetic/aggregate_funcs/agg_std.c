@@ -77,24 +77,47 @@ void StDev_Free(void *pdata) {
 	_agg_StDevCtx *stdev_ctx = pdata;
 	if(stdev_ctx->values != NULL) {
 		array_free(stdev_ctx->values);
+		stdev_ctx->values = NULL;
 	}
-	rm_free(pdata);
 }
 
-AggregateCtx *STD_PrivateData(void)
-{
-	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
+// merge partial standard deviations
+void StDev_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	_agg_StDevCtx *a = dst->private_data;
+	_agg_StDevCtx *b = src->private_data;
+
+	// src didn't aggregate any value
+	if(b->values == NULL) return;
+
+	if(a->values == NULL) {
+		// take over src's values
+		a->values = b->values;
+		a->total  = b->total;
+		b->values = NULL;
+		return;
+	}
 
+	uint n = array_len(b->values);
+	for(uint i = 0; i < n; i++) {
+		array_append(a->values, b->values[i]);
+	}
+	a->total += b->total;
+}
+
+void STD_Init
+(
+	AggregateCtx *ctx
+) {
 	ctx->result = SI_DoubleVal(0);  // STD default value is 0
 
 	// initialize private data
-	_agg_StDevCtx *pdata = rm_calloc(1, sizeof(_agg_StDevCtx));
+	_agg_StDevCtx *pdata = ctx->private_data;
 	pdata->values = NULL;
 	pdata->total = -1;
-
-	ctx->private_data = pdata;
-
-	return ctx;
 }
 
 void Register_STD(void) {
@@ -106,14 +129,16 @@ void Register_STD(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("stDev", AGG_STDEV, 1, 1, types, ret_type,
-			StDev_Free, StDevFinalize, STD_PrivateData);
+			StDev_Free, StDevFinalize, STD_Init, sizeof(_agg_StDevCtx));
+	AR_AggFuncSetCombine(func_desc, StDev_Combine);
 	AR_RegFunc(func_desc);
 
 	types = array_new(SIType, 2);
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("stDevP", AGG_STDEV, 1, 1, types, ret_type,
-			StDev_Free, StDevPFinalize, STD_PrivateData);
+			StDev_Free, StDevPFinalize, STD_Init, sizeof(_agg_StDevCtx));
+	AR_AggFuncSetCombine(func_desc, StDev_Combine);
 	AR_RegFunc(func_desc);
 }
 
@@ -25,14 +25,20 @@ AggregateResult AGG_SUM(SIValue *argv, int argc, void *private_data) {
 	return AGGREGATE_OK;
 }
 
-AggregateCtx *SUM_PrivateData(void)
-{
-	AggregateCtx *ctx = rm_malloc(sizeof(AggregateCtx));
-
+void SUM_Init
+(
+	AggregateCtx *ctx
+) {
 	ctx->result = SI_DoubleVal(0);  // SUM default value is 0
-	ctx->private_data = NULL;
+}
 
-	return ctx;
+// merge partial sums
+void SUM_Combine
+(
+	AggregateCtx *dst,
+	AggregateCtx *src
+) {
+	dst->result.doubleval += src->result.doubleval;
 }
 
 void Register_SUM(void) {
@@ -44,7 +50,8 @@ void Register_SUM(void) {
 	array_append(types, T_NULL | T_INT64 | T_DOUBLE);
 	ret_type = T_NULL | T_DOUBLE;
 	func_desc = AR_AggFuncDescNew("sum", AGG_SUM, 1, 1, types, ret_type, NULL,
-			NULL, SUM_PrivateData);
+			NULL, SUM_Init, 0);
+	AR_AggFuncSetCombine(func_desc, SUM_Combine);
 	AR_RegFunc(func_desc);
 }
 
@@ -8,6 +8,7 @@
 
 #include "../graph/graph.h"
 #include "../graph/query_graph.h"
+#include "../util/cache/cache.h"
 
 static RG_Matrix IDENTITY_MATRIX = (RG_Matrix)0x31032017;  // identity matrix
 
@@ -226,6 +227,15 @@ RG_Matrix AlgebraicExpression_Eval
 	RG_Matrix res                   // Result output
 );
 
+// create a cache of intermediate products
+// products of graph matrices computed by AlgebraicExpression_Eval are reused
+// by later evaluations for as long as none of their operands is modified
+// cached products consume at most 64MB per graph
+Cache *AlgebraicExpression_NewProductCache
+(
+	uint cap  // max number of cached products
+);
+
 // locates operand based on row,column domain and edge or label
 // sets 'operand' if found otherwise set it to NULL
 // sets 'parent' if requested, parent can still be set to NULL
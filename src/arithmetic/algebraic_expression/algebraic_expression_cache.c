@@ -0,0 +1,201 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "utils.h"
+#include "../../util/rmalloc.h"
+#include "../algebraic_expression.h"
+
+#include <stdio.h>
+
+// products of graph matrices are cached under a key composed of
+// their operands addresses e.g. "0x7f10*0x7f38*0x7f10"
+// graph matrices live as long as the graph does, as such an address
+// uniquely identifies a matrix within the graph's cache
+//
+// a cached product records the version of each of its operands
+// once any of these advance the product is considered stale and is discarded
+//
+// a product can be as large as a relation matrix, in addition to the number
+// of cached products the cache bounds the memory they consume
+// stale products count towards this bound until they're discarded or evicted
+
+// max memory consumed by the cached products of a single graph, in bytes
+#define PRODUCT_CACHE_MAX_MEMORY (64 * 1024 * 1024)
+
+// max length of a single operand within a key, "0x" + 16 hex digits + '*'
+#define KEY_OPERAND_LEN 19
+
+static char *_AlgebraicProduct_Key
+(
+	const RG_Matrix *operands,  // chain operands
+	uint n                      // number of operands
+) {
+	ASSERT(n > 0);
+	ASSERT(operands != NULL);
+
+	char *key = rm_malloc(n * KEY_OPERAND_LEN + 1);
+	int   len = 0;
+
+	for(uint i = 0; i < n; i++) {
+		len += sprintf(key + len, (i == 0) ? "%p" : "*%p", (void *)operands[i]);
+	}
+
+	return key;
+}
+
+static AlgebraicProduct *_AlgebraicProduct_New
+(
+	const RG_Matrix *operands,  // chain operands
+	uint n,                     // number of operands
+	RG_Matrix matrix            // operands product
+) {
+	AlgebraicProduct *product = rm_malloc(sizeof(AlgebraicProduct));
+
+	product->n         = n;
+	product->size      = 0;
+	product->matrix    = matrix;
+	product->versions  = rm_malloc(sizeof(uint64_t) * n);
+	product->ref_count = 1;
+
+	for(uint i = 0; i < n; i++) {
+		product->versions[i] = RG_Matrix_version(operands[i]);
+	}
+
+	GrB_Info info = GxB_Matrix_memoryUsage(&product->size, RG_MATRIX_M(matrix));
+	UNUSED(info);
+	ASSERT(info == GrB_SUCCESS);
+
+	return product;
+}
+
+// cache weight function, the memory consumed by product
+static uint64_t _AlgebraicProduct_Size
+(
+	const AlgebraicProduct *product
+) {
+	return product->size;
+}
+
+// cache copy function, shares product with the caller
+static AlgebraicProduct *_AlgebraicProduct_Share
+(
+	AlgebraicProduct *product
+) {
+	__atomic_fetch_add(&product->ref_count, 1, __ATOMIC_RELAXED);
+	return product;
+}
+
+void _AlgebraicProduct_Release
+(
+	AlgebraicProduct *product
+) {
+	ASSERT(product != NULL);
+
+	if(__atomic_sub_fetch(&product->ref_count, 1, __ATOMIC_ACQ_REL) > 0) {
+		return;
+	}
+
+	RG_Matrix_free(&product->matrix);
+	rm_free(product->versions);
+	rm_free(product);
+}
+
+bool _AlgebraicProduct_GraphMatrix
+(
+	const Graph *g,
+	RG_Matrix m
+) {
+	ASSERT(g != NULL);
+	ASSERT(m != NULL);
+
+	if(m == g->_zero_matrix) return true;
+
+	RG_Matrix adj = g->adjacency_matrix;
+	if(m == adj || m == RG_Matrix_getTranspose(adj)) return true;
+
+	uint n = Graph_LabelTypeCount(g);
+	for(uint i = 0; i < n; i++) {
+		if(m == g->labels[i]) return true;
+	}
+
+	n = Graph_RelationTypeCount(g);
+	for(uint i = 0; i < n; i++) {
+		RG_Matrix r = g->relations[i];
+		if(m == r || m == RG_Matrix_getTranspose(r)) return true;
+	}
+
+	return false;
+}
+
+AlgebraicProduct *_AlgebraicProduct_Get
+(
+	Cache *cache,
+	const RG_Matrix *operands,
+	uint n
+) {
+	ASSERT(cache != NULL);
+
+	char *key = _AlgebraicProduct_Key(operands, n);
+	AlgebraicProduct *product = Cache_GetValue(cache, key);
+
+	if(product != NULL) {
+		ASSERT(product->n == n);
+
+		// make sure none of the operands was modified
+		for(uint i = 0; i < n; i++) {
+			if(product->versions[i] != RG_Matrix_version(operands[i])) {
+				_AlgebraicProduct_Release(product);
+				Cache_RemoveValue(cache, key);
+				product = NULL;
+				break;
+			}
+		}
+	}
+
+	rm_free(key);
+	return product;
+}
+
+void _AlgebraicProduct_Set
+(
+	Cache *cache,
+	const RG_Matrix *operands,
+	uint n,
+	RG_Matrix *matrix
+) {
+	ASSERT(cache   != NULL);
+	ASSERT(matrix  != NULL && *matrix != NULL);
+
+	// cached products are read concurrently, complete any pending work
+	GrB_Info info = GrB_wait(RG_MATRIX_M(*matrix), GrB_MATERIALIZE);
+	UNUSED(info);
+	ASSERT(info == GrB_SUCCESS);
+
+	char *key = _AlgebraicProduct_Key(operands, n);
+	AlgebraicProduct *product = _AlgebraicProduct_New(operands, n, *matrix);
+
+	// in case product was added to the cache 'res' is a shared reference
+	// otherwise 'res' is product itself, either way release it
+	AlgebraicProduct *res = Cache_SetGetValue(cache, key, product);
+	_AlgebraicProduct_Release(res);
+
+	*matrix = NULL;
+	rm_free(key);
+}
+
+Cache *AlgebraicExpression_NewProductCache
+(
+	uint cap
+) {
+	ASSERT(cap > 0);
+	Cache *cache = Cache_New(cap, (CacheEntryFreeFunc)_AlgebraicProduct_Release,
+			(CacheEntryCopyFunc)_AlgebraicProduct_Share);
+
+	Cache_SetMaxWeight(cache, PRODUCT_CACHE_MAX_MEMORY,
+			(CacheEntryWeightFunc)_AlgebraicProduct_Size);
+
+	return cache;
+}
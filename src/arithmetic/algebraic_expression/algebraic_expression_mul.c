@@ -8,6 +8,225 @@
 #include "../../query_ctx.h"
 #include "../algebraic_expression.h"
 
+#include <math.h>
+
+// multiplication is associative, a chain F * L1 * R1 * L2 * R2
+// can be evaluated in any order e.g. (F * L1) * (R1 * (L2 * R2))
+// the evaluation order is chosen matrix-chain style, minimizing the estimated
+// amount of work given each operand's current number of entries
+//
+// the cost of A * B is estimated as:
+// nvals(A) + nvals(A) * average row degree of B
+// that is, every entry of A is visited and joined with a row of B
+// diagonal (label) operands contribute their selectivity through their
+// average row degree, e.g. a label with 10 nodes out of 1000 filters out
+// 99% of the entries it is multiplied with
+//
+// ties are resolved in favour of left to right evaluation
+//
+// products of graph matrices, e.g. the right hand side of F * (L1 * R1 * L2)
+// are independent of the records being processed, these are cached and reused
+// by later evaluations for as long as none of their operands is modified
+// a cached sub-chain costs nothing to compute
+
+// an uncached product of graph matrices is expected to be reused
+// its cost is spread across this many evaluations
+#define CACHED_PRODUCT_REUSE 4
+
+// plan of a sub-chain i..j
+typedef struct {
+	double cost;                // estimated cost of computing sub-chain
+	double nvals;               // estimated number of entries in sub-chain's product
+	uint split;                 // sub-chain product = (i..split) * (split+1..j)
+	AlgebraicProduct *product;  // cached sub-chain product, NULL if not cached
+} MulPlan;
+
+// chain of operands to multiply
+typedef struct {
+	RG_Matrix *operands;  // chain operands
+	bool *graph;          // operand is a graph matrix
+	uint n;               // number of operands
+	Cache *cache;         // intermediate products cache, NULL if disabled
+	MulPlan *plans;       // evaluation plan of every sub-chain
+} MulChain;
+
+#define PLAN(chain, i, j) (chain)->plans[(i) * (chain)->n + (j)]
+
+// returns true if sub-chain i..j product can be cached
+// the first operand is left out as it is usually specific to the evaluation
+// e.g. the filter matrix of a traversal
+static bool _MulChain_Cacheable
+(
+	const MulChain *chain,  // chain
+	uint i,                 // sub-chain first operand
+	uint j                  // sub-chain last operand
+) {
+	if(chain->cache == NULL || i == 0 || i == j) return false;
+
+	for(uint k = i; k <= j; k++) {
+		if(!chain->graph[k]) return false;
+	}
+
+	return true;
+}
+
+// compute evaluation order of operands
+static void _MulChain_Plan
+(
+	MulChain *chain  // chain to plan
+) {
+	GrB_Info  info;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Index nvals;
+
+	uint       n        = chain->n;
+	RG_Matrix *operands = chain->operands;
+	double    *rows     = rm_malloc(sizeof(double) * n);
+	double    *cols     = rm_malloc(sizeof(double) * n);
+
+	chain->plans = rm_calloc(n * n, sizeof(MulPlan));
+
+	for(uint i = 0; i < n; i++) {
+		info = RG_Matrix_nrows(&nrows, operands[i]);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_ncols(&ncols, operands[i]);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_nvals(&nvals, operands[i]);
+		ASSERT(info == GrB_SUCCESS);
+
+		rows[i] = nrows;
+		cols[i] = ncols;
+		PLAN(chain, i, i) = (MulPlan) {.cost = 0, .nvals = nvals, .split = i};
+	}
+
+	for(uint len = 2; len <= n; len++) {
+		for(uint i = 0; i + len <= n; i++) {
+			uint j = i + len - 1;
+			MulPlan *p = &PLAN(chain, i, j);
+
+			// use cached product if available
+			if(_MulChain_Cacheable(chain, i, j)) {
+				p->product = _AlgebraicProduct_Get(chain->cache, operands + i,
+						len);
+				if(p->product != NULL) {
+					info = RG_Matrix_nvals(&nvals, p->product->matrix);
+					ASSERT(info == GrB_SUCCESS);
+					p->cost  = 0;
+					p->split = j - 1;
+					p->nvals = nvals;
+					continue;
+				}
+			}
+
+			// default to left to right evaluation
+			p->cost  = INFINITY;
+			p->split = j - 1;
+			p->nvals = rows[i] * cols[j];
+
+			// consider splits from right to left
+			// such that left to right evaluation wins ties
+			for(uint s = j; s-- > i;) {
+				// the left hand side of a multiplication must be synced
+				// only intermediate results and synced operands qualify
+				if(s == i && !RG_Matrix_Synced(operands[i])) continue;
+
+				const MulPlan *l = &PLAN(chain, i, s);
+				const MulPlan *r = &PLAN(chain, s + 1, j);
+
+				double rcost = r->cost;
+				if(r->product == NULL && _MulChain_Cacheable(chain, s + 1, j)) {
+					rcost /= CACHED_PRODUCT_REUSE;
+				}
+
+				double degree = (rows[s + 1] > 0) ? r->nvals / rows[s + 1] : 0;
+				double flops  = l->nvals * degree;
+				double cost   = l->cost + rcost + l->nvals + flops;
+
+				if(cost < p->cost) {
+					p->cost  = cost;
+					p->split = s;
+					p->nvals = fmin(flops, rows[i] * cols[j]);
+				}
+			}
+		}
+	}
+
+	rm_free(rows);
+	rm_free(cols);
+}
+
+// evaluate sub-chain i..j into res
+static void _MulChain_Eval
+(
+	const MulChain *chain,  // chain to evaluate
+	uint i,                 // sub-chain first operand
+	uint j,                 // sub-chain last operand
+	RG_Matrix res           // [output] sub-chain product
+) {
+	ASSERT(i < j);
+	ASSERT(PLAN(chain, i, j).product == NULL);
+
+	GrB_Info         info;
+	GrB_Index        nvals;
+	GrB_Index        nrows;
+	GrB_Index        ncols;
+	RG_Matrix        A         =  NULL;
+	RG_Matrix        B         =  NULL;
+	RG_Matrix        inter     =  NULL;
+	GrB_Semiring     semiring  =  GxB_ANY_PAIR_BOOL;
+	RG_Matrix       *operands  =  chain->operands;
+	uint             s         =  PLAN(chain, i, j).split;
+	const MulPlan   *l         =  &PLAN(chain, i, s);
+	const MulPlan   *r         =  &PLAN(chain, s + 1, j);
+
+	UNUSED(info);
+
+	// left hand side
+	if(s == i) {
+		A = operands[i];
+	} else if(l->product != NULL) {
+		A = l->product->matrix;
+	} else {
+		_MulChain_Eval(chain, i, s, res);
+		A = res;
+
+		// exit early if 'res' is empty 0 * B = 0
+		info = RG_Matrix_nvals(&nvals, res);
+		ASSERT(info == GrB_SUCCESS);
+		if(nvals == 0) return;
+	}
+
+	// right hand side
+	if(s + 1 == j) {
+		B = operands[j];
+	} else if(r->product != NULL) {
+		B = r->product->matrix;
+	} else {
+		info = RG_Matrix_nrows(&nrows, operands[s + 1]);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_ncols(&ncols, operands[j]);
+		ASSERT(info == GrB_SUCCESS);
+		info = RG_Matrix_new(&inter, GrB_BOOL, nrows, ncols);
+		ASSERT(info == GrB_SUCCESS);
+
+		_MulChain_Eval(chain, s + 1, j, inter);
+		B = inter;
+	}
+
+	info = RG_mxm(res, semiring, A, B);
+	ASSERT(info == GrB_SUCCESS);
+
+	if(inter != NULL) {
+		// hand intermediate product over to the cache
+		if(_MulChain_Cacheable(chain, s + 1, j)) {
+			_AlgebraicProduct_Set(chain->cache, operands + s + 1, j - s, &inter);
+		} else {
+			RG_Matrix_free(&inter);
+		}
+	}
+}
+
 RG_Matrix _Eval_Mul
 (
 	const AlgebraicExpression *exp,
@@ -21,47 +240,42 @@ RG_Matrix _Eval_Mul
 	ASSERT(AlgebraicExpression_ChildCount(exp) > 1) ;
 	ASSERT(AlgebraicExpression_OperationCount(exp, AL_EXP_MUL) == 1) ;
 
-	GrB_Info             info    ;
-	RG_Matrix            M       ;  // current operand
-	GrB_Index            nvals   ;  // NNZ in res
-	AlgebraicExpression  *c      ;  // current child node
-
-	UNUSED(info) ;
+	GraphContext *gc = QueryCtx_GetGraphCtx() ;
+	uint child_count = AlgebraicExpression_ChildCount(exp) ;
 
-	RG_Matrix     A             =  NULL                                 ; 
-	bool          res_modified  =  false                                ;
-	GrB_Semiring  semiring      =  GxB_ANY_PAIR_BOOL                    ;
-	uint          child_count   =  AlgebraicExpression_ChildCount(exp)  ;
+	MulChain chain ;
+	chain.n        = child_count ;
+	chain.cache    = gc->products ;
+	chain.plans    = NULL ;
+	chain.graph    = rm_calloc(child_count, sizeof(bool)) ;
+	chain.operands = rm_malloc(sizeof(RG_Matrix) * child_count) ;
 
 	for(uint i = 0; i < child_count; i++) {
-		c = CHILD_AT(exp, i) ;
+		AlgebraicExpression *c = CHILD_AT(exp, i) ;
 		ASSERT(c->type == AL_OPERAND) ;
-
-		M = c->operand.matrix ;
-
-		// first time A is set
-		if(A == NULL) {
-			A = M ;
-			continue ;
+		chain.operands[i] = c->operand.matrix ;
+		if(chain.cache != NULL) {
+			chain.graph[i] = _AlgebraicProduct_GraphMatrix(gc->g,
+					chain.operands[i]) ;
 		}
+	}
 
-		// both A and M are valid matrices, perform multiplication
-		info = RG_mxm(res, semiring, A, M) ;
-		res_modified = true ;
-		// setup for next iteration
-		A = res ;
+	//--------------------------------------------------------------------------
+	// choose evaluation order and evaluate
+	//--------------------------------------------------------------------------
 
-		// exit early if 'res' is empty 0 * A = 0
-		info = RG_Matrix_nvals(&nvals, res);
-		ASSERT(info == GrB_SUCCESS) ;
-		if(nvals == 0) break ;
-	}
+	_MulChain_Plan(&chain) ;
+	_MulChain_Eval(&chain, 0, child_count - 1, res) ;
 
-	if(!res_modified) {
-		info = RG_Matrix_copy(res, A) ;
-		ASSERT(info == GrB_SUCCESS) ;
+	// release cached products
+	for(uint i = 0; i < child_count * child_count; i++) {
+		AlgebraicProduct *product = chain.plans[i].product ;
+		if(product != NULL) _AlgebraicProduct_Release(product) ;
 	}
 
+	rm_free(chain.plans) ;
+	rm_free(chain.graph) ;
+	rm_free(chain.operands) ;
+
 	return res ;
 }
-
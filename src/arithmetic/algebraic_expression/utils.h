@@ -128,3 +128,50 @@ void _AlgebraicExpression_RemoveRedundentOperands
 	const QueryGraph *qg
 );
 
+
+//------------------------------------------------------------------------------
+// intermediate products cache
+//------------------------------------------------------------------------------
+
+// product of a chain of graph matrices
+// shared between the products cache and the evaluations using it
+typedef struct {
+	RG_Matrix matrix;    // operands product
+	size_t size;         // memory consumed by matrix, in bytes
+	uint n;              // number of operands
+	uint64_t *versions;  // operands versions at the time product was computed
+	int ref_count;       // number of references to product
+} AlgebraicProduct;
+
+// returns true if 'm' is one of the graph's matrices
+bool _AlgebraicProduct_GraphMatrix
+(
+	const Graph *g,  // graph
+	RG_Matrix m      // matrix
+);
+
+// lookup the product of 'operands'
+// returns NULL if the product isn't cached or any of its operands was modified
+// since the product was computed, the caller must release the returned product
+AlgebraicProduct *_AlgebraicProduct_Get
+(
+	Cache *cache,                // products cache
+	const RG_Matrix *operands,   // chain operands
+	uint n                       // number of operands
+);
+
+// cache 'matrix' as the product of 'operands'
+// takes ownership of 'matrix' and sets it to NULL
+void _AlgebraicProduct_Set
+(
+	Cache *cache,                // products cache
+	const RG_Matrix *operands,   // chain operands
+	uint n,                      // number of operands
+	RG_Matrix *matrix            // operands product
+);
+
+// release a reference to product
+void _AlgebraicProduct_Release
+(
+	AlgebraicProduct *product  // product to release
+);
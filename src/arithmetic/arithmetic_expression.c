@@ -200,8 +200,7 @@ AR_ExpNode *AR_EXP_NewOpNode
 	// add aggregation context as function private data
 	if(func->aggregate) {
 		// generate aggregation context and store it in node's private data
-		ASSERT(func->callbacks.private_data != NULL);
-		node->op.private_data = func->callbacks.private_data();
+		node->op.private_data = Aggregate_NewCtx(func);
 	}
 
 	return node;
@@ -468,7 +467,6 @@ static AR_EXP_Result _AR_EXP_EvaluateFunctionCall
 	} else {
 		sub_trees = sub_trees_on_stack;
 	}
-	bool param_found = false;
 	for(int child_idx = 0; child_idx < child_count; child_idx++) {
 		SIValue v;
 		AR_ExpNode *child = NODE_CHILD(node, child_idx);
@@ -482,12 +480,9 @@ static AR_EXP_Result _AR_EXP_EvaluateFunctionCall
 			return res;
 		}
 
-		param_found |= (res == EVAL_FOUND_PARAM);
 		sub_trees[child_idx] = v;
 	}
 
-	if(param_found) res = EVAL_FOUND_PARAM;
-
 	// validate before evaluation
 	if(!_AR_EXP_ValidateInvocation(node->op.f, sub_trees, child_count)) {
 		// the expression tree failed its validations and set an error message
@@ -551,7 +546,8 @@ static AR_EXP_Result _AR_EXP_EvaluateParam
 	SIValue *result
 ) {
 	SIValue *param;
-	rax *params = QueryCtx_GetParams();
+	QueryCtx *ctx = QueryCtx_GetQueryCtx();
+	rax *params   = ctx->query_data.params;
 
 	if(params) {
 		param = (SIValue*)raxFind(params,
@@ -565,16 +561,17 @@ static AR_EXP_Result _AR_EXP_EvaluateParam
 		return EVAL_ERR;
 	}
 
-	//--------------------------------------------------------------------------
-	// in place replacement
-	//--------------------------------------------------------------------------
-
-	node->operand.type     = AR_EXP_CONSTANT;
-	node->operand.constant = SI_ShareValue(*param);
+	// the parameter is looked up on every evaluation rather than replaced
+	// by its value, such that an executed plan can be reused with
+	// different parameter values
+	if(ctx->query_data.bindings != NULL) {
+		PlanBindings_Add(ctx->query_data.bindings, node->operand.param_name,
+				*param);
+	}
 
-	*result = node->operand.constant;
+	*result = SI_ShareValue(*param);
 
-	return EVAL_FOUND_PARAM;
+	return EVAL_OK;
 }
 
 static inline AR_EXP_Result _AR_EXP_EvaluateBorrowRecord(AR_ExpNode *node, const Record r,
@@ -629,12 +626,6 @@ SIValue AR_EXP_Evaluate_NoThrow(AR_ExpNode *root, const Record r) {
 		return SI_NullVal(); // Otherwise return NULL; the query-level error will be emitted after cleanup.
 	}
 
-	// at least one param node was encountered during evaluation,
-	// tree should be parameters free, try reducing the tree
-	if(res == EVAL_FOUND_PARAM) {
-		AR_EXP_ReduceToScalar(root, true, NULL);
-	}
-
 	return result;
 }
 
@@ -653,12 +644,6 @@ SIValue AR_EXP_Evaluate
 		return SI_NullVal();
 	}
 
-	// at least one param node was encountered during evaluation,
-	// tree should be parameters free, try reducing the tree
-	if(res == EVAL_FOUND_PARAM) {
-		AR_EXP_ReduceToScalar(root, true, NULL);
-	}
-
 	return result;
 }
 
@@ -727,6 +712,122 @@ SIValue AR_EXP_FinalizeAggregations
 	return AR_EXP_Evaluate(root, r);
 }
 
+// collect aggregation nodes within expression tree, in depth-first order
+void AR_EXP_CollectAggregations
+(
+	AR_ExpNode *root,   // expression tree
+	AR_ExpNode ***aggs  // [output] aggregation nodes
+) {
+	ASSERT(root != NULL);
+	ASSERT(aggs != NULL && *aggs != NULL);
+
+	if(AGGREGATION_NODE(root)) {
+		// aggregation nodes cannot contain nested aggregation nodes
+		array_append(*aggs, root);
+		return;
+	}
+
+	if(AR_EXP_IsOperation(root)) {
+		for(int i = 0; i < NODE_CHILD_COUNT(root); i++) {
+			AR_EXP_CollectAggregations(NODE_CHILD(root, i), aggs);
+		}
+	}
+}
+
+// aggregate record into an external aggregation context
+void AR_EXP_AggregateCtx
+(
+	AR_ExpNode *agg,    // aggregation node
+	const Record r,     // record to aggregate
+	AggregateCtx *ctx,  // aggregation context
+	void *distinct_set  // [optional] set used by a distinct aggregation
+) {
+	ASSERT(ctx != NULL);
+	ASSERT(AGGREGATION_NODE(agg));
+
+	// temporarily swap node's context with the external context
+	AR_ExpNode *distinct = NULL;
+	void *distinct_pdata = NULL;
+	void *pdata = agg->op.private_data;
+	agg->op.private_data = ctx;
+
+	if(distinct_set != NULL) {
+		distinct = NODE_CHILD(agg, 0);
+		ASSERT(AR_EXP_IsOperation(distinct));
+		distinct_pdata = distinct->op.private_data;
+		distinct->op.private_data = distinct_set;
+	}
+
+	AR_EXP_Result res = _AR_EXP_EvaluateFunctionCall(agg, r, NULL);
+
+	// restore node's context before a possible exception is raised
+	agg->op.private_data = pdata;
+	if(distinct != NULL) distinct->op.private_data = distinct_pdata;
+
+	if(res == EVAL_ERR) {
+		ErrorCtx_RaiseRuntimeException(NULL);
+	}
+}
+
+// finalize external aggregation contexts and evaluate the expression
+SIValue AR_EXP_FinalizeAggregationsCtx
+(
+	AR_ExpNode *root,    // expression tree
+	const Record r,      // record to evaluate against
+	AggregateCtx **ctxs  // contexts, one per aggregation node in DFS order
+) {
+	ASSERT(root != NULL);
+	ASSERT(ctxs != NULL);
+
+	// expression is a sole aggregation, e.g. count(n)
+	if(AGGREGATION_NODE(root)) {
+		Aggregate_Finalize(root->op.f, ctxs[0]);
+		SIValue v = Aggregate_GetResult(ctxs[0]);
+		ASSERT(SI_TYPE(v) & AR_FuncDesc_RetType(root->op.f));
+		return v;
+	}
+
+	AR_ExpNode **aggs = array_new(AR_ExpNode *, 1);
+	AR_EXP_CollectAggregations(root, &aggs);
+	uint n = array_len(aggs);
+
+	// substitute each aggregation node with a constant of its final value
+	// the template tree is restored once evaluated
+	AR_ExpNode saved[n];
+	for(uint i = 0; i < n; i++) {
+		AR_ExpNode *agg = aggs[i];
+		Aggregate_Finalize(agg->op.f, ctxs[i]);
+		SIValue v = Aggregate_GetResult(ctxs[i]);
+		ASSERT(SI_TYPE(v) & AR_FuncDesc_RetType(agg->op.f));
+
+		saved[i] = *agg;
+		agg->type             = AR_EXP_OPERAND;
+		agg->operand.type     = AR_EXP_CONSTANT;
+		agg->operand.constant = v;
+	}
+
+	SIValue result;
+	AR_EXP_Result res = _AR_EXP_Evaluate(root, r, &result);
+
+	// result might share a substituted value, make sure it owns its data
+	if(res != EVAL_ERR) SIValue_Persist(&result);
+
+	// restore aggregation nodes
+	for(uint i = 0; i < n; i++) {
+		AR_ExpNode *agg = aggs[i];
+		SIValue_Free(agg->operand.constant);
+		*agg = saved[i];
+	}
+	array_free(aggs);
+
+	if(res == EVAL_ERR) {
+		ErrorCtx_RaiseRuntimeException(NULL);
+		return SI_NullVal();
+	}
+
+	return result;
+}
+
 void AR_EXP_CollectEntities(AR_ExpNode *root, rax *aliases) {
 	if(AR_EXP_IsOperation(root)) {
 		for(int i = 0; i < root->op.child_count; i ++) {
@@ -34,7 +34,6 @@ typedef enum {
 typedef enum {
 	EVAL_OK = 0,
 	EVAL_ERR = (1 << 0),
-	EVAL_FOUND_PARAM = (1 << 1),
 } AR_EXP_Result;
 
 // op represents an operation applied to child args
@@ -118,6 +117,33 @@ void AR_EXP_Aggregate(AR_ExpNode *root, const Record r);
 // and evaluates the expression
 SIValue AR_EXP_FinalizeAggregations(AR_ExpNode *root, const Record r);
 
+// collect aggregation nodes within expression tree, in depth-first order
+void AR_EXP_CollectAggregations
+(
+	AR_ExpNode *root,   // expression tree
+	AR_ExpNode ***aggs  // [output] aggregation nodes
+);
+
+// aggregate record into an external aggregation context
+// the tree's own aggregation context is left untouched, allowing a single
+// expression tree to serve multiple groups
+void AR_EXP_AggregateCtx
+(
+	AR_ExpNode *agg,    // aggregation node
+	const Record r,     // record to aggregate
+	AggregateCtx *ctx,  // aggregation context
+	void *distinct_set  // [optional] set used by a distinct aggregation
+);
+
+// finalize external aggregation contexts and evaluate the expression
+// the expression tree is left intact
+SIValue AR_EXP_FinalizeAggregationsCtx
+(
+	AR_ExpNode *root,    // expression tree
+	const Record r,      // record to evaluate against
+	AggregateCtx **ctxs  // contexts, one per aggregation node in DFS order
+);
+
 //------------------------------------------------------------------------------
 // Utility functions
 //------------------------------------------------------------------------------
@@ -31,15 +31,24 @@ typedef void (*AR_Func_Free)(void *ctx);
 // AR_Func_Clone - function pointer to a routine for cloning a function's private data
 typedef void *(*AR_Func_Clone)(void *orig);
 
-// AR_Func_PrivateData - function pointer to a routine which produce function's private data
-typedef AggregateCtx *(*AR_Func_PrivateData)(void);
+// AR_Func_AggInit - function pointer to a routine which initializes an
+// aggregation context, the context's private data if any is allocated
+// by the caller and zeroed
+typedef void (*AR_Func_AggInit)(AggregateCtx *ctx);
+
+// AR_Func_AggCombine - function pointer to a routine which merges a partial
+// aggregation context into another, used to combine partial aggregations
+// computed independently, src is released by the caller
+typedef void (*AR_Func_AggCombine)(AggregateCtx *dst, AggregateCtx *src);
 
 // aggregation function callbacks
 typedef struct {
 	AR_Func_Free free;                  // [optional] function pointer to cleanup routine
 	AR_Func_Clone clone;                // [optional] function pointer to clone routine
 	AR_Func_Finalize finalize;          // [optional] function pointer to finalizing aggregate value routine
-	AR_Func_PrivateData private_data;   // function pointer to private data generator
+	AR_Func_AggInit init;               // function pointer to aggregation context initializer
+	AR_Func_AggCombine combine;         // [optional] function pointer to partial aggregations merge routine
+	size_t private_size;                // size of aggregation context private data
 } AR_FuncCBs;
 
 typedef struct {
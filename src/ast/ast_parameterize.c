@@ -0,0 +1,358 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "ast_parameterize.h"
+#include "../value.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+#include <math.h>
+#include <errno.h>
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// lexer state
+typedef struct {
+	const char *q;       // query string
+	size_t i;            // current position
+	char *out;           // normalized query
+	SIValue *values;     // hidden parameters values
+	char prev;           // last significant character emitted
+	int depth;           // curly braces depth
+	int return_depth;    // depth at which RETURN was encountered
+	bool in_return;      // within a RETURN clause
+	bool in_order;       // within an ORDER BY clause
+	bool keep_next;      // next literal follows LIMIT / SKIP
+} Parameterizer;
+
+// clauses terminating an ORDER BY clause
+static const char *_clauses[] = {
+	"MATCH", "OPTIONAL", "WITH", "UNWIND", "CREATE", "MERGE", "SET", "DELETE",
+	"DETACH", "REMOVE", "FOREACH", "CALL", "WHERE"
+};
+
+static inline bool _IsIdentChar
+(
+	char c
+) {
+	return isalnum((unsigned char)c) || c == '_';
+}
+
+static inline void _Emit
+(
+	Parameterizer *p,
+	const char *s,
+	size_t n
+) {
+	array_ensure_append(p->out, s, n, char);
+}
+
+// literals are kept as is within RETURN and ORDER BY clauses
+// following LIMIT / SKIP and within variable length ranges, e.g. [*1..3]
+static inline bool _Replaceable
+(
+	const Parameterizer *p
+) {
+	return !(p->in_return || p->in_order || p->keep_next || p->prev == '*' ||
+			p->prev == '.');
+}
+
+// emits a reference to a new hidden parameter holding v
+static void _EmitParam
+(
+	Parameterizer *p,
+	SIValue v
+) {
+	char name[32];
+	int n = snprintf(name, sizeof(name), "$" AST_AUTO_PARAM_PREFIX "%u",
+			array_len(p->values));
+	array_append(p->values, v);
+	_Emit(p, name, n);
+}
+
+// returns false if the query should be left untouched
+static bool _ScanWord
+(
+	Parameterizer *p
+) {
+	const char *q = p->q;
+	size_t start = p->i;
+	while(_IsIdentChar(q[p->i])) p->i++;
+	size_t len = p->i - start;
+	const char *w = q + start;
+
+	#define IS(kw) (len == strlen(kw) && strncasecmp(w, kw, len) == 0)
+
+	bool limit = false;
+	if(p->prev == '.') {
+		// attribute name or namespace, e.g. n.limit or db.labels
+	} else if(IS("RETURN")) {
+		p->in_return = true;
+		p->return_depth = p->depth;
+	} else if(IS("UNION")) {
+		p->in_return = false;
+		p->in_order = false;
+	} else if(IS("ORDER")) {
+		p->in_order = true;
+	} else if(IS("LIMIT") || IS("SKIP")) {
+		limit = true;
+	} else if(IS("INDEX")) {
+		// index creation and deletion
+		return false;
+	} else {
+		for(uint i = 0; i < sizeof(_clauses) / sizeof(_clauses[0]); i++) {
+			if(IS(_clauses[i])) {
+				p->in_order = false;
+				break;
+			}
+		}
+
+		if(IS("CALL")) {
+			// procedure call, arguments might determine the procedure's output
+			size_t j = p->i;
+			while(isspace((unsigned char)q[j])) j++;
+			if(q[j] != '{') return false;
+		}
+	}
+
+	#undef IS
+
+	_Emit(p, w, len);
+	p->keep_next = limit;
+	p->prev = 'a';
+	return true;
+}
+
+// scans a numeric literal
+static void _ScanNumber
+(
+	Parameterizer *p
+) {
+	const char *q = p->q;
+	size_t start = p->i;
+	bool is_float = false;
+
+	while(isdigit((unsigned char)q[p->i])) p->i++;
+
+	if(q[p->i] == '.' && isdigit((unsigned char)q[p->i + 1])) {
+		is_float = true;
+		p->i++;
+		while(isdigit((unsigned char)q[p->i])) p->i++;
+	}
+
+	if(q[p->i] == 'e' || q[p->i] == 'E') {
+		size_t j = p->i + 1;
+		if(q[j] == '+' || q[j] == '-') j++;
+		if(isdigit((unsigned char)q[j])) {
+			is_float = true;
+			p->i = j;
+			while(isdigit((unsigned char)q[p->i])) p->i++;
+		}
+	}
+
+	// hexadecimal, octal and malformed numbers are kept as is
+	bool replace = _Replaceable(p)     &&
+		!_IsIdentChar(q[p->i])         &&
+		!(q[start] == '0' && isdigit((unsigned char)q[start + 1]));
+
+	if(replace) {
+		char *end;
+		errno = 0;
+		if(is_float) {
+			double d = strtod(q + start, &end);
+			replace = (errno == 0 && isfinite(d) && end == q + p->i);
+			if(replace) _EmitParam(p, SI_DoubleVal(d));
+		} else {
+			long long l = strtoll(q + start, &end, 10);
+			replace = (errno == 0 && end == q + p->i);
+			if(replace) _EmitParam(p, SI_LongVal(l));
+		}
+	}
+
+	if(!replace) _Emit(p, q + start, p->i - start);
+
+	p->keep_next = false;
+	p->prev = '0';
+}
+
+// scans a quoted string literal
+// returns false if the string isn't terminated
+static bool _ScanString
+(
+	Parameterizer *p
+) {
+	const char *q = p->q;
+	char quote = q[p->i];
+	size_t start = p->i++;
+	bool escaped = false;
+
+	while(q[p->i] != quote) {
+		if(q[p->i] == '\0') return false;
+		if(q[p->i] == '\\') {
+			// skip escaped character
+			escaped = true;
+			p->i++;
+			if(q[p->i] == '\0') return false;
+		}
+		p->i++;
+	}
+	p->i++;  // skip closing quote
+
+	// strings containing escape sequences are kept as is
+	if(!escaped && _Replaceable(p)) {
+		char *s = rm_strndup(q + start + 1, p->i - start - 2);
+		_EmitParam(p, SI_TransferStringVal(s));
+	} else {
+		_Emit(p, q + start, p->i - start);
+	}
+
+	p->keep_next = false;
+	p->prev = quote;
+	return true;
+}
+
+// copies q[p->i] up to and including terminator
+// returns false if terminator wasn't found
+static bool _CopyUntil
+(
+	Parameterizer *p,
+	size_t skip,            // number of characters to copy before searching
+	const char *terminator  // sequence to search for
+) {
+	const char *q = p->q;
+	const char *end = strstr(q + p->i + skip, terminator);
+	if(end == NULL) return false;
+
+	size_t n = (end - (q + p->i)) + strlen(terminator);
+	_Emit(p, q + p->i, n);
+	p->i += n;
+	return true;
+}
+
+static void _FreeValues
+(
+	SIValue *values
+) {
+	uint n = array_len(values);
+	for(uint i = 0; i < n; i++) SIValue_Free(values[i]);
+	array_free(values);
+}
+
+char *AST_AutoParameterize
+(
+	const char *query,  // query string, excluding parameters
+	rax **params        // [input/output] query parameters
+) {
+	ASSERT(query  != NULL);
+	ASSERT(params != NULL);
+
+	// quick check, avoid scanning queries without literals
+	if(strpbrk(query, "0123456789'\"") == NULL) return NULL;
+
+	// leave queries which refer to hidden parameters as is
+	if(strstr(query, "$" AST_AUTO_PARAM_PREFIX) != NULL) return NULL;
+
+	size_t len = strlen(query);
+	Parameterizer p = {
+		.q            = query,
+		.i            = 0,
+		.out          = array_new(char, len + 32),
+		.values       = array_new(SIValue, 4),
+		.prev         = '\0',
+		.depth        = 0,
+		.return_depth = 0,
+		.in_return    = false,
+		.in_order     = false,
+		.keep_next    = false
+	};
+
+	bool ok = true;
+	while(ok && p.i < len) {
+		char c = query[p.i];
+		char next = query[p.i + 1];
+
+		if(isspace((unsigned char)c)) {
+			_Emit(&p, &c, 1);
+			p.i++;
+		} else if(c == '/' && next == '/') {
+			// line comment, might be terminated by the end of the query
+			if(!_CopyUntil(&p, 2, "\n")) {
+				_Emit(&p, query + p.i, len - p.i);
+				p.i = len;
+			}
+		} else if(c == '/' && next == '*') {
+			ok = _CopyUntil(&p, 2, "*/");
+		} else if(c == '`') {
+			// escaped identifier
+			ok = _CopyUntil(&p, 1, "`");
+			p.prev = 'a';
+		} else if(c == '\'' || c == '"') {
+			ok = _ScanString(&p);
+		} else if(c == '$') {
+			// parameter
+			size_t start = p.i++;
+			while(_IsIdentChar(query[p.i])) p.i++;
+			_Emit(&p, query + start, p.i - start);
+			p.keep_next = false;
+			p.prev = 'a';
+		} else if(isdigit((unsigned char)c)) {
+			_ScanNumber(&p);
+		} else if(isalpha((unsigned char)c) || c == '_') {
+			ok = _ScanWord(&p);
+		} else {
+			if(c == '{') {
+				p.depth++;
+			} else if(c == '}') {
+				p.depth--;
+				// end of a sub query
+				if(p.depth < p.return_depth) {
+					p.in_return = false;
+					p.in_order  = false;
+				}
+			}
+			_Emit(&p, &c, 1);
+			p.i++;
+			p.keep_next = false;
+			p.prev = c;
+		}
+
+		if(array_len(p.values) > AST_AUTO_PARAM_MAX) ok = false;
+	}
+
+	uint nvalues = array_len(p.values);
+
+	// make sure hidden parameters don't collide with user provided ones
+	char name[32];
+	for(uint i = 0; *params != NULL && ok && i < nvalues; i++) {
+		int n = snprintf(name, sizeof(name), AST_AUTO_PARAM_PREFIX "%u", i);
+		ok = raxFind(*params, (unsigned char *)name, n) == raxNotFound;
+	}
+
+	if(!ok || nvalues == 0) {
+		_FreeValues(p.values);
+		array_free(p.out);
+		return NULL;
+	}
+
+	// add hidden parameters
+	if(*params == NULL) *params = raxNew();
+	for(uint i = 0; i < nvalues; i++) {
+		int n = snprintf(name, sizeof(name), AST_AUTO_PARAM_PREFIX "%u", i);
+		SIValue *v = rm_malloc(sizeof(SIValue));
+		*v = p.values[i];
+		raxInsert(*params, (unsigned char *)name, n, v, NULL);
+	}
+	array_free(p.values);
+
+	char *normalized = rm_strndup(p.out, array_len(p.out));
+	array_free(p.out);
+
+	return normalized;
+}
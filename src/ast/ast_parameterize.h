@@ -0,0 +1,36 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "rax.h"
+
+// prefix of hidden parameters introduced by auto parameterization
+#define AST_AUTO_PARAM_PREFIX "__lit"
+
+// maximum number of literals replaced within a single query
+#define AST_AUTO_PARAM_MAX 256
+
+// replaces literals within query with hidden parameters
+// such that queries differing only by their literals share the same text
+//
+// literals which affect the structure of the execution plan
+// or the query's output are left as is:
+// LIMIT and SKIP values, variable length ranges,
+// RETURN and ORDER BY clauses (which determine column names)
+// labels, relationship types and attribute names are identifiers
+// and are never replaced
+//
+// queries containing index operations or procedure calls are left untouched
+//
+// returns a normalized copy of query, or NULL if query was left untouched
+// in which case params isn't modified
+// hidden parameters values are added to *params, creating it if NULL
+char *AST_AutoParameterize
+(
+	const char *query,  // query string, excluding parameters
+	rax **params        // [input/output] query parameters
+);
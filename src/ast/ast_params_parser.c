@@ -0,0 +1,396 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "ast_params_parser.h"
+#include "../value.h"
+#include "../query_ctx.h"
+#include "../util/rmalloc.h"
+#include "../datatypes/map.h"
+#include "../datatypes/array.h"
+
+#include <math.h>
+#include <errno.h>
+#include <ctype.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h>
+
+// maximum nesting depth of lists and maps
+#define PARAMS_MAX_DEPTH 64
+
+static bool _ParseValue(const char **s, SIValue *v, int depth);
+
+static void _ParameterFree
+(
+	void *param_val
+) {
+	SIValue *val = (SIValue *)param_val;
+	SIValue_Free(*val);
+	rm_free(val);
+}
+
+static inline bool _IsIdentChar
+(
+	char c
+) {
+	return isalnum((unsigned char)c) || c == '_';
+}
+
+static inline void _SkipSpaces
+(
+	const char **s
+) {
+	while(isspace((unsigned char)**s)) (*s)++;
+}
+
+// scans an identifier, returns its length, 0 if s doesn't start with one
+static inline size_t _ScanIdent
+(
+	const char *s
+) {
+	if(!isalpha((unsigned char)*s) && *s != '_') return 0;
+
+	size_t n = 1;
+	while(_IsIdentChar(s[n])) n++;
+	return n;
+}
+
+// checks if s starts with keyword kw, followed by a non identifier char
+static inline bool _IsKeyword
+(
+	const char *s,
+	const char *kw
+) {
+	size_t n = strlen(kw);
+	return strncasecmp(s, kw, n) == 0 && !_IsIdentChar(s[n]);
+}
+
+// parses a quoted string, unescaping common escape sequences
+static bool _ParseString
+(
+	const char **s,
+	SIValue *v
+) {
+	const char *p = *s;
+	char quote = *p++;
+
+	// find closing quote, the unescaped string is no longer than the quoted one
+	const char *end = p;
+	while(*end != quote) {
+		if(*end == '\0') return false;
+		if(*end == '\\') {
+			end++;
+			if(*end == '\0') return false;
+		}
+		end++;
+	}
+
+	char *str = rm_malloc(end - p + 1);
+	char *w = str;
+	for(; p < end; p++) {
+		if(*p != '\\') {
+			*w++ = *p;
+			continue;
+		}
+
+		p++;
+		switch(*p) {
+			case '\\':
+			case '\'':
+			case '"':
+				*w++ = *p;
+				break;
+			case 'n':
+				*w++ = '\n';
+				break;
+			case 't':
+				*w++ = '\t';
+				break;
+			case 'r':
+				*w++ = '\r';
+				break;
+			case 'b':
+				*w++ = '\b';
+				break;
+			case 'f':
+				*w++ = '\f';
+				break;
+			default:
+				// unicode and unknown escape sequences
+				rm_free(str);
+				return false;
+		}
+	}
+	*w = '\0';
+
+	*v = SI_TransferStringVal(str);
+	*s = end + 1;
+	return true;
+}
+
+// parses a decimal integer or a floating point
+static bool _ParseNumber
+(
+	const char **s,
+	SIValue *v
+) {
+	const char *p = *s;
+	bool negative = (*p == '-');
+	if(negative) p++;
+
+	const char *start = p;
+	if(!isdigit((unsigned char)*p)) return false;
+	while(isdigit((unsigned char)*p)) p++;
+
+	// octal and hexadecimal numbers are left to the parser
+	if(*start == '0' && p - start > 1) return false;
+
+	bool is_float = false;
+	if(*p == '.') {
+		is_float = true;
+		p++;
+		if(!isdigit((unsigned char)*p)) return false;
+		while(isdigit((unsigned char)*p)) p++;
+	}
+
+	if(*p == 'e' || *p == 'E') {
+		is_float = true;
+		p++;
+		if(*p == '+' || *p == '-') p++;
+		if(!isdigit((unsigned char)*p)) return false;
+		while(isdigit((unsigned char)*p)) p++;
+	}
+
+	if(_IsIdentChar(*p) || *p == '.') return false;
+
+	char *end;
+	errno = 0;
+	if(is_float) {
+		double d = strtod(start, &end);
+		if(errno != 0 || !isfinite(d)) return false;
+		*v = SI_DoubleVal(negative ? -d : d);
+	} else {
+		long long l = strtoll(start, &end, 10);
+		if(errno != 0) return false;
+		*v = SI_LongVal(negative ? -l : l);
+	}
+
+	*s = p;
+	return true;
+}
+
+// parses a list, e.g. [1, 'a', [2]]
+static bool _ParseList
+(
+	const char **s,
+	SIValue *v,
+	int depth
+) {
+	const char *p = *s + 1;  // skip '['
+	SIValue list = SI_Array(0);
+
+	_SkipSpaces(&p);
+	if(*p != ']') {
+		while(true) {
+			SIValue elem;
+			if(!_ParseValue(&p, &elem, depth)) goto error;
+			SIArray_AppendNoClone(&list, elem);
+
+			_SkipSpaces(&p);
+			if(*p == ']') break;
+			if(*p != ',') goto error;
+			p++;
+			_SkipSpaces(&p);
+		}
+	}
+
+	*s = p + 1;  // skip ']'
+	*v = list;
+	return true;
+
+error:
+	SIValue_Free(list);
+	return false;
+}
+
+// parses a map, e.g. {a: 1, 'b': [2]}
+static bool _ParseMap
+(
+	const char **s,
+	SIValue *v,
+	int depth
+) {
+	const char *p = *s + 1;  // skip '{'
+	SIValue map = SI_Map(0);
+
+	_SkipSpaces(&p);
+	if(*p != '}') {
+		while(true) {
+			SIValue key;
+			size_t n = _ScanIdent(p);
+			if(n > 0) {
+				key = SI_TransferStringVal(rm_strndup(p, n));
+				p += n;
+			} else if(*p == '\'' || *p == '"') {
+				if(!_ParseString(&p, &key)) goto error;
+			} else {
+				goto error;
+			}
+
+			_SkipSpaces(&p);
+			if(*p != ':') {
+				SIValue_Free(key);
+				goto error;
+			}
+			p++;
+			_SkipSpaces(&p);
+
+			SIValue val;
+			if(!_ParseValue(&p, &val, depth)) {
+				SIValue_Free(key);
+				goto error;
+			}
+			Map_AddNoClone(&map, key, val);
+
+			_SkipSpaces(&p);
+			if(*p == '}') break;
+			if(*p != ',') goto error;
+			p++;
+			_SkipSpaces(&p);
+		}
+	}
+
+	*s = p + 1;  // skip '}'
+	*v = map;
+	return true;
+
+error:
+	SIValue_Free(map);
+	return false;
+}
+
+// parses a literal value
+// returns false if s doesn't start with a supported literal
+static bool _ParseValue
+(
+	const char **s,
+	SIValue *v,
+	int depth
+) {
+	const char *p = *s;
+
+	if(depth > PARAMS_MAX_DEPTH) return false;
+
+	switch(*p) {
+		case '[':
+			return _ParseList(s, v, depth + 1);
+		case '{':
+			return _ParseMap(s, v, depth + 1);
+		case '\'':
+		case '"':
+			return _ParseString(s, v);
+		case '-':
+			return _ParseNumber(s, v);
+		default:
+			break;
+	}
+
+	if(isdigit((unsigned char)*p)) return _ParseNumber(s, v);
+
+	if(_IsKeyword(p, "true")) {
+		*v = SI_BoolVal(true);
+		*s = p + 4;
+	} else if(_IsKeyword(p, "false")) {
+		*v = SI_BoolVal(false);
+		*s = p + 5;
+	} else if(_IsKeyword(p, "null")) {
+		*v = SI_NullVal();
+		*s = p + 4;
+	} else {
+		// identifiers, function calls, etc.
+		return false;
+	}
+
+	return true;
+}
+
+bool AST_ParseParamsFast
+(
+	const char *query,       // query string
+	const char **query_body  // [output] query string excluding parameters
+) {
+	ASSERT(query      != NULL);
+	ASSERT(query_body != NULL);
+
+	const char *p = query;
+	_SkipSpaces(&p);
+
+	// queries starting with comments or query options other than CYPHER
+	// are left to the parser
+	if(*p == '/' || _IsKeyword(p, "EXPLAIN") || _IsKeyword(p, "PROFILE")) {
+		return false;
+	}
+
+	// query without parameters
+	if(!_IsKeyword(p, "CYPHER")) {
+		*query_body = p;
+		return true;
+	}
+
+	p += strlen("CYPHER");
+	rax *params = raxNew();
+
+	while(true) {
+		_SkipSpaces(&p);
+
+		// parameter name, followed by '='
+		const char *name = p;
+		size_t name_len = _ScanIdent(p);
+		if(name_len == 0) break;
+
+		const char *eq = p + name_len;
+		_SkipSpaces(&eq);
+		if(*eq != '=') break;
+
+		p = eq + 1;
+		_SkipSpaces(&p);
+
+		SIValue v;
+		if(!_ParseValue(&p, &v, 0)) goto error;
+
+		// a value must be followed by whitespace
+		// e.g. 'CYPHER a=1+2' is left to the parser
+		if(*p != '\0' && !isspace((unsigned char)*p)) {
+			SIValue_Free(v);
+			goto error;
+		}
+
+		SIValue *val = rm_malloc(sizeof(SIValue));
+		*val = v;
+
+		// duplicated parameters are reported by the parser
+		if(!raxTryInsert(params, (unsigned char *)name, name_len, val, NULL)) {
+			_ParameterFree(val);
+			goto error;
+		}
+	}
+
+	// at least one parameter is expected
+	// multiple query options are left to the parser
+	if(raxSize(params) == 0 || _IsKeyword(p, "CYPHER") ||
+	   _IsKeyword(p, "EXPLAIN") || _IsKeyword(p, "PROFILE") || *p == '/') {
+		goto error;
+	}
+
+	QueryCtx_SetParams(params);
+	*query_body = p;
+	return true;
+
+error:
+	raxFreeWithCallback(params, _ParameterFree);
+	return false;
+}
@@ -0,0 +1,26 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdbool.h>
+
+// parses the parameters header of a query, e.g. CYPHER a=1 b=[1, 'x']
+// without going through libcypher-parser
+//
+// handles parameters whose values are literals:
+// integers, floats, strings, booleans, NULL and arbitrarily nested
+// lists and maps of those
+// parameter values are added to the query context
+//
+// returns false if query can't be handled, e.g. a parameter value
+// is an expression, in which case query should be parsed by parse_params
+// and the query context is left untouched
+bool AST_ParseParamsFast
+(
+	const char *query,       // query string
+	const char **query_body  // [output] query string excluding parameters
+);
@@ -217,8 +217,6 @@ static int _BulkInsert_ProcessNodeFile
 		Graph_GetLabelMatrix(gc->g, label_ids[i]);
 	}
 
-    // sync node-label matrix
-    Graph_GetNodeLabelMatrix(gc->g);
     Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_NOP);
 
     //--------------------------------------------------------------------------
@@ -414,6 +412,8 @@ cleanup:
 	// reset graph sync policy
 	Graph_SetMatrixPolicy(g, SYNC_POLICY_FLUSH_RESIZE);
 	Graph_ReleaseLock(g);
+	// flush pending changes in the background, if needed
+	GraphContext_ScheduleFlush(gc);
 	return res;
 }
 
@@ -6,7 +6,9 @@
 
 #include "RG.h"
 #include "cmd_context.h"
+#include "prepared_statements.h"
 #include "../globals.h"
+#include "../util/arr.h"
 #include "../util/rmalloc.h"
 #include "../util/thpool/pools.h"
 #include "../slow_log/slow_log.h"
@@ -43,6 +45,10 @@ CommandCtx *CommandCtx_New
 	context->timeout_rw         = timeout_rw;
 	context->received_ts        = received_ts;
 	context->command_name       = NULL;
+	context->stmt               = NULL;
+	context->params             = NULL;
+	context->params_len         = 0;
+	context->batch              = NULL;
 	context->replicated_command = replicated_command;
 
 	simple_timer_copy(timer, context->timer);
@@ -62,6 +68,49 @@ CommandCtx *CommandCtx_New
 	return context;
 }
 
+// associate command with a prepared statement and its binary parameters
+void CommandCtx_SetPreparedStatement
+(
+	CommandCtx *command_ctx,   // command context
+	PreparedStatement *stmt,   // prepared statement to execute
+	RedisModuleString *params  // binary parameters
+) {
+	ASSERT(stmt        != NULL);
+	ASSERT(params      != NULL);
+	ASSERT(command_ctx != NULL);
+	ASSERT(command_ctx->query == NULL);
+
+	// the statement's query is reported by the slowlog and the queries log
+	command_ctx->stmt  = stmt;
+	command_ctx->query = rm_strdup(stmt->query);
+
+	// make a copy of the parameters, which might not be NULL terminated
+	size_t len;
+	const char *p = RedisModule_StringPtrLen(params, &len);
+	command_ctx->params     = rm_malloc(len);
+	command_ctx->params_len = len;
+	memcpy(command_ctx->params, p, len);
+}
+
+// associate command with batched parameter sets
+void CommandCtx_SetBatch
+(
+	CommandCtx *command_ctx,   // command context
+	RedisModuleString **sets,  // parameter sets
+	int n                      // number of parameter sets
+) {
+	ASSERT(n           > 0);
+	ASSERT(sets        != NULL);
+	ASSERT(command_ctx != NULL);
+
+	// make a copy of each parameter set
+	command_ctx->batch = array_new(char *, n);
+	for(int i = 0; i < n; i++) {
+		const char *set = RedisModule_StringPtrLen(sets[i], NULL);
+		array_append(command_ctx->batch, rm_strdup(set));
+	}
+}
+
 // increment command context reference count
 void CommandCtx_Incref
 (
@@ -172,6 +221,12 @@ void CommandCtx_Free
 		ASSERT(command_ctx->bc == NULL);
 
 		if(command_ctx->query != NULL) rm_free(command_ctx->query);
+		if(command_ctx->params != NULL) rm_free(command_ctx->params);
+		if(command_ctx->batch != NULL) {
+			uint n = array_len(command_ctx->batch);
+			for(uint i = 0; i < n; i++) rm_free(command_ctx->batch[i]);
+			array_free(command_ctx->batch);
+		}
 		rm_free(command_ctx->command_name);
 		rm_free(command_ctx);
 	}
@@ -13,6 +13,8 @@
 
 #include <stdatomic.h>
 
+struct PreparedStatement;
+
 // ExecutorThread lists the diffrent types of threads in the system
 typedef enum {
 	EXEC_THREAD_MAIN,    // redis main thread
@@ -35,6 +37,10 @@ typedef struct {
 	bool timeout_rw;               // apply timeout on both read and write queries
 	uint64_t received_ts;          // command received at this UNIX timestamp
 	simple_timer_t timer;          // stopwatch started upon command received
+	struct PreparedStatement *stmt;  // prepared statement to execute, if any
+	char *params;                  // prepared statement binary parameters
+	size_t params_len;             // length of binary parameters
+	char **batch;                  // batched parameter sets, if any
 } CommandCtx;
 
 // create a new command context
@@ -54,6 +60,22 @@ CommandCtx *CommandCtx_New
 	simple_timer_t timer           // stopwatch started upon command received
 );
 
+// associate command with a prepared statement and its binary parameters
+void CommandCtx_SetPreparedStatement
+(
+	CommandCtx *command_ctx,   // command context
+	struct PreparedStatement *stmt,  // prepared statement to execute
+	RedisModuleString *params        // binary parameters
+);
+
+// associate command with batched parameter sets
+void CommandCtx_SetBatch
+(
+	CommandCtx *command_ctx,   // command context
+	RedisModuleString **sets,  // parameter sets
+	int n                      // number of parameter sets
+);
+
 // increment command context reference count
 void CommandCtx_Incref
 (
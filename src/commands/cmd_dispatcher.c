@@ -7,9 +7,11 @@
 #include "RG.h"
 #include "commands.h"
 #include "cmd_context.h"
+#include "prepared_statements.h"
 #include "../util/thpool/pools.h"
 #include "../util/simple_timer.h"
 #include "../util/blocked_client.h"
+#include "../errors/errors.h"
 #include "../configuration/config.h"
 
 #define GRAPH_VERSION_MISSING -1
@@ -23,10 +25,13 @@ static int _read_flags
 (
 	RedisModuleString **argv,   // commands arguments
   	int argc,                   // number of arguments
+	int first,                  // index of first flag
   	bool *compact,              // compact result-set format
 	long long *timeout,         // query level timeout
   	bool *timeout_rw,           // apply timeout on both read and write queries
   	uint *graph_version,        // graph version [UNUSED]
+	int *batch_offset,          // index of first batched parameter set
+	int *batch_size,            // number of batched parameter sets
   	char **errmsg               // reported error message
 ) {
 	ASSERT(compact != NULL);
@@ -36,6 +41,8 @@ static int _read_flags
 
 	// set defaults
 	*compact = false;  // verbose
+	*batch_size = 0;
+	*batch_offset = 0;
 	*graph_version = GRAPH_VERSION_MISSING;
 	Config_Option_get(Config_TIMEOUT_DEFAULT, timeout);
 	Config_Option_get(Config_TIMEOUT_MAX, &max_timeout);
@@ -52,11 +59,12 @@ static int _read_flags
 	}
 
 	// GRAPH.QUERY <GRAPH_KEY> <QUERY>
-	// make sure we've got more than 3 arguments
-	if(argc <= 3) return REDISMODULE_OK;
+	// GRAPH.EXECUTE <GRAPH_KEY> <HANDLE> <PARAMS>
+	// make sure we've got flags
+	if(argc <= first) return REDISMODULE_OK;
 
 	// scan arguments
-	for(int i = 3; i < argc; i++) {
+	for(int i = first; i < argc; i++) {
 		const char *arg = RedisModule_StringPtrLen(argv[i], NULL);
 
 		if(!strcasecmp(arg, "--compact")) {
@@ -107,6 +115,25 @@ static int _read_flags
 			}
 
 			continue;
+		} else if(!strcasecmp(arg, "batch")) {
+			// BATCH <count> <params_1> ... <params_count>
+			long long n = 0;
+			int err = REDISMODULE_ERR;
+			if(i < argc - 1) {
+				i++; // Set the current argument to the count value.
+				err = RedisModule_StringToLongLong(argv[i], &n);
+			}
+
+			// Emit error on missing, non-positive, or exceeding count values.
+			if(err != REDISMODULE_OK || n <= 0 || n > argc - i - 1) {
+				int rc __attribute__((unused));
+				rc = asprintf(errmsg, "Failed to parse batch size value");
+				return REDISMODULE_ERR;
+			}
+
+			*batch_offset = i + 1;
+			*batch_size   = n;
+			i += n;  // skip parameter sets
 		}
 	}
 	return REDISMODULE_OK;
@@ -135,6 +162,10 @@ static inline bool _validate_command_arity(GRAPH_Commands cmd, int arity) {
 		case CMD_PROFILE:
 			// Expect a command, graph name, a query, and optional config flags.
 			return arity >= 3 && arity <= 8;
+		case CMD_EXECUTE:
+			// Expect a command, graph name, a statement handle, parameters
+			// and optional config flags.
+			return arity >= 4 && arity <= 9;
 		default:
 			ASSERT("encountered unhandled query type" && false);
 			return false;
@@ -146,6 +177,7 @@ static Command_Handler get_command_handler(GRAPH_Commands cmd) {
 	switch(cmd) {
 		case CMD_QUERY:
 		case CMD_RO_QUERY:
+		case CMD_EXECUTE:
 			return Graph_Query;
 		case CMD_EXPLAIN:
 			return Graph_Explain;
@@ -164,6 +196,7 @@ static bool should_command_create_graph(GRAPH_Commands cmd) {
 			return true;
 		case CMD_EXPLAIN:
 		case CMD_RO_QUERY:
+		case CMD_EXECUTE:
 			return false;
 		default:
 			ASSERT(false);
@@ -189,15 +222,26 @@ int CommandDispatch
 	uint64_t received_ts = unix_timestamp();
 
 	RedisModuleString *graph_name = argv[1];
-	RedisModuleString *query = (argc > 2) ? argv[2] : NULL;
 	const char *command_name = RedisModule_StringPtrLen(argv[0], NULL);
 	GRAPH_Commands cmd = CommandFromString(command_name);
 
-	if(_validate_command_arity(cmd, argc) == false) return RedisModule_WrongArity(ctx);
+	// a prepared statement is executed given its handle and parameters
+	bool prepared = (cmd == CMD_EXECUTE);
+	RedisModuleString *query = (argc > 2 && !prepared) ? argv[2] : NULL;
 
 	// parse additional arguments
-	int res = _read_flags(argv, argc, &compact, &timeout, &timeout_rw, &version,
-			&errmsg);
+	int batch_size;
+	int batch_offset;
+	int res = _read_flags(argv, argc, prepared ? 4 : 3, &compact, &timeout,
+			&timeout_rw, &version, &batch_offset, &batch_size, &errmsg);
+
+	// batched parameter sets aren't accounted for by the command arity
+	int arity = (batch_size > 0) ? argc - batch_size - 2 : argc;
+	if(_validate_command_arity(cmd, arity) == false) {
+		if(res == REDISMODULE_ERR) free(errmsg);
+		return RedisModule_WrongArity(ctx);
+	}
+
 	if(res == REDISMODULE_ERR) {
 		// emit error and exit if argument parsing failed
 		RedisModule_ReplyWithError(ctx, errmsg);
@@ -205,6 +249,11 @@ int CommandDispatch
 		return REDISMODULE_OK;
 	}
 
+	if(batch_size > 0 && cmd != CMD_QUERY && cmd != CMD_RO_QUERY) {
+		RedisModule_ReplyWithError(ctx, EMSG_BATCH_UNSUPPORTED_COMMAND);
+		return REDISMODULE_OK;
+	}
+
 	bool shouldCreate = should_command_create_graph(cmd);
 	GraphContext *gc = GraphContext_Retrieve(ctx, graph_name, true,
 			shouldCreate);
@@ -221,6 +270,21 @@ int CommandDispatch
 		return REDISMODULE_OK;
 	}
 
+	// look up prepared statement
+	PreparedStatement *stmt = NULL;
+	if(prepared) {
+		long long handle;
+		if(RedisModule_StringToLongLong(argv[2], &handle) == REDISMODULE_OK) {
+			stmt = PreparedStatements_Get(GraphContext_GetPreparedStatements(gc),
+					handle);
+		}
+
+		if(stmt == NULL) {
+			RedisModule_ReplyWithError(ctx, EMSG_PREPARED_UNKNOWN);
+			GraphContext_DecreaseRefCount(gc);
+			return REDISMODULE_OK;
+		}
+	}
 
 	// determine the query execution context
 	// queries issued within a LUA script or multi exec block must
@@ -244,6 +308,10 @@ int CommandDispatch
 		context = CommandCtx_New(ctx, NULL, argv[0], query, gc, exec_thread,
 								 is_replicated, compact, timeout, timeout_rw,
 								 received_ts, timer);
+		if(prepared) CommandCtx_SetPreparedStatement(context, stmt, argv[3]);
+		if(batch_size > 0) {
+			CommandCtx_SetBatch(context, argv + batch_offset, batch_size);
+		}
 		handler(context);
 	} else {
 		// run query on a dedicated thread
@@ -251,6 +319,10 @@ int CommandDispatch
 		context = CommandCtx_New(NULL, bc, argv[0], query, gc, exec_thread,
 								 is_replicated, compact, timeout, timeout_rw,
 								 received_ts, timer);
+		if(prepared) CommandCtx_SetPreparedStatement(context, stmt, argv[3]);
+		if(batch_size > 0) {
+			CommandCtx_SetBatch(context, argv + batch_offset, batch_size);
+		}
 
 		if(ThreadPools_AddWorkReader(handler, context, false) ==
 				THPOOL_QUEUE_FULL) {
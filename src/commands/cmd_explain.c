@@ -54,7 +54,8 @@ void Graph_Explain(void *args) {
 	Graph_AcquireReadLock(gc->g);
 	lock_acquired = true;
 
-	ExecutionPlan_PreparePlan(plan);
+	// a reused plan is already prepared
+	if(!plan->prepared) ExecutionPlan_PreparePlan(plan);
 	ExecutionPlan_Init(plan);       // Initialize the plan's ops.
 
 	if (ErrorCtx_EncounteredError()) {
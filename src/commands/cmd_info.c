@@ -23,6 +23,8 @@
 
 #define SUBCOMMAND_NAME_RUNNING_QUERIES "RunningQueries"
 #define SUBCOMMAND_NAME_WAITING_QUERIES "WaitingQueries"
+#define SUBCOMMAND_NAME_PLAN_CACHE      "PlanCache"
+#define SUBCOMMAND_NAME_MATRICES        "Matrices"
 
 //------------------------------------------------------------------------------
 // Info section API
@@ -240,6 +242,153 @@ static void _info_waiting_queries
 	free(cmds);
 }
 
+// handles the "GRAPH.INFO PlanCache" section
+// "GRAPH.INFO PlanCache"
+static void _info_plan_cache
+(
+	RedisModuleCtx *ctx       // redis context
+) {
+	// an example for a command and reply:
+	// command:
+	// GRAPH.INFO PlanCache
+	// reply:
+	// "# Plan cache"
+	//     "Graph name"
+	//     "Size"
+	//     "Hits"
+	//     "Misses"
+	//     "Evictions"
+	//     "Rejections"
+	//     "Reused plans"
+	//     "Cached products"
+	//     "Cached products memory"
+
+	ASSERT(ctx != NULL);
+
+	RedisModule_ReplyWithCString(ctx, "# Plan cache");
+	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+
+	uint32_t n = 0;
+	GraphContext *gc = NULL;
+	KeySpaceGraphIterator it;
+	Globals_ScanGraphs(&it);
+
+	while((gc = GraphIterator_Next(&it)) != NULL) {
+		CacheStats stats;
+		Cache_GetStats(GraphContext_GetCache(gc), &stats);
+
+		// intermediate products cache, might be disabled
+		CacheStats products = {0};
+		if(gc->products != NULL) Cache_GetStats(gc->products, &products);
+
+		RedisModule_ReplyWithArray(ctx, 9 * 2);
+		Info_SectionAddEntryString(ctx, GRAPH_NAME_KEY_NAME,
+				GraphContext_GetName(gc));
+		Info_SectionAddEntryLongLong(ctx, "Size", stats.size);
+		Info_SectionAddEntryLongLong(ctx, "Hits", stats.hits);
+		Info_SectionAddEntryLongLong(ctx, "Misses", stats.misses);
+		Info_SectionAddEntryLongLong(ctx, "Evictions", stats.evictions);
+		Info_SectionAddEntryLongLong(ctx, "Rejections", stats.rejections);
+		Info_SectionAddEntryLongLong(ctx, "Reused plans",
+				GraphContext_PlanReuses(gc));
+		Info_SectionAddEntryLongLong(ctx, "Cached products", products.size);
+		Info_SectionAddEntryLongLong(ctx, "Cached products memory",
+				products.weight);
+
+		GraphContext_DecreaseRefCount(gc);
+		n++;
+	}
+
+	RedisModule_ReplySetArrayLength(ctx, n);
+}
+
+// replies with matrix information
+static void _emit_matrix
+(
+	RedisModuleCtx *ctx,     // redis module context
+	const GraphContext *gc,  // graph context
+	const char *type,        // matrix type
+	const char *name,        // label or relationship-type name
+	RG_Matrix M              // matrix
+) {
+	ASSERT(M   != NULL);
+	ASSERT(gc  != NULL);
+	ASSERT(ctx != NULL);
+	ASSERT(type != NULL);
+	ASSERT(name != NULL);
+
+	GrB_Index nvals;
+	RG_Matrix_nvals(&nvals, M);
+
+	RedisModule_ReplyWithArray(ctx, 5 * 2);
+	Info_SectionAddEntryString(ctx, GRAPH_NAME_KEY_NAME,
+			GraphContext_GetName(gc));
+	Info_SectionAddEntryString(ctx, "Type", type);
+	Info_SectionAddEntryString(ctx, "Name", name);
+	Info_SectionAddEntryLongLong(ctx, "Entries", nvals);
+	Info_SectionAddEntryString(ctx, "Format",
+			RG_Matrix_formatName(RG_Matrix_format(M)));
+}
+
+// handles the "GRAPH.INFO Matrices" section
+// "GRAPH.INFO Matrices"
+static void _info_matrices
+(
+	RedisModuleCtx *ctx       // redis context
+) {
+	// an example for a command and reply:
+	// command:
+	// GRAPH.INFO Matrices
+	// reply:
+	// "# Matrices"
+	//     "Graph name"
+	//     "Type"
+	//     "Name"
+	//     "Entries"
+	//     "Format"
+
+	ASSERT(ctx != NULL);
+
+	RedisModule_ReplyWithCString(ctx, "# Matrices");
+	RedisModule_ReplyWithArray(ctx, REDISMODULE_POSTPONED_ARRAY_LEN);
+
+	uint32_t n = 0;
+	GraphContext *gc = NULL;
+	KeySpaceGraphIterator it;
+	Globals_ScanGraphs(&it);
+
+	while((gc = GraphIterator_Next(&it)) != NULL) {
+		Graph *g = gc->g;
+
+		// matrices are retrieved the same way readers retrieve them
+		Graph_AcquireReadLock(g);
+
+		_emit_matrix(ctx, gc, "adjacency", "",
+				Graph_GetAdjacencyMatrix(g, false));
+		n++;
+
+		int label_count = Graph_LabelTypeCount(g);
+		for(int i = 0; i < label_count; i++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_NODE);
+			_emit_matrix(ctx, gc, "label", Schema_GetName(s),
+					Graph_GetLabelMatrix(g, i));
+		}
+
+		int rel_count = Graph_RelationTypeCount(g);
+		for(int i = 0; i < rel_count; i++) {
+			Schema *s = GraphContext_GetSchemaByID(gc, i, SCHEMA_EDGE);
+			_emit_matrix(ctx, gc, "relation", Schema_GetName(s),
+					Graph_GetRelationMatrix(g, i, false));
+		}
+		n += label_count + rel_count;
+
+		Graph_ReleaseLock(g);
+		GraphContext_DecreaseRefCount(gc);
+	}
+
+	RedisModule_ReplySetArrayLength(ctx, n);
+}
+
 // attempts to find the specified sections of "GRAPH.INFO" and dispatch it
 static void _handle_sections
 (
@@ -253,6 +402,8 @@ static void _handle_sections
 	int section_count = 0;
 	bool running_queries = false;
 	bool waiting_queries = false;
+	bool plan_cache = false;
+	bool matrices = false;
 
 	if(argc == 0) {
 		running_queries = true;
@@ -269,6 +420,14 @@ static void _handle_sections
 					  !strcasecmp(subcmd, SUBCOMMAND_NAME_WAITING_QUERIES)) {
 				waiting_queries = true;
 				section_count++;
+			} else if(!plan_cache &&
+					  !strcasecmp(subcmd, SUBCOMMAND_NAME_PLAN_CACHE)) {
+				plan_cache = true;
+				section_count++;
+			} else if(!matrices &&
+					  !strcasecmp(subcmd, SUBCOMMAND_NAME_MATRICES)) {
+				matrices = true;
+				section_count++;
 			}
 		}
 	}
@@ -285,11 +444,17 @@ static void _handle_sections
 	if(waiting_queries) {
 		_info_waiting_queries(ctx);
 	}
+	if(plan_cache) {
+		_info_plan_cache(ctx);
+	}
+	if(matrices) {
+		_info_matrices(ctx);
+	}
 }
 
 // graph.info command handler
 // GRAPH.INFO [Section [Section ...]]
-// GRAPH.INFO RunningQueries WaitingQueries
+// GRAPH.INFO RunningQueries WaitingQueries PlanCache Matrices
 int Graph_Info
 (
 	RedisModuleCtx *ctx,       // redis module context
@@ -0,0 +1,63 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "../util/arr.h"
+#include "../query_ctx.h"
+#include "../errors/errors.h"
+#include "prepared_statements.h"
+#include "../graph/graphcontext.h"
+
+// GRAPH.PREPARE command handler
+// prepares a query for repeated execution via GRAPH.EXECUTE
+// replies with the statement's handle followed by the names of its parameters
+// in the order GRAPH.EXECUTE expects their values
+int Graph_Prepare
+(
+	RedisModuleCtx *ctx,       // redis module context
+	RedisModuleString **argv,  // command arguments
+	int argc                   // number of arguments
+) {
+	// GRAPH.PREPARE <key> <query>
+	if(argc != 3) {
+		return RedisModule_WrongArity(ctx);
+	}
+
+	// get graph context
+	GraphContext *gc = GraphContext_Retrieve(ctx, argv[1], true, false);
+
+	// if GraphContext is null, key access failed and an error been emitted
+	if(gc == NULL) return REDISMODULE_ERR;
+
+	// the query is parsed and planned against the graph
+	QueryCtx_SetGraphCtx(gc);
+
+	const char *query = RedisModule_StringPtrLen(argv[2], NULL);
+	PreparedStatements *stmts = GraphContext_GetPreparedStatements(gc);
+	int64_t handle = PreparedStatements_Prepare(stmts, query);
+
+	if(handle == -1) {
+		RedisModule_ReplyWithError(ctx, ErrorCtx_Get()->error);
+	} else {
+		PreparedStatement *stmt = PreparedStatements_Get(stmts, handle);
+		uint n = array_len(stmt->params);
+
+		RedisModule_ReplyWithArray(ctx, 2);
+		RedisModule_ReplyWithLongLong(ctx, handle);
+		RedisModule_ReplyWithArray(ctx, n);
+		for(uint i = 0; i < n; i++) {
+			const char *name = stmt->params[i];
+			RedisModule_ReplyWithStringBuffer(ctx, name, strlen(name));
+		}
+	}
+
+	// clean up
+	QueryCtx_Free();
+	ErrorCtx_Clear();
+	GraphContext_DecreaseRefCount(gc);
+
+	return REDISMODULE_OK;
+}
@@ -12,16 +12,20 @@
 #include "../globals.h"
 #include "../query_ctx.h"
 #include "execution_ctx.h"
+#include "prepared_statements.h"
 #include "../graph/graph.h"
 #include "../util/rmalloc.h"
 #include "../errors/errors.h"
 #include "../index/indexer.h"
+#include "../ast/ast_params_parser.h"
 #include "../effects/effects.h"
 #include "../util/cache/cache.h"
 #include "../util/thpool/pools.h"
 #include "../configuration/config.h"
 #include "../execution_plan/execution_plan.h"
 
+#include <ctype.h>
+
 // GraphQueryCtx stores the allocations required to execute a query.
 typedef struct {
 	GraphContext *graph_ctx;  // graph context
@@ -30,6 +34,9 @@ typedef struct {
 	ExecutionCtx *exec_ctx;   // execution context
 	CommandCtx *command_ctx;  // command context
 	CronTaskHandle timeout;   // timeout cron task
+	rax **batch;              // batched parameter sets
+	long long batch_timeout;  // batch timeout, 0 if not enforced
+	ResultSet **results;      // result set of each batched parameter set
 } GraphQueryCtx;
 
 static GraphQueryCtx *GraphQueryCtx_New
@@ -50,15 +57,45 @@ static GraphQueryCtx *GraphQueryCtx_New
 	ctx->query_ctx->flags = flags;
 	ctx->command_ctx      =  command_ctx;
 	ctx->timeout          =  timeout;
+	ctx->batch            =  NULL;
+	ctx->batch_timeout    =  0;
+	ctx->results          =  NULL;
 
 	return ctx;
 }
 
+static void _ParameterFree
+(
+	void *param_val
+) {
+	SIValue *val = (SIValue *)param_val;
+	SIValue_Free(*val);
+	rm_free(val);
+}
+
+static void _FreeBatch
+(
+	rax **batch
+) {
+	uint n = array_len(batch);
+	for(uint i = 0; i < n; i++) raxFreeWithCallback(batch[i], _ParameterFree);
+	array_free(batch);
+}
+
 static void inline GraphQueryCtx_Free
 (
 	GraphQueryCtx *ctx
 ) {
 	ASSERT(ctx != NULL);
+
+	if(ctx->batch != NULL) _FreeBatch(ctx->batch);
+
+	if(ctx->results != NULL) {
+		uint n = array_len(ctx->results);
+		for(uint i = 0; i < n; i++) ResultSet_Free(ctx->results[i]);
+		array_free(ctx->results);
+	}
+
 	rm_free(ctx);
 }
 
@@ -275,27 +312,225 @@ CronTaskHandle Query_SetTimeOut(uint timeout, ExecutionPlan *plan) {
 	return Cron_AddTask(timeout, QueryTimedOut, NULL, plan);
 }
 
+//------------------------------------------------------------------------------
+// Batched execution
+//------------------------------------------------------------------------------
+
+// adds parameters specified by the query itself to a batched parameter set
+// query parameters take precedence
+static void _MergeParams
+(
+	rax *params,  // batched parameter set
+	rax *base     // query parameters
+) {
+	if(base == NULL) return;
+
+	raxIterator it;
+	raxStart(&it, base);
+	raxSeek(&it, "^", NULL, 0);
+	while(raxNext(&it)) {
+		SIValue *val = rm_malloc(sizeof(SIValue));
+		*val = SI_CloneValue(*(SIValue *)it.data);
+
+		void *old = NULL;
+		if(raxInsert(params, it.key, it.key_len, val, &old) == 0) {
+			_ParameterFree(old);
+		}
+	}
+	raxStop(&it);
+}
+
+// parses batched parameter sets, e.g. "CYPHER a=1 b='x'"
+// returns NULL and sets an error if a set is invalid
+static rax **_ParseBatch
+(
+	char **sets  // parameter sets
+) {
+	QueryCtx *query_ctx = QueryCtx_GetQueryCtx();
+	rax *base = query_ctx->query_data.params;
+
+	uint n = array_len(sets);
+	rax **batch = array_new(rax *, n);
+
+	for(uint i = 0; i < n; i++) {
+		// parameters parsers populate the query context
+		query_ctx->query_data.params = NULL;
+
+		const char *body;
+		bool valid = AST_ParseParamsFast(sets[i], &body);
+		if(!valid) {
+			cypher_parse_result_t *parse_result = parse_params(sets[i], &body);
+			valid = (parse_result != NULL);
+			parse_result_free(parse_result);
+		}
+
+		rax *params = query_ctx->query_data.params;
+		query_ctx->query_data.params = base;
+
+		if(params == NULL) params = raxNew();
+		array_append(batch, params);
+
+		// a parameter set consists of parameters only
+		if(valid) {
+			while(isspace((unsigned char)*body)) body++;
+			valid = (*body == '\0');
+		}
+
+		if(!valid) {
+			if(!ErrorCtx_EncounteredError()) {
+				ErrorCtx_SetError(EMSG_BATCH_INVALID_PARAMETERS, i);
+			}
+			_FreeBatch(batch);
+			return NULL;
+		}
+
+		_MergeParams(params, base);
+	}
+
+	return batch;
+}
+
+// arms the timeout of a batched parameter set
+// with the time left for the entire batch
+// returns false if the batch has already timed out
+static bool _BatchSetTimeOut
+(
+	GraphQueryCtx *gq_ctx,
+	ExecutionPlan *plan
+) {
+	gq_ctx->timeout = 0;
+	if(gq_ctx->batch_timeout == 0) return true;
+
+	double elapsed =
+		TIMER_GET_ELAPSED_MILLISECONDS(gq_ctx->command_ctx->timer);
+	if(elapsed >= gq_ctx->batch_timeout) {
+		ErrorCtx_SetError(EMSG_QUERY_TIMEOUT);
+		return false;
+	}
+
+	gq_ctx->timeout = Query_SetTimeOut(gq_ctx->batch_timeout - elapsed, plan);
+	return true;
+}
+
+// executes query once for each batched parameter set
+// all sets are executed under the same locks and record their modifications
+// into the same undo log and effects buffer, such that the batch
+// is committed or rolled back as a whole
+static void _ExecuteBatch
+(
+	GraphQueryCtx *gq_ctx,            // query context
+	ResultSetFormatterType format     // result sets format
+) {
+	QueryCtx     *query_ctx = gq_ctx->query_ctx;
+	ExecutionCtx *exec_ctx  = gq_ctx->exec_ctx;
+	rax          *base      = query_ctx->query_data.params;
+	ResultSet    *result_set = QueryCtx_GetResultSet();
+
+	// every set executes its own copy of the plan
+	// the first set executes the plan exec_ctx already holds, unless
+	// exec_ctx is the template itself
+	ExecutionCtx *template =
+		(exec_ctx->template != NULL) ? exec_ctx->template : exec_ctx;
+
+	uint n = array_len(gq_ctx->batch);
+	gq_ctx->results = array_new(ResultSet *, n);
+
+	for(uint i = 0; i < n && !ErrorCtx_EncounteredError(); i++) {
+		query_ctx->query_data.params = gq_ctx->batch[i];
+
+		ExecutionCtx *ctx = (i == 0 && template != exec_ctx)
+			? exec_ctx
+			: ExecutionCtx_Clone(template);
+		ExecutionPlan *plan = ctx->plan;
+
+		ResultSet *set = NewResultSet(gq_ctx->rm_ctx, format);
+		if(exec_ctx->cached) ResultSet_CachedExecution(set);
+		QueryCtx_SetResultSet(set);
+		array_append(gq_ctx->results, set);
+
+		if(_BatchSetTimeOut(gq_ctx, plan)) {
+			if(!plan->prepared) ExecutionPlan_PreparePlan(plan);
+			else ExecutionPlan_PrepareReuse(plan);
+			ExecutionPlan_Execute(plan);
+			if(abort_and_check_timeout(gq_ctx, plan)) {
+				query_ctx->status = QueryExecutionStatus_TIMEDOUT;
+			}
+		} else {
+			query_ctx->status = QueryExecutionStatus_TIMEDOUT;
+		}
+
+		// hand successfully executed read-only plans back for reuse
+		bool reuse = !(query_ctx->flags & QueryExecutionTypeFlag_WRITE) &&
+			!ErrorCtx_EncounteredError();
+		ExecutionCtx_ReleasePlan(ctx, reuse);
+		if(ctx != exec_ctx) ExecutionCtx_Free(ctx);
+	}
+
+	query_ctx->query_data.params = base;
+	QueryCtx_SetResultSet(result_set);
+}
+
+// returns true if query modified the graph
+static bool _GraphModified
+(
+	const GraphQueryCtx *gq_ctx,
+	ResultSet *result_set
+) {
+	if(gq_ctx->results == NULL) {
+		return ResultSetStat_IndicateModification(&result_set->stats);
+	}
+
+	uint n = array_len(gq_ctx->results);
+	for(uint i = 0; i < n; i++) {
+		if(ResultSetStat_IndicateModification(&gq_ctx->results[i]->stats)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+// returns true if query's results reference graph entities
+static bool _ReferencesGraph
+(
+	const GraphQueryCtx *gq_ctx,
+	ResultSet *result_set
+) {
+	if(gq_ctx->results == NULL) return ResultSet_ReferencesGraph(result_set);
+
+	uint n = array_len(gq_ctx->results);
+	for(uint i = 0; i < n; i++) {
+		if(ResultSet_ReferencesGraph(gq_ctx->results[i])) return true;
+	}
+	return false;
+}
+
+// replies with the result set of each batched parameter set
+// sets are replied to once the entire batch executed, as an error fails
+// the batch as a whole, graph entities returned by a set therefore
+// reflect the modifications of the sets following it
+static void _ReplyBatch
+(
+	GraphQueryCtx *gq_ctx
+) {
+	uint n = array_len(gq_ctx->results);
+	RedisModule_ReplyWithArray(gq_ctx->rm_ctx, n);
+	for(uint i = 0; i < n; i++) ResultSet_Reply(gq_ctx->results[i]);
+}
+
 inline static bool _readonly_cmd_mode(CommandCtx *ctx) {
 	return strcasecmp(CommandCtx_GetCommandName(ctx), "graph.RO_QUERY") == 0;
 }
 
-// _ExecuteQuery accepts a GraphQueryCtx as an argument
-// it may be called directly by a reader thread or the Redis main thread,
-// or dispatched as a worker thread job when used for writing.
-static void _ExecuteQuery(void *args) {
-	ASSERT(args != NULL);
-
-	GraphQueryCtx  *gq_ctx      = args;
-	QueryCtx       *query_ctx   = gq_ctx->query_ctx;
-	GraphContext   *gc          = gq_ctx->graph_ctx;
-	RedisModuleCtx *rm_ctx      = gq_ctx->rm_ctx;
-	ExecutionCtx   *exec_ctx    = gq_ctx->exec_ctx;
-	CommandCtx     *command_ctx = gq_ctx->command_ctx;
-	AST            *ast         = exec_ctx->ast;
-	ExecutionPlan  *plan        = exec_ctx->plan;
-	ExecutionType  exec_type    = exec_ctx->exec_type;
-	const bool     profile      = (query_ctx->flags & QueryExecutionTypeFlag_PROFILE);
-	const bool     readonly     = !(query_ctx->flags & QueryExecutionTypeFlag_WRITE);
+// sets up the execution of a query
+// returns the query's result set
+static ResultSet *_ExecutionBegin
+(
+	GraphQueryCtx *gq_ctx,          // query context
+	ResultSetFormatterType *format  // [output] result set format
+) {
+	QueryCtx    *query_ctx   = gq_ctx->query_ctx;
+	CommandCtx  *command_ctx = gq_ctx->command_ctx;
+	const bool  profile      = (query_ctx->flags & QueryExecutionTypeFlag_PROFILE);
 
 	// if we have migrated to a writer thread,
 	// update thread-local storage and track the CommandCtx
@@ -309,60 +544,74 @@ static void _ExecuteQuery(void *args) {
 	// instantiate the query ResultSet
 	bool compact = command_ctx->compact;
 	// replicated command don't need to return result
-	ResultSetFormatterType resultset_format =
+	*format =
 		profile || command_ctx->replicated_command
 		? FORMATTER_NOP
 		: (compact)
 			? FORMATTER_COMPACT
 			: FORMATTER_VERBOSE;
-	ResultSet *result_set = NewResultSet(rm_ctx, resultset_format);
-	if(exec_ctx->cached) {
+	ResultSet *result_set = NewResultSet(gq_ctx->rm_ctx, *format);
+	if(gq_ctx->exec_ctx->cached) {
 		ResultSet_CachedExecution(result_set); // indicate a cached execution
 	}
 
 	QueryCtx_SetResultSet(result_set);
 
-	// acquire the appropriate lock
-	if(readonly) {
-		Graph_AcquireReadLock(gc->g);
-	} else {
-		// if this is a writer query `we need to re-open the graph key with write flag
-		// this notifies Redis that the key is "dirty" any watcher on that key will
-		// be notified
-		CommandCtx_ThreadSafeContextLock(command_ctx);
-		{
-			GraphContext_MarkWriter(rm_ctx, gc);
-		}
-		CommandCtx_ThreadSafeContextUnlock(command_ctx);
-	}
+	return result_set;
+}
+
+// executes query, expecting the appropriate lock to be held
+// returns the query's result set
+static ResultSet *_ExecutionRun
+(
+	GraphQueryCtx *gq_ctx,          // query context
+	ResultSet *result_set,          // query's result set
+	ResultSetFormatterType format   // result set format
+) {
+	QueryCtx       *query_ctx   = gq_ctx->query_ctx;
+	GraphContext   *gc          = gq_ctx->graph_ctx;
+	RedisModuleCtx *rm_ctx      = gq_ctx->rm_ctx;
+	ExecutionCtx   *exec_ctx    = gq_ctx->exec_ctx;
+	AST            *ast         = exec_ctx->ast;
+	ExecutionPlan  *plan        = exec_ctx->plan;
+	ExecutionType  exec_type    = exec_ctx->exec_type;
+	const bool     profile      = (query_ctx->flags & QueryExecutionTypeFlag_PROFILE);
+	const bool     readonly     = !(query_ctx->flags & QueryExecutionTypeFlag_WRITE);
 
 	if(exec_type == EXECUTION_TYPE_QUERY) {  // query operation
 		// set policy after lock acquisition,
 		// avoid resetting policies between readers and writers
 		Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 
-		ExecutionPlan_PreparePlan(plan);
-		if(profile) {
-			ExecutionPlan_Profile(plan);
-			if (abort_and_check_timeout(gq_ctx, plan)) {
-				query_ctx->status = QueryExecutionStatus_TIMEDOUT;
-			}
-
-			if(!ErrorCtx_EncounteredError()) {
-				// transition the query from executing reporting
-				QueryCtx_AdvanceStage(query_ctx);
-				ExecutionPlan_Print(plan, rm_ctx);
+		if(gq_ctx->batch != NULL) {
+			_ExecuteBatch(gq_ctx, format);
+		} else {
+			// a reused plan is already optimized
+			if(!plan->prepared) ExecutionPlan_PreparePlan(plan);
+			else ExecutionPlan_PrepareReuse(plan);
+			if(profile) {
+				ExecutionPlan_Profile(plan);
+				if (abort_and_check_timeout(gq_ctx, plan)) {
+					query_ctx->status = QueryExecutionStatus_TIMEDOUT;
+				}
+
+				if(!ErrorCtx_EncounteredError()) {
+					// transition the query from executing reporting
+					QueryCtx_AdvanceStage(query_ctx);
+					ExecutionPlan_Print(plan, rm_ctx);
+				}
 			}
-		}
-		else {
-			result_set = ExecutionPlan_Execute(plan);
-			if (abort_and_check_timeout(gq_ctx, plan)) {
-				query_ctx->status = QueryExecutionStatus_TIMEDOUT;
+			else {
+				result_set = ExecutionPlan_Execute(plan);
+				if (abort_and_check_timeout(gq_ctx, plan)) {
+					query_ctx->status = QueryExecutionStatus_TIMEDOUT;
+				}
 			}
-		}
 
-		ExecutionPlan_Free(plan);
-		exec_ctx->plan = NULL;
+			// hand successfully executed read-only plans back for reuse
+			bool reuse = readonly && !profile && !ErrorCtx_EncounteredError();
+			ExecutionCtx_ReleasePlan(exec_ctx, reuse);
+		}
 	} else if(exec_type == EXECUTION_TYPE_INDEX_CREATE ||
 			exec_type == EXECUTION_TYPE_INDEX_DROP) {
 		_index_operation(rm_ctx, gc, ast, exec_type);
@@ -370,51 +619,56 @@ static void _ExecuteQuery(void *args) {
 		ASSERT("Unhandled query type" && false);
 	}
 
-	// in case of an error, rollback any modifications
-	if(ErrorCtx_EncounteredError()) {
-		QueryCtx_Rollback();
-		// clear resultset statistics, avoiding commnad being replicated
-		ResultSet_Clear(result_set);
-		if (query_ctx->status != QueryExecutionStatus_TIMEDOUT) {
-			query_ctx->status = QueryExecutionStatus_FAILURE;
-		}
-	} else {
-		// replicate if graph was modified
-		if(ResultSetStat_IndicateModification(&result_set->stats)) {
-			// determine rather or not to replicate via effects
-			if(EffectsBuffer_Length(QueryCtx_GetEffectsBuffer()) > 0 &&
-			   _should_replicate_effects()) {
-				// compute effects buffer
-				size_t effects_len = 0;
-				u_char *effects = EffectsBuffer_Buffer(
-						QueryCtx_GetEffectsBuffer(), &effects_len);
-				ASSERT(effects_len > 0 && effects != NULL);
+	return result_set;
+}
 
-				// replicate effects
-				RedisModule_Replicate(rm_ctx, "GRAPH.EFFECT", "cb!",
-						GraphContext_GetName(gc), effects, effects_len);
-				rm_free(effects);
-			} else {
-				// replicate original query
-				QueryCtx_Replicate(query_ctx);
-			}
-		}	
+// in case of an error, rollback any modifications
+// returns true if query failed
+static bool _ExecutionRollback
+(
+	QueryCtx *query_ctx,   // query context
+	ResultSet *result_set  // query's result set
+) {
+	if(!ErrorCtx_EncounteredError()) return false;
+
+	QueryCtx_Rollback();
+	// clear resultset statistics, avoiding commnad being replicated
+	ResultSet_Clear(result_set);
+	if (query_ctx->status != QueryExecutionStatus_TIMEDOUT) {
+		query_ctx->status = QueryExecutionStatus_FAILURE;
 	}
 
-	QueryCtx_UnlockCommit();
+	return true;
+}
+
+// replies to the client and releases the query's resources
+static void _ExecutionEnd
+(
+	GraphQueryCtx *gq_ctx,  // query context
+	ResultSet *result_set,  // query's result set
+	bool read_locked        // graph read lock is held
+) {
+	QueryCtx     *query_ctx   = gq_ctx->query_ctx;
+	GraphContext *gc          = gq_ctx->graph_ctx;
+	CommandCtx   *command_ctx = gq_ctx->command_ctx;
+	const bool   profile      = (query_ctx->flags & QueryExecutionTypeFlag_PROFILE);
 
 	if(!profile || ErrorCtx_EncounteredError()) {
 		// if we encountered an error, ResultSet_Reply will emit the error
 		// send result-set back to client
 		// transition the query from executing reporting
 		QueryCtx_AdvanceStage(query_ctx);
-		ResultSet_Reply(result_set);
+		if(gq_ctx->results != NULL && !ErrorCtx_EncounteredError()) {
+			_ReplyBatch(gq_ctx);
+		} else {
+			ResultSet_Reply(result_set);
+		}
 
 		// transition the query from reporting to finished
 		QueryCtx_AdvanceStage(query_ctx);
 	}
 
-	if(readonly) Graph_ReleaseLock(gc->g); // release read lock
+	if(read_locked) Graph_ReleaseLock(gc->g); // release read lock
 
 	// log query to slowlog
 	SlowLog *slowlog = GraphContext_GetSlowLog(gc);
@@ -422,7 +676,7 @@ static void _ExecuteQuery(void *args) {
 				QueryCtx_GetRuntime(), NULL);
 
 	// clean up
-	ExecutionCtx_Free(exec_ctx);
+	ExecutionCtx_Free(gq_ctx->exec_ctx);
 	GraphContext_DecreaseRefCount(gc);
 	Globals_UntrackCommandCtx(command_ctx);
 	CommandCtx_UnblockClient(command_ctx);
@@ -433,6 +687,211 @@ static void _ExecuteQuery(void *args) {
 	GraphQueryCtx_Free(gq_ctx);
 }
 
+// commits the query's modifications
+// in case of an error modifications are rolled back, otherwise they are
+// replicated, finally the locks acquired for the commit are released
+static void _ExecutionCommit
+(
+	GraphQueryCtx *gq_ctx,  // query context
+	ResultSet *result_set   // query's result set
+) {
+	GraphContext   *gc          = gq_ctx->graph_ctx;
+	RedisModuleCtx *rm_ctx      = gq_ctx->rm_ctx;
+	CommandCtx     *command_ctx = gq_ctx->command_ctx;
+
+	// in case of an error, rollback any modifications
+	if(!_ExecutionRollback(gq_ctx->query_ctx, result_set)) {
+		// modifications are committed, release the graph write lock
+		// replication only requires the GIL, which remains held
+		// this shortens the write lock hold by the time spent replicating
+		// readers still wait for the write lock while the query executes
+		QueryCtx_ReleaseGraphLock();
+
+		// replicate if graph was modified
+		if(_GraphModified(gq_ctx, result_set)) {
+			// determine rather or not to replicate via effects
+			// prepared statements are unknown to replicas and batched
+			// parameter sets aren't part of the replicated query
+			// as such both are always replicated via effects
+			bool verbatim = (command_ctx->stmt == NULL && gq_ctx->batch == NULL);
+			if(EffectsBuffer_Length(QueryCtx_GetEffectsBuffer()) > 0 &&
+			   (!verbatim || _should_replicate_effects())) {
+				// compute effects buffer
+				size_t effects_len = 0;
+				u_char *effects = EffectsBuffer_Buffer(
+						QueryCtx_GetEffectsBuffer(), &effects_len);
+				ASSERT(effects_len > 0 && effects != NULL);
+
+				// replicate effects
+				RedisModule_Replicate(rm_ctx, "GRAPH.EFFECT", "cb!",
+						GraphContext_GetName(gc), effects, effects_len);
+				rm_free(effects);
+			} else if(verbatim) {
+				// replicate original query
+				QueryCtx_Replicate(gq_ctx->query_ctx);
+			}
+		}	
+	}
+
+	QueryCtx_UnlockCommit();
+}
+
+//------------------------------------------------------------------------------
+// Group commit
+//------------------------------------------------------------------------------
+
+// write queries queued against the same graph are pulled off the writers
+// queue at once and executed back to back by the writer thread
+// such that the graph key is re-opened for writing once per group
+// rather than once per query
+
+// maximum number of queries committed as a group
+#define GROUP_COMMIT_MAX_SIZE 1024
+
+static void _ExecuteQuery(void *args);
+
+// returns true if query can be committed as part of a group
+static bool _GroupCommitCandidate
+(
+	const GraphQueryCtx *gq_ctx  // query context
+) {
+	QueryExecutionTypeFlag flags = gq_ctx->query_ctx->flags;
+	return (flags & QueryExecutionTypeFlag_WRITE) &&
+		!(flags & QueryExecutionTypeFlag_PROFILE) &&
+		gq_ctx->exec_ctx->exec_type == EXECUTION_TYPE_QUERY &&
+		gq_ctx->batch == NULL;
+}
+
+// writers queue filter, accepts write queries against the leader's graph
+static bool _GroupCommitMember
+(
+	void *task,  // queued GraphQueryCtx
+	void *pdata  // group leader
+) {
+	const GraphQueryCtx *gq_ctx = task;
+	const GraphQueryCtx *leader = pdata;
+
+	return gq_ctx->graph_ctx == leader->graph_ctx &&
+		_GroupCommitCandidate(gq_ctx);
+}
+
+// collects the write queries queued right behind leader into a group
+// returns NULL if group commit is disabled or no query was collected
+static GraphQueryCtx **_GroupCommitCollect
+(
+	GraphQueryCtx *leader  // group leader
+) {
+	uint64_t size;
+	Config_Option_get(Config_GROUP_COMMIT_SIZE, &size);
+	if(size <= 1 || !_GroupCommitCandidate(leader)) return NULL;
+
+	if(size > GROUP_COMMIT_MAX_SIZE) size = GROUP_COMMIT_MAX_SIZE;
+
+	void *tasks[GROUP_COMMIT_MAX_SIZE];
+	uint32_t n = size - 1;
+	ThreadPools_PullWorkWriter(_ExecuteQuery, _GroupCommitMember, leader,
+			tasks, &n);
+	if(n == 0) return NULL;
+
+	GraphQueryCtx **group = array_new(GraphQueryCtx *, n + 1);
+	array_append(group, leader);
+	for(uint32_t i = 0; i < n; i++) array_append(group, tasks[i]);
+
+	return group;
+}
+
+// executes a group of write queries against the same graph
+// the graph key is re-opened with write flag once for the entire group
+// each query commits, replicates and is replied to before the next one
+// executes, the GIL and the graph write lock are released in between
+// such that a reply only reflects the modifications of preceding queries
+// and Redis isn't blocked for the duration of the entire group
+static void _ExecuteGroup
+(
+	GraphQueryCtx **group  // queries to execute, in queue order
+) {
+	uint           n      = array_len(group);
+	GraphQueryCtx  *first = group[0];
+	GraphContext   *gc    = first->graph_ctx;
+	RedisModuleCtx *rm_ctx = first->rm_ctx;
+
+	// re-open the graph key with write flag once for the entire group
+	// notifying Redis the key is "dirty"
+	CommandCtx_ThreadSafeContextLock(first->command_ctx);
+	{
+		GraphContext_MarkWriter(rm_ctx, gc);
+	}
+	CommandCtx_ThreadSafeContextUnlock(first->command_ctx);
+
+	for(uint i = 0; i < n; i++) {
+		GraphQueryCtx *gq_ctx = group[i];
+
+		ResultSetFormatterType format;
+		ResultSet *result_set = _ExecutionBegin(gq_ctx, &format);
+
+		result_set = _ExecutionRun(gq_ctx, result_set, format);
+		_ExecutionCommit(gq_ctx, result_set);
+		_ExecutionEnd(gq_ctx, result_set, false);
+	}
+}
+
+// _ExecuteQuery accepts a GraphQueryCtx as an argument
+// it may be called directly by a reader thread or the Redis main thread,
+// or dispatched as a worker thread job when used for writing.
+static void _ExecuteQuery(void *args) {
+	ASSERT(args != NULL);
+
+	GraphQueryCtx  *gq_ctx      = args;
+
+	// commit queued write queries against the same graph along with this one
+	if(gq_ctx->command_ctx->thread == EXEC_THREAD_WRITER) {
+		GraphQueryCtx **group = _GroupCommitCollect(gq_ctx);
+		if(group != NULL) {
+			_ExecuteGroup(group);
+			array_free(group);
+			return;
+		}
+	}
+
+	QueryCtx       *query_ctx   = gq_ctx->query_ctx;
+	GraphContext   *gc          = gq_ctx->graph_ctx;
+	RedisModuleCtx *rm_ctx      = gq_ctx->rm_ctx;
+	CommandCtx     *command_ctx = gq_ctx->command_ctx;
+	const bool     readonly     = !(query_ctx->flags & QueryExecutionTypeFlag_WRITE);
+
+	ResultSetFormatterType resultset_format;
+	ResultSet *result_set = _ExecutionBegin(gq_ctx, &resultset_format);
+
+	// acquire the appropriate lock
+	if(readonly) {
+		Graph_AcquireReadLock(gc->g);
+	} else {
+		// if this is a writer query `we need to re-open the graph key with write flag
+		// this notifies Redis that the key is "dirty" any watcher on that key will
+		// be notified
+		CommandCtx_ThreadSafeContextLock(command_ctx);
+		{
+			GraphContext_MarkWriter(rm_ctx, gc);
+		}
+		CommandCtx_ThreadSafeContextUnlock(command_ctx);
+	}
+
+	result_set = _ExecutionRun(gq_ctx, result_set, resultset_format);
+
+	_ExecutionCommit(gq_ctx, result_set);
+
+	// a result set which doesn't reference graph entities is self contained
+	// release the read lock before replying, as replying to the client
+	// might be slow and writers would otherwise be blocked
+	bool read_locked = readonly;
+	if(readonly && !_ReferencesGraph(gq_ctx, result_set)) {
+		Graph_ReleaseLock(gc->g);
+		read_locked = false;
+	}
+
+	_ExecutionEnd(gq_ctx, result_set, read_locked);
+}
+
 static void _DelegateWriter(GraphQueryCtx *gq_ctx) {
 	ASSERT(gq_ctx != NULL);
 
@@ -478,7 +937,13 @@ void _query
 
 	// parse query parameters and build an execution plan
 	// or retrieve it from the cache
-	exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	// prepared statements only require their parameters to be decoded
+	if(command_ctx->stmt != NULL) {
+		exec_ctx = PreparedStatement_Bind(command_ctx->stmt,
+				command_ctx->params, command_ctx->params_len);
+	} else {
+		exec_ctx = ExecutionCtx_FromQuery(command_ctx->query);
+	}
 	if(exec_ctx == NULL) goto cleanup;
 
 	// update cached flag
@@ -500,14 +965,28 @@ void _query
 		goto cleanup;
 	}
 
+	// parse batched parameter sets up front
+	// such that an invalid set fails the query before anything is executed
+	rax **batch = NULL;
+	if(command_ctx->batch != NULL) {
+		if(index_op) {
+			ErrorCtx_SetError(EMSG_BATCH_INDEX_OPERATION);
+			goto cleanup;
+		}
+
+		batch = _ParseBatch(command_ctx->batch);
+		if(batch == NULL) goto cleanup;
+	}
+
 	CronTaskHandle timeout_task = 0;
 
 	// enforce specified timeout when query is readonly
 	// or timeout applies to both read and write
+	// batched parameter sets arm the timeout as they execute
 	bool enforce_timeout = command_ctx->timeout != 0 && !index_op &&
 		(readonly || command_ctx->timeout_rw) &&
 		!command_ctx->replicated_command;
-	if(enforce_timeout) {
+	if(enforce_timeout && batch == NULL) {
 		timeout_task = Query_SetTimeOut(command_ctx->timeout, exec_ctx->plan);
 	}
 
@@ -521,6 +1000,8 @@ void _query
 	}
 	GraphQueryCtx *gq_ctx = GraphQueryCtx_New(gc, ctx, exec_ctx, command_ctx,
 											  flags, timeout_task);
+	gq_ctx->batch         = batch;
+	gq_ctx->batch_timeout = enforce_timeout ? command_ctx->timeout : 0;
 
 	// if 'thread' is redis main thread, continue running
 	// if readonly is true we're executing on a worker thread from
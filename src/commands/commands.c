@@ -20,6 +20,8 @@ GRAPH_Commands CommandFromString(const char *cmd_name) {
 	if (!strcasecmp(cmd_name, "graph.SLOWLOG"))  return CMD_SLOWLOG;
 	if (!strcasecmp(cmd_name, "graph.RO_QUERY")) return CMD_RO_QUERY;
 	if (!strcasecmp(cmd_name, "graph.BULK"))     return CMD_BULK_INSERT;
+	if (!strcasecmp(cmd_name, "graph.PREPARE"))  return CMD_PREPARE;
+	if (!strcasecmp(cmd_name, "graph.EXECUTE"))  return CMD_EXECUTE;
 
 	// we shouldn't reach this point
 	ASSERT(false);
@@ -27,7 +27,9 @@ typedef enum {
 	CMD_LIST        = 9,
 	CMD_DEBUG       = 10,
 	CMD_INFO        = 11,
-	CMD_EFFECT      = 12
+	CMD_EFFECT      = 12,
+	CMD_PREPARE     = 13,
+	CMD_EXECUTE     = 14
 } GRAPH_Commands;
 
 //------------------------------------------------------------------------------
@@ -45,6 +47,7 @@ int Graph_Info(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Debug(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Delete(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Effect(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
+int Graph_Prepare(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Config(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int Graph_Slowlog(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
 int CommandDispatch(RedisModuleCtx *ctx, RedisModuleString **argv, int argc);
@@ -8,6 +8,11 @@
 #include "RG.h"
 #include "../query_ctx.h"
 #include "../errors/errors.h"
+#include "../index/index.h"
+#include "../ast/ast_parameterize.h"
+#include "../ast/ast_params_parser.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
 #include "../execution_plan/execution_plan_clone.h"
 
 static ExecutionType _GetExecutionTypeFromAST
@@ -65,15 +70,89 @@ static ExecutionCtx *_ExecutionCtx_New
 	exec_ctx->plan      = plan;
 	exec_ctx->cached    = false;
 	exec_ctx->exec_type = exec_type;
+	exec_ctx->template  = NULL;
+	exec_ctx->ref_count = 1;
+	exec_ctx->pool      = array_new(PooledPlan, 0);
+
+	// plans specialized to parameter values are only reused
+	// with the same values, see PlanBinding
+	exec_ctx->reusable = (plan != NULL);
+
+	int res = pthread_mutex_init(&exec_ctx->pool_lock, NULL);
+	UNUSED(res);
+	ASSERT(res == 0);
 
 	return exec_ctx;
 }
 
+// returns the current schema state
+static PlanStamp _ExecutionCtx_Stamp(void) {
+	PlanStamp stamp;
+	stamp.version     = GraphContext_GetVersion(QueryCtx_GetGraphCtx());
+	stamp.index_epoch = Index_Epoch();
+	return stamp;
+}
+
+// returns true if every operation in the op tree can be reset
+static bool _ExecutionCtx_PlanResettable
+(
+	const OpBase *op
+) {
+	// filters are stateless
+	if(op->reset == NULL && op->type != OPType_FILTER) return false;
+
+	for(int i = 0; i < op->childCount; i++) {
+		if(!_ExecutionCtx_PlanResettable(op->children[i])) return false;
+	}
+
+	return true;
+}
+
+// take an executed plan from template's pool
+// plans cloned under a different schema state are discarded
+// plans specialized to different parameter values are skipped
+// returns NULL if no plan is available
+static ExecutionPlan *_ExecutionCtx_TakePlan
+(
+	ExecutionCtx *template,  // template to take plan from
+	PlanStamp *stamp         // [output] plan's stamp
+) {
+	if(!template->reusable) return NULL;
+
+	ExecutionPlan *plan = NULL;
+	PlanStamp current = _ExecutionCtx_Stamp();
+	rax *params = QueryCtx_GetParams();
+
+	pthread_mutex_lock(&template->pool_lock);
+	uint i = array_len(template->pool);
+	while(i > 0) {
+		i--;
+		PooledPlan pooled = template->pool[i];
+		if(pooled.stamp.version     != current.version ||
+		   pooled.stamp.index_epoch != current.index_epoch) {
+			// stale plan
+			ExecutionPlan_Free(pooled.plan);
+			array_del_fast(template->pool, i);
+			continue;
+		}
+
+		if(PlanBindings_Match(pooled.plan->bindings, params)) {
+			plan   = pooled.plan;
+			*stamp = pooled.stamp;
+			array_del_fast(template->pool, i);
+			break;
+		}
+	}
+	pthread_mutex_unlock(&template->pool_lock);
+
+	return plan;
+}
+
 // clone the execution ctx and return a shallow copy for the ast
-// deep copy for the execution plan
+// the execution plan is either a previously executed plan or a deep copy
 ExecutionCtx *ExecutionCtx_Clone
 (
-	const ExecutionCtx *ctx  // execution context to clone
+	ExecutionCtx *ctx  // execution context to clone
 ) {
 	ExecutionCtx *clone = rm_malloc(sizeof(ExecutionCtx));
 
@@ -82,13 +161,67 @@ ExecutionCtx *ExecutionCtx_Clone
 	// set the AST copy in thread local storage
 	QueryCtx_SetAST(clone->ast);
 
-	clone->plan      = ExecutionPlan_Clone(ctx->plan);
+	clone->plan = _ExecutionCtx_TakePlan(ctx, &clone->stamp);
+	if(clone->plan == NULL) {
+		// stamp before cloning, a schema change while cloning or executing
+		// leaves the plan with an outdated stamp
+		clone->stamp = _ExecutionCtx_Stamp();
+
+		// operations may evaluate parameters as they're cloned e.g. LIMIT $l
+		PlanBinding *bindings = NULL;
+		QueryCtx_RecordBindings(&bindings);
+		clone->plan = ExecutionPlan_Clone(ctx->plan);
+		QueryCtx_RecordBindings(NULL);
+		clone->plan->bindings = bindings;
+	} else {
+		GraphContext_PlanReused(QueryCtx_GetGraphCtx());
+	}
+
 	clone->cached    = ctx->cached;
 	clone->exec_type = ctx->exec_type;
+	clone->template  = ctx;
+	clone->reusable  = false;
+	clone->pool      = NULL;
+	clone->ref_count = 1;
+
+	// keep template alive while the clone is in use
+	__atomic_fetch_add(&ctx->ref_count, 1, __ATOMIC_RELAXED);
 
 	return clone;
 }
 
+// release the execution plan of an executed context
+void ExecutionCtx_ReleasePlan
+(
+	ExecutionCtx *ctx,  // executed context
+	bool reuse          // plan executed successfully and can be reused
+) {
+	ASSERT(ctx != NULL);
+
+	ExecutionPlan *plan    = ctx->plan;
+	ExecutionCtx *template = ctx->template;
+	ctx->plan = NULL;
+
+	if(plan == NULL) return;
+
+	if(reuse && template != NULL && template->reusable &&
+	   plan->prepared && !ExecutionPlan_Drained(plan) &&
+	   _ExecutionCtx_PlanResettable(plan->root)) {
+		// reset operations, releasing resources held by the execution
+		OpBase_PropagateReset(plan->root);
+
+		pthread_mutex_lock(&template->pool_lock);
+		if(array_len(template->pool) < EXECUTION_CTX_MAX_POOLED_PLANS) {
+			PooledPlan pooled = {.plan = plan, .stamp = ctx->stamp};
+			array_append(template->pool, pooled);
+			plan = NULL;
+		}
+		pthread_mutex_unlock(&template->pool_lock);
+	}
+
+	if(plan != NULL) ExecutionPlan_Free(plan);
+}
+
 // returns the objects and information required for query execution
 // if the query contains error, a ExecutionCtx struct with the AST
 // and Execution plan objects will be NULL
@@ -111,11 +244,15 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	// parse and validate parameters only
 	// extract query string
 	// return invalid execution context if failed to parse params
-	cypher_parse_result_t *params_parse_result = parse_params(q, &q_str);
+	// parameters holding literals are handled without invoking the parser
+	cypher_parse_result_t *params_parse_result = NULL;
+	if(!AST_ParseParamsFast(q, &q_str)) {
+		params_parse_result = parse_params(q, &q_str);
 
-	// parameter parsing failed, return NULL
-	if(params_parse_result == NULL) {
-		return NULL;
+		// parameter parsing failed, return NULL
+		if(params_parse_result == NULL) {
+			return NULL;
+		}
 	}
 
 	// seems like we should be able to free 'params_parse_result'
@@ -133,6 +270,18 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	QueryCtx *ctx = QueryCtx_GetQueryCtx();
 	ctx->query_data.query_no_params = q_str;
 
+	// replace literals with hidden parameters
+	// such that queries which differ only by their literals share a cache entry
+	const char *raw_q_str = q_str;
+	rax *params = ctx->query_data.params;
+	char *normalized = AST_AutoParameterize(q_str, &params);
+	if(normalized != NULL) {
+		if(ctx->query_data.params == NULL) QueryCtx_SetParams(params);
+		ctx->query_data.query_normalized = normalized;
+		ctx->query_data.query_no_params  = normalized;
+		q_str = normalized;
+	}
+
 	// get cache
 	Cache *cache = GraphContext_GetCache(QueryCtx_GetGraphCtx());
 
@@ -156,6 +305,15 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	// try to parse the query
 	AST *ast = _ExecutionCtx_ParseAST(q_str);
 
+	// normalized query failed to parse or validate
+	// report errors in terms of the original query
+	if(ast == NULL && normalized != NULL) {
+		ErrorCtx_Clear();
+		q_str = raw_q_str;
+		ctx->query_data.query_no_params = q_str;
+		ast = _ExecutionCtx_ParseAST(q_str);
+	}
+
 	// parser failed
 	if(ast == NULL) {
 		parse_result_free(params_parse_result);  // free parsed params
@@ -200,6 +358,72 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	return ret;
 }
 
+// builds an execution context for a prepared statement
+ExecutionCtx *ExecutionCtx_Prepare
+(
+	const char *q  // string representing the query
+) {
+	ASSERT(q != NULL);
+
+	const char *q_str;  // query string excluding query parameters
+
+	if(unlikely(strlen(q) == 0)) {
+		ErrorCtx_SetError(EMSG_EMPTY_QUERY);
+		return NULL;
+	}
+
+	cypher_parse_result_t *params_parse_result = parse_params(q, &q_str);
+	if(params_parse_result == NULL) {
+		if(!ErrorCtx_EncounteredError()) {
+			ErrorCtx_SetError(EMSG_COULD_NOT_PARSE_QUERY);
+		}
+		return NULL;
+	}
+
+	// parameters are bound upon execution
+	if(QueryCtx_GetParams() != NULL) {
+		parse_result_free(params_parse_result);
+		ErrorCtx_SetError(EMSG_PREPARED_WITH_PARAMETERS);
+		return NULL;
+	}
+
+	if(unlikely(strlen(q_str) == 0)) {
+		parse_result_free(params_parse_result);
+		ErrorCtx_SetError(EMSG_EMPTY_QUERY);
+		return NULL;
+	}
+
+	QueryCtx *ctx = QueryCtx_GetQueryCtx();
+	ctx->query_data.query_no_params = q_str;
+
+	AST *ast = _ExecutionCtx_ParseAST(q_str);
+	if(ast == NULL) {
+		parse_result_free(params_parse_result);
+		if(!ErrorCtx_EncounteredError()) {
+			ErrorCtx_SetError(EMSG_COULD_NOT_PARSE_QUERY);
+		}
+		return NULL;
+	}
+
+	AST_SetParamsParseResult(ast, params_parse_result);
+
+	// index operations aren't prepared
+	if(_GetExecutionTypeFromAST(ast) != EXECUTION_TYPE_QUERY) {
+		AST_Free(ast);
+		ErrorCtx_SetError(EMSG_PREPARED_INDEX_OPERATION);
+		return NULL;
+	}
+
+	ExecutionPlan *plan = ExecutionPlan_FromTLS_AST();
+	if(ErrorCtx_EncounteredError()) {
+		AST_Free(ast);
+		ExecutionPlan_Free(plan);
+		return NULL;
+	}
+
+	return _ExecutionCtx_New(ast, plan, EXECUTION_TYPE_QUERY);
+}
+
 // free an ExecutionCTX struct and its inner fields
 void ExecutionCtx_Free
 (
@@ -209,14 +433,32 @@ void ExecutionCtx_Free
 		return;
 	}
 
+	// template is shared by the cache and its clones
+	// the last releaser must observe other threads' updates to the pool
+	if(__atomic_sub_fetch(&ctx->ref_count, 1, __ATOMIC_ACQ_REL) > 0) {
+		return;
+	}
+
 	if(ctx->plan != NULL) {
 		ExecutionPlan_Free(ctx->plan);
 	}
 
+	if(ctx->pool != NULL) {
+		uint n = array_len(ctx->pool);
+		for(uint i = 0; i < n; i++) ExecutionPlan_Free(ctx->pool[i].plan);
+		array_free(ctx->pool);
+
+		int res = pthread_mutex_destroy(&ctx->pool_lock);
+		UNUSED(res);
+		ASSERT(res == 0);
+	}
+
 	if(ctx->ast != NULL) {
 		AST_Free(ctx->ast);
 	}
 
+	// release template
+	ExecutionCtx_Free(ctx->template);
+
 	rm_free(ctx);
 }
-
@@ -8,6 +8,9 @@
 
 #include "../ast/ast.h"
 #include "../execution_plan/execution_plan.h"
+#include "xxhash.h"
+
+#include <pthread.h>
 
  // execution type derived from a query
 typedef enum {
@@ -16,13 +19,44 @@ typedef enum {
 	EXECUTION_TYPE_INDEX_DROP     // drop index execution
 } ExecutionType;
 
- // a struct for saving execution objects in cache
+// maximum number of executed plans kept for reuse per cached query
+#define EXECUTION_CTX_MAX_POOLED_PLANS 8
+
+// plans are optimized against the graph schema and indices
+// an executed plan is reused only if neither changed since it was cloned
+// and the current parameters match the plan's bindings
+typedef struct {
+	XXH32_hash_t version;  // graph version
+	uint64_t index_epoch;  // index epoch
+} PlanStamp;
+
+// an executed plan kept for reuse
 typedef struct {
-	AST *ast;                 // AST
-	bool cached;              // cache hit/miss
-	ExecutionPlan *plan;      // execution plan
-	ExecutionType exec_type;  // execution type: query, index create/delete
-} ExecutionCtx;
+	ExecutionPlan *plan;  // prepared plan, its operations reset
+	PlanStamp stamp;      // schema state plan was cloned under
+} PooledPlan;
+
+typedef struct ExecutionCtx ExecutionCtx;
+
+ // a struct for saving execution objects in cache
+ //
+ // the cached context is a template, every query execution works on a copy
+ // copying a template requires a deep clone of its execution plan
+ // once executed, a read-only plan is reset and returned to its template
+ // such that following executions of the same query skip cloning
+ // and optimizing the plan altogether
+struct ExecutionCtx {
+	AST *ast;                  // AST
+	bool cached;               // cache hit/miss
+	ExecutionPlan *plan;       // execution plan
+	ExecutionType exec_type;   // execution type: query, index create/delete
+	ExecutionCtx *template;    // template this context was copied from
+	PlanStamp stamp;           // schema state plan was cloned under
+	bool reusable;             // template's executed plans can be reused
+	PooledPlan *pool;          // template's executed plans ready for reuse
+	pthread_mutex_t pool_lock; // protects pool
+	uint ref_count;            // number of references to template
+};
 
 // returns the objects and information required for query execution
 // if the query contains error, a ExecutionCtx struct with the AST
@@ -34,11 +68,29 @@ ExecutionCtx *ExecutionCtx_FromQuery
 	const char *q  // string representing the query
 );
 
+// builds an execution context for a prepared statement
+// the context isn't cached, parameters are bound upon each execution
+// as such the query may not specify parameter values
+// returns NULL and sets an error if query is invalid or isn't a plain query
+ExecutionCtx *ExecutionCtx_Prepare
+(
+	const char *q  // string representing the query
+);
+
 // clone the execution ctx and return a shallow copy for the ast
-// deep copy for the execution plan
+// the execution plan is either a previously executed plan or a deep copy
 ExecutionCtx *ExecutionCtx_Clone
 (
-	const ExecutionCtx *ctx  // execution context to clone
+	ExecutionCtx *ctx  // execution context to clone
+);
+
+// release the execution plan of an executed context
+// if reuse is set and the plan qualifies, the plan is reset and handed back
+// to the context's template, otherwise the plan is freed
+void ExecutionCtx_ReleasePlan
+(
+	ExecutionCtx *ctx,  // executed context
+	bool reuse          // plan executed successfully and can be reused
 );
 
 // free an ExecutionCTX struct and its inner fields
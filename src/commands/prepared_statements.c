@@ -0,0 +1,349 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "prepared_statements.h"
+#include "../value.h"
+#include "../query_ctx.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+#include "../errors/errors.h"
+#include "../datatypes/map.h"
+#include "../datatypes/array.h"
+
+#include <string.h>
+
+// maximum nesting depth of lists and maps
+#define PARAMS_MAX_DEPTH 64
+
+// binary parameters reader
+typedef struct {
+	const unsigned char *p;    // current position
+	const unsigned char *end;  // end of payload
+} ParamsReader;
+
+static bool _DecodeValue(ParamsReader *r, SIValue *v, int depth);
+
+static void _ParameterFree
+(
+	void *param_val
+) {
+	SIValue *val = (SIValue *)param_val;
+	SIValue_Free(*val);
+	rm_free(val);
+}
+
+// number of unread bytes
+static inline size_t _Remaining
+(
+	const ParamsReader *r
+) {
+	return r->end - r->p;
+}
+
+// reads n bytes into dst
+// payload numbers are little-endian, as is every supported platform
+static inline bool _Read
+(
+	ParamsReader *r,
+	void *dst,
+	size_t n
+) {
+	if(_Remaining(r) < n) return false;
+
+	memcpy(dst, r->p, n);
+	r->p += n;
+	return true;
+}
+
+// decodes a length prefixed string
+static bool _DecodeString
+(
+	ParamsReader *r,
+	SIValue *v
+) {
+	uint32_t len;
+	if(!_Read(r, &len, sizeof(len))) return false;
+	if(_Remaining(r) < len) return false;
+
+	// strings are NULL terminated
+	if(memchr(r->p, '\0', len) != NULL) return false;
+
+	char *str = rm_malloc(len + 1);
+	memcpy(str, r->p, len);
+	str[len] = '\0';
+	r->p += len;
+
+	*v = SI_TransferStringVal(str);
+	return true;
+}
+
+static bool _DecodeList
+(
+	ParamsReader *r,
+	SIValue *v,
+	int depth
+) {
+	uint32_t n;
+	if(!_Read(r, &n, sizeof(n))) return false;
+
+	// every element takes at least one byte
+	if(_Remaining(r) < n) return false;
+
+	SIValue list = SI_Array(n);
+	for(uint32_t i = 0; i < n; i++) {
+		SIValue elem;
+		if(!_DecodeValue(r, &elem, depth)) {
+			SIValue_Free(list);
+			return false;
+		}
+		SIArray_AppendNoClone(&list, elem);
+	}
+
+	*v = list;
+	return true;
+}
+
+static bool _DecodeMap
+(
+	ParamsReader *r,
+	SIValue *v,
+	int depth
+) {
+	uint32_t n;
+	if(!_Read(r, &n, sizeof(n))) return false;
+
+	// every entry takes at least five bytes
+	if(_Remaining(r) / 5 < n) return false;
+
+	SIValue map = SI_Map(n);
+	for(uint32_t i = 0; i < n; i++) {
+		SIValue key;
+		SIValue val;
+		if(!_DecodeString(r, &key)) goto error;
+		if(!_DecodeValue(r, &val, depth)) {
+			SIValue_Free(key);
+			goto error;
+		}
+		Map_AddNoClone(&map, key, val);
+	}
+
+	*v = map;
+	return true;
+
+error:
+	SIValue_Free(map);
+	return false;
+}
+
+static bool _DecodeValue
+(
+	ParamsReader *r,
+	SIValue *v,
+	int depth
+) {
+	if(depth > PARAMS_MAX_DEPTH) return false;
+
+	uint8_t tag;
+	if(!_Read(r, &tag, sizeof(tag))) return false;
+
+	uint8_t  b;
+	int64_t  i;
+	double   d;
+
+	switch(tag) {
+		case PARAM_TAG_NULL:
+			*v = SI_NullVal();
+			return true;
+		case PARAM_TAG_BOOL:
+			if(!_Read(r, &b, sizeof(b)) || b > 1) return false;
+			*v = SI_BoolVal(b);
+			return true;
+		case PARAM_TAG_INT:
+			if(!_Read(r, &i, sizeof(i))) return false;
+			*v = SI_LongVal(i);
+			return true;
+		case PARAM_TAG_DOUBLE:
+			if(!_Read(r, &d, sizeof(d))) return false;
+			*v = SI_DoubleVal(d);
+			return true;
+		case PARAM_TAG_STRING:
+			return _DecodeString(r, v);
+		case PARAM_TAG_LIST:
+			return _DecodeList(r, v, depth + 1);
+		case PARAM_TAG_MAP:
+			return _DecodeMap(r, v, depth + 1);
+		default:
+			return false;
+	}
+}
+
+// collect the names of the parameters referenced by the AST
+// in order of first appearance
+static char **_CollectParams
+(
+	const AST *ast
+) {
+	char **names = array_new(char *, 0);
+	const cypher_astnode_t **params =
+		AST_GetTypedNodes(ast->root, CYPHER_AST_PARAMETER);
+
+	uint n = array_len(params);
+	for(uint i = 0; i < n; i++) {
+		const char *name = cypher_ast_parameter_get_name(params[i]);
+
+		bool seen = false;
+		uint m = array_len(names);
+		for(uint j = 0; j < m && !seen; j++) {
+			seen = (strcmp(names[j], name) == 0);
+		}
+
+		if(!seen) array_append(names, rm_strdup(name));
+	}
+
+	array_free(params);
+	return names;
+}
+
+static void _PreparedStatement_Free
+(
+	PreparedStatement *stmt
+) {
+	uint n = array_len(stmt->params);
+	for(uint i = 0; i < n; i++) rm_free(stmt->params[i]);
+	array_free(stmt->params);
+
+	ExecutionCtx_Free(stmt->exec_ctx);
+	rm_free(stmt->query);
+	rm_free(stmt);
+}
+
+PreparedStatements *PreparedStatements_New(void) {
+	PreparedStatements *stmts = rm_malloc(sizeof(PreparedStatements));
+
+	stmts->stmts   = array_new(PreparedStatement *, 0);
+	stmts->handles = raxNew();
+
+	return stmts;
+}
+
+int64_t PreparedStatements_Prepare
+(
+	PreparedStatements *stmts,  // prepared statements
+	const char *query           // query to prepare
+) {
+	ASSERT(stmts != NULL);
+	ASSERT(query != NULL);
+
+	// query already prepared
+	size_t len = strlen(query);
+	void *h = raxFind(stmts->handles, (unsigned char *)query, len);
+	if(h != raxNotFound) return (int64_t)(uintptr_t)h;
+
+	uint n = array_len(stmts->stmts);
+	if(n >= PREPARED_STATEMENTS_MAX) {
+		ErrorCtx_SetError(EMSG_PREPARED_LIMIT, PREPARED_STATEMENTS_MAX);
+		return -1;
+	}
+
+	// the statement owns its own copy of the query
+	char *q = rm_strdup(query);
+	ExecutionCtx *exec_ctx = ExecutionCtx_Prepare(q);
+	if(exec_ctx == NULL) {
+		rm_free(q);
+		return -1;
+	}
+
+	PreparedStatement *stmt = rm_malloc(sizeof(PreparedStatement));
+
+	stmt->query    = q;
+	stmt->body     = QueryCtx_GetQueryCtx()->query_data.query_no_params;
+	stmt->params   = _CollectParams(exec_ctx->ast);
+	stmt->exec_ctx = exec_ctx;
+
+	array_append(stmts->stmts, stmt);
+	raxInsert(stmts->handles, (unsigned char *)query, len, (void *)(uintptr_t)n,
+			NULL);
+
+	return n;
+}
+
+PreparedStatement *PreparedStatements_Get
+(
+	const PreparedStatements *stmts,  // prepared statements
+	int64_t handle                    // statement handle
+) {
+	ASSERT(stmts != NULL);
+
+	if(handle < 0 || handle >= array_len(stmts->stmts)) return NULL;
+	return stmts->stmts[handle];
+}
+
+uint PreparedStatements_Count
+(
+	const PreparedStatements *stmts  // prepared statements
+) {
+	ASSERT(stmts != NULL);
+	return array_len(stmts->stmts);
+}
+
+ExecutionCtx *PreparedStatement_Bind
+(
+	const PreparedStatement *stmt,  // statement to execute
+	const char *payload,            // binary parameters
+	size_t len                      // payload length
+) {
+	ASSERT(stmt != NULL);
+
+	ParamsReader r = {
+		.p   = (const unsigned char *)payload,
+		.end = (const unsigned char *)payload + len
+	};
+
+	rax *params = raxNew();
+	uint n = array_len(stmt->params);
+	for(uint i = 0; i < n; i++) {
+		SIValue v;
+		if(!_DecodeValue(&r, &v, 0)) goto error;
+
+		SIValue *val = rm_malloc(sizeof(SIValue));
+		*val = v;
+
+		const char *name = stmt->params[i];
+		raxInsert(params, (unsigned char *)name, strlen(name), val, NULL);
+	}
+
+	// payload holds more values than the statement expects
+	if(_Remaining(&r) > 0) goto error;
+
+	QueryCtx_SetParams(params);
+	QueryCtx_GetQueryCtx()->query_data.query_no_params = stmt->body;
+
+	// the statement was parsed and planned upon preparation
+	ExecutionCtx *exec_ctx = ExecutionCtx_Clone(stmt->exec_ctx);
+	exec_ctx->cached = true;
+
+	return exec_ctx;
+
+error:
+	raxFreeWithCallback(params, _ParameterFree);
+	ErrorCtx_SetError(EMSG_PREPARED_INVALID_PARAMETERS);
+	return NULL;
+}
+
+void PreparedStatements_Free
+(
+	PreparedStatements *stmts  // prepared statements to free
+) {
+	ASSERT(stmts != NULL);
+
+	uint n = array_len(stmts->stmts);
+	for(uint i = 0; i < n; i++) _PreparedStatement_Free(stmts->stmts[i]);
+	array_free(stmts->stmts);
+
+	raxFree(stmts->handles);
+	rm_free(stmts);
+}
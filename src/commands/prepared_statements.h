@@ -0,0 +1,100 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "rax.h"
+#include "execution_ctx.h"
+
+#include <stdint.h>
+#include <stddef.h>
+
+// maximum number of prepared statements per graph
+#define PREPARED_STATEMENTS_MAX 4096
+
+// binary parameters payload
+//
+// parameter values are encoded one after the other, in the order reported
+// by GRAPH.PREPARE, all numbers are little-endian
+//
+// value := tag:uint8 data
+//
+// tag | type   | data
+// ----+--------+-------------------------------------------------
+//  0  | null   |
+//  1  | bool   | uint8
+//  2  | int    | int64
+//  3  | double | float64
+//  4  | string | length:uint32 bytes
+//  5  | list   | count:uint32 value*
+//  6  | map    | count:uint32 (key_length:uint32 key_bytes value)*
+typedef enum {
+	PARAM_TAG_NULL   = 0,
+	PARAM_TAG_BOOL   = 1,
+	PARAM_TAG_INT    = 2,
+	PARAM_TAG_DOUBLE = 3,
+	PARAM_TAG_STRING = 4,
+	PARAM_TAG_LIST   = 5,
+	PARAM_TAG_MAP    = 6,
+} PreparedParamTag;
+
+// a query prepared ahead of execution
+typedef struct PreparedStatement {
+	char *query;             // query string
+	const char *body;        // query string excluding query options
+	char **params;           // parameter names, in payload order
+	ExecutionCtx *exec_ctx;  // execution context template
+} PreparedStatement;
+
+// prepared statements of a graph
+// statements are added and looked up only on Redis main thread
+// once prepared a statement lives as long as its graph
+typedef struct PreparedStatements {
+	PreparedStatement **stmts;  // statements, indexed by handle
+	rax *handles;               // query string to handle
+} PreparedStatements;
+
+// create an empty set of prepared statements
+PreparedStatements *PreparedStatements_New(void);
+
+// prepare query, returns its handle
+// preparing the same query multiple times returns the same handle
+// returns -1 and sets an error if the query can't be prepared
+int64_t PreparedStatements_Prepare
+(
+	PreparedStatements *stmts,  // prepared statements
+	const char *query           // query to prepare
+);
+
+// get prepared statement by handle, NULL if handle is unknown
+PreparedStatement *PreparedStatements_Get
+(
+	const PreparedStatements *stmts,  // prepared statements
+	int64_t handle                    // statement handle
+);
+
+// number of prepared statements
+uint PreparedStatements_Count
+(
+	const PreparedStatements *stmts  // prepared statements
+);
+
+// bind binary parameters to statement
+// decoded parameters are added to the query context
+// returns an execution context ready for execution
+// or NULL and sets an error if payload is malformed
+ExecutionCtx *PreparedStatement_Bind
+(
+	const PreparedStatement *stmt,  // statement to execute
+	const char *payload,            // binary parameters
+	size_t len                      // payload length
+);
+
+// free prepared statements
+void PreparedStatements_Free
+(
+	PreparedStatements *stmts  // prepared statements to free
+);
@@ -64,6 +64,14 @@
 // effects replication threshold
 #define EFFECTS_THRESHOLD "EFFECTS_THRESHOLD"
 
+// number of workers used by parallel scans
+#define PARALLEL_SCAN_WORKERS "PARALLEL_SCAN_WORKERS"
+// max number of write queries committed together
+#define GROUP_COMMIT_SIZE "GROUP_COMMIT_SIZE"
+// flush delta matrices in the background
+#define DELTA_BACKGROUND_FLUSH "DELTA_BACKGROUND_FLUSH"
+// max number of cached algebraic products per graph
+#define PRODUCT_CACHE_SIZE "PRODUCT_CACHE_SIZE"
 
 //------------------------------------------------------------------------------
 // Configuration defaults
@@ -94,6 +102,10 @@ typedef struct {
 	bool cmd_info_on;                  // If true, the GRAPH.INFO is enabled.
 	uint64_t effects_threshold;        // replicate via effects when runtime exceeds threshold
 	uint32_t max_info_queries_count;   // Maximum number of query info elements.
+	uint64_t parallel_scan_workers;    // Number of threads participating in a parallel scan.
+	uint64_t group_commit_size;        // Max number of write queries committed together.
+	bool delta_background_flush;       // If true, delta matrices are flushed in the background.
+	uint64_t product_cache_size;       // Max number of cached algebraic products per graph.
 } RG_Config;
 
 RG_Config config; // global module configuration
@@ -436,6 +448,66 @@ static uint64_t Config_effects_threshold_get (void) {
 	return config.effects_threshold;
 }
 
+//------------------------------------------------------------------------------
+// parallel scan workers
+//------------------------------------------------------------------------------
+
+static void Config_parallel_scan_workers_set
+(
+	uint64_t parallel_scan_workers
+) {
+	config.parallel_scan_workers = parallel_scan_workers;
+}
+
+static uint64_t Config_parallel_scan_workers_get(void) {
+	return config.parallel_scan_workers;
+}
+
+//------------------------------------------------------------------------------
+// group commit size
+//------------------------------------------------------------------------------
+
+static void Config_group_commit_size_set
+(
+	uint64_t group_commit_size
+) {
+	config.group_commit_size = group_commit_size;
+}
+
+static uint64_t Config_group_commit_size_get(void) {
+	return config.group_commit_size;
+}
+
+//------------------------------------------------------------------------------
+// delta background flush
+//------------------------------------------------------------------------------
+
+static void Config_delta_background_flush_set
+(
+	bool delta_background_flush
+) {
+	config.delta_background_flush = delta_background_flush;
+}
+
+static bool Config_delta_background_flush_get(void) {
+	return config.delta_background_flush;
+}
+
+//------------------------------------------------------------------------------
+// product cache size
+//------------------------------------------------------------------------------
+
+static void Config_product_cache_size_set
+(
+	uint64_t product_cache_size
+) {
+	config.product_cache_size = product_cache_size;
+}
+
+static uint64_t Config_product_cache_size_get(void) {
+	return config.product_cache_size;
+}
+
 bool Config_Contains_field
 (
 	const char *field_str,
@@ -477,6 +549,14 @@ bool Config_Contains_field
 		f = Config_CMD_INFO_MAX_QUERY_COUNT;
 	} else if (!(strcasecmp(field_str, EFFECTS_THRESHOLD))) {
 		f = Config_EFFECTS_THRESHOLD;
+	} else if(!(strcasecmp(field_str, PARALLEL_SCAN_WORKERS))) {
+		f = Config_PARALLEL_SCAN_WORKERS;
+	} else if(!(strcasecmp(field_str, GROUP_COMMIT_SIZE))) {
+		f = Config_GROUP_COMMIT_SIZE;
+	} else if(!(strcasecmp(field_str, DELTA_BACKGROUND_FLUSH))) {
+		f = Config_DELTA_BACKGROUND_FLUSH;
+	} else if(!(strcasecmp(field_str, PRODUCT_CACHE_SIZE))) {
+		f = Config_PRODUCT_CACHE_SIZE;
 	} else {
 		return false;
 	}
@@ -555,6 +635,22 @@ const char *Config_Field_name
 			name = EFFECTS_THRESHOLD;
 			break;
 
+		case Config_PARALLEL_SCAN_WORKERS:
+			name = PARALLEL_SCAN_WORKERS;
+			break;
+
+		case Config_GROUP_COMMIT_SIZE:
+			name = GROUP_COMMIT_SIZE;
+			break;
+
+		case Config_DELTA_BACKGROUND_FLUSH:
+			name = DELTA_BACKGROUND_FLUSH;
+			break;
+
+		case Config_PRODUCT_CACHE_SIZE:
+			name = PRODUCT_CACHE_SIZE;
+			break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -622,6 +718,18 @@ static void _Config_SetToDefaults(void) {
 
 	// replicate effects if avg change time μs > effects_threshold μs
 	config.effects_threshold = 300 ;
+
+	// parallel scans are disabled by default
+	config.parallel_scan_workers = 0;
+
+	// group commit is disabled by default
+	config.group_commit_size = 1;
+
+	// background flush is enabled by default
+	config.delta_background_flush = true;
+
+	// cache up to 16 products per graph by default
+	config.product_cache_size = 16;
 }
 
 int Config_Init
@@ -930,6 +1038,62 @@ bool Config_Option_get
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// parallel scan workers
+		//----------------------------------------------------------------------
+
+		case Config_PARALLEL_SCAN_WORKERS: {
+			va_start(ap, field);
+			uint64_t *parallel_scan_workers = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(parallel_scan_workers != NULL);
+			(*parallel_scan_workers) = Config_parallel_scan_workers_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// group commit size
+		//----------------------------------------------------------------------
+
+		case Config_GROUP_COMMIT_SIZE: {
+			va_start(ap, field);
+			uint64_t *group_commit_size = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(group_commit_size != NULL);
+			(*group_commit_size) = Config_group_commit_size_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// delta background flush
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_BACKGROUND_FLUSH: {
+			va_start(ap, field);
+			bool *delta_background_flush = va_arg(ap, bool *);
+			va_end(ap);
+
+			ASSERT(delta_background_flush != NULL);
+			(*delta_background_flush) = Config_delta_background_flush_get();
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// product cache size
+		//----------------------------------------------------------------------
+
+		case Config_PRODUCT_CACHE_SIZE: {
+			va_start(ap, field);
+			uint64_t *product_cache_size = va_arg(ap, uint64_t *);
+			va_end(ap);
+
+			ASSERT(product_cache_size != NULL);
+			(*product_cache_size) = Config_product_cache_size_get();
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
@@ -1169,6 +1333,54 @@ bool Config_Option_set
 		}
 		break;
 
+		//----------------------------------------------------------------------
+		// parallel scan workers
+		//----------------------------------------------------------------------
+
+		case Config_PARALLEL_SCAN_WORKERS: {
+			long long parallel_scan_workers;
+			if(!_Config_ParseNonNegativeInteger(val, &parallel_scan_workers)) return false;
+
+			Config_parallel_scan_workers_set(parallel_scan_workers);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// group commit size
+		//----------------------------------------------------------------------
+
+		case Config_GROUP_COMMIT_SIZE: {
+			long long group_commit_size;
+			if(!_Config_ParsePositiveInteger(val, &group_commit_size)) return false;
+
+			Config_group_commit_size_set(group_commit_size);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// delta background flush
+		//----------------------------------------------------------------------
+
+		case Config_DELTA_BACKGROUND_FLUSH: {
+			bool delta_background_flush;
+			if(!_Config_ParseYesNo(val, &delta_background_flush)) return false;
+
+			Config_delta_background_flush_set(delta_background_flush);
+		}
+		break;
+
+		//----------------------------------------------------------------------
+		// product cache size
+		//----------------------------------------------------------------------
+
+		case Config_PRODUCT_CACHE_SIZE: {
+			long long product_cache_size;
+			if(!_Config_ParseNonNegativeInteger(val, &product_cache_size)) return false;
+
+			Config_product_cache_size_set(product_cache_size);
+		}
+		break;
+
 		//----------------------------------------------------------------------
 		// invalid option
 		//----------------------------------------------------------------------
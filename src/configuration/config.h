@@ -33,7 +33,11 @@ typedef enum {
 	Config_CMD_INFO                  = 13,  // toggle on/off the GRAPH.INFO
 	Config_CMD_INFO_MAX_QUERY_COUNT  = 14,  // the max number of info queries count
 	Config_EFFECTS_THRESHOLD         = 15,  // replicate queries via effects
-	Config_END_MARKER                = 16
+	Config_PARALLEL_SCAN_WORKERS     = 16,  // number of workers used by parallel scans
+	Config_GROUP_COMMIT_SIZE         = 17,  // max number of write queries committed together
+	Config_DELTA_BACKGROUND_FLUSH    = 18,  // flush delta matrices in the background
+	Config_PRODUCT_CACHE_SIZE        = 19,  // max number of cached algebraic products per graph
+	Config_END_MARKER                = 20
 } Config_Option_Field;
 
 // callback function, invoked once configuration changes as a result of
@@ -53,7 +57,10 @@ static const Config_Option_Field RUNTIME_CONFIGS[] = {
 	Config_DELTA_MAX_PENDING_CHANGES,
 	Config_CMD_INFO,
 	Config_CMD_INFO_MAX_QUERY_COUNT,
-	Config_EFFECTS_THRESHOLD
+	Config_EFFECTS_THRESHOLD,
+	Config_PARALLEL_SCAN_WORKERS,
+	Config_GROUP_COMMIT_SIZE,
+	Config_DELTA_BACKGROUND_FLUSH
 };
 static const size_t RUNTIME_CONFIG_COUNT = sizeof(RUNTIME_CONFIGS) / sizeof(RUNTIME_CONFIGS[0]);
 
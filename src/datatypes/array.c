@@ -25,6 +25,10 @@ void SIArray_Append(SIValue *siarray, SIValue value) {
 	array_append(siarray->array, clone);
 }
 
+void SIArray_AppendNoClone(SIValue *siarray, SIValue value) {
+	array_append(siarray->array, value);
+}
+
 SIValue SIArray_Get(SIValue siarray, uint32_t index) {
 	// check index
 	if(index >= SIArray_Length(siarray)) return SI_NullVal();
@@ -180,6 +184,24 @@ XXH64_hash_t SIArray_HashCode(SIValue siarray) {
 	return hashCode;
 }
 
+// writes a binary representation of an array to stream
+void SIArray_ToBinary
+(
+	FILE *stream,         // stream to write array to
+	const SIValue *array  // array to write
+) {
+	// format:
+	// number of elements
+	// elements
+	uint32_t n = SIArray_Length(*array);
+	fwrite_assert(&n, sizeof(uint32_t), stream);
+
+	for(uint32_t i = 0; i < n; i++) {
+		SIValue elem = SIArray_Get(*array, i);
+		SIValue_ToBinary(stream, &elem);
+	}
+}
+
 // creates an array from its binary representation
 // this is the reverse of SIArray_ToBinary
 // x = SIArray_FromBinary(SIArray_ToBinary(y));
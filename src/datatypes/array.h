@@ -22,6 +22,14 @@ SIValue SIArray_New(u_int32_t initialCapacity);
   */
 void SIArray_Append(SIValue *siarray, SIValue value);
 
+/**
+  * @brief  Appends a new SIValue to a given array, array takes ownership
+  *         over the appended value
+  * @param  siarray: pointer to array
+  * @param  value: new value
+  */
+void SIArray_AppendNoClone(SIValue *siarray, SIValue value);
+
 /**
   * @brief  Returns a volatile copy of the SIValue from an array in a given index
   * @note   If index is out of bound, SI_NullVal is returned
@@ -97,6 +105,13 @@ void SIArray_ToString(SIValue list, char **buf, size_t *bufferLen, size_t *bytes
  */
 XXH64_hash_t SIArray_HashCode(SIValue siarray);
 
+// writes a binary representation of an array to stream
+void SIArray_ToBinary
+(
+	FILE *stream,         // stream to write array to
+	const SIValue *array  // array to write
+);
+
 // creates an array from its binary representation
 // this is the reverse of SIArray_ToBinary
 // x = SIArray_FromBinary(SIArray_ToBinary(y));
@@ -112,6 +112,23 @@ void Map_Add
 	array_append(map->map, pair);
 }
 
+// adds key/value to map, without cloning them
+void Map_AddNoClone
+(
+	SIValue *map,
+	SIValue key,
+	SIValue value
+) {
+	ASSERT(SI_TYPE(*map) & T_MAP);
+	ASSERT(SI_TYPE(key) & T_STRING);
+
+	// remove key if already existed
+	Map_Remove(*map, key);
+
+	Pair pair = {.key = key, .val = value};
+	array_append(map->map, pair);
+}
+
 // removes key from map
 void Map_Remove
 (
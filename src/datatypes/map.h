@@ -51,6 +51,15 @@ void Map_Add
 	SIValue value  // value to add under key
 );
 
+// adds key/value to map
+// map takes ownership over both key and value
+void Map_AddNoClone
+(
+	SIValue *map,  // map to add element to
+	SIValue key,   // key under which value is added
+	SIValue value  // value to add under key
+);
+
 // removes key from map
 void Map_Remove
 (
@@ -578,6 +578,9 @@ void Effects_Apply
 	// release write lock
 	Graph_ReleaseLock(g);
 
+	// flush pending changes in the background, if needed
+	GraphContext_ScheduleFlush(gc);
+
 	// close stream
 	fclose(stream);
 }
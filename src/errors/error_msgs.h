@@ -84,6 +84,14 @@
 #define EMSG_UNKNOWN_EXECUTION_TYPE "ERR Encountered unknown query execution type."
 #define EMSG_MISUSE_GRAPH_ROQUERY "graph.RO_QUERY is to be executed only on read-only queries"
 #define EMSG_COULD_NOT_PARSE_QUERY "Error: could not parse query"
+#define EMSG_PREPARED_WITH_PARAMETERS "Prepared statements can't specify parameter values"
+#define EMSG_PREPARED_INDEX_OPERATION "Index operations can't be prepared"
+#define EMSG_PREPARED_LIMIT "Maximum number of prepared statements (%d) reached"
+#define EMSG_PREPARED_UNKNOWN "Unknown prepared statement"
+#define EMSG_PREPARED_INVALID_PARAMETERS "Failed to decode prepared statement parameters"
+#define EMSG_BATCH_UNSUPPORTED_COMMAND "BATCH is supported only by GRAPH.QUERY and GRAPH.RO_QUERY"
+#define EMSG_BATCH_INDEX_OPERATION "Index operations can't be batched"
+#define EMSG_BATCH_INVALID_PARAMETERS "Invalid batch parameter set at position %d"
 #define EMSG_UNABLE_TO_RESOLVE_FILTER_ALIAS "Unable to resolve filtered alias '%s'"
 #define EMSG_TYPE_MISMATCH "Type mismatch: expected %s but was %s"
 #define EMSG_REDISGRAPH_SUPPORT "RedisGraph does not currently support %s"
@@ -376,10 +376,19 @@ ExecutionPlan *ExecutionPlan_FromTLS_AST(void) {
 void ExecutionPlan_PreparePlan(ExecutionPlan *plan) {
 	// Plan should be prepared only once.
 	ASSERT(!plan->prepared);
+	// Parameters evaluated by optimizations may be folded into the plan.
+	QueryCtx_RecordBindings(&plan->bindings);
 	optimizePlan(plan);
+	QueryCtx_RecordBindings(NULL);
 	plan->prepared = true;
 }
 
+void ExecutionPlan_PrepareReuse(ExecutionPlan *plan) {
+	ASSERT(plan->prepared);
+	// The graph and parameters may have changed since the plan was last executed.
+	OpBase_PropagateReset(plan->root);
+}
+
 inline rax *ExecutionPlan_GetMappings(const ExecutionPlan *plan) {
 	ASSERT(plan && plan->record_map);
 	return plan->record_map;
@@ -421,7 +430,9 @@ static void _ExecutionPlanInit(OpBase *root) {
 	_ExecutionPlan_InitRecordPool((ExecutionPlan *)root->plan);
 
 	// Initialize the operation if necessary.
-	if(root->init) root->init(root);
+	// operations of a reused plan are already initialized
+	if(root->init && !root->op_initialized) root->init(root);
+	root->op_initialized = true;
 
 	// Continue initializing downstream operations.
 	for(int i = 0; i < root->childCount; i++) {
@@ -471,12 +482,14 @@ bool ExecutionPlan_Drained(ExecutionPlan *plan) {
 
 static void _ExecutionPlan_Drain(OpBase *root) {
 	root->consume = deplete_consume;
+	root->consumeBatch = NULL;
 	for(int i = 0; i < root->childCount; i++) {
 		_ExecutionPlan_Drain(root->children[i]);
 	}
 }
 
 // Resets each operation consume function to simply return NULL
+// batch consume functions are removed, falling back to consume
 // this will cause the execution-plan to quickly deplete
 void ExecutionPlan_Drain(ExecutionPlan *plan) {
 	ASSERT(plan && plan->root);
@@ -542,6 +555,7 @@ static void _ExecutionPlan_FreeInternals
 	if(plan->ast_segment != NULL) {
 		AST_Free(plan->ast_segment);
 	}
+	PlanBindings_Free(plan->bindings);
 	rm_free(plan);
 }
 
@@ -11,6 +11,7 @@
 #include "../resultset/resultset.h"
 #include "../filter_tree/filter_tree.h"
 #include "../util/object_pool/object_pool.h"
+#include "execution_plan_bindings.h"
 
 typedef struct ExecutionPlan ExecutionPlan;
 
@@ -21,6 +22,7 @@ struct ExecutionPlan {
 	QueryGraph *query_graph;            // QueryGraph representing all graph entities in this segment.
 	ObjectPool *record_pool;
 	bool prepared;                      // Indicates if the execution plan is ready for execute.
+	PlanBinding *bindings;              // Parameter values the plan was specialized to.
 };
 
 // Creates a new execution plan from AST
@@ -29,6 +31,10 @@ ExecutionPlan *ExecutionPlan_FromTLS_AST(void);
 // Prepare an execution plan for execution: optimize, initialize result set schema.
 void ExecutionPlan_PreparePlan(ExecutionPlan *plan);
 
+// Prepare a previously executed plan for another execution,
+// operations re-evaluate state derived from the graph and query parameters.
+void ExecutionPlan_PrepareReuse(ExecutionPlan *plan);
+
 // Allocate a new ExecutionPlan segment.
 ExecutionPlan *ExecutionPlan_NewEmptyExecutionPlan(void);
 
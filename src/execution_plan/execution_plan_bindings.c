@@ -0,0 +1,88 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "execution_plan_bindings.h"
+#include "../util/arr.h"
+#include "../util/rmalloc.h"
+
+// types for which a value comparison is defined
+#define BINDING_COMPARABLE \
+	(T_NULL | T_BOOL | SI_NUMERIC | T_STRING | T_ARRAY | T_MAP | T_POINT)
+
+// returns true if parameter value equals bound value
+static bool _PlanBinding_Equal
+(
+	SIValue bound,  // bound value
+	SIValue v       // parameter value
+) {
+	// a plan specialized to an integer doesn't apply to an equal float
+	if(SI_TYPE(bound) != SI_TYPE(v)) return false;
+	if(!(SI_TYPE(v) & BINDING_COMPARABLE)) return false;
+	if(SI_TYPE(v) == T_NULL) return true;
+
+	int disjoint_or_null;
+	int res = SIValue_Compare(bound, v, &disjoint_or_null);
+	return (res == 0 && disjoint_or_null == 0);
+}
+
+void PlanBindings_Add
+(
+	PlanBinding **bindings,
+	const char *name,
+	SIValue value
+) {
+	ASSERT(name     != NULL);
+	ASSERT(bindings != NULL);
+
+	if(*bindings == NULL) *bindings = array_new(PlanBinding, 1);
+
+	uint n = array_len(*bindings);
+	for(uint i = 0; i < n; i++) {
+		if(strcmp((*bindings)[i].name, name) == 0) return;
+	}
+
+	PlanBinding binding = {
+		.name  = rm_strdup(name),
+		.value = SI_CloneValue(value)
+	};
+	array_append(*bindings, binding);
+}
+
+bool PlanBindings_Match
+(
+	const PlanBinding *bindings,
+	rax *params
+) {
+	if(bindings == NULL) return true;
+
+	uint n = array_len(bindings);
+	for(uint i = 0; i < n; i++) {
+		const PlanBinding *binding = bindings + i;
+		if(params == NULL) return false;
+
+		SIValue *v = raxFind(params, (unsigned char *)binding->name,
+				strlen(binding->name));
+		if(v == raxNotFound) return false;
+		if(!_PlanBinding_Equal(binding->value, *v)) return false;
+	}
+
+	return true;
+}
+
+void PlanBindings_Free
+(
+	PlanBinding *bindings
+) {
+	if(bindings == NULL) return;
+
+	uint n = array_len(bindings);
+	for(uint i = 0; i < n; i++) {
+		rm_free(bindings[i].name);
+		SIValue_Free(bindings[i].value);
+	}
+	array_free(bindings);
+}
@@ -0,0 +1,42 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "rax.h"
+#include "../value.h"
+
+// a parameter value an execution plan was specialized to
+//
+// parameters evaluated while a plan is cloned or optimized may shape the plan
+// e.g. `id(n) = $id` is turned into an ID seek over the value of $id
+// such a plan can only be executed again with the same parameter value
+// parameters evaluated during execution are looked up on every evaluation
+typedef struct {
+	char *name;     // parameter name
+	SIValue value;  // parameter value
+} PlanBinding;
+
+// record parameter value, unless the parameter is already recorded
+void PlanBindings_Add
+(
+	PlanBinding **bindings,  // [input/output] recorded bindings
+	const char *name,        // parameter name
+	SIValue value            // parameter value
+);
+
+// returns true if every binding matches its parameter's value within params
+bool PlanBindings_Match
+(
+	const PlanBinding *bindings,  // recorded bindings
+	rax *params                   // current parameters
+);
+
+// free bindings
+void PlanBindings_Free
+(
+	PlanBinding *bindings  // bindings to free
+);
@@ -59,6 +59,8 @@ void OpBase_Init
 	op->profile  = NULL;
 	op->consume  = consume;
 	op->toString = toString;
+
+	op->consumeBatch = NULL;
 }
 
 inline Record OpBase_Consume
@@ -68,6 +70,44 @@ inline Record OpBase_Consume
 	return op->consume(op);
 }
 
+// fallback batch consume for row based operations
+// pulls records one at a time until either the batch is full
+// or op is depleted
+static uint _OpBase_ConsumeRows
+(
+	OpBase *op,
+	Record *batch,
+	uint cap
+) {
+	uint n = 0;
+	while(n < cap) {
+		Record r = OpBase_Consume(op);
+		if(r == NULL) break;
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
+uint OpBase_ConsumeBatch
+(
+	OpBase *op,
+	Record *batch,
+	uint cap
+) {
+	ASSERT(op    != NULL);
+	ASSERT(batch != NULL);
+	ASSERT(cap   > 0);
+
+	// profiled operations are consumed one record at a time
+	// such that their statistics remain accurate
+	if(op->consumeBatch == NULL || op->stats != NULL) {
+		return _OpBase_ConsumeRows(op, batch, cap);
+	}
+
+	return op->consumeBatch(op, batch, cap);
+}
+
 // mark alias as being modified by operation
 // returns the ID associated with alias
 int OpBase_Modifies
@@ -250,6 +290,15 @@ void OpBase_UpdateConsume
 	else op->consume = consume;
 }
 
+void OpBase_UpdateConsumeBatch
+(
+	OpBase *op,
+	fpConsumeBatch consumeBatch
+) {
+	ASSERT(op != NULL);
+	op->consumeBatch = consumeBatch;
+}
+
 // updates the plan of an operation
 void OpBase_BindOpToPlan
 (
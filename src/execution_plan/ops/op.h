@@ -55,6 +55,7 @@ typedef enum {
 	OPType_OR_APPLY_MULTIPLEXER,
 	OPType_AND_APPLY_MULTIPLEXER,
 	OPType_OPTIONAL,
+	OPType_EXCHANGE,
 } OPType;
 
 typedef enum {
@@ -89,6 +90,9 @@ static const OPType SCAN_OPS[] = {
 	OPType_NODE_BY_LABEL_AND_ID_SCAN
 };
 
+// default number of records exchanged between batch consuming operations
+#define OP_BATCH_SIZE 64
+
 #define BLACKLIST_OP_COUNT 2
 static const OPType FILTER_RECURSE_BLACKLIST[] = {
 	OPType_APPLY,
@@ -112,6 +116,7 @@ struct ExecutionPlan;
 typedef void (*fpFree)(struct OpBase *);
 typedef OpResult(*fpInit)(struct OpBase *);
 typedef Record(*fpConsume)(struct OpBase *);
+typedef uint(*fpConsumeBatch)(struct OpBase *, Record *, uint);
 typedef OpResult(*fpReset)(struct OpBase *);
 typedef void (*fpToString)(const struct OpBase *, sds *);
 typedef struct OpBase *(*fpClone)(const struct ExecutionPlan *, const struct OpBase *);
@@ -130,6 +135,7 @@ struct OpBase {
 	fpClone clone;              // Operation clone.
 	fpConsume consume;          // Produce next record.
 	fpConsume profile;          // Profiled version of consume.
+	fpConsumeBatch consumeBatch; // Produce a batch of records, NULL if op is row based.
 	fpToString toString;        // Operation string representation.
 	const char *name;           // Operation name.
 	int childCount;             // Number of children.
@@ -171,6 +177,17 @@ Record OpBase_Consume
 	OpBase *op
 );
 
+// consume a batch of records from op
+// fills 'batch' with up to 'cap' records and returns the number of records
+// produced, a batch shorter than 'cap' indicates op is depleted
+// ops lacking a native batch implementation are consumed one record at a time
+uint OpBase_ConsumeBatch
+(
+	OpBase *op,    // op to consume from
+	Record *batch, // [output] records produced
+	uint cap       // batch capacity
+);
+
 // profile op
 Record OpBase_Profile
 (
@@ -262,6 +279,13 @@ void OpBase_UpdateConsume
 	fpConsume consume
 );
 
+// update operation batch consume function
+void OpBase_UpdateConsumeBatch
+(
+	OpBase *op,
+	fpConsumeBatch consumeBatch
+);
+
 // updates the plan of an operation
 void OpBase_BindOpToPlan
 (
@@ -6,6 +6,7 @@
 
 #include "RG.h"
 #include "op_sort.h"
+#include "op_exchange.h"
 #include "op_aggregate.h"
 #include "../../util/arr.h"
 #include "../../query_ctx.h"
@@ -17,28 +18,6 @@ static Record AggregateConsume(OpBase *opBase);
 static OpResult AggregateReset(OpBase *opBase);
 static OpBase *AggregateClone(const ExecutionPlan *plan, const OpBase *opBase);
 
-// fake hash function
-// hash of key is simply key
-static uint64_t _id_hash
-(
-	const void *key
-) {
-	return ((uint64_t)key);
-}
-
-// hashtable entry free callback
-static void freeCallback
-(
-	dict *d,
-	void *val
-) {
-	Group_Free((Group*)val);
-}
-
-// hashtable callbacks
-static dictType _dt = { _id_hash, NULL, NULL, NULL, NULL, freeCallback, NULL,
-	NULL, NULL, NULL};
-
 // migrate each expression projected by this operation to either
 // the array of keys or the array of aggregate functions as appropriate
 static void _migrate_expressions
@@ -63,129 +42,185 @@ static void _migrate_expressions
 	op->aggregate_count = array_len(op->aggregate_exps);
 }
 
-// clone all aggregate expression templates to associate with a new group
-static inline AR_ExpNode **_build_aggregate_exps
+// evaluate group keys
+static void _ComputeGroupKey
 (
-	OpAggregate *op
+	SIValue *keys,
+	AR_ExpNode **key_exps,
+	uint key_count,
+	Record r
 ) {
-	AR_ExpNode **agg_exps =
-		rm_malloc(op->aggregate_count * sizeof(AR_ExpNode *));
-
-	for(uint i = 0; i < op->aggregate_count; i++) {
-		agg_exps[i] = AR_EXP_Clone(op->aggregate_exps[i]);
+	for(uint i = 0; i < key_count; i++) {
+		AR_ExpNode *exp = key_exps[i];
+		// note if AR_EXP_Evaluate throws a runtime exception we will leak
+		keys[i] = AR_EXP_Evaluate(exp, r);
 	}
-
-	return agg_exps;
 }
 
-// build a new group key from the SIValue results of non-aggregate expressions
-static inline SIValue *_build_group_key
+// retrieves group under which given record belongs to
+// creates group if it doesn't exists
+static uint32_t _GetGroup
 (
-	SIValue *keys,
-	uint n
+	GroupTable *groups,
+	AR_ExpNode **key_exps,
+	uint key_count,
+	Record r
 ) {
-	// TODO: might be expensive incase we're generating lots of groups
-	SIValue *group_keys = rm_malloc(sizeof(SIValue) * n);
+	// construct group key
+	// evaluate non-aggregated fields
+	SIValue keys[key_count];
+	_ComputeGroupKey(keys, key_exps, key_count, r);
 
-	for(uint i = 0; i < n; i++) {
-		SIValue key = SI_TransferOwnership(keys + i);
-		SIValue_Persist(&key);
-		group_keys[i] = key;
+	// lookup group, keys are copied by the group table if group is created
+	bool added;
+	uint32_t g = GroupTable_GetGroup(groups, keys, &added);
+
+	// free computed keys
+	for(uint i = 0; i < key_count; i++) {
+		SIValue_Free(keys[i]);
 	}
 
-	return group_keys;
+	return g;
 }
 
-static Group *_CreateGroup
+static void _aggregateRecord
 (
 	OpAggregate *op,
-	SIValue *keys
+	Record r
 ) {
-	// create a new group, clone group keys
-	SIValue *group_keys = _build_group_key(keys, op->key_count);
+	// get group
+	uint32_t g = _GetGroup(op->groups, op->key_exps, op->key_count, r);
 
-	// get a fresh copy of aggregation functions
-	AR_ExpNode **agg_exps = _build_aggregate_exps(op);
+	// aggregate group exps
+	GroupTable_Aggregate(op->groups, g, r);
 
-	return Group_New(group_keys, op->key_count, agg_exps, op->aggregate_count);
+	OpBase_DeleteRecord(r);
 }
 
-static XXH64_hash_t _ComputeGroupKey
+//------------------------------------------------------------------------------
+// partial aggregation
+//------------------------------------------------------------------------------
+
+// partial aggregation performed by a thread participating in a parallel scan
+typedef struct {
+	AR_ExpNode **key_exps;        // key expressions
+	AR_ExpNode **aggregate_exps;  // aggregate expressions
+	GroupTable *groups;           // partial groups
+	bool owned;                   // expressions and groups are owned
+} AggregatePartial;
+
+// create a worker partial aggregation
+// workers evaluate private copies of the operation's expressions
+static void *_PartialNew
 (
-	SIValue *keys,
-	OpAggregate *op,
-	Record r
+	void *pdata
 ) {
-	// initialize the hash state
-	XXH64_state_t state;
-	XXH_errorcode res = XXH64_reset(&state, 0);
-	ASSERT(res != XXH_ERROR);
+	OpAggregate *op = (OpAggregate *)pdata;
+	AggregatePartial *p = rm_malloc(sizeof(AggregatePartial));
+
+	p->owned          = true;
+	p->key_exps       = array_new(AR_ExpNode *, op->key_count);
+	p->aggregate_exps = array_new(AR_ExpNode *, op->aggregate_count);
 
 	for(uint i = 0; i < op->key_count; i++) {
-		AR_ExpNode *exp = op->key_exps[i];
-		// note if AR_EXP_Evaluate throws a runtime exception we will leak
-		keys[i] = AR_EXP_Evaluate(exp, r);
-		// update the hash state with the current value.
-		SIValue_HashUpdate(keys[i], &state);
+		array_append(p->key_exps, AR_EXP_Clone(op->key_exps[i]));
+	}
+	for(uint i = 0; i < op->aggregate_count; i++) {
+		array_append(p->aggregate_exps, AR_EXP_Clone(op->aggregate_exps[i]));
 	}
 
-	// finalize the hash
-	return XXH64_digest(&state);
+	p->groups = GroupTable_New(op->key_count, p->aggregate_exps,
+			op->aggregate_count);
+
+	return p;
 }
 
-// retrieves group under which given record belongs to
-// creates group if it doesn't exists
-static Group *_GetGroup
+// aggregate a record produced by the parallel scan
+// the record is borrowed from the scan
+static void _PartialConsume
 (
-	OpAggregate *op,
+	void *state,
 	Record r
 ) {
-	// construct group key
-	// evaluate non-aggregated fields
+	AggregatePartial *p = (AggregatePartial *)state;
 
-	SIValue keys[op->key_count];
-	XXH64_hash_t hash = _ComputeGroupKey(keys, op, r);
+	uint32_t g = _GetGroup(p->groups, p->key_exps, array_len(p->key_exps), r);
+	GroupTable_Aggregate(p->groups, g, r);
+}
 
-	// lookup group by hashed key
-	Group *g;
-	dictEntry *existing;
-	dictEntry *entry = HashTableAddRaw(op->groups, (void *)hash, &existing);
-	if(entry == NULL) {
-		// group exists
-		ASSERT(existing != NULL);
+// merge worker's partial aggregation into the operation's groups
+static void _PartialMerge
+(
+	void *pdata,
+	void *state
+) {
+	OpAggregate *op = (OpAggregate *)pdata;
+	AggregatePartial *p = (AggregatePartial *)state;
 
-		// free computed keys
-		for(uint i = 0; i < op->key_count; i++) {
-			SIValue_Free(keys[i]);
-		}
+	GroupTable_Merge(op->groups, p->groups);
+}
 
-		g = HashTableGetVal(existing);
-	} else {
-		// entry missing
-		// group does not exists, create it
-		g = _CreateGroup(op, keys);
-		HashTableSetVal(op->groups, entry, g);
-	}
+static void _PartialFree
+(
+	void *state
+) {
+	AggregatePartial *p = (AggregatePartial *)state;
+	ASSERT(p->owned);
 
-	return g;
+	// group table references the aggregate expressions, free it first
+	GroupTable_Free(&p->groups);
+
+	uint n = array_len(p->key_exps);
+	for(uint i = 0; i < n; i++) AR_EXP_Free(p->key_exps[i]);
+	array_free(p->key_exps);
+
+	n = array_len(p->aggregate_exps);
+	for(uint i = 0; i < n; i++) AR_EXP_Free(p->aggregate_exps[i]);
+	array_free(p->aggregate_exps);
+
+	rm_free(p);
 }
 
-static void _aggregateRecord
+// aggregate the output of a parallel scan
+// each participating thread aggregates into its own partial group table
+// partials are merged into the operation's groups once the scan completes
+// returns false if the scan isn't performed in parallel
+static bool _aggregateParallel
 (
 	OpAggregate *op,
-	Record r
+	OpBase *exchange
 ) {
-	// get group
-	Group *g = _GetGroup(op, r);
-	ASSERT(g != NULL);
+	if(!GroupTable_Combinable(op->groups)) return false;
+
+	// the operation's thread aggregates directly into the operation's groups
+	AggregatePartial own = {
+		.key_exps       = op->key_exps,
+		.aggregate_exps = op->aggregate_exps,
+		.groups         = op->groups,
+		.owned          = false
+	};
+
+	ExchangeSink sink = {
+		.new_state  = _PartialNew,
+		.consume    = _PartialConsume,
+		.merge      = _PartialMerge,
+		.free_state = _PartialFree,
+		.pdata      = op,
+		.state      = &own
+	};
+
+	return Exchange_Drain((OpExchange *)exchange, &sink);
+}
 
-	// aggregate group exps
-	for(uint i = 0; i < op->aggregate_count; i++) {
-		AR_ExpNode *exp = g->agg[i];
-		AR_EXP_Aggregate(exp, r);
-	}
+// returns true if the aggregation can be split into partial aggregations
+bool AggregateParallelizable
+(
+	const OpBase *opBase
+) {
+	ASSERT(OpBase_Type(opBase) == OPType_AGGREGATE);
 
-	OpBase_DeleteRecord(r);
+	const OpAggregate *op = (const OpAggregate *)opBase;
+	return GroupTable_Combinable(op->groups);
 }
 
 // returns a record populated with group data
@@ -193,14 +228,13 @@ static Record _handoff
 (
 	OpAggregate *op
 ) {
-	dictEntry *entry = HashTableNext(op->group_iter);
-	if(entry == NULL) {
+	if(op->group_idx == GroupTable_Count(op->groups)) {
 		return NULL;
 	}
 
-	Record   r    = OpBase_CreateRecord((OpBase*)op);
-	Group   *g    = (Group*)HashTableGetVal(entry);
-	SIValue *keys = g->keys;
+	uint32_t       g    = op->group_idx++;
+	Record         r    = OpBase_CreateRecord((OpBase*)op);
+	const SIValue *keys = GroupTable_Keys(op->groups, g);
 
 	// add all projected keys to the Record
 	for(uint i = 0; i < op->key_count; i++) {
@@ -213,9 +247,7 @@ static Record _handoff
 	// compute the final value of all aggregate expressions and add to Record
 	for(uint i = 0; i < op->aggregate_count; i++) {
 		int rec_idx = op->record_offsets[i + op->key_count];
-		AR_ExpNode *exp = g->agg[i];
-
-		SIValue agg = AR_EXP_FinalizeAggregations(exp, r);
+		SIValue agg = GroupTable_Finalize(op->groups, g, i, r);
 		Record_AddScalar(r, rec_idx, agg);
 	}
 
@@ -229,22 +261,22 @@ OpBase *NewAggregateOp
 ) {
 	OpAggregate *op = rm_malloc(sizeof(OpAggregate));
 
-	op->groups               = HashTableCreate(&_dt);
-	op->group_iter           = NULL;
+	op->groups    = NULL;
+	op->group_idx = 0;
+	op->depleted  = false;
 
 	OpBase_Init((OpBase *)op, OPType_AGGREGATE, "Aggregate", NULL,
 			AggregateConsume, AggregateReset, NULL, AggregateClone,
 			AggregateFree, false, plan);
 
-	// expand hashtable to 2048 slots
-	int res = HashTableExpand(op->groups, 2048);
-	ASSERT(res == DICT_OK);
-
 	// migrate each expression to the keys array or
 	// the aggregations array as appropriate
 	_migrate_expressions(op, exps);
 	array_free(exps);
 
+	op->groups = GroupTable_New(op->key_count, op->aggregate_exps,
+			op->aggregate_count);
+
 	// the projected record will associate values with their resolved name
 	// to ensure that space is allocated for each entry
 	op->record_offsets = array_new(uint, op->aggregate_count + op->key_count);
@@ -269,7 +301,7 @@ static Record AggregateConsume
 	OpBase *opBase
 ) {
 	OpAggregate *op = (OpAggregate *)opBase;
-	if(op->group_iter != NULL) {
+	if(op->depleted) {
 		return _handoff(op);
 	}
 
@@ -281,9 +313,19 @@ static Record AggregateConsume
 		_aggregateRecord(op, r);
 	} else {
 		OpBase *child = op->op.children[0];
+		bool parallel = (OpBase_Type(child) == OPType_EXCHANGE &&
+				_aggregateParallel(op, child));
+
 		// eager consumption!
-		while((r = OpBase_Consume(child))) {
-			_aggregateRecord(op, r);
+		// pull records from child in batches
+		uint n;
+		Record batch[OP_BATCH_SIZE];
+		while(!parallel) {
+			n = OpBase_ConsumeBatch(child, batch, OP_BATCH_SIZE);
+			for(uint i = 0; i < n; i++) {
+				_aggregateRecord(op, batch[i]);
+			}
+			if(n < OP_BATCH_SIZE) break;
 		}
 	}
 
@@ -291,7 +333,7 @@ static Record AggregateConsume
 	// does aggregation contains keys?
 	// e.g.
 	// MATCH (n:N) WHERE n.noneExisting = 2 RETURN count(n)
-	if(HashTableElemCount(op->groups) == 0 && op->key_count == 0) {
+	if(GroupTable_Count(op->groups) == 0 && op->key_count == 0) {
 
 		// no data was processed and aggregation doesn't have a key
 		// in this case we want to return aggregation default value
@@ -309,14 +351,15 @@ static Record AggregateConsume
 		r = OpBase_CreateRecord(child);
 
 		// get group
-		_GetGroup(op, r);
+		_GetGroup(op->groups, op->key_exps, op->key_count, r);
 
 		// free record
 		OpBase_DeleteRecord(r);
 	}
 
-	// create group iterator
-	op->group_iter = HashTableGetIterator(op->groups);
+	// start emitting groups
+	op->depleted  = true;
+	op->group_idx = 0;
 
 	return _handoff(op);
 }
@@ -327,20 +370,10 @@ static OpResult AggregateReset
 ) {
 	OpAggregate *op = (OpAggregate *)opBase;
 
-	if(op->group_iter != NULL) {
-		HashTableReleaseIterator(op->group_iter);
-		op->group_iter = NULL;
-	}
-
-	// re-create hashtable
-	unsigned long elem_count = HashTableElemCount(op->groups);
-	HashTableRelease(op->groups);
-
-	op->groups = HashTableCreate(&_dt);
-
-	// expand hashtable to previous element count
-	int res = HashTableExpand(op->groups, elem_count);
-	ASSERT(res == DICT_OK);
+	// drop all groups, table capacity is retained
+	GroupTable_Clear(op->groups);
+	op->group_idx = 0;
+	op->depleted  = false;
 
 	return OP_OK;
 }
@@ -404,9 +437,9 @@ static void AggregateFree
 		return;
 	}
 
-	if(op->group_iter) {
-		HashTableReleaseIterator(op->group_iter);
-		op->group_iter = NULL;
+	// group table references the aggregate expressions, free it first
+	if(op->groups) {
+		GroupTable_Free(&op->groups);
 	}
 
 	if(op->key_exps) {
@@ -425,11 +458,6 @@ static void AggregateFree
 		op->aggregate_exps = NULL;
 	}
 
-	if(op->groups) {
-		HashTableRelease(op->groups);
-		op->groups = NULL;
-	}
-
 	if(op->record_offsets) {
 		array_free(op->record_offsets);
 		op->record_offsets = NULL;
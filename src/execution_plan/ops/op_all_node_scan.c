@@ -12,6 +12,7 @@
 static OpResult AllNodeScanInit(OpBase *opBase);
 static Record AllNodeScanConsume(OpBase *opBase);
 static Record AllNodeScanConsumeFromChild(OpBase *opBase);
+static uint AllNodeScanConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpResult AllNodeScanReset(OpBase *opBase);
 static OpBase *AllNodeScanClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void AllNodeScanFree(OpBase *opBase);
@@ -36,8 +37,12 @@ OpBase *NewAllNodeScanOp(const ExecutionPlan *plan, const char *alias) {
 
 static OpResult AllNodeScanInit(OpBase *opBase) {
 	AllNodeScan *op = (AllNodeScan *)opBase;
-	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
-	else op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+	if(opBase->childCount > 0) {
+		OpBase_UpdateConsume(opBase, AllNodeScanConsumeFromChild);
+	} else {
+		op->iter = Graph_ScanNodes(QueryCtx_GetGraph());
+		OpBase_UpdateConsumeBatch(opBase, AllNodeScanConsumeBatch);
+	}
 	return OP_OK;
 }
 
@@ -89,9 +94,33 @@ static Record AllNodeScanConsume(OpBase *opBase) {
 	return r;
 }
 
+// produce a batch of records, one for each scanned node
+static uint AllNodeScanConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	AllNodeScan *op = (AllNodeScan *)opBase;
+
+	uint n = 0;
+	while(n < cap) {
+		Node node = GE_NEW_NODE();
+		node.attributes = DataBlockIterator_Next(op->iter, &node.id);
+		if(node.attributes == NULL) break;
+
+		Record r = OpBase_CreateRecord(opBase);
+		Record_AddNode(r, op->nodeRecIdx, node);
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 static OpResult AllNodeScanReset(OpBase *op) {
 	AllNodeScan *allNodeScan = (AllNodeScan *)op;
-	if(allNodeScan->iter) DataBlockIterator_Reset(allNodeScan->iter);
+	// the graph might have grown since the iterator was created
+	// recreate it to cover the current node storage
+	if(allNodeScan->iter) {
+		DataBlockIterator_Free(allNodeScan->iter);
+		allNodeScan->iter = NULL;
+	}
+	if(op->childCount == 0) allNodeScan->iter = Graph_ScanNodes(QueryCtx_GetGraph());
 	return OP_OK;
 }
 
@@ -133,9 +133,10 @@ OpBase *NewCondVarLenTraverseOp
 	return (OpBase *)op;
 }
 
-static OpResult CondVarLenTraverseInit(OpBase *opBase) {
-	CondVarLenTraverse *op = (CondVarLenTraverse *)opBase;
-
+// select consume function
+// path-less traversal depends on the traversed relationship not containing
+// multi-edge entries, as such the selection is repeated by every execution
+static void _select_consume(CondVarLenTraverse *op) {
 	// check if variable length traversal doesn't require path construction
 	// in which case we only care for reachable destination nodes
 	// which is alot cheaper to compute
@@ -156,16 +157,21 @@ static OpResult CondVarLenTraverseInit(OpBase *opBase) {
 			AlgebraicExpression_Edge(op->ae));
 	uint reltype_count = QGEdge_RelationCount(e);
 
+	int   rel_id      =  GRAPH_NO_RELATION;
 	bool  multi_edge  =  true;
 	bool  transpose   =  op->traverseDir != GRAPH_EDGE_DIR_OUTGOING;
 	if(reltype_count == 1) {
-		int rel_id = QGEdge_RelationID(e, 0);
+		rel_id = QGEdge_RelationID(e, 0);
 		if(rel_id != GRAPH_NO_RELATION && rel_id != GRAPH_UNKNOWN_RELATION) {
 			multi_edge = Graph_RelationshipContainsMultiEdge(op->g, rel_id,
 					transpose);
 		}
 	}
 
+	op->M             = NULL;
+	op->collect_paths = true;
+	OpBase_UpdateConsume((OpBase *)op, CondVarLenTraverseConsume);
+
 	if(op->ft          == NULL                && // no filter on path
 	   op->edgesIdx    == -1                  && // edge isn't required
 	   op->expandInto  == false               && // destination unknown
@@ -173,12 +179,15 @@ static OpResult CondVarLenTraverseInit(OpBase *opBase) {
 	   multi_edge      == false               && // no multi edge entries
 	   op->traverseDir != GRAPH_EDGE_DIR_BOTH    // directed
 	  ) {
-		AlgebraicExpression_Optimize(&op->ae);
-		ASSERT(op->ae->type == AL_OPERAND);
+		// traversed matrix, synchronized with pending changes
+		op->M = Graph_GetRelationMatrix(op->g, rel_id, transpose);
 		op->collect_paths = false;
-		OpBase_UpdateConsume(opBase, CondVarLenTraverseOptimizedConsume);
+		OpBase_UpdateConsume((OpBase *)op, CondVarLenTraverseOptimizedConsume);
 	}
+}
 
+static OpResult CondVarLenTraverseInit(OpBase *opBase) {
+	_select_consume((CondVarLenTraverse *)opBase);
 	return OP_OK;
 }
 
@@ -215,8 +224,6 @@ static Record CondVarLenTraverseOptimizedConsume(OpBase *opBase) {
 			// consider: MATCH (S)-[:L*]->(M) RETURN M
 			// where label L does not exists */
 			if(op->edgeRelationCount == 0 && op->minHops > 0) return NULL;
-
-			op->M = op->ae->operand.matrix;
 		}
 
 		if(op->allNeighborsCtx == NULL) {
@@ -323,6 +330,9 @@ static OpResult CondVarLenTraverseReset(OpBase *ctx) {
 		}
 	}
 
+	// multi-edge entries might be introduced before the next execution
+	_select_consume(op);
+
 	return OP_OK;
 }
 
@@ -9,8 +9,10 @@
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
 
-// default number of records to accumulate before traversing
-#define BATCH_SIZE 16
+// maximum expected number of neighbors per source node for which
+// the traversal iterates the source row directly rather than multiplying
+// a batch of sources by the traversed matrix
+#define DIRECT_TRAVERSE_MAX_FANOUT 64
 
 /* Forward declarations. */
 static OpResult CondTraverseInit(OpBase *opBase);
@@ -39,6 +41,126 @@ static void _populate_filter_matrix(OpCondTraverse *op) {
 	}
 }
 
+// adapt batch size to the previous batch
+// resizing the records array and both filter and result matrices
+static void _adapt_batch_size(OpCondTraverse *op, bool full) {
+	GrB_Index nvals;
+	GrB_Info info = RG_Matrix_nvals(&nvals, op->M);
+	ASSERT(info == GrB_SUCCESS);
+
+	uint cap = TraverseBatch_NextSize(op->record_cap, op->batch_max, full,
+			nvals);
+	if(cap == op->record_cap) return;
+
+	op->record_cap = cap;
+	op->records = rm_realloc(op->records, cap * sizeof(Record));
+
+	// iterator is depleted, detach it before M is modified
+	info = RG_MatrixTupleIter_detach(&op->iter);
+	ASSERT(info == GrB_SUCCESS);
+
+	// only the number of rows changes
+	GrB_Index ncols;
+	info = RG_Matrix_ncols(&ncols, op->F);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_resize(op->F, cap, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_resize(op->M, cap, ncols);
+	ASSERT(info == GrB_SUCCESS);
+}
+
+// determine if the traversal can skip matrix multiplication
+// which is the case when the expression is a single, possibly transposed
+// relationship operand, e.g. (a)-[:R]->(b) or (a)<-[:R]-(b)
+// and the expected fan-out is small enough, in which case each source row
+// of the traversed matrix is scanned directly
+// only the mode is decided here, the matrix is fetched by every execution
+// the mode is selected again on reset as the fan-out might have changed
+static void _select_traversal_mode(OpCondTraverse *op) {
+	bool transposed = false;
+	AlgebraicExpression *operand = op->ae;
+
+	op->direct = false;
+
+	if(operand->type == AL_OPERATION) {
+		if(operand->operation.op != AL_EXP_TRANSPOSE) return;
+		operand = operand->operation.children[0];
+		if(operand->type != AL_OPERAND) return;
+		transposed = true;
+	}
+
+	// label operands are not traversed directly
+	if(operand->operand.diagonal) return;
+
+	Graph *g = op->graph;
+	uint64_t edge_count;
+	RelationID r = GRAPH_NO_RELATION;
+	const char *relation = AlgebraicExpression_Label(operand);
+
+	if(relation == NULL) {
+		// matrix isn't associated with a relationship, use the adjacency matrix
+		edge_count = Graph_EdgeCount(g);
+	} else {
+		// it is OK if the relationship doesn't exists, in this case
+		// we won't use the direct traversal
+		GraphContext *gc = QueryCtx_GetGraphCtx();
+		Schema *s = GraphContext_GetSchema(gc, relation, SCHEMA_EDGE);
+		if(s == NULL) return;
+
+		r = Schema_GetID(s);
+		edge_count = Graph_RelationEdgeCount(g, r);
+	}
+
+	// multiplication parallelizes better on high fan-out
+	size_t node_count = Graph_NodeCount(g);
+	if(node_count > 0 &&
+	   edge_count / node_count > DIRECT_TRAVERSE_MAX_FANOUT) {
+		return;
+	}
+
+	op->direct            = true;
+	op->direct_rel        = r;
+	op->direct_transposed = transposed;
+}
+
+// set iterator over the row of the current source node
+static void _traverse_direct(OpCondTraverse *op) {
+	ASSERT(op->record_count == 1);
+
+	// first traversal since the op was initialized or reset
+	// fetch the traversed matrix, synchronizing it with pending changes
+	if(op->M == NULL) {
+		op->M = Graph_GetRelationMatrix(op->graph, op->direct_rel,
+				op->direct_transposed);
+	}
+
+	if(!RG_MatrixTupleIter_is_attached(&op->iter, op->M)) {
+		GrB_Info info = RG_MatrixTupleIter_attach(&op->iter, op->M);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
+	Node *n = Record_GetNode(op->records[0], op->srcNodeIdx);
+	RG_MatrixTupleIter_iterate_row(&op->iter, ENTITY_GET_ID(n));
+}
+
+// free the evaluated expression along with its filter and result matrices
+static void _free_eval(OpCondTraverse *op) {
+	if(op->F != NULL) {
+		RG_Matrix_free(&op->F);
+		op->F = NULL;
+	}
+
+	if(op->M != NULL) {
+		RG_Matrix_free(&op->M);
+		op->M = NULL;
+	}
+
+	if(op->eval != NULL) {
+		AlgebraicExpression_Free(op->eval);
+		op->eval = NULL;
+	}
+}
+
 // evaluate algebraic expression:
 // prepends filter matrix as the left most operand
 // perform multiplications
@@ -53,18 +175,20 @@ void _traverse(OpCondTraverse *op) {
 		RG_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
 		RG_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
 
-		// prepend filter matrix to algebraic expression as the leftmost operand
-		AlgebraicExpression_MultiplyToTheLeft(&op->ae, op->F);
+		// prepend filter matrix to a copy of the algebraic expression
+		// as the leftmost operand
+		op->eval = AlgebraicExpression_Clone(op->ae);
+		AlgebraicExpression_MultiplyToTheLeft(&op->eval, op->F);
 
 		// optimize the expression tree
-		AlgebraicExpression_Optimize(&op->ae);
+		AlgebraicExpression_Optimize(&op->eval);
 	}
 
 	// populate filter matrix
 	_populate_filter_matrix(op);
 
 	// evaluate expression
-	AlgebraicExpression_Eval(op->ae, op->M);
+	AlgebraicExpression_Eval(op->eval, op->M);
 
 	RG_MatrixTupleIter_attach(&op->iter, op->M);
 }
@@ -79,7 +203,7 @@ OpBase *NewCondTraverseOp
 
 	op->ae         = ae;
 	op->graph      = g;
-	op->record_cap = BATCH_SIZE;
+	op->record_cap = TRAVERSE_BATCH_MIN;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_CONDITIONAL_TRAVERSE,
@@ -111,9 +235,16 @@ static OpResult CondTraverseInit(OpBase *opBase) {
 	OpCondTraverse *op = (OpCondTraverse *)opBase;
 	// Create 'records' with this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
-	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
+	// batches never grow beyond the limit
+	op->batch_max = op->record_cap;
+	if(op->batch_max > TRAVERSE_BATCH_MAX) op->batch_max = TRAVERSE_BATCH_MAX;
+	if(op->record_cap > TRAVERSE_BATCH_MIN) op->record_cap = TRAVERSE_BATCH_MIN;
+
+	// see if we can avoid matrix multiplication altogether
+	// in which case records are processed one at a time
+	_select_traversal_mode(op);
+	if(op->direct) op->record_cap = 1;
+
 	op->records = rm_calloc(op->record_cap, sizeof(Record));
 
 	return OP_OK;
@@ -150,34 +281,46 @@ static Record CondTraverseConsume(OpBase *opBase) {
 			OpBase_DeleteRecord(op->records[i]);
 		}
 
+		// previous batch fully consumed, adapt batch size
+		if(op->F != NULL) _adapt_batch_size(op, op->batch_full);
+
 		// Ask child operations for data.
-		for(op->record_count = 0; op->record_count < op->record_cap; op->record_count++) {
-			Record childRecord = OpBase_Consume(child);
-			// If the Record is NULL, the child has been depleted.
-			if(childRecord == NULL) {
-				break;
-			}
-			if(!Record_GetNode(childRecord, op->srcNodeIdx)) {
-				/* The child Record may not contain the source node in scenarios like
-				 * a failed OPTIONAL MATCH. In this case, delete the Record and try again. */
-				OpBase_DeleteRecord(childRecord);
-				op->record_count--;
-				continue;
+		op->record_count = 0;
+		op->batch_full   = false;
+		while(op->record_count < op->record_cap) {
+			uint requested = op->record_cap - op->record_count;
+			Record *batch = op->records + op->record_count;
+			uint n = OpBase_ConsumeBatch(child, batch, requested);
+
+			for(uint i = 0; i < n; i++) {
+				Record childRecord = batch[i];
+				if(!Record_GetNode(childRecord, op->srcNodeIdx)) {
+					/* The child Record may not contain the source node in scenarios like
+					 * a failed OPTIONAL MATCH. In this case, delete the Record. */
+					OpBase_DeleteRecord(childRecord);
+					continue;
+				}
+
+				// Store received record.
+				Record_PersistScalars(childRecord);
+				op->records[op->record_count++] = childRecord;
 			}
 
-			// Store received record.
-			Record_PersistScalars(childRecord);
-			op->records[op->record_count] = childRecord;
+			// If the batch is short, the child has been depleted.
+			if(n < requested) break;
 		}
+		op->batch_full = (op->record_count == op->record_cap);
 
 		// No data.
 		if(op->record_count == 0) return NULL;
 
-		_traverse(op);
+		if(op->direct) _traverse_direct(op);
+		else _traverse(op);
 	}
 
-	/* Get node from current column. */
-	op->r = op->records[src_id];
+	/* Get node from current column.
+	 * When traversing directly, rows are node IDs of a single record. */
+	op->r = op->records[op->direct ? 0 : src_id];
 	// Populate the destination node and add it to the Record.
 	Node destNode = GE_NEW_NODE();
 	Graph_GetNode(op->graph, dest_id, &destNode);
@@ -208,7 +351,35 @@ static OpResult CondTraverseReset(OpBase *ctx) {
 	GrB_Info info = RG_MatrixTupleIter_detach(&op->iter);
 	ASSERT(info == GrB_SUCCESS);
 
-	if(op->F != NULL) RG_Matrix_clear(op->F);
+	// the graph might be modified before the next execution
+	// select the traversal mode again
+	bool direct = op->direct;
+	_select_traversal_mode(op);
+
+	if(direct) {
+		// re-fetch the traversed matrix once traversing
+		op->M = NULL;
+	} else if(op->F != NULL) {
+		// rebuild the evaluated expression once the graph outgrows
+		// the dimensions of its operands
+		GrB_Index ncols;
+		info = RG_Matrix_ncols(&ncols, op->F);
+		ASSERT(info == GrB_SUCCESS);
+		if(op->direct || ncols != Graph_RequiredMatrixDim(op->graph)) {
+			_free_eval(op);
+		} else {
+			RG_Matrix_clear(op->F);
+		}
+	}
+
+	// mode changed, direct traversal processes records one at a time
+	if(op->direct != direct) {
+		op->record_cap = op->batch_max;
+		if(op->record_cap > TRAVERSE_BATCH_MIN) op->record_cap = TRAVERSE_BATCH_MIN;
+		if(op->direct) op->record_cap = 1;
+		op->records = rm_realloc(op->records, op->record_cap * sizeof(Record));
+	}
+
 	return OP_OK;
 }
 
@@ -225,15 +396,9 @@ static void CondTraverseFree(OpBase *ctx) {
 	GrB_Info info = RG_MatrixTupleIter_detach(&op->iter);
 	ASSERT(info == GrB_SUCCESS);
 
-	if(op->F != NULL) {
-		RG_Matrix_free(&op->F);
-		op->F = NULL;
-	}
-
-	if(op->M != NULL) {
-		RG_Matrix_free(&op->M);
-		op->M = NULL;
-	}
+	// M is owned by the graph when traversing directly
+	if(op->direct) op->M = NULL;
+	else _free_eval(op);
 
 	if(op->ae) {
 		AlgebraicExpression_Free(op->ae);
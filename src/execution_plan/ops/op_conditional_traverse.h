@@ -18,6 +18,7 @@ typedef struct {
 	OpBase op;
 	Graph *graph;
 	AlgebraicExpression *ae;
+	AlgebraicExpression *eval;  // ae prefixed by F, evaluated per batch.
 	RG_Matrix F;                // Filter matrix.
 	RG_Matrix M;                // Algebraic expression result.
 	EdgeTraverseCtx *edge_ctx;  // Edge collection data if the edge needs to be set.
@@ -26,6 +27,11 @@ typedef struct {
 	int destNodeIdx;            // Destination node index into record.
 	uint record_count;          // Number of held records.
 	uint record_cap;            // Max number of records to process.
+	uint batch_max;             // Max value record_cap can grow to.
+	bool batch_full;            // Last batch reached record_cap.
+	bool direct;                // Scan source rows of M, no multiplication.
+	RelationID direct_rel;      // Relationship traversed directly.
+	bool direct_transposed;     // Traverse relationship in reverse.
 	Record *records;            // Array of records.
 	Record r;                   // Currently selected record.
 } OpCondTraverse;
@@ -7,7 +7,6 @@
 #include "op_distinct.h"
 #include "op_project.h"
 #include "op_aggregate.h"
-#include "xxhash.h"
 #include "../../util/arr.h"
 #include "../execution_plan_build/execution_plan_modify.h"
 
@@ -17,28 +16,6 @@ static Record DistinctConsume(OpBase *opBase);
 static OpResult DistinctReset(OpBase *opBase);
 static OpBase *DistinctClone(const ExecutionPlan *plan, const OpBase *opBase);
 
-// compute hash on distinct values
-// values that are required to be distinct are located at 'offset'
-// positions within the record
-static unsigned long long _compute_hash(OpDistinct *op, Record r) {
-	// initialize the hash state
-	XXH64_state_t state;
-	XXH_errorcode res = XXH64_reset(&state, 0);
-	ASSERT(res != XXH_ERROR);
-
-	for(uint i = 0; i < op->offset_count; i++) {
-		// retrieve the entry at 'idx' as an SIValue
-		uint idx = op->offsets[i];
-		SIValue v = Record_Get(r, idx);
-		// update the hash state with the current value.
-		SIValue_HashUpdate(v, &state);
-	}
-
-	// finalize the hash
-	unsigned long long const hash = XXH64_digest(&state);
-	return hash;
-}
-
 // compute record offset to distinct values
 static void _updateOffsets(OpDistinct *op, Record r) {
 	ASSERT(op->aliases != NULL);
@@ -57,7 +34,7 @@ OpBase *NewDistinctOp(const ExecutionPlan *plan, const char **aliases, uint alia
 
 	OpDistinct *op = rm_malloc(sizeof(OpDistinct));
 
-	op->found           =  raxNew();
+	op->found           =  TupleTable_New(alias_count);
 	op->mapping         =  NULL;
 	op->aliases         =  rm_malloc(alias_count * sizeof(const char *));
 	op->offset_count    =  alias_count;
@@ -94,8 +71,15 @@ static Record DistinctConsume(OpBase *opBase) {
 			op->mapping = record_mapping;
 		}
 
-		unsigned long long const hash = _compute_hash(op, r);
-		int is_new = raxInsert(op->found, (unsigned char *) &hash, sizeof(hash), NULL, NULL);
+		// collect distinct values
+		SIValue values[op->offset_count];
+		for(uint i = 0; i < op->offset_count; i++) {
+			values[i] = Record_Get(r, op->offsets[i]);
+		}
+
+		bool is_new;
+		XXH64_hash_t hash = TupleTable_Hash(values, op->offset_count);
+		TupleTable_FindOrAdd(op->found, values, hash, &is_new);
 		if(is_new) return r;
 		OpBase_DeleteRecord(r);
 	}
@@ -113,20 +97,14 @@ static OpResult DistinctReset
 ) {
 	OpDistinct *op = (OpDistinct *)opBase;
 
-	if(op->found) {
-		raxFree(op->found);
-		op->found = raxNew();
-	}
+	if(op->found) TupleTable_Clear(op->found);
 
 	return OP_OK;
 }
 
 static void DistinctFree(OpBase *ctx) {
 	OpDistinct *op = (OpDistinct *)ctx;
-	if(op->found) {
-		raxFree(op->found);
-		op->found = NULL;
-	}
+	if(op->found) TupleTable_Free(&op->found);
 
 	if(op->aliases) {
 		rm_free(op->aliases);
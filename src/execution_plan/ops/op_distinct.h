@@ -9,10 +9,11 @@
 #include "op.h"
 #include "rax.h"
 #include "../execution_plan.h"
+#include "../../util/tuple_table.h"
 
 typedef struct {
 	OpBase op;
-	rax *found;
+	TupleTable *found;     // distinct values encountered
 	rax *mapping;          // record mapping
 	uint *offsets;         // offsets to expression values
 	const char **aliases;  // expression aliases to distinct by
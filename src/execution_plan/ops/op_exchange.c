@@ -0,0 +1,806 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "op_filter.h"
+#include "op_exchange.h"
+#include "op_all_node_scan.h"
+#include "op_node_by_label_scan.h"
+#include "../../query_ctx.h"
+#include "../../errors/errors.h"
+#include "../../util/rmalloc.h"
+#include "../../util/thpool/pools.h"
+#include "../../configuration/config.h"
+
+#include <pthread.h>
+
+// number of node IDs covered by a single morsel
+#define MORSEL_SIZE 16384
+
+// max number of morsel outputs queued per worker
+// workers block once the queue is full
+#define MAX_PENDING_PER_WORKER 4
+
+// forward declarations
+static OpResult ExchangeInit(OpBase *opBase);
+static Record ExchangeConsume(OpBase *opBase);
+static Record ExchangeConsumeParallel(OpBase *opBase);
+static Record ExchangeConsumePassThrough(OpBase *opBase);
+static uint ExchangeConsumeBatchPassThrough(OpBase *opBase, Record *batch,
+		uint cap);
+static OpResult ExchangeReset(OpBase *opBase);
+static OpBase *ExchangeClone(const ExecutionPlan *plan, const OpBase *opBase);
+static void ExchangeFree(OpBase *opBase);
+
+// state shared between the exchange and its workers
+struct ExchangeCtx {
+	pthread_mutex_t lock;     // guards shared state
+	pthread_cond_t cond;      // signaled whenever shared state changes
+	uint refcount;            // number of references to context
+	uint active;              // number of running workers
+	bool cancelled;           // workers should stop
+	char *error;              // error raised by a worker
+	NodeID next;              // first ID of the next morsel
+	NodeID end;               // scan stops at this ID
+	NodeID **output;          // queued morsel outputs
+	uint max_pending;         // max number of queued outputs
+	Graph *g;                 // graph scanned
+	RG_Matrix L;              // label matrix, NULL when scanning all nodes
+	int nodeRecIdx;           // scanned node position within record
+	rax *mapping;             // record mapping
+	QueryCtx *query_ctx;      // query context, shared with workers
+	FT_FilterNode **filters;  // filters applied by the exchange's thread
+	Record r;                 // record filters are evaluated against
+	bool drain;               // records are fed into sink
+	ExchangeSink sink;        // records consumer
+	void **states;            // sink states handed over by workers
+	int64_t n_alloced;        // memory allocated by workers, not yet charged
+};
+
+// worker state
+typedef struct {
+	ExchangeCtx *ctx;         // shared context
+	FT_FilterNode **filters;  // private copy of the filters
+	Record r;                 // record filters are evaluated against
+	NodeID *ids;              // morsel output
+	void *state;              // sink state
+} ExchangeWorker;
+
+bool Exchange_ParallelizableScan
+(
+	const OpBase *op
+) {
+	ASSERT(op != NULL);
+
+	if(op->childCount != 0) return false;
+
+	OPType t = OpBase_Type(op);
+	return (t == OPType_ALL_NODE_SCAN     ||
+			t == OPType_NODE_BY_LABEL_SCAN ||
+			t == OPType_NODE_BY_LABEL_AND_ID_SCAN);
+}
+
+OpBase *NewExchangeOp
+(
+	const ExecutionPlan *plan
+) {
+	OpExchange *op = rm_calloc(1, sizeof(OpExchange));
+
+	OpBase_Init((OpBase *)op, OPType_EXCHANGE, "Exchange", ExchangeInit,
+			ExchangeConsume, ExchangeReset, NULL, ExchangeClone, ExchangeFree,
+			false, plan);
+
+	return (OpBase *)op;
+}
+
+//------------------------------------------------------------------------------
+// morsel processing
+//------------------------------------------------------------------------------
+
+// claim the next morsel
+// returns false if there are no more morsels to process
+// expects ctx->lock to be held
+static bool _Exchange_ClaimMorsel
+(
+	ExchangeCtx *ctx,
+	NodeID *start,
+	NodeID *end
+) {
+	if(ctx->next >= ctx->end) return false;
+
+	*start = ctx->next;
+	*end   = ctx->next + MORSEL_SIZE;
+	if(*end > ctx->end) *end = ctx->end;
+
+	ctx->next = *end;
+	return true;
+}
+
+// returns true if node passes all filters
+static inline bool _Exchange_PassFilters
+(
+	FT_FilterNode **filters,
+	Record r
+) {
+	uint n = array_len(filters);
+	for(uint i = 0; i < n; i++) {
+		if(FilterTree_applyFilters(filters[i], r) != FILTER_PASS) return false;
+	}
+	return true;
+}
+
+// handle a node passing all filters
+// either feed the record into the sink or collect the node's ID
+static inline void _Exchange_Emit
+(
+	const ExchangeCtx *ctx,  // shared context
+	Record r,                // record holding node
+	NodeID id,               // node ID
+	void *state,             // sink state
+	NodeID **ids             // [input/output] IDs of passing nodes
+) {
+	if(ctx->drain) ctx->sink.consume(state, r);
+	else array_append(*ids, id);
+}
+
+// scan nodes within [start, end)
+// collecting the IDs of nodes passing all filters into 'ids'
+// or feeding their records into the sink when draining
+static void _Exchange_ScanMorsel
+(
+	const ExchangeCtx *ctx,   // shared context
+	FT_FilterNode **filters,  // filters to apply
+	Record r,                 // record filters are evaluated against
+	NodeID start,             // first ID to scan
+	NodeID end,               // scan stops at this ID
+	void *state,              // sink state
+	NodeID **ids              // [input/output] IDs of passing nodes
+) {
+	if(!ctx->drain) {
+		if(*ids == NULL) *ids = array_new(NodeID, MORSEL_SIZE / 4);
+		else array_clear(*ids);
+	}
+
+	Node n = GE_NEW_NODE();
+
+	if(ctx->L != NULL) {
+		GrB_Index id;
+		RG_MatrixTupleIter it = {0};
+		GrB_Info info = RG_MatrixTupleIter_AttachRange(&it, ctx->L, start,
+				end - 1);
+		ASSERT(info == GrB_SUCCESS);
+
+		while(RG_MatrixTupleIter_next_BOOL(&it, &id, NULL, NULL) ==
+				GrB_SUCCESS) {
+			Graph_GetNode(ctx->g, id, &n);
+			Record_AddNode(r, ctx->nodeRecIdx, n);
+			if(_Exchange_PassFilters(filters, r)) {
+				_Exchange_Emit(ctx, r, id, state, ids);
+			}
+		}
+
+		RG_MatrixTupleIter_detach(&it);
+	} else {
+		for(NodeID id = start; id < end; id++) {
+			// skip deleted nodes
+			if(!Graph_GetNode(ctx->g, id, &n)) continue;
+
+			Record_AddNode(r, ctx->nodeRecIdx, n);
+			if(_Exchange_PassFilters(filters, r)) {
+				_Exchange_Emit(ctx, r, id, state, ids);
+			}
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// exchange context
+//------------------------------------------------------------------------------
+
+static ExchangeCtx *_ExchangeCtx_New
+(
+	uint workers
+) {
+	ExchangeCtx *ctx = rm_calloc(1, sizeof(ExchangeCtx));
+
+	ctx->refcount    = 1;
+	ctx->output      = array_new(NodeID *, 0);
+	ctx->max_pending = workers * MAX_PENDING_PER_WORKER;
+	ctx->query_ctx   = QueryCtx_GetQueryCtx();
+
+	int res = pthread_mutex_init(&ctx->lock, NULL);
+	ASSERT(res == 0);
+	res = pthread_cond_init(&ctx->cond, NULL);
+	ASSERT(res == 0);
+
+	return ctx;
+}
+
+// drop a reference to the context, freeing it once unreferenced
+static void _ExchangeCtx_Release
+(
+	ExchangeCtx *ctx
+) {
+	pthread_mutex_lock(&ctx->lock);
+	bool last = (--ctx->refcount == 0);
+	pthread_mutex_unlock(&ctx->lock);
+
+	if(!last) return;
+
+	uint n = array_len(ctx->output);
+	for(uint i = 0; i < n; i++) array_free(ctx->output[i]);
+	array_free(ctx->output);
+
+	if(ctx->states != NULL) {
+		n = array_len(ctx->states);
+		for(uint i = 0; i < n; i++) ctx->sink.free_state(ctx->states[i]);
+		array_free(ctx->states);
+	}
+
+	if(ctx->filters != NULL) array_free(ctx->filters);
+	if(ctx->r != NULL) Record_Free(ctx->r);
+	if(ctx->error != NULL) rm_free(ctx->error);
+
+	pthread_cond_destroy(&ctx->cond);
+	pthread_mutex_destroy(&ctx->lock);
+
+	rm_free(ctx);
+}
+
+// charge the memory allocated by workers to the exchange's thread
+// such that it counts towards the query's memory consumption
+// expects ctx->lock to be held
+static inline void _ExchangeCtx_ChargeAllocations
+(
+	ExchangeCtx *ctx
+) {
+	if(ctx->n_alloced == 0) return;
+
+	rm_add_n_alloced(ctx->n_alloced);
+	ctx->n_alloced = 0;
+}
+
+//------------------------------------------------------------------------------
+// workers
+//------------------------------------------------------------------------------
+
+// hand the memory allocated by the calling worker over to the exchange
+// records and morsel outputs are allocated by workers and freed by the
+// exchange's thread, per thread counters only balance once merged
+// expects ctx->lock to be held
+static inline void _ExchangeWorker_HandOverAllocations
+(
+	ExchangeCtx *ctx
+) {
+	ctx->n_alloced += rm_get_n_alloced();
+	rm_reset_n_alloced();
+}
+
+static ExchangeWorker *_ExchangeWorker_New
+(
+	ExchangeCtx *ctx
+) {
+	ExchangeWorker *w = rm_calloc(1, sizeof(ExchangeWorker));
+
+	w->ctx     = ctx;
+	w->r       = Record_New(ctx->mapping);
+	w->filters = array_new(FT_FilterNode *, array_len(ctx->filters));
+
+	uint n = array_len(ctx->filters);
+	for(uint i = 0; i < n; i++) {
+		array_append(w->filters, FilterTree_Clone(ctx->filters[i]));
+	}
+
+	// worker states are created by the exchange's thread
+	if(ctx->drain) w->state = ctx->sink.new_state(ctx->sink.pdata);
+
+	return w;
+}
+
+static void _ExchangeWorker_Free
+(
+	ExchangeWorker *w
+) {
+	uint n = array_len(w->filters);
+	for(uint i = 0; i < n; i++) FilterTree_Free(w->filters[i]);
+	array_free(w->filters);
+
+	if(w->ids != NULL) array_free(w->ids);
+	if(w->state != NULL) w->ctx->sink.free_state(w->state);
+	Record_Free(w->r);
+	rm_free(w);
+}
+
+// process morsels until either none are left or the scan is cancelled
+static void _ExchangeWorker_Run
+(
+	ExchangeWorker *w
+) {
+	NodeID start;
+	NodeID end;
+	ExchangeCtx *ctx = w->ctx;
+
+	while(true) {
+		pthread_mutex_lock(&ctx->lock);
+
+		_ExchangeWorker_HandOverAllocations(ctx);
+
+		// wait for room in the output queue
+		while(!ctx->cancelled && array_len(ctx->output) >= ctx->max_pending) {
+			pthread_cond_wait(&ctx->cond, &ctx->lock);
+		}
+
+		if(ctx->cancelled || !_Exchange_ClaimMorsel(ctx, &start, &end)) {
+			pthread_mutex_unlock(&ctx->lock);
+			break;
+		}
+
+		pthread_mutex_unlock(&ctx->lock);
+
+		_Exchange_ScanMorsel(ctx, w->filters, w->r, start, end, w->state,
+				&w->ids);
+
+		// hand over morsel output
+		if(!ctx->drain && array_len(w->ids) > 0) {
+			pthread_mutex_lock(&ctx->lock);
+			array_append(ctx->output, w->ids);
+			w->ids = NULL;
+			pthread_cond_broadcast(&ctx->cond);
+			pthread_mutex_unlock(&ctx->lock);
+		}
+	}
+}
+
+// record worker's error and cancel the scan
+static void _ExchangeWorker_ReportError
+(
+	ExchangeWorker *w
+) {
+	ExchangeCtx *ctx = w->ctx;
+	ErrorCtx *err = ErrorCtx_Get();
+
+	pthread_mutex_lock(&ctx->lock);
+	if(ctx->error == NULL) {
+		ctx->error = rm_strdup(err->error != NULL ? err->error :
+				"parallel scan failed");
+	}
+	ctx->cancelled = true;
+	pthread_cond_broadcast(&ctx->cond);
+	pthread_mutex_unlock(&ctx->lock);
+}
+
+// worker entry point, executed by a thread from the readers pool
+static void _ExchangeWorker_Work
+(
+	void *arg
+) {
+	ExchangeWorker *w = (ExchangeWorker *)arg;
+	ExchangeCtx *ctx = w->ctx;
+
+	// the scan might have completed before the worker got scheduled
+	pthread_mutex_lock(&ctx->lock);
+	bool cancelled = ctx->cancelled;
+	if(!cancelled) ctx->active++;
+	pthread_mutex_unlock(&ctx->lock);
+
+	if(!cancelled) {
+		// the thread's counter holds the consumption of its previous task
+		rm_reset_n_alloced();
+		QueryCtx_SetTLS(ctx->query_ctx);
+
+		// a filter raising an exception returns us to this breakpoint
+		if(SET_EXCEPTION_HANDLER()) {
+			_ExchangeWorker_ReportError(w);
+		} else {
+			_ExchangeWorker_Run(w);
+			if(ErrorCtx_EncounteredError()) _ExchangeWorker_ReportError(w);
+		}
+
+		ErrorCtx_Clear();
+		QueryCtx_RemoveFromTLS();
+
+		// free the worker ahead of handing over its allocations
+		// as it was allocated by the exchange's thread
+		void *state = w->state;
+		w->state = NULL;
+		_ExchangeWorker_Free(w);
+
+		pthread_mutex_lock(&ctx->lock);
+		// hand over sink state, merged by the exchange's thread
+		if(ctx->drain) array_append(ctx->states, state);
+		_ExchangeWorker_HandOverAllocations(ctx);
+		ctx->active--;
+		pthread_cond_broadcast(&ctx->cond);
+		pthread_mutex_unlock(&ctx->lock);
+	} else {
+		// the exchange might be gone, the worker's allocations
+		// remain charged to the exchange's thread
+		_ExchangeWorker_Free(w);
+	}
+
+	_ExchangeCtx_Release(ctx);
+}
+
+//------------------------------------------------------------------------------
+// exchange
+//------------------------------------------------------------------------------
+
+// cancel parallel scan and wait for active workers to exit
+static void _Exchange_Stop
+(
+	OpExchange *op
+) {
+	ExchangeCtx *ctx = op->ctx;
+	if(ctx == NULL) return;
+
+	pthread_mutex_lock(&ctx->lock);
+	ctx->cancelled = true;
+	pthread_cond_broadcast(&ctx->cond);
+	while(ctx->active > 0) pthread_cond_wait(&ctx->cond, &ctx->lock);
+	_ExchangeCtx_ChargeAllocations(ctx);
+	pthread_mutex_unlock(&ctx->lock);
+
+	_ExchangeCtx_Release(ctx);
+	op->ctx = NULL;
+}
+
+// determine the range of IDs to scan
+// returns false if the scan shouldn't be performed in parallel
+static bool _Exchange_ScanRange
+(
+	OpExchange *op,
+	const OpBase *scan,
+	RG_Matrix *L,
+	NodeID *start,
+	NodeID *end
+) {
+	if(OpBase_Type(scan) == OPType_ALL_NODE_SCAN) {
+		*L     = NULL;
+		*start = 0;
+		*end   = Graph_UncompactedNodeCount(op->g);
+		return true;
+	}
+
+	NodeByLabelScan *label_scan = (NodeByLabelScan *)scan;
+
+	// missing label
+	if(label_scan->n->label_id == GRAPH_UNKNOWN_LABEL) return false;
+
+	// the scan's ID range has been tightened to the label matrix dimensions
+	// by the scan's initialization or its last reset
+	UnsignedRange *range = &label_scan->range;
+	if(!UnsignedRange_IsValid(range)) return false;
+
+	*L     = Graph_GetLabelMatrix(op->g, label_scan->n->label_id);
+	*start = range->include_min ? range->min : range->min + 1;
+	*end   = range->include_max ? range->max + 1 : range->max;
+
+	return true;
+}
+
+// decide whether to scan in parallel, dispatching workers if so
+// records are fed into sink if one is provided
+static void _Exchange_Start
+(
+	OpExchange *op,
+	const ExchangeSink *sink
+) {
+	op->parallel = false;
+	op->depleted = false;
+
+	uint64_t workers = 0;
+	Config_Option_get(Config_PARALLEL_SCAN_WORKERS, &workers);
+
+	// workers are drawn from the readers pool
+	uint64_t readers = ThreadPools_ReadersCount();
+	if(workers > readers) workers = readers;
+	if(workers <= 1) return;
+
+	// collect filters on top of the scan
+	OpBase *scan = op->op.children[0];
+	FT_FilterNode **filters = array_new(FT_FilterNode *, 1);
+	while(OpBase_Type(scan) == OPType_FILTER) {
+		array_append(filters, ((OpFilter *)scan)->filterTree);
+		scan = scan->children[0];
+	}
+	ASSERT(Exchange_ParallelizableScan(scan));
+
+	NodeID start;
+	NodeID end;
+	RG_Matrix L;
+	op->g = QueryCtx_GetGraph();
+	if(!_Exchange_ScanRange(op, scan, &L, &start, &end) ||
+	   end <= start || end - start < 2 * MORSEL_SIZE) {
+		// scanned range doesn't justify a parallel scan
+		array_free(filters);
+		return;
+	}
+
+	// no need for more workers than there are morsels
+	uint64_t morsels = (end - start + MORSEL_SIZE - 1) / MORSEL_SIZE;
+	if(workers > morsels) workers = morsels;
+
+	ExchangeCtx *ctx = _ExchangeCtx_New(workers);
+
+	ctx->g          = op->g;
+	ctx->L          = L;
+	ctx->r          = Record_New(ExecutionPlan_GetMappings(op->op.plan));
+	ctx->end        = end;
+	ctx->next       = start;
+	ctx->filters    = filters;
+	ctx->mapping    = ctx->r->mapping;
+	ctx->nodeRecIdx = (OpBase_Type(scan) == OPType_ALL_NODE_SCAN) ?
+		((AllNodeScan *)scan)->nodeRecIdx :
+		((NodeByLabelScan *)scan)->nodeRecIdx;
+
+	if(sink != NULL) {
+		ctx->drain  = true;
+		ctx->sink   = *sink;
+		ctx->states = array_new(void *, workers);
+	}
+
+	op->ctx        = ctx;
+	op->parallel   = true;
+	op->nodeRecIdx = ctx->nodeRecIdx;
+
+	// the exchange's thread participates in the scan
+	// dispatch additional workers to the readers pool
+	// a worker which isn't picked up before the scan completes exits immediately
+	for(uint i = 1; i < workers; i++) {
+		ExchangeWorker *w = _ExchangeWorker_New(ctx);
+
+		pthread_mutex_lock(&ctx->lock);
+		ctx->refcount++;
+		pthread_mutex_unlock(&ctx->lock);
+
+		if(ThreadPools_AddWorkReader(_ExchangeWorker_Work, w, false) != 0) {
+			// readers queue is full, make do with the workers we have
+			_ExchangeWorker_Free(w);
+			_ExchangeCtx_Release(ctx);
+			break;
+		}
+	}
+}
+
+// retrieve the next morsel output into op->ids
+// either by taking over a worker's output or by scanning a morsel
+// returns false once all morsels have been processed
+static bool _Exchange_NextMorsel
+(
+	OpExchange *op
+) {
+	NodeID start;
+	NodeID end;
+	ExchangeCtx *ctx = op->ctx;
+
+	pthread_mutex_lock(&ctx->lock);
+
+	while(ctx->error == NULL) {
+		_ExchangeCtx_ChargeAllocations(ctx);
+
+		// prefer workers output
+		if(array_len(ctx->output) > 0) {
+			NodeID *ids = array_pop(ctx->output);
+			// make room for blocked workers
+			pthread_cond_broadcast(&ctx->cond);
+			pthread_mutex_unlock(&ctx->lock);
+
+			if(op->ids != NULL) array_free(op->ids);
+			op->ids     = ids;
+			op->ids_idx = 0;
+			return true;
+		}
+
+		// scan a morsel ourselves
+		if(_Exchange_ClaimMorsel(ctx, &start, &end)) {
+			pthread_mutex_unlock(&ctx->lock);
+
+			_Exchange_ScanMorsel(ctx, ctx->filters, ctx->r, start, end, NULL,
+					&op->ids);
+			op->ids_idx = 0;
+			return true;
+		}
+
+		// all morsels claimed, wait for active workers
+		if(ctx->active == 0) break;
+		pthread_cond_wait(&ctx->cond, &ctx->lock);
+	}
+
+	pthread_mutex_unlock(&ctx->lock);
+
+	// propagate worker's error
+	if(ctx->error != NULL) ErrorCtx_RaiseRuntimeException("%s", ctx->error);
+
+	return false;
+}
+
+// scan in parallel feeding every record passing the filters into sink
+bool Exchange_Drain
+(
+	OpExchange *op,           // exchange
+	const ExchangeSink *sink  // records consumer
+) {
+	ASSERT(op   != NULL);
+	ASSERT(sink != NULL);
+	ASSERT(op->ctx == NULL);
+
+	// profiled plans are executed serially
+	if(op->op.stats != NULL) return false;
+
+	_Exchange_Start(op, sink);
+	if(!op->parallel) return false;
+
+	NodeID start;
+	NodeID end;
+	ExchangeCtx *ctx = op->ctx;
+
+	// participate in the scan, feeding the caller's state
+	pthread_mutex_lock(&ctx->lock);
+	while(ctx->error == NULL) {
+		if(_Exchange_ClaimMorsel(ctx, &start, &end)) {
+			pthread_mutex_unlock(&ctx->lock);
+			_Exchange_ScanMorsel(ctx, ctx->filters, ctx->r, start, end,
+					sink->state, &op->ids);
+			pthread_mutex_lock(&ctx->lock);
+			continue;
+		}
+
+		// all morsels claimed, wait for active workers
+		if(ctx->active == 0) break;
+		pthread_cond_wait(&ctx->cond, &ctx->lock);
+	}
+
+	// workers which didn't start yet won't run
+	// their states are freed along with the context
+	ctx->cancelled = true;
+	_ExchangeCtx_ChargeAllocations(ctx);
+	void **states = ctx->states;
+	ctx->states = array_new(void *, 0);
+	pthread_mutex_unlock(&ctx->lock);
+
+	// merge worker states
+	uint n = array_len(states);
+	if(ctx->error == NULL) {
+		for(uint i = 0; i < n; i++) sink->merge(sink->pdata, states[i]);
+	}
+	for(uint i = 0; i < n; i++) sink->free_state(states[i]);
+	array_free(states);
+
+	// propagate worker's error
+	if(ctx->error != NULL) ErrorCtx_RaiseRuntimeException("%s", ctx->error);
+
+	// nothing left to emit
+	op->depleted = true;
+	OpBase_UpdateConsume((OpBase *)op, ExchangeConsumeParallel);
+
+	return true;
+}
+
+static OpResult ExchangeInit
+(
+	OpBase *opBase
+) {
+	ASSERT(opBase->childCount == 1);
+
+	// profiled plans are executed serially
+	// such that each operation reports its own statistics
+	if(opBase->stats != NULL) {
+		OpBase_UpdateConsume(opBase, ExchangeConsumePassThrough);
+		OpBase_UpdateConsumeBatch(opBase, ExchangeConsumeBatchPassThrough);
+	}
+
+	return OP_OK;
+}
+
+// first call, determine execution mode
+static Record ExchangeConsume
+(
+	OpBase *opBase
+) {
+	OpExchange *op = (OpExchange *)opBase;
+
+	_Exchange_Start(op, NULL);
+
+	if(op->parallel) {
+		OpBase_UpdateConsume(opBase, ExchangeConsumeParallel);
+	} else {
+		OpBase_UpdateConsume(opBase, ExchangeConsumePassThrough);
+		OpBase_UpdateConsumeBatch(opBase, ExchangeConsumeBatchPassThrough);
+	}
+
+	return OpBase_Consume(opBase);
+}
+
+// emit nodes located by the parallel scan
+static Record ExchangeConsumeParallel
+(
+	OpBase *opBase
+) {
+	OpExchange *op = (OpExchange *)opBase;
+
+	while(op->ids == NULL || op->ids_idx == array_len(op->ids)) {
+		if(op->depleted) return NULL;
+		if(!_Exchange_NextMorsel(op)) {
+			op->depleted = true;
+			return NULL;
+		}
+	}
+
+	NodeID id = op->ids[op->ids_idx++];
+
+	Node n = GE_NEW_NODE();
+	Graph_GetNode(op->g, id, &n);
+
+	Record r = OpBase_CreateRecord(opBase);
+	Record_AddNode(r, op->nodeRecIdx, n);
+
+	return r;
+}
+
+static Record ExchangeConsumePassThrough
+(
+	OpBase *opBase
+) {
+	return OpBase_Consume(opBase->children[0]);
+}
+
+static uint ExchangeConsumeBatchPassThrough
+(
+	OpBase *opBase,
+	Record *batch,
+	uint cap
+) {
+	return OpBase_ConsumeBatch(opBase->children[0], batch, cap);
+}
+
+static OpResult ExchangeReset
+(
+	OpBase *opBase
+) {
+	OpExchange *op = (OpExchange *)opBase;
+
+	_Exchange_Stop(op);
+
+	if(op->ids != NULL) {
+		array_free(op->ids);
+		op->ids = NULL;
+	}
+	op->ids_idx  = 0;
+	op->parallel = false;
+	op->depleted = false;
+
+	// re-evaluate execution mode on next call
+	if(opBase->stats == NULL) {
+		OpBase_UpdateConsume(opBase, ExchangeConsume);
+		OpBase_UpdateConsumeBatch(opBase, NULL);
+	}
+
+	return OP_OK;
+}
+
+static OpBase *ExchangeClone
+(
+	const ExecutionPlan *plan,
+	const OpBase *opBase
+) {
+	ASSERT(opBase->type == OPType_EXCHANGE);
+	return NewExchangeOp(plan);
+}
+
+static void ExchangeFree
+(
+	OpBase *opBase
+) {
+	OpExchange *op = (OpExchange *)opBase;
+
+	// workers must not outlive the query
+	_Exchange_Stop(op);
+
+	if(op->ids != NULL) {
+		array_free(op->ids);
+		op->ids = NULL;
+	}
+}
@@ -0,0 +1,81 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "op.h"
+#include "../execution_plan.h"
+#include "../../graph/graph.h"
+#include "../../filter_tree/filter_tree.h"
+#include "../../graph/rg_matrix/rg_matrix.h"
+
+// Exchange merges the output of a parallel scan
+//
+// the operation sits on top of a chain of filters applied to a tap
+// label scan or all node scan:
+//
+// Exchange
+//     Filter
+//         Node By Label Scan
+//
+// when parallel scans are enabled the scanned ID range is split into morsels
+// each morsel is scanned and filtered independently by either the query's
+// thread or a worker from the readers thread-pool
+// IDs of nodes passing the filters are collected and emitted by the exchange
+// the filter and scan operations beneath the exchange aren't consumed
+//
+// when parallel scans are disabled, the scanned range is small or the query
+// is profiled, the exchange simply passes through records produced
+// by its child
+//
+// alternatively the exchange's parent can drain the scan into a sink
+// in which case every thread feeds the records it produces into a private
+// sink state, e.g. a partial aggregation, rather than handing IDs back
+// to the exchange, worker states are merged by the exchange's thread
+
+typedef struct ExchangeCtx ExchangeCtx;
+
+// consumer of records produced by a parallel scan
+typedef struct {
+	void *(*new_state)(void *pdata);         // create a worker state
+	void (*consume)(void *state, Record r);  // consume a record, r is borrowed
+	void (*merge)(void *pdata, void *state); // merge worker state into pdata
+	void (*free_state)(void *state);         // free a worker state
+	void *pdata;                             // sink private data
+	void *state;                             // state of the exchange's thread
+} ExchangeSink;
+
+typedef struct {
+	OpBase op;
+	bool parallel;          // scan is performed in parallel
+	bool depleted;          // all morsels have been processed
+	Graph *g;               // graph scanned
+	int nodeRecIdx;         // scanned node position within record
+	NodeID *ids;            // morsel output currently being emitted
+	uint ids_idx;           // position within ids
+	ExchangeCtx *ctx;       // parallel scan context, shared with workers
+} OpExchange;
+
+// creates a new Exchange operation
+OpBase *NewExchangeOp
+(
+	const ExecutionPlan *plan  // execution plan
+);
+
+// scan in parallel feeding every record passing the filters into sink
+// returns false if the scan isn't performed in parallel, in which case
+// the exchange should be consumed as usual
+bool Exchange_Drain
+(
+	OpExchange *op,           // exchange
+	const ExchangeSink *sink  // records consumer
+);
+
+// returns true if op is a tap scan which can be split into morsels
+bool Exchange_ParallelizableScan
+(
+	const OpBase *op  // op to inspect
+);
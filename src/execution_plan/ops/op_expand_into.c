@@ -8,9 +8,6 @@
 #include "shared/print_functions.h"
 #include "../../query_ctx.h"
 
-// default number of records to accumulate before traversing
-#define BATCH_SIZE 16
-
 // forward declarations
 static OpResult ExpandIntoInit(OpBase *opBase);
 static Record ExpandIntoConsume(OpBase *opBase);
@@ -51,6 +48,55 @@ static void _populate_filter_matrix
 	GrB_Matrix_wait(FM, GrB_MATERIALIZE);
 }
 
+// adapt batch size to the previous batch
+// resizing the records array and both filter and result matrices
+static void _adapt_batch_size
+(
+	OpExpandInto *op,
+	bool full
+) {
+	GrB_Index nvals;
+	GrB_Info info = RG_Matrix_nvals(&nvals, op->M);
+	ASSERT(info == GrB_SUCCESS);
+
+	uint cap = TraverseBatch_NextSize(op->record_cap, op->batch_max, full,
+			nvals);
+	if(cap == op->record_cap) return;
+
+	op->record_cap = cap;
+	op->records = rm_realloc(op->records, cap * sizeof(Record));
+
+	// only the number of rows changes
+	GrB_Index ncols;
+	info = RG_Matrix_ncols(&ncols, op->F);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_resize(op->F, cap, ncols);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_resize(op->M, cap, ncols);
+	ASSERT(info == GrB_SUCCESS);
+}
+
+// free the evaluated expression along with its filter and result matrices
+static void _free_eval
+(
+	OpExpandInto *op
+) {
+	if(op->F != NULL) {
+		RG_Matrix_free(&op->F);
+		op->F = NULL;
+	}
+
+	if(op->M != NULL) {
+		RG_Matrix_free(&op->M);
+		op->M = NULL;
+	}
+
+	if(op->eval != NULL) {
+		AlgebraicExpression_Free(op->eval);
+		op->eval = NULL;
+	}
+}
+
 // evaluate algebraic expression:
 // appends filter matrix as the left most operand
 // perform multiplications
@@ -67,17 +113,18 @@ static void _traverse
 		RG_Matrix_new(&op->M, GrB_BOOL, op->record_cap, required_dim);
 		RG_Matrix_new(&op->F, GrB_BOOL, op->record_cap, required_dim);
 
-		// prepend the filter matrix to algebraic expression
+		// prepend the filter matrix to a copy of the algebraic expression
 		// as the leftmost operand
-		AlgebraicExpression_MultiplyToTheLeft(&op->ae, op->F);
-		AlgebraicExpression_Optimize(&op->ae);
+		op->eval = AlgebraicExpression_Clone(op->ae);
+		AlgebraicExpression_MultiplyToTheLeft(&op->eval, op->F);
+		AlgebraicExpression_Optimize(&op->eval);
 	}
 
 	// populate filter matrix
 	_populate_filter_matrix(op);
 
 	// evaluate expression
-	AlgebraicExpression_Eval(op->ae, op->M);
+	AlgebraicExpression_Eval(op->eval, op->M);
 }
 
 OpBase *NewExpandIntoOp
@@ -92,12 +139,16 @@ OpBase *NewExpandIntoOp
 	op->F               =  NULL;
 	op->M               =  NULL;
 	op->ae              =  ae;
+	op->eval            =  NULL;
 	op->graph           =  g;
 	op->records         =  NULL;
 	op->edge_ctx        =  NULL;
-	op->record_cap      =  BATCH_SIZE;
+	op->batch_max       =  TRAVERSE_BATCH_MIN;
+	op->batch_full      =  false;
+	op->record_cap      =  TRAVERSE_BATCH_MIN;
 	op->record_count    =  0;
 	op->single_operand  =  false;
+	op->single_rel      =  GRAPH_NO_RELATION;
 
 	// set our Op operations
 	OpBase_Init((OpBase *)op, OPType_EXPAND_INTO, "Expand Into", ExpandIntoInit,
@@ -137,35 +188,33 @@ static OpResult ExpandIntoInit
 	if(op->ae->type == AL_OPERAND) {
 		// if traversed expression is a single operand e.g. [R]
 		// check if specified operand R exists
+		// the matrix itself is fetched by every execution, see _handoff
 		GraphContext *gc = QueryCtx_GetGraphCtx();
 		const char *label = AlgebraicExpression_Label(op->ae);
 		if(label == NULL) {
 			// matrix isn't associated with a label, use the adjacency matrix
-			op->M = Graph_GetAdjacencyMatrix(op->graph, false);
+			op->single_operand = true;
 		} else {
-			// try to retrieve relationship matrix
+			// try to retrieve relationship
 			// it is OK if the relationship doesn't exists, in this case
 			// we won't use this single operand optimization
 			Schema *s = GraphContext_GetSchema(gc, label, SCHEMA_EDGE);
 			if(s != NULL) {
-				// stream records as they enter
-				op->M = Graph_GetRelationMatrix(op->graph, Schema_GetID(s), false);
+				op->single_rel     = Schema_GetID(s);
+				op->single_operand = true;
 			}
 		}
 
-		// if we've managed to set M, restrict record cap to 1
-		// and note the optimization
-		if(op->M) {
-			op->record_cap      =  1;     // record buffer size will be set to 1
-			op->single_operand  =  true;
-		}
+		// stream records as they enter, restrict record cap to 1
+		if(op->single_operand) op->record_cap = 1;
 	}
 
 	// create 'records' within this Init function as 'record_cap'
 	// might be set during optimization time (applyLimit)
-	// If cap greater than BATCH_SIZE is specified,
-	// use BATCH_SIZE as the value.
-	if(op->record_cap > BATCH_SIZE) op->record_cap = BATCH_SIZE;
+	// batches never grow beyond the limit
+	op->batch_max = op->record_cap;
+	if(op->batch_max > TRAVERSE_BATCH_MAX) op->batch_max = TRAVERSE_BATCH_MAX;
+	if(op->record_cap > TRAVERSE_BATCH_MIN) op->record_cap = TRAVERSE_BATCH_MIN;
 
 	op->records = rm_calloc(op->record_cap, sizeof(Record));
 
@@ -201,6 +250,12 @@ static Record _handoff
 		}
 	}
 
+	// first probe since the op was initialized or reset
+	// fetch the probed matrix, synchronizing it with pending changes
+	if(op->single_operand && op->M == NULL && op->record_count > 0) {
+		op->M = Graph_GetRelationMatrix(op->graph, op->single_rel, false);
+	}
+
 	// find a record where both record's source and destination
 	// nodes are connected M[i,j] is set
 	while(op->record_count) {
@@ -277,6 +332,9 @@ static Record ExpandIntoConsume
 		// get data
 		//----------------------------------------------------------------------
 
+		// previous batch fully consumed, adapt batch size
+		if(op->F != NULL) _adapt_batch_size(op, op->batch_full);
+
 		// ask child operation for at most 'record_cap' records
 		int i = 0;
 		for(; i < op->record_cap; i++) {
@@ -301,6 +359,7 @@ static Record ExpandIntoConsume
 			op->records[i] = r;
 		}
 		op->record_count = i;
+		op->batch_full   = (i == op->record_cap);
 
 		// did not managed to produce data, depleted
 		if(op->record_count == 0) return NULL;
@@ -329,6 +388,19 @@ static OpResult ExpandIntoReset
 
 	if(op->edge_ctx != NULL) EdgeTraverseCtx_Reset(op->edge_ctx);
 
+	// the graph might be modified before the next execution
+	if(op->single_operand) {
+		// re-fetch the probed matrix once probing
+		op->M = NULL;
+	} else if(op->F != NULL) {
+		// rebuild the evaluated expression once the graph outgrows
+		// the dimensions of its operands
+		GrB_Index ncols;
+		GrB_Info info = RG_Matrix_ncols(&ncols, op->F);
+		ASSERT(info == GrB_SUCCESS);
+		if(ncols != Graph_RequiredMatrixDim(op->graph)) _free_eval(op);
+	}
+
 	return OP_OK;
 }
 
@@ -351,18 +423,9 @@ static void ExpandIntoFree
 ) {
 	OpExpandInto *op = (OpExpandInto *)ctx;
 
-	if(op->F != NULL) {
-		RG_Matrix_free(&op->F);
-		op->F = NULL;
-	}
+	if(!op->single_operand) _free_eval(op);
 
 	if(op->ae != NULL) {
-		// M was allocated by us
-		if(op->M != NULL && !op->single_operand) {
-			RG_Matrix_free(&op->M);
-			op->M = NULL;
-		}
-
 		AlgebraicExpression_Free(op->ae);
 		op->ae = NULL;
 	}
@@ -17,14 +17,18 @@ typedef struct {
 	OpBase op;
 	Graph *graph;
 	AlgebraicExpression *ae;
+	AlgebraicExpression *eval;  // ae prefixed by F, evaluated per batch
 	RG_Matrix F;                // filter matrix
 	RG_Matrix M;                // algebraic expression result
 	EdgeTraverseCtx *edge_ctx;  // edge collection data if the edge needs to be set
 	int srcNodeIdx;             // source node index into record
 	int destNodeIdx;            // destination node index into record
 	bool single_operand;        // expression contains a single operand
+	RelationID single_rel;      // relationship probed by a single operand
 	uint record_count;          // number of held records
 	uint record_cap;            // max number of records to process
+	uint batch_max;             // max value record_cap can grow to
+	bool batch_full;            // last batch reached record_cap
 	Record *records;            // array of records
 	Record r;                   // currently selected record
 } OpExpandInto;
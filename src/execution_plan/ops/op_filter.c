@@ -9,6 +9,7 @@
 
 /* Forward declarations. */
 static Record FilterConsume(OpBase *opBase);
+static uint FilterConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void FilterFree(OpBase *opBase);
 
@@ -19,6 +20,7 @@ OpBase *NewFilterOp(const ExecutionPlan *plan, FT_FilterNode *filterTree) {
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_FILTER, "Filter", NULL, FilterConsume,
 				NULL, NULL, FilterClone, FilterFree, false, plan);
+	OpBase_UpdateConsumeBatch((OpBase *)op, FilterConsumeBatch);
 
 	return (OpBase *)op;
 }
@@ -42,6 +44,36 @@ static Record FilterConsume(OpBase *opBase) {
 	return r;
 }
 
+/* FilterConsumeBatch
+ * pulls batches from child, compacting passing records in place
+ * until either the batch is full or child is depleted. */
+static uint FilterConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	OpFilter *filter = (OpFilter *)opBase;
+	OpBase *child = filter->op.children[0];
+
+	uint n = 0;
+	while(n < cap) {
+		uint requested = cap - n;
+		uint count = OpBase_ConsumeBatch(child, batch + n, requested);
+		uint end = n + count;
+
+		for(uint i = n; i < end; i++) {
+			Record r = batch[i];
+			/* Pass record through filter tree */
+			if(FilterTree_applyFilters(filter->filterTree, r) == FILTER_PASS) {
+				batch[n++] = r;
+			} else {
+				OpBase_DeleteRecord(r);
+			}
+		}
+
+		// child depleted
+		if(count < requested) break;
+	}
+
+	return n;
+}
+
 static inline OpBase *FilterClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_FILTER);
 	OpFilter *op = (OpFilter *)opBase;
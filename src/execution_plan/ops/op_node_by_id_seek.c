@@ -40,7 +40,8 @@ OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const char *alias, Unsigned
 	/* The largest possible entity ID is the same as Graph_RequiredMatrixDim.
 	 * This value will be set on Init, to allow operation clone be independent
 	 * on the current graph size.*/
-	op->maxId = id_range->include_max ? id_range->max : id_range->max - 1;
+	op->rangeMaxId = id_range->include_max ? id_range->max : id_range->max - 1;
+	op->maxId = op->rangeMaxId;
 
 	op->currentId = op->minId;
 
@@ -53,12 +54,17 @@ OpBase *NewNodeByIdSeekOp(const ExecutionPlan *plan, const char *alias, Unsigned
 	return (OpBase *)op;
 }
 
+// Clamp the requested range to the number of nodes in the graph.
+static inline void _clampRange(NodeByIdSeek *op) {
+	// The largest possible entity ID is the number of nodes - deleted and real - in the DataBlock.
+	size_t node_count = Graph_UncompactedNodeCount(op->g);
+	op->maxId = MIN(node_count - 1, op->rangeMaxId);
+}
+
 static OpResult NodeByIdSeekInit(OpBase *opBase) {
 	ASSERT(opBase->type == OPType_NODE_BY_ID_SEEK);
 	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
-	// The largest possible entity ID is the number of nodes - deleted and real - in the DataBlock.
-	size_t node_count = Graph_UncompactedNodeCount(op->g);
-	op->maxId = MIN(node_count - 1, op->maxId);
+	_clampRange(op);
 	if(opBase->childCount > 0) OpBase_UpdateConsume(opBase, NodeByIdSeekConsumeFromChild);
 	return OP_OK;
 }
@@ -128,6 +134,8 @@ static Record NodeByIdSeekConsume(OpBase *opBase) {
 
 static OpResult NodeByIdSeekReset(OpBase *ctx) {
 	NodeByIdSeek *op = (NodeByIdSeek *)ctx;
+	// The graph may have grown since the range was clamped.
+	_clampRange(op);
 	op->currentId = op->minId;
 	return OP_OK;
 }
@@ -137,12 +145,12 @@ static OpBase *NodeByIdSeekClone(const ExecutionPlan *plan, const OpBase *opBase
 	NodeByIdSeek *op = (NodeByIdSeek *)opBase;
 	UnsignedRange range;
 	range.min = op->minId;
-	range.max = op->maxId;
+	range.max = op->rangeMaxId;
 	/* In order to clone the range set at the original op, the range must be inclusive so the clone will set the exact range as the original.
 	 * During the call to NewNodeByIdSeekOp with the range, the following lines are executed:
 	 * op->minId = id_range->include_min ? id_range->min : id_range->min + 1;
-	 * op->maxId = id_range->include_max ? id_range->max : id_range->max - 1;
-	 * Since the range object min equals to the origin minId, and so is the max equals to the origin maxId, and the range is inclusive
+	 * op->rangeMaxId = id_range->include_max ? id_range->max : id_range->max - 1;
+	 * Since the range object min equals to the origin minId, and so is the max equals to the origin rangeMaxId, and the range is inclusive
 	 * the clone will set its values to be the same as in the origin. */
 	range.include_min = true;
 	range.include_max = true;
@@ -21,7 +21,8 @@ typedef struct {
 	const char *alias;      // Alias of the node being scanned by this op.
 	NodeID currentId;       // Current ID fetched.
 	NodeID minId;           // Min ID to fetch.
-	NodeID maxId;           // Max ID to fetch.
+	NodeID maxId;           // Max ID to fetch, clamped to the graph size.
+	NodeID rangeMaxId;      // Max ID requested.
 	int nodeRecIdx;         // Position of entity within record.
 } NodeByIdSeek;
 
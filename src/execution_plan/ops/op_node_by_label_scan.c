@@ -13,6 +13,7 @@
 /* Forward declarations. */
 static OpResult NodeByLabelScanInit(OpBase *opBase);
 static Record NodeByLabelScanConsume(OpBase *opBase);
+static uint NodeByLabelScanConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static Record NodeByLabelScanConsumeFromChild(OpBase *opBase);
 static Record NodeByLabelScanNoOp(OpBase *opBase);
 static OpResult NodeByLabelScanReset(OpBase *opBase);
@@ -89,16 +90,20 @@ static GrB_Info _ConstructIterator
 	ASSERT(info == GrB_SUCCESS);
 
 	// make sure range is within matrix bounds
-	UnsignedRange_TightenRange(op->id_range, OP_GE, 0);
-	UnsignedRange_TightenRange(op->id_range, OP_LT, nrows);
+	// the requested range is left untouched as the matrix may grow
+	// by the time the iterator is reconstructed
+	UnsignedRange *range = &op->range;
+	*range = *op->id_range;
+	UnsignedRange_TightenRange(range, OP_GE, 0);
+	UnsignedRange_TightenRange(range, OP_LT, nrows);
 
-	if(!UnsignedRange_IsValid(op->id_range)) return GrB_DIMENSION_MISMATCH;
+	if(!UnsignedRange_IsValid(range)) return GrB_DIMENSION_MISMATCH;
 
-	if(op->id_range->include_min) minId = op->id_range->min;
-	else minId = op->id_range->min + 1;
+	if(range->include_min) minId = range->min;
+	else minId = range->min + 1;
 
-	if(op->id_range->include_max) maxId = op->id_range->max;
-	else maxId = op->id_range->max - 1;
+	if(range->include_max) maxId = range->max;
+	else maxId = range->max - 1;
 
 	info = RG_MatrixTupleIter_AttachRange(&op->iter, L, minId, maxId);
 	ASSERT(info == GrB_SUCCESS);
@@ -106,33 +111,49 @@ static GrB_Info _ConstructIterator
 	return info;
 }
 
-static OpResult NodeByLabelScanInit
+// sets the consume functions of a tap operation
+// according to the current label matrix dimensions
+static void _SetTapConsume
 (
-	OpBase *opBase
+	NodeByLabelScan *op
 ) {
-	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+	OpBase *opBase = (OpBase *)op;
 	OpBase_UpdateConsume(opBase, NodeByLabelScanConsume); // default consume function
-
-	// operation has children, consume from child
-	if(opBase->childCount > 0) {
-		OpBase_UpdateConsume(opBase, NodeByLabelScanConsumeFromChild);
-		return OP_OK;
-	}
+	OpBase_UpdateConsumeBatch(opBase, NULL);
 
 	if(op->n->label_id == GRAPH_UNKNOWN_LABEL) {
 		// missing schema, use the NOP consume function
 		OpBase_UpdateConsume(opBase, NodeByLabelScanNoOp);
-		return OP_OK;
-	}	
+		return;
+	}
 
 	// the iterator build may fail if the ID range does not match the matrix dimensions
 	GrB_Info iterator_built = _ConstructIterator(op);
 	if(iterator_built != GrB_SUCCESS) {
 		// invalid range, use the NOP consume function
 		OpBase_UpdateConsume(opBase, NodeByLabelScanNoOp);
+		return;
+	}
+
+	// tap operation, scan label matrix in batches
+	OpBase_UpdateConsumeBatch(opBase, NodeByLabelScanConsumeBatch);
+}
+
+static OpResult NodeByLabelScanInit
+(
+	OpBase *opBase
+) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	// operation has children, consume from child
+	if(opBase->childCount > 0) {
+		OpBase_UpdateConsume(opBase, NodeByLabelScanConsumeFromChild);
+		OpBase_UpdateConsumeBatch(opBase, NULL);
 		return OP_OK;
 	}
 
+	_SetTapConsume(op);
+
 	return OP_OK;
 }
 
@@ -218,6 +239,28 @@ static Record NodeByLabelScanConsume(OpBase *opBase) {
 	return r;
 }
 
+// produce a batch of records, one for each scanned node
+static uint NodeByLabelScanConsumeBatch
+(
+	OpBase *opBase,
+	Record *batch,
+	uint cap
+) {
+	NodeByLabelScan *op = (NodeByLabelScan *)opBase;
+
+	uint n = 0;
+	GrB_Index nodeId;
+	while(n < cap &&
+		  RG_MatrixTupleIter_next_BOOL(&op->iter, &nodeId, NULL, NULL) ==
+		  GrB_SUCCESS) {
+		Record r = OpBase_CreateRecord(opBase);
+		_UpdateRecord(op, r, nodeId);
+		batch[n++] = r;
+	}
+
+	return n;
+}
+
 // this function is invoked when the op has no children
 // and no valid label is requested (either no label, or non existing label)
 // the op simply needs to return NULL
@@ -239,7 +282,14 @@ static OpResult NodeByLabelScanReset
 		op->child_record = NULL;
 	}
 
-	_ResetIterator(op);
+	if(ctx->childCount > 0) {
+		_ResetIterator(op);
+	} else {
+		// the graph may have changed since the operation was initialized
+		// re-evaluate the scanned range against the label matrix
+		_SetTapConsume(op);
+	}
+
 	return OP_OK;
 }
 
@@ -23,6 +23,7 @@ typedef struct {
 	NodeScanCtx *n;             // Label data of node being scanned
 	unsigned int nodeRecIdx;    // Node position within record
 	UnsignedRange *id_range;    // ID range to iterate over
+	UnsignedRange range;        // ID range clamped to the label matrix dimensions
 	RG_MatrixTupleIter iter;    // Iterator over label matrix
 	Record child_record;        // The Record this op acts on if it is not a tap
 } NodeByLabelScan;
@@ -12,7 +12,9 @@
 #include "../../util/rmalloc.h"
 
 /* Forward declarations. */
+static OpResult ProjectInit(OpBase *opBase);
 static Record ProjectConsume(OpBase *opBase);
+static uint ProjectConsumeBatch(OpBase *opBase, Record *batch, uint cap);
 static OpResult ProjectReset(OpBase *opBase);
 static OpBase *ProjectClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ProjectFree(OpBase *opBase);
@@ -27,7 +29,7 @@ OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	op->projection = NULL;
 
 	// Set our Op operations
-	OpBase_Init((OpBase *)op, OPType_PROJECT, "Project", NULL, ProjectConsume,
+	OpBase_Init((OpBase *)op, OPType_PROJECT, "Project", ProjectInit, ProjectConsume,
 				ProjectReset, NULL, ProjectClone, ProjectFree, false, plan);
 
 	for(uint i = 0; i < op->exp_count; i ++) {
@@ -40,22 +42,17 @@ OpBase *NewProjectOp(const ExecutionPlan *plan, AR_ExpNode **exps) {
 	return (OpBase *)op;
 }
 
-static Record ProjectConsume(OpBase *opBase) {
-	OpProject *op = (OpProject *)opBase;
-
-	if(op->op.childCount) {
-		OpBase *child = op->op.children[0];
-		op->r = OpBase_Consume(child);
-		if(!op->r) return NULL;
-	} else {
-		// QUERY: RETURN 1+2
-		// Return a single record followed by NULL on the second call.
-		if(op->singleResponse) return NULL;
-		op->singleResponse = true;
-		op->r = OpBase_CreateRecord(opBase);
+static OpResult ProjectInit(OpBase *opBase) {
+	// project in batches only when there's a child to pull batches from
+	if(opBase->childCount > 0) {
+		OpBase_UpdateConsumeBatch(opBase, ProjectConsumeBatch);
 	}
+	return OP_OK;
+}
 
-	op->projection = OpBase_CreateRecord(opBase);
+// project op->r into a new record, op->r is released once projected
+static Record _ProjectRecord(OpProject *op) {
+	op->projection = OpBase_CreateRecord((OpBase *)op);
 
 	for(uint i = 0; i < op->exp_count; i++) {
 		AR_ExpNode *exp = op->exps[i];
@@ -93,6 +90,38 @@ static Record ProjectConsume(OpBase *opBase) {
 	return projection;
 }
 
+static Record ProjectConsume(OpBase *opBase) {
+	OpProject *op = (OpProject *)opBase;
+
+	if(op->op.childCount) {
+		OpBase *child = op->op.children[0];
+		op->r = OpBase_Consume(child);
+		if(!op->r) return NULL;
+	} else {
+		// QUERY: RETURN 1+2
+		// Return a single record followed by NULL on the second call.
+		if(op->singleResponse) return NULL;
+		op->singleResponse = true;
+		op->r = OpBase_CreateRecord(opBase);
+	}
+
+	return _ProjectRecord(op);
+}
+
+// replaces each record of a batch pulled from child with its projection
+static uint ProjectConsumeBatch(OpBase *opBase, Record *batch, uint cap) {
+	OpProject *op = (OpProject *)opBase;
+	OpBase *child = op->op.children[0];
+
+	uint n = OpBase_ConsumeBatch(child, batch, cap);
+	for(uint i = 0; i < n; i++) {
+		op->r = batch[i];
+		batch[i] = _ProjectRecord(op);
+	}
+
+	return n;
+}
+
 static OpResult ProjectReset(OpBase *opBase) {
 	OpProject *op = (OpProject *)opBase;
 	op->singleResponse = false;
@@ -16,20 +16,23 @@
 /* Forward declarations. */
 static Record ResultsConsume(OpBase *opBase);
 static OpResult ResultsInit(OpBase *opBase);
+static OpResult ResultsReset(OpBase *opBase);
 static OpBase *ResultsClone(const ExecutionPlan *plan, const OpBase *opBase);
 
 OpBase *NewResultsOp(const ExecutionPlan *plan) {
 	Results *op = rm_malloc(sizeof(Results));
+	op->result_set = NULL;
 
 	// Set our Op operations
 	OpBase_Init((OpBase *)op, OPType_RESULTS, "Results", ResultsInit, ResultsConsume,
-				NULL, NULL, ResultsClone, NULL, false, plan);
+				ResultsReset, NULL, ResultsClone, NULL, false, plan);
 
 	return (OpBase *)op;
 }
 
-static OpResult ResultsInit(OpBase *opBase) {
-	Results *op = (Results *)opBase;
+// bind operation to the current query's result set
+static void _ResultsBind(Results *op) {
+	OpBase *opBase = (OpBase *)op;
 	op->result_set = QueryCtx_GetResultSet();
 	Config_Option_get(Config_RESULTSET_MAX_SIZE, &op->result_set_size_limit);
 
@@ -39,7 +42,10 @@ static OpResult ResultsInit(OpBase *opBase) {
 		rax *mapping = ExecutionPlan_GetMappings(opBase->plan);
 		ResultSet_MapProjection(op->result_set, mapping);
 	}
+}
 
+static OpResult ResultsInit(OpBase *opBase) {
+	_ResultsBind((Results *)opBase);
 	return OP_OK;
 }
 
@@ -49,6 +55,9 @@ static Record ResultsConsume(OpBase *opBase) {
 	Record r = NULL;
 	Results *op = (Results *)opBase;
 
+	// operation was reset, bind to the current query
+	if(op->result_set == NULL) _ResultsBind(op);
+
 	// enforce result-set size limit
 	if(op->result_set_size_limit == 0) return NULL;
 	op->result_set_size_limit--;
@@ -62,6 +71,14 @@ static Record ResultsConsume(OpBase *opBase) {
 	return r;
 }
 
+// detach from the query's result set
+// the operation binds to the next query's result set once consumed
+static OpResult ResultsReset(OpBase *opBase) {
+	Results *op = (Results *)opBase;
+	op->result_set = NULL;
+	return OP_OK;
+}
+
 static inline OpBase *ResultsClone(const ExecutionPlan *plan, const OpBase *opBase) {
 	ASSERT(opBase->type == OPType_RESULTS);
 	return NewResultsOp(plan);
@@ -10,7 +10,11 @@
 #include "../../util/arr.h"
 #include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "../../util/sort_key.h"
 #include "../../query_ctx.h"
+#include "shared/spill_functions.h"
+
+#include <string.h>
 
 // forward declarations
 static OpResult SortInit(OpBase *opBase);
@@ -19,6 +23,16 @@ static OpResult SortReset(OpBase *opBase);
 static OpBase *SortClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void SortFree(OpBase *opBase);
 
+// number of bytes in a key block
+#define SORT_KEY_BLOCK_SIZE (64 * 1024)
+
+// a run is spilled once it consumes 1/SORT_RUN_CAPACITY_SHARE of
+// the query memory capacity
+#define SORT_RUN_CAPACITY_SHARE 4
+
+// under memory pressure runs are spilled once they reach this size
+#define SORT_RUN_MIN_SIZE SORT_KEY_BLOCK_SIZE
+
 // function to compare two records on a subset of fields
 // return value similar to strcmp
 static int _record_cmp
@@ -42,13 +56,287 @@ static int _record_cmp
 	return 0;
 }
 
-static int _buffer_elem_cmp
+// compare two entries, by their keys if available
+static int _entry_cmp
+(
+	const SortEntry *a,
+	const SortEntry *b,
+	OpSort *op
+) {
+	if(op->encoded) {
+		return SortKey_Compare(a->key, a->key_len, b->key, b->key_len);
+	}
+	return _record_cmp(a->r, b->r, op);
+}
+
+// compare runs by their head entry
+// the merge heap keeps the greatest element on top, hence the inversion
+static int _run_cmp
+(
+	const SortRun *a,
+	const SortRun *b,
+	OpSort *op
+) {
+	return _entry_cmp(&b->head, &a->head, op);
+}
+
+// stop comparing records by their keys
+// called once a sorted value can't be encoded
+static void _disable_keys
+(
+	OpSort *op
+) {
+	ASSERT(op->merge == NULL);
+
+	op->encoded = false;
+	if(op->heap == NULL) return;
+
+	// heap was ordered by keys, reorder it by values
+	uint n = Heap_count(op->heap);
+	SortEntry **entries = array_newlen(SortEntry *, n);
+	for(uint i = 0; i < n; i++) entries[i] = Heap_poll(op->heap);
+	for(uint i = 0; i < n; i++) Heap_offer(&op->heap, entries[i]);
+	array_free(entries);
+}
+
+// compute r's sort key into key
+// returns false if one of the sorted values can't be encoded
+static bool _compute_key
+(
+	OpSort *op,
+	Record r,
+	unsigned char **key
+) {
+	array_clear(*key);
+
+	uint n = array_len(op->record_offsets);
+	for(uint i = 0; i < n; i++) {
+		SIValue v = Record_Get(r, op->record_offsets[i]);
+		if(!SortKey_Append(key, v, op->directions[i] < 0)) return false;
+	}
+
+	return true;
+}
+
+// allocate len bytes for a buffered record key
+// keys are packed into blocks which are released all at once
+static unsigned char *_key_alloc
+(
+	OpSort *op,
+	uint32_t len
+) {
+	// large keys get a block of their own
+	if(len > SORT_KEY_BLOCK_SIZE / 4) {
+		unsigned char *block = rm_malloc(len);
+		array_append(op->key_blocks, block);
+		return block;
+	}
+
+	if(op->key_block == NULL ||
+	   op->key_block_used + len > SORT_KEY_BLOCK_SIZE) {
+		op->key_block = rm_malloc(SORT_KEY_BLOCK_SIZE);
+		op->key_block_used = 0;
+		array_append(op->key_blocks, op->key_block);
+	}
+
+	unsigned char *key = op->key_block + op->key_block_used;
+	op->key_block_used += len;
+	return key;
+}
+
+// release all buffered records keys
+static void _free_keys
 (
-	const Record *a,
-	const Record *b,
 	OpSort *op
 ) {
-	return _record_cmp(*a, *b, op);
+	if(op->key_blocks == NULL) return;
+
+	uint n = array_len(op->key_blocks);
+	for(uint i = 0; i < n; i++) rm_free(op->key_blocks[i]);
+	array_clear(op->key_blocks);
+
+	op->key_block      = NULL;
+	op->key_block_used = 0;
+}
+
+// create a heap entry for r, holding a copy of the scratch key
+static SortEntry *_heap_entry_new
+(
+	OpSort *op,
+	Record r
+) {
+	uint32_t len = op->encoded ? array_len(op->key) : 0;
+	SortEntry *e = rm_malloc(sizeof(SortEntry) + len);
+
+	e->r       = r;
+	e->key     = (unsigned char *)(e + 1);
+	e->key_len = len;
+	if(len > 0) memcpy(e + 1, op->key, len);
+
+	return e;
+}
+
+// returns true if buffered records should be spilled
+// a run's size is the query memory consumed since the run began
+static bool _run_full
+(
+	const OpSort *op
+) {
+	int64_t capacity = rm_get_mem_capacity();
+	if(capacity <= 0) return false;
+
+	int64_t size = rm_get_n_alloced() - op->run_start;
+	return (size >= capacity / SORT_RUN_CAPACITY_SHARE ||
+			(size >= SORT_RUN_MIN_SIZE && Spill_MemoryPressure()));
+}
+
+// sort buffered records and spill them to a new run
+static void _spill_run
+(
+	OpSort *op
+) {
+	uint n = array_len(op->buffer);
+
+	// make sure all records can be spilled
+	for(uint i = 0; i < n; i++) {
+		if(!Spill_RecordSupported(op->buffer[i].r)) {
+			op->spillable = false;
+			return;
+		}
+	}
+
+	FILE *stream = tmpfile();
+	if(stream == NULL) {
+		op->spillable = false;
+		return;
+	}
+
+	sort_r(op->buffer, n, sizeof(SortEntry), (heap_cmp)_entry_cmp, op);
+
+	// keys are recomputed when records are read back
+	for(uint i = 0; i < n; i++) {
+		Spill_WriteRecord(stream, op->buffer[i].r);
+		OpBase_DeleteRecord(op->buffer[i].r);
+	}
+	array_clear(op->buffer);
+	_free_keys(op);
+
+	if(op->runs == NULL) op->runs = array_new(SortRun, 2);
+	SortRun run = {.stream = stream, .head = {0},
+		.key = array_new(unsigned char, 64)};
+	array_append(op->runs, run);
+
+	op->run_start = rm_get_n_alloced();
+}
+
+// advance run to its next record
+// returns false if run is depleted
+static bool _run_advance
+(
+	OpSort *op,
+	SortRun *run
+) {
+	run->head.r = NULL;
+
+	if(run->stream == NULL) {
+		// in-memory run
+		if(op->record_idx == array_len(op->buffer)) return false;
+		run->head = op->buffer[op->record_idx++];
+		return true;
+	}
+
+	// spilled records were produced by the child operation
+	// restore them under the same owner
+	Record r = OpBase_CreateRecord(op->op.children[0]);
+	if(Spill_ReadRecord(run->stream, r)) {
+		run->head.r = r;
+		if(op->encoded) {
+			// every record was encoded before it was spilled
+			bool encoded = _compute_key(op, r, &run->key);
+			ASSERT(encoded);
+			UNUSED(encoded);
+			run->head.key     = run->key;
+			run->head.key_len = array_len(run->key);
+		}
+		return true;
+	}
+
+	// run depleted
+	OpBase_DeleteRecord(r);
+	fclose(run->stream);
+	run->stream = NULL;
+	return false;
+}
+
+// prepare spilled runs and the in-memory buffer for merging
+static void _merge_init
+(
+	OpSort *op
+) {
+	// remaining records form an in-memory run
+	sort_r(op->buffer, array_len(op->buffer), sizeof(SortEntry),
+			(heap_cmp)_entry_cmp, op);
+
+	SortRun mem_run = {.stream = NULL, .head = {0}, .key = NULL};
+	array_append(op->runs, mem_run);
+
+	uint n = array_len(op->runs);
+	op->merge = Heap_new((heap_cmp)_run_cmp, op);
+	for(uint i = 0; i < n; i++) {
+		SortRun *run = op->runs + i;
+		if(run->stream != NULL) rewind(run->stream);
+		if(_run_advance(op, run)) Heap_offer(&op->merge, run);
+	}
+}
+
+// emit the smallest head record among all runs
+static Record _merge_handoff
+(
+	OpSort *op
+) {
+	if(Heap_count(op->merge) == 0) return NULL;
+
+	SortRun *run = Heap_poll(op->merge);
+	Record r = run->head.r;
+	if(_run_advance(op, run)) Heap_offer(&op->merge, run);
+
+	return r;
+}
+
+// release runs
+static void _free_runs
+(
+	OpSort *op
+) {
+	if(op->merge != NULL) {
+		Heap_free(op->merge);
+		op->merge = NULL;
+	}
+
+	if(op->runs == NULL) return;
+
+	uint n = array_len(op->runs);
+	for(uint i = 0; i < n; i++) {
+		SortRun *run = op->runs + i;
+		if(run->head.r != NULL) OpBase_DeleteRecord(run->head.r);
+		if(run->stream != NULL) fclose(run->stream);
+		if(run->key != NULL) array_free(run->key);
+	}
+	array_free(op->runs);
+	op->runs = NULL;
+}
+
+// release heap entries and their records
+static void _free_heap_entries
+(
+	OpSort *op
+) {
+	uint n = Heap_count(op->heap);
+	for(uint i = 0; i < n; i++) {
+		SortEntry *e = Heap_poll(op->heap);
+		OpBase_DeleteRecord(e->r);
+		rm_free(e);
+	}
 }
 
 static void _accumulate
@@ -56,21 +344,37 @@ static void _accumulate
 	OpSort *op,
 	Record r
 ) {
+	// compute record's key into the scratch key
+	if(op->encoded && !_compute_key(op, r, &op->key)) _disable_keys(op);
+
 	if(op->limit == UNLIMITED) {
 		// not using a heap and there's room for record
-		array_append(op->buffer, r);
+		SortEntry e = {.r = r, .key = NULL, .key_len = 0};
+		if(op->encoded) {
+			e.key_len = array_len(op->key);
+			unsigned char *key = _key_alloc(op, e.key_len);
+			memcpy(key, op->key, e.key_len);
+			e.key = key;
+		}
+		array_append(op->buffer, e);
+
+		// spill buffered records once they outgrow their memory share
+		if(op->spillable && _run_full(op)) _spill_run(op);
 		return;
 	}
 
 	if(Heap_count(op->heap) < op->limit) {
-		Heap_offer(&op->heap, r);
+		Heap_offer(&op->heap, _heap_entry_new(op, r));
 	} else {
 		// no room in the heap, see if we need to replace
 		// a heap stored record with the current record
-		if(_record_cmp(Heap_peek(op->heap), r, op) > 0) {
-			Record replaced = Heap_poll(op->heap);
-			OpBase_DeleteRecord(replaced);
-			Heap_offer(&op->heap, r);
+		SortEntry e = {.r = r, .key = op->key,
+			.key_len = op->encoded ? array_len(op->key) : 0};
+		if(_entry_cmp(Heap_peek(op->heap), &e, op) > 0) {
+			SortEntry *replaced = Heap_poll(op->heap);
+			OpBase_DeleteRecord(replaced->r);
+			rm_free(replaced);
+			Heap_offer(&op->heap, _heap_entry_new(op, r));
 		} else {
 			OpBase_DeleteRecord(r);
 		}
@@ -78,8 +382,10 @@ static void _accumulate
 }
 
 static inline Record _handoff(OpSort *op) {
+	if(op->merge != NULL) return _merge_handoff(op);
+
 	if(op->record_idx < array_len(op->buffer)) {
-		return op->buffer[op->record_idx++];
+		return op->buffer[op->record_idx++].r;
 	}
 	return NULL;
 }
@@ -94,6 +400,15 @@ OpBase *NewSortOp
 
 	op->exps           = exps;
 	op->heap           = NULL;
+	op->runs           = NULL;
+	op->merge          = NULL;
+	op->spillable      = true;
+	op->run_start      = 0;
+	op->encoded        = true;
+	op->key            = NULL;
+	op->key_blocks     = NULL;
+	op->key_block      = NULL;
+	op->key_block_used = 0;
 	op->skip           = 0;
 	op->first          = true;
 	op->limit          = UNLIMITED;
@@ -119,12 +434,15 @@ static OpResult SortInit(OpBase *opBase) {
 	if(op->limit != UNLIMITED) {
 		op->limit += op->skip;
 		// if a limit is specified, use heapsort to poll the top N
-		op->heap = Heap_new((heap_cmp)_record_cmp, op);
+		op->heap = Heap_new((heap_cmp)_entry_cmp, op);
 	} else {
 		// if all records are being sorted, use quicksort
-		op->buffer = array_new(Record, 32);
+		op->buffer     = array_new(SortEntry, 32);
+		op->key_blocks = array_new(unsigned char *, 1);
 	}
 
+	op->key = array_new(unsigned char, 64);
+
 	uint comparison_count = array_len(op->exps);
 	op->record_offsets = array_new(uint, comparison_count);
 	for(uint i = 0; i < comparison_count; i ++) {
@@ -152,21 +470,27 @@ static Record SortConsume(OpBase *opBase) {
 	// try to get records
 	OpBase *child = op->op.children[0];
 	bool newData = false;
+	op->run_start = rm_get_n_alloced();
 	while((r = OpBase_Consume(child))) {
 		_accumulate(op, r);
 		newData = true;
 	}
 	if(!newData) return NULL;
 
-	if(op->buffer) {
-		sort_r(op->buffer, array_len(op->buffer), sizeof(Record),
-				(heap_cmp)_buffer_elem_cmp, op);
+	if(op->runs != NULL) {
+		// records were spilled, merge runs
+		_merge_init(op);
+	} else if(op->buffer) {
+		sort_r(op->buffer, array_len(op->buffer), sizeof(SortEntry),
+				(heap_cmp)_entry_cmp, op);
 	} else {
-		// heap
+		// heap, keys are no longer required once records are ordered
 		int records_count = Heap_count(op->heap);
-		op->buffer = array_newlen(Record, records_count);
+		op->buffer = array_newlen(SortEntry, records_count);
 		for(int i = records_count-1; i >= 0 ; i--) {
-			op->buffer[i] = Heap_poll(op->heap);
+			SortEntry *e = Heap_poll(op->heap);
+			op->buffer[i] = (SortEntry){.r = e->r, .key = NULL, .key_len = 0};
+			rm_free(e);
 		}
 	}
 
@@ -179,24 +503,29 @@ static OpResult SortReset(OpBase *ctx) {
 	OpSort *op = (OpSort *)ctx;
 	uint recordCount;
 
-	if(op->heap) {
-		recordCount = Heap_count(op->heap);
-		for(uint i = 0; i < recordCount; i++) {
-			Record r = (Record)Heap_poll(op->heap);
-			OpBase_DeleteRecord(r);
-		}
-	}
+	if(op->heap) _free_heap_entries(op);
 
 	if(op->buffer) {
 		recordCount = array_len(op->buffer);
 		for(uint i = op->record_idx; i < recordCount; i++) {
-			Record r = op->buffer[i];
-			OpBase_DeleteRecord(r);
+			OpBase_DeleteRecord(op->buffer[i].r);
 		}
 		array_clear(op->buffer);
+
+		// when sorting the top records the buffer is built once consumed
+		if(op->heap) {
+			array_free(op->buffer);
+			op->buffer = NULL;
+		}
 	}
 
+	_free_runs(op);
+	_free_keys(op);
+
+	op->first      = true;
 	op->record_idx = 0;
+	op->spillable  = true;
+	op->encoded    = true;
 
 	return OP_OK;
 }
@@ -216,11 +545,7 @@ static void SortFree(OpBase *ctx) {
 	OpSort *op = (OpSort *)ctx;
 
 	if(op->heap) {
-		uint recordCount = Heap_count(op->heap);
-		for(uint i = 0; i < recordCount; i++) {
-			Record r = (Record)Heap_poll(op->heap);
-			OpBase_DeleteRecord(r);
-		}
+		_free_heap_entries(op);
 		Heap_free(op->heap);
 		op->heap = NULL;
 	}
@@ -228,13 +553,25 @@ static void SortFree(OpBase *ctx) {
 	if(op->buffer) {
 		uint recordCount = array_len(op->buffer);
 		for(uint i = op->record_idx; i < recordCount; i++) {
-			Record r = op->buffer[i];
-			OpBase_DeleteRecord(r);
+			OpBase_DeleteRecord(op->buffer[i].r);
 		}
 		array_free(op->buffer);
 		op->buffer = NULL;
 	}
 
+	_free_runs(op);
+
+	if(op->key_blocks) {
+		_free_keys(op);
+		array_free(op->key_blocks);
+		op->key_blocks = NULL;
+	}
+
+	if(op->key) {
+		array_free(op->key);
+		op->key = NULL;
+	}
+
 	if(op->record_offsets) {
 		array_free(op->record_offsets);
 		op->record_offsets = NULL;
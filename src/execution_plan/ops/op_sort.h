@@ -7,21 +7,54 @@
 #pragma once
 
 #include "op.h"
+#include <stdio.h>
 #include "../../util/heap.h"
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+// record paired with its sort key
+typedef struct {
+	Record r;                  // record
+	const unsigned char *key;  // record's sort key, see sort_key.h
+	uint32_t key_len;          // key length
+} SortEntry;
+
+// sorted run of records
+// either spilled to disk or the in-memory buffer
+typedef struct {
+	FILE *stream;        // spilled records, NULL for the in-memory run
+	SortEntry head;      // run's smallest entry yet to be emitted
+	unsigned char *key;  // head's key of a spilled run
+} SortRun;
+
+// records are ordered by their sort keys, which are compared with memcmp
+// if a sorted value can't be encoded into a key, all records are compared
+// value by value instead
+//
+// when sorting all records and query memory is constrained
+// sorted runs of records are spilled to temporary files
+// once a run outgrows its share of the query memory capacity
+// runs are k-way merged when records are emitted
 typedef struct {
 	OpBase op;
-	Record *buffer;        // Holds all records.
-	heap_t *heap;          // Holds top n records.
-	bool first;            // first visit to consume func
-	uint skip;             // Total number of records to skip
-	uint record_idx;       // index of current record to return
-	uint limit;            // Total number of records to produce
-	uint *record_offsets;  // All Record offsets containing values to sort by
-	int *directions;       // Array of sort directions(ascending / descending)
-	AR_ExpNode **exps;     // Projected expressons.
+	SortEntry *buffer;           // Holds all records.
+	heap_t *heap;                // Holds top n records.
+	SortRun *runs;               // sorted runs
+	heap_t *merge;               // runs ordered by their head record
+	bool spillable;              // buffered records can be spilled
+	int64_t run_start;           // query memory consumed when current run began
+	bool encoded;                // records are compared by their sort keys
+	unsigned char *key;          // scratch key
+	unsigned char **key_blocks;  // buffered records keys
+	unsigned char *key_block;    // current key block
+	uint32_t key_block_used;     // number of bytes used in current key block
+	bool first;                  // first visit to consume func
+	uint skip;                   // Total number of records to skip
+	uint record_idx;             // index of current record to return
+	uint limit;                  // Total number of records to produce
+	uint *record_offsets;        // All Record offsets containing values to sort by
+	int *directions;             // Array of sort directions(ascending / descending)
+	AR_ExpNode **exps;           // Projected expressons.
 } OpSort;
 
 /* Creates a new Sort operation */
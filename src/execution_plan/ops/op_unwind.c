@@ -115,9 +115,15 @@ static Record UnwindConsume
 		return r;
 	}
 
-	// no child operation to pull data from, we're done
+	// no child operation to pull data from
 	if(op->op.childCount == 0) {
-		return NULL;
+		// static list is depleted
+		if(SI_TYPE(op->list) != T_NULL) return NULL;
+
+		// operation was reset, re-evaluate static list
+		// as it may depend on query parameters
+		_initList(op);
+		return _handoff(op);
 	}
 
 	OpBase *child = op->op.children[0];
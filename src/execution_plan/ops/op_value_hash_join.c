@@ -7,8 +7,8 @@
 #include "op_value_hash_join.h"
 #include "../../value.h"
 #include "../../util/arr.h"
-#include "../../util/qsort.h"
 #include "../../util/rmalloc.h"
+#include "shared/spill_functions.h"
 
 // forward declarations
 static Record ValueHashJoinConsume(OpBase *opBase);
@@ -16,187 +16,459 @@ static OpResult ValueHashJoinReset(OpBase *opBase);
 static OpBase *ValueHashJoinClone(const ExecutionPlan *plan, const OpBase *opBase);
 static void ValueHashJoinFree(OpBase *opBase);
 
-// Determins order between two records by inspecting
-// element stored at postion idx
-static inline int _record_cmp
+// partition holding hash
+#define PARTITION(hash) (((hash) >> 60) % JOIN_SPILL_PARTITIONS)
+
+// returns true if a and b are equal join values
+static inline bool _values_equal
 (
-	Record *l,
-	Record *r,
-	uint *_idx
+	SIValue a,
+	SIValue b
 ) {
-	uint    idx = *_idx;
-	SIValue lv  = Record_Get(*l, idx);
-	SIValue rv  = Record_Get(*r, idx);
-	return SIValue_Compare(lv, rv, NULL);
+	int disjointOrNull = 0;
+	int res = SIValue_Compare(a, b, &disjointOrNull);
+	// NULL and NaN never match
+	return (res == 0 &&
+			disjointOrNull != COMPARED_NULL &&
+			disjointOrNull != COMPARED_NAN);
 }
 
-// performs binary search, returns the leftmost index of a match
-static bool _binarySearchLeftmost
+//------------------------------------------------------------------------------
+// hash table
+//------------------------------------------------------------------------------
+
+// free cached records and hash table
+static void _clear_table
 (
-	uint *idx,
-	Record *array,
-	uint array_len,
-	int join_key_idx,
-	SIValue v
+	OpValueHashJoin *op
 ) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(x, v, NULL) < 0) left = pos + 1;
-		else right = pos;
+	if(op->entries != NULL) {
+		uint32_t n = array_len(op->entries);
+		for(uint32_t i = 0; i < n; i++) {
+			OpBase_DeleteRecord(op->entries[i].r);
+		}
+		array_clear(op->entries);
 	}
 
-	// make sure value was found
-	*idx = left;
+	if(op->buckets != NULL) {
+		rm_free(op->buckets);
+		op->buckets = NULL;
+	}
 
-	if(left == array_len) return false;
+	op->bucket_mask = 0;
+	op->match       = JOIN_NIL;
+}
 
-	x = Record_Get(array[*idx], join_key_idx);
-	// return false if the value wasn't found or evaluated to NULL
-	int disjointOrNull = 0;
-	return (SIValue_Compare(x, v, &disjointOrNull) == 0 &&
-			disjointOrNull != COMPARED_NULL);
+// index cached entries
+// entries sharing the same hash are chained
+static void _build_table
+(
+	OpValueHashJoin *op
+) {
+	ASSERT(op->buckets == NULL);
+
+	uint32_t n = array_len(op->entries);
+
+	// keep load factor under 0.5
+	uint32_t cap = 16;
+	while(cap < n * 2) cap <<= 1;
+
+	op->buckets     = rm_calloc(cap, sizeof(uint32_t));
+	op->bucket_mask = cap - 1;
+
+	for(uint32_t i = 0; i < n; i++) {
+		JoinEntry *e = op->entries + i;
+		uint32_t pos = e->hash & op->bucket_mask;
+
+		// linear probing
+		while(true) {
+			uint32_t slot = op->buckets[pos];
+			if(slot == 0) {
+				// new chain
+				e->next = JOIN_NIL;
+				op->buckets[pos] = i + 1;
+				break;
+			}
+
+			if(op->entries[slot - 1].hash == e->hash) {
+				// prepend to chain
+				e->next = slot - 1;
+				op->buckets[pos] = i + 1;
+				break;
+			}
+
+			pos = (pos + 1) & op->bucket_mask;
+		}
+	}
 }
 
-// performs binary search, returns the rightmost index of a match
-// assuming 'v' exists in 'array'
-static bool _binarySearchRightmost
+// returns the head of the chain matching hash, JOIN_NIL if none
+static uint32_t _lookup
 (
-	uint *idx,
-	Record *array,
-	uint array_len,
-	int join_key_idx,
-	SIValue v
+	const OpValueHashJoin *op,
+	XXH64_hash_t hash
 ) {
-	ASSERT(idx != NULL);
-
-	SIValue x;
-	uint pos = 0;
-	uint left = 0;
-	uint right = array_len;
-
-	while(left < right) {
-		pos = (right + left) / 2;
-		x = Record_Get(array[pos], join_key_idx);
-		if(SIValue_Compare(v, x, NULL) < 0) right = pos;
-		else left = pos + 1;
+	if(op->buckets == NULL) return JOIN_NIL;
+
+	uint32_t pos = hash & op->bucket_mask;
+	while(true) {
+		uint32_t slot = op->buckets[pos];
+		if(slot == 0) return JOIN_NIL;
+		if(op->entries[slot - 1].hash == hash) return slot - 1;
+		pos = (pos + 1) & op->bucket_mask;
 	}
+}
 
-	*idx = right - 1;
-	return true;
+// returns the next cached record matching the current probe value
+// NULL if there are no more matches
+static Record _next_match
+(
+	OpValueHashJoin *op
+) {
+	while(op->match != JOIN_NIL) {
+		JoinEntry *e = op->entries + op->match;
+		op->match = e->next;
+
+		// verify equality, distinct values might share a hash
+		SIValue v = Record_Get(e->r, op->join_value_rec_idx);
+		if(_values_equal(v, op->rhs_v)) return e->r;
+	}
+
+	return NULL;
 }
 
-// retrive the next intersecting record
-// if such exists, otherwise returns NULL
-static Record _get_intersecting_record
+//------------------------------------------------------------------------------
+// spill
+//------------------------------------------------------------------------------
+
+// free spilled partitions
+static void _free_partitions
 (
 	OpValueHashJoin *op
 ) {
-	// no more intersecting records
-	if(op->intersect_idx == -1 ||
-	   op->number_of_intersections == 0) return NULL;
+	if(op->partitions == NULL) return;
+
+	for(int i = 0; i < JOIN_SPILL_PARTITIONS; i++) {
+		JoinPartition *p = op->partitions + i;
+		if(p->build != NULL) fclose(p->build);
+		if(p->probe != NULL) fclose(p->probe);
 
-	Record cr = op->cached_records[op->intersect_idx];
+		uint n = array_len(p->build_resident);
+		for(uint j = 0; j < n; j++) {
+			OpBase_DeleteRecord(p->build_resident[j].r);
+		}
+		array_free(p->build_resident);
+
+		n = array_len(p->probe_resident);
+		for(uint j = 0; j < n; j++) {
+			OpBase_DeleteRecord(p->probe_resident[j].r);
+			SIValue_Free(p->probe_resident[j].v);
+		}
+		array_free(p->probe_resident);
+	}
 
-	// update intersection trackers
-	op->intersect_idx++;
-	op->number_of_intersections--;
+	rm_free(op->partitions);
+	op->partitions = NULL;
+}
+
+// create spill partitions
+// returns false if temporary files can't be created
+static bool _create_partitions
+(
+	OpValueHashJoin *op
+) {
+	ASSERT(op->partitions == NULL);
+
+	op->partitions = rm_calloc(JOIN_SPILL_PARTITIONS, sizeof(JoinPartition));
+	for(int i = 0; i < JOIN_SPILL_PARTITIONS; i++) {
+		JoinPartition *p = op->partitions + i;
+		p->build_resident = array_new(JoinEntry, 0);
+		p->probe_resident = array_new(JoinProbe, 0);
+		p->build = tmpfile();
+		p->probe = tmpfile();
+		if(p->build == NULL || p->probe == NULL) {
+			_free_partitions(op);
+			return false;
+		}
+	}
 
-	return cr;
+	return true;
 }
 
-// look up first intersecting cached record CR position
-// returns false if no intersecting record is found
-static bool _set_intersection_idx
+// adds a build side record to its partition
+static void _spill_build_record
 (
 	OpValueHashJoin *op,
-	SIValue v
+	JoinEntry e
 ) {
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
-	uint record_count = array_len(op->cached_records);
+	JoinPartition *p = op->partitions + PARTITION(e.hash);
 
-	uint leftmost_idx  = 0;
-	uint rightmost_idx = 0;
+	if(!Spill_RecordSupported(e.r)) {
+		array_append(p->build_resident, e);
+		return;
+	}
 
-	if(!_binarySearchLeftmost(&leftmost_idx, op->cached_records,
-				array_len(op->cached_records), op->join_value_rec_idx, v)) {
-		return false;
+	// format:
+	//    hash
+	//    record
+	fwrite_assert(&e.hash, sizeof(XXH64_hash_t), p->build);
+	Spill_WriteRecord(p->build, e.r);
+	OpBase_DeleteRecord(e.r);
+}
+
+// adds a probe side record to its partition
+static void _spill_probe_record
+(
+	OpValueHashJoin *op,
+	JoinProbe e
+) {
+	JoinPartition *p = op->partitions + PARTITION(e.hash);
+
+	if(!Spill_ValueSupported(e.v) || !Spill_RecordSupported(e.r)) {
+		array_append(p->probe_resident, e);
+		return;
 	}
 
-	// value was found
-	// idx points to the first intersecting record
-	// update number_of_intersections to count how many
-	// records share the same value
-	op->intersect_idx = leftmost_idx;
-
-	// count how many records share the same node
-	// reduce search space by truncating left bound
-	bool found = _binarySearchRightmost(&rightmost_idx,
-			op->cached_records + leftmost_idx, record_count - leftmost_idx,
-			op->join_value_rec_idx, v);
-	UNUSED(found);
-	ASSERT(found == true);
-
-	// compensate index
-	rightmost_idx += leftmost_idx;
-	// +1 consider rightmost_idx == leftmost_idx
-	op->number_of_intersections = rightmost_idx - leftmost_idx + 1;
-	ASSERT(op->number_of_intersections > 0);
+	// format:
+	//    hash
+	//    join value
+	//    record
+	fwrite_assert(&e.hash, sizeof(XXH64_hash_t), p->probe);
+	SIValue_ToBinary(p->probe, &e.v);
+	Spill_WriteRecord(p->probe, e.r);
+	OpBase_DeleteRecord(e.r);
+	SIValue_Free(e.v);
+}
 
-	return true;
+// move cached build side records into partitions
+static void _spill
+(
+	OpValueHashJoin *op
+) {
+	if(!_create_partitions(op)) {
+		// unable to spill, keep build side in memory
+		op->spillable = false;
+		return;
+	}
+
+	uint32_t n = array_len(op->entries);
+	for(uint32_t i = 0; i < n; i++) {
+		_spill_build_record(op, op->entries[i]);
+	}
+	array_clear(op->entries);
 }
 
-// sorts cached records by joined value
-void _sort_cached_records
+// partition probe side
+static void _partition_probe
 (
 	OpValueHashJoin *op
 ) {
-	uint idx = op->join_value_rec_idx;
-	sort_r(
-			op->cached_records,
-			array_len(op->cached_records),
-			sizeof(Record),
-			(int(*)(const void*, const void*, void*))_record_cmp,
-			&idx
-		);
+	OpBase *right_child = op->op.children[1];
+
+	Record r;
+	while((r = right_child->consume(right_child))) {
+		SIValue v = AR_EXP_Evaluate(op->rhs_exp, r);
+
+		// NULL doesn't match any value
+		if(SIValue_IsNull(v)) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
+
+		SIValue_Persist(&v);
+		JoinProbe e = {.hash = SIValue_HashCode(v), .r = r, .v = v};
+		_spill_probe_record(op, e);
+	}
 }
 
+// load partition's build side into the hash table
+static void _load_partition
+(
+	OpValueHashJoin *op,
+	int idx
+) {
+	_clear_table(op);
+
+	JoinPartition *p = op->partitions + idx;
+	op->partition_idx = idx;
+	op->probe_idx     = 0;
+
+	// read spilled build records
+	JoinEntry e;
+	fflush(p->build);
+	rewind(p->build);
+	while(fread(&e.hash, sizeof(XXH64_hash_t), 1, p->build) == 1) {
+		e.r = OpBase_CreateRecord((OpBase *)op);
+		bool read = Spill_ReadRecord(p->build, e.r);
+		UNUSED(read);
+		ASSERT(read == true);
+		array_append(op->entries, e);
+	}
+
+	// transfer resident build records
+	uint n = array_len(p->build_resident);
+	for(uint i = 0; i < n; i++) {
+		array_append(op->entries, p->build_resident[i]);
+	}
+	array_clear(p->build_resident);
+
+	// release spilled data
+	fclose(p->build);
+	p->build = NULL;
+
+	_build_table(op);
+
+	fflush(p->probe);
+	rewind(p->probe);
+}
+
+// reads the next probe record of the current partition
+static bool _next_partition_probe
+(
+	OpValueHashJoin *op
+) {
+	JoinPartition *p = op->partitions + op->partition_idx;
+
+	if(p->probe != NULL) {
+		XXH64_hash_t hash;
+		if(fread(&hash, sizeof(XXH64_hash_t), 1, p->probe) == 1) {
+			op->rhs_hash = hash;
+			op->rhs_v    = SIValue_FromBinary(p->probe);
+			op->rhs_rec  = OpBase_CreateRecord((OpBase *)op);
+			bool read = Spill_ReadRecord(p->probe, op->rhs_rec);
+			UNUSED(read);
+			ASSERT(read == true);
+			return true;
+		}
+
+		// spilled probe records depleted
+		fclose(p->probe);
+		p->probe = NULL;
+	}
+
+	if(op->probe_idx < array_len(p->probe_resident)) {
+		JoinProbe *e = p->probe_resident + op->probe_idx;
+		op->rhs_hash = e->hash;
+		op->rhs_v    = e->v;
+		op->rhs_rec  = e->r;
+		// ownership transferred to op
+		e->r = NULL;
+		e->v = SI_NullVal();
+		op->probe_idx++;
+		return true;
+	}
+
+	return false;
+}
+
+//------------------------------------------------------------------------------
+// build & probe
+//------------------------------------------------------------------------------
+
 // caches all records coming from left branch
-void _cache_records
+static void _build
 (
 	OpValueHashJoin *op
 ) {
-	ASSERT(op->cached_records == NULL);
+	ASSERT(!op->built);
 
+	op->built = true;
 	OpBase *left_child = op->op.children[0];
-	op->cached_records = array_new(Record, 32);
 
-	Record r = left_child->consume(left_child);
-	if(!r) return;
-
-	// as long as there's data coming in from left branch
-	do {
+	Record r;
+	while((r = left_child->consume(left_child))) {
 		// evaluate joined expression
 		SIValue v = AR_EXP_Evaluate(op->lhs_exp, r);
 
 		// if the joined value is NULL
 		// it cannot be compared to other values - skip this record
-		if(SIValue_IsNull(v)) continue;
+		if(SIValue_IsNull(v)) {
+			OpBase_DeleteRecord(r);
+			continue;
+		}
 
 		// add joined value to record
 		Record_AddScalar(r, op->join_value_rec_idx, v);
 
-		// cache the record
-		array_append(op->cached_records, r);
-	} while((r = left_child->consume(left_child)));
+		JoinEntry e = {.hash = SIValue_HashCode(v), .r = r, .next = JOIN_NIL};
+		if(op->partitions != NULL) {
+			_spill_build_record(op, e);
+			continue;
+		}
+
+		array_append(op->entries, e);
+		if(op->spillable && Spill_MemoryPressure()) _spill(op);
+	}
+
+	if(op->partitions == NULL) {
+		// build side fits in memory
+		_build_table(op);
+	} else {
+		// partition probe side, partitions are loaded on demand
+		_partition_probe(op);
+		op->partition_idx = -1;
+	}
+}
+
+// release current probe record
+static void _release_probe
+(
+	OpValueHashJoin *op
+) {
+	if(op->rhs_rec == NULL) return;
+
+	OpBase_DeleteRecord(op->rhs_rec);
+	SIValue_Free(op->rhs_v);
+	op->rhs_rec = NULL;
+	op->rhs_v   = SI_NullVal();
+	op->match   = JOIN_NIL;
+}
+
+// pull the next probe record
+// returns false if probe side is depleted
+static bool _next_probe
+(
+	OpValueHashJoin *op
+) {
+	ASSERT(op->rhs_rec == NULL);
+
+	if(op->partitions != NULL) {
+		// advance to next partition once current one is depleted
+		while(op->partition_idx < 0 || !_next_partition_probe(op)) {
+			if(op->partition_idx + 1 == JOIN_SPILL_PARTITIONS) {
+				_clear_table(op);
+				return false;
+			}
+			_load_partition(op, op->partition_idx + 1);
+		}
+	} else {
+		OpBase *right_child = op->op.children[1];
+		while(true) {
+			Record r = right_child->consume(right_child);
+			if(r == NULL) return false;
+
+			// get value on which we're intersecting
+			SIValue v = AR_EXP_Evaluate(op->rhs_exp, r);
+
+			// NULL doesn't match any value
+			if(SIValue_IsNull(v)) {
+				OpBase_DeleteRecord(r);
+				continue;
+			}
+
+			// R is handed off to joined records
+			// make sure V remains valid while matching
+			SIValue_Persist(&v);
+
+			op->rhs_rec  = r;
+			op->rhs_v    = v;
+			op->rhs_hash = SIValue_HashCode(v);
+			break;
+		}
+	}
+
+	op->match = _lookup(op, op->rhs_hash);
+	return true;
 }
 
 // string representation of operation
@@ -230,18 +502,26 @@ static void ValueHashJoinToString
 // creates a new valueHashJoin operation
 OpBase *NewValueHashJoin
 (
-	const ExecutionPlan *plan,
-	AR_ExpNode *lhs_exp,
-	AR_ExpNode *rhs_exp
+	const ExecutionPlan *plan,  // execution plan
+	AR_ExpNode *lhs_exp,        // left hand side expression to join on
+	AR_ExpNode *rhs_exp         // right hand side expression to join on
 ) {
 	OpValueHashJoin *op = rm_malloc(sizeof(OpValueHashJoin));
 
-	op->rhs_rec                 = NULL;
-	op->lhs_exp                 = lhs_exp;
-	op->rhs_exp                 = rhs_exp;
-	op->intersect_idx           = -1;
-	op->cached_records          = NULL;
-	op->number_of_intersections = 0;
+	op->built          = false;
+	op->match          = JOIN_NIL;
+	op->rhs_v          = SI_NullVal();
+	op->rhs_rec        = NULL;
+	op->lhs_exp        = lhs_exp;
+	op->rhs_exp        = rhs_exp;
+	op->entries        = array_new(JoinEntry, 32);
+	op->buckets        = NULL;
+	op->rhs_hash       = 0;
+	op->spillable      = true;
+	op->probe_idx      = 0;
+	op->partitions     = NULL;
+	op->bucket_mask    = 0;
+	op->partition_idx  = -1;
 
 	// set our Op operations
 	OpBase_Init((OpBase *)op, OPType_VALUE_HASH_JOIN, "Value Hash Join",
@@ -253,7 +533,7 @@ OpBase *NewValueHashJoin
 	return (OpBase *)op;
 }
 
-// Produce a record by joining
+// produce a record by joining
 // records coming from the left and right hand side
 // of this operation
 static Record ValueHashJoinConsume
@@ -261,65 +541,35 @@ static Record ValueHashJoinConsume
 	OpBase *opBase
 ) {
 	OpValueHashJoin *op = (OpValueHashJoin *)opBase;
-	OpBase *right_child = op->op.children[1];
 
 	// eager, pull from left branch until depleted
-	if(op->cached_records == NULL) {
-		_cache_records(op);
-		// sort cache on intersect node ID
-		_sort_cached_records(op);
-	}
+	if(!op->built) _build(op);
 
 	// try to produce a record:
 	// given a right hand side record R,
 	// evaluate V = exp on R,
-	// see if there are any cached records
-	// which V evaluated to V:
-	// X in cached_records and X[idx] = V
-	// return merged record:
-	// X merged with R
-
-	Record l;
-	if(op->number_of_intersections > 0) {
-		while((l = _get_intersecting_record(op))) {
-			// clone cached record before merging rhs
-			Record c = OpBase_CloneRecord(l);
-			Record_Merge(c, op->rhs_rec);
-			return c;
-		}
-	}
-
-	// if we're here there are no more
-	// left hand side records which intersect with R
-	// discard R
-	if(op->rhs_rec) OpBase_DeleteRecord(op->rhs_rec);
-
-	// try to get new right hand side record
-	// which intersect with a left hand side record
+	// walk cached records X which hash as V
+	// return merged record X merged with R if X[idx] = V
 	while(true) {
-		// pull from right branch
-		op->rhs_rec = right_child->consume(right_child);
-		if(!op->rhs_rec) return NULL;
-
-		// get value on which we're intersecting
-		SIValue v = AR_EXP_Evaluate(op->rhs_exp, op->rhs_rec);
-
-		bool found_intersection = _set_intersection_idx(op, v);
-		SIValue_Free(v);
-		// no intersection, discard R
-		if(!found_intersection) {
-			OpBase_DeleteRecord(op->rhs_rec);
-			continue;
+		if(op->rhs_rec != NULL) {
+			Record l = _next_match(op);
+			if(l != NULL) {
+				// clone cached record before merging rhs
+				// spilled partitions are released once joined
+				// as such their records must be deep cloned
+				Record c = (op->partitions != NULL)
+					? OpBase_DeepCloneRecord(l)
+					: OpBase_CloneRecord(l);
+				Record_Merge(c, op->rhs_rec);
+				return c;
+			}
+
+			// no more left hand side records intersect with R
+			// discard R
+			_release_probe(op);
 		}
 
-		// found atleast one intersecting record
-		l = _get_intersecting_record(op);
-
-		// clone cached record before merging rhs
-		Record c = OpBase_CloneRecord(l);
-		Record_Merge(c, op->rhs_rec);
-
-		return c;
+		if(!_next_probe(op)) return NULL;
 	}
 }
 
@@ -328,24 +578,15 @@ static OpResult ValueHashJoinReset
 	OpBase *ctx
 ) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	op->intersect_idx = -1;
-	op->number_of_intersections = 0;
 
-	// clear cached records
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
+	_release_probe(op);
+	_clear_table(op);
+	_free_partitions(op);
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
-	}
+	op->built         = false;
+	op->spillable     = true;
+	op->probe_idx     = 0;
+	op->partition_idx = -1;
 
 	return OP_OK;
 }
@@ -362,22 +603,19 @@ static inline OpBase *ValueHashJoinClone
 }
 
 // frees ValueHashJoin
-static void ValueHashJoinFree(OpBase *ctx) {
+static void ValueHashJoinFree
+(
+	OpBase *ctx
+) {
 	OpValueHashJoin *op = (OpValueHashJoin *)ctx;
-	// free cached records
-	if(op->rhs_rec) {
-		OpBase_DeleteRecord(op->rhs_rec);
-		op->rhs_rec = NULL;
-	}
 
-	if(op->cached_records) {
-		uint record_count = array_len(op->cached_records);
-		for(uint i = 0; i < record_count; i++) {
-			Record r = op->cached_records[i];
-			OpBase_DeleteRecord(r);
-		}
-		array_free(op->cached_records);
-		op->cached_records = NULL;
+	_release_probe(op);
+	_clear_table(op);
+	_free_partitions(op);
+
+	if(op->entries) {
+		array_free(op->entries);
+		op->entries = NULL;
 	}
 
 	if(op->lhs_exp) {
@@ -390,4 +628,3 @@ static void ValueHashJoinFree(OpBase *ctx) {
 		op->rhs_exp = NULL;
 	}
 }
-
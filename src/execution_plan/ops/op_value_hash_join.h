@@ -10,16 +10,69 @@
 #include "../execution_plan.h"
 #include "../../arithmetic/arithmetic_expression.h"
 
+#include <stdio.h>
+
+// ValueHashJoin joins records coming from its left and right branches
+// on the equality of a value computed for each record
+//
+// the left branch (build side) is consumed eagerly, its records are hashed
+// by their join value into an open addressing table, records sharing
+// the same hash are chained
+// records from the right branch (probe side) are streamed, each probe
+// walks the chain matching its value's hash, verifying equality
+//
+// when a memory capacity is set and the build side exceeds
+// half of it, both sides are partitioned by hash into temporary files
+// partitions are then joined one at a time
+
+#define JOIN_NIL UINT32_MAX       // end of chain
+#define JOIN_SPILL_PARTITIONS 16  // number of spill partitions
+
+// cached build side record
+typedef struct {
+	XXH64_hash_t hash;  // join value hash
+	Record r;           // cached record
+	uint32_t next;      // next entry sharing hash, JOIN_NIL if last
+} JoinEntry;
+
+// probe side record held by a spilled partition
+typedef struct {
+	XXH64_hash_t hash;  // join value hash
+	Record r;           // probe record
+	SIValue v;          // join value
+} JoinProbe;
+
+// spilled partition
+typedef struct {
+	FILE *build;                // spilled build side records
+	FILE *probe;                // spilled probe side records
+	JoinEntry *build_resident;  // build records which can't be spilled
+	JoinProbe *probe_resident;  // probe records which can't be spilled
+} JoinPartition;
+
 typedef struct {
 	OpBase op;
-	Record rhs_rec;                     // Right hand side record.
-	AR_ExpNode *lhs_exp;                // Left hand side expression to join on.
-	AR_ExpNode *rhs_exp;                // Right hand side expression to join on.
-	int64_t intersect_idx;              // Current intersection, < number_of_intersections
-	Record *cached_records;             // Cached left hand side records.
-	uint join_value_rec_idx;            // position on joined expression within record.
-	int64_t number_of_intersections;    // Number of intersections located.
+	Record rhs_rec;                 // right hand side record
+	SIValue rhs_v;                  // right hand side join value
+	XXH64_hash_t rhs_hash;          // right hand side join value hash
+	AR_ExpNode *lhs_exp;            // left hand side expression to join on
+	AR_ExpNode *rhs_exp;            // right hand side expression to join on
+	uint join_value_rec_idx;        // position of joined value within record
+	bool built;                     // build side consumed
+	bool spillable;                 // build side can be spilled
+	JoinEntry *entries;             // cached left hand side records
+	uint32_t *buckets;              // open addressing table, entry idx + 1
+	uint32_t bucket_mask;           // number of buckets - 1
+	uint32_t match;                 // next candidate entry, JOIN_NIL if none
+	JoinPartition *partitions;      // spilled partitions, NULL if not spilled
+	int partition_idx;              // partition currently joined
+	uint probe_idx;                 // position within resident probe records
 } OpValueHashJoin;
 
-/* Creates a new ValueHashJoin operation */
-OpBase *NewValueHashJoin(const ExecutionPlan *plan, AR_ExpNode *lhs_exp, AR_ExpNode *rhs_exp);
+// creates a new ValueHashJoin operation
+OpBase *NewValueHashJoin
+(
+	const ExecutionPlan *plan,  // execution plan
+	AR_ExpNode *lhs_exp,        // left hand side expression to join on
+	AR_ExpNode *rhs_exp         // right hand side expression to join on
+);
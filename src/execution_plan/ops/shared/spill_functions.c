@@ -0,0 +1,168 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "spill_functions.h"
+#include "../../../util/rmalloc.h"
+#include "../../../datatypes/array.h"
+
+// returns true if eager operations should spill their data
+bool Spill_MemoryPressure(void) {
+	int64_t capacity = rm_get_mem_capacity();
+	return (capacity > 0 && rm_get_n_alloced() > capacity / 2);
+}
+
+// returns true if v can be written to a spill file
+bool Spill_ValueSupported
+(
+	SIValue v  // value to inspect
+) {
+	switch(SI_TYPE(v)) {
+		case T_NULL:
+		case T_BOOL:
+		case T_INT64:
+		case T_DOUBLE:
+		case T_STRING:
+		case T_POINT:
+		case T_DATETIME:
+		case T_LOCALDATETIME:
+		case T_DATE:
+		case T_TIME:
+		case T_LOCALTIME:
+		case T_DURATION:
+			return true;
+		case T_ARRAY: {
+			uint32_t n = SIArray_Length(v);
+			for(uint32_t i = 0; i < n; i++) {
+				if(!Spill_ValueSupported(SIArray_Get(v, i))) return false;
+			}
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+// returns true if all of r's entries can be written to a spill file
+bool Spill_RecordSupported
+(
+	const Record r  // record to inspect
+) {
+	ASSERT(r != NULL);
+
+	uint n = Record_length(r);
+	for(uint i = 0; i < n; i++) {
+		RecordEntryType t = Record_GetType(r, i);
+		switch(t) {
+			case REC_TYPE_UNKNOWN:
+			case REC_TYPE_NODE:
+			case REC_TYPE_EDGE:
+				break;
+			case REC_TYPE_SCALAR:
+				if(!Spill_ValueSupported(Record_Get(r, i))) return false;
+				break;
+			default:
+				return false;
+		}
+	}
+
+	return true;
+}
+
+// writes r's entries to stream
+void Spill_WriteRecord
+(
+	FILE *stream,   // stream to write to
+	const Record r  // record to write
+) {
+	ASSERT(r      != NULL);
+	ASSERT(stream != NULL);
+	ASSERT(Spill_RecordSupported(r));
+
+	// format:
+	//    number of entries
+	//    entries:
+	//       index
+	//       type
+	//       value
+
+	uint32_t n = 0;
+	uint len = Record_length(r);
+	for(uint i = 0; i < len; i++) {
+		if(Record_GetType(r, i) != REC_TYPE_UNKNOWN) n++;
+	}
+
+	fwrite_assert(&n, sizeof(uint32_t), stream);
+
+	for(uint32_t i = 0; i < len; i++) {
+		RecordEntryType t = Record_GetType(r, i);
+		if(t == REC_TYPE_UNKNOWN) continue;
+
+		fwrite_assert(&i, sizeof(uint32_t), stream);
+		fwrite_assert(&t, sizeof(RecordEntryType), stream);
+
+		switch(t) {
+			case REC_TYPE_NODE:
+				fwrite_assert(Record_GetNode(r, i), sizeof(Node), stream);
+				break;
+			case REC_TYPE_EDGE:
+				fwrite_assert(Record_GetEdge(r, i), sizeof(Edge), stream);
+				break;
+			case REC_TYPE_SCALAR: {
+				SIValue v = Record_Get(r, i);
+				SIValue_ToBinary(stream, &v);
+				break;
+			}
+			default:
+				ASSERT(false && "unexpected record entry type");
+				break;
+		}
+	}
+}
+
+// reads a record off stream into r
+// returns false if stream is depleted
+bool Spill_ReadRecord
+(
+	FILE *stream,  // stream to read from
+	Record r       // record to populate
+) {
+	ASSERT(r      != NULL);
+	ASSERT(stream != NULL);
+
+	uint32_t n;
+	if(fread(&n, sizeof(uint32_t), 1, stream) != 1) return false;
+
+	for(uint32_t i = 0; i < n; i++) {
+		Node node;
+		Edge edge;
+		uint32_t idx;
+		RecordEntryType t;
+
+		fread_assert(&idx, sizeof(uint32_t), stream);
+		fread_assert(&t, sizeof(RecordEntryType), stream);
+
+		switch(t) {
+			case REC_TYPE_NODE:
+				fread_assert(&node, sizeof(Node), stream);
+				Record_AddNode(r, idx, node);
+				break;
+			case REC_TYPE_EDGE:
+				fread_assert(&edge, sizeof(Edge), stream);
+				Record_AddEdge(r, idx, edge);
+				break;
+			case REC_TYPE_SCALAR:
+				// value is owned by the record
+				Record_AddScalar(r, idx, SIValue_FromBinary(stream));
+				break;
+			default:
+				ASSERT(false && "unexpected record entry type");
+				break;
+		}
+	}
+
+	return true;
+}
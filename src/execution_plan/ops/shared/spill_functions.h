@@ -0,0 +1,50 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdio.h>
+#include "../../record.h"
+
+// spill functions write records to and read records from a temporary file
+// allowing eager operations to offload data when memory is constrained
+//
+// nodes and edges are written as is, their attribute sets are referenced
+// rather than copied, as such spilled records can only be read back
+// by the process and query which wrote them
+
+// returns true if eager operations should spill their data
+// spilling kicks in once half of the query memory capacity is consumed
+// always false when query memory capacity isn't limited
+bool Spill_MemoryPressure(void);
+
+// returns true if v can be written to a spill file
+bool Spill_ValueSupported
+(
+	SIValue v  // value to inspect
+);
+
+// returns true if all of r's entries can be written to a spill file
+bool Spill_RecordSupported
+(
+	const Record r  // record to inspect
+);
+
+// writes r's entries to stream
+void Spill_WriteRecord
+(
+	FILE *stream,   // stream to write to
+	const Record r  // record to write
+);
+
+// reads a record off stream into r
+// r is expected to be empty
+// returns false if stream is depleted
+bool Spill_ReadRecord
+(
+	FILE *stream,  // stream to read from
+	Record r       // record to populate
+);
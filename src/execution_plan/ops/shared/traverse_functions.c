@@ -169,3 +169,26 @@ void EdgeTraverseCtx_Free
 	rm_free(edge_ctx);
 }
 
+uint TraverseBatch_NextSize
+(
+	uint cap,         // current batch size
+	uint max,         // maximum batch size
+	bool full,        // previous batch was full
+	GrB_Index nvals   // number of entries in previous batch result
+) {
+	ASSERT(cap > 0);
+	ASSERT(cap <= max);
+
+	// previous batch result is too large, shrink batch
+	if(nvals > TRAVERSE_BATCH_MAX_RESULT) {
+		cap = cap / 2;
+		return (cap > 0) ? cap : 1;
+	}
+
+	// child is depleted or doubling the batch is likely to exceed the
+	// result cap, keep current size
+	if(!full || nvals > TRAVERSE_BATCH_MAX_RESULT / 2) return cap;
+
+	// grow batch
+	return (cap > max / 2) ? max : cap * 2;
+}
@@ -9,6 +9,24 @@
 #include "../../execution_plan.h"
 #include "../../../arithmetic/algebraic_expression.h"
 
+// traversal ops such as CondTraverse and ExpandInto accumulate a batch of
+// records, evaluate their algebraic expression once for the entire batch
+// and emit the batch results
+//
+// batches start small, doubling in size each time a full batch is consumed
+// growth stops at TRAVERSE_BATCH_MAX records, at the op's limit
+// or once a batch result exceeds TRAVERSE_BATCH_MAX_RESULT entries
+// in which case the batch size is halved
+
+// initial number of records in a batch
+#define TRAVERSE_BATCH_MIN 16
+
+// maximum number of records in a batch
+#define TRAVERSE_BATCH_MAX 16384
+
+// maximum number of entries in a batch result matrix
+#define TRAVERSE_BATCH_MAX_RESULT (1 << 20)
+
 // container struct for traversing and populating referenced edges in
 // traversal ops like CondTraverse and ExpandInto
 typedef struct {
@@ -61,3 +79,12 @@ void EdgeTraverseCtx_Free
 	EdgeTraverseCtx *edge_ctx
 );
 
+// compute the number of records to accumulate in the next batch
+uint TraverseBatch_NextSize
+(
+	uint cap,         // current batch size
+	uint max,         // maximum batch size
+	bool full,        // previous batch was full
+	GrB_Index nvals   // number of entries in previous batch result
+);
+
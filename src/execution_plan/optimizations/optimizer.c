@@ -60,5 +60,8 @@ void optimizePlan(ExecutionPlan *plan) {
 
 	// let operations know about specified skip(s)
 	applySkip(plan);
+
+	// merge filtered scans performed in parallel
+	parallelizeScans(plan);
 }
 
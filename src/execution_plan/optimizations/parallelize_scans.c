@@ -0,0 +1,103 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "../ops/ops.h"
+#include "../../util/arr.h"
+#include "../../configuration/config.h"
+#include "../execution_plan_build/execution_plan_util.h"
+#include "../execution_plan_build/execution_plan_modify.h"
+
+// parallelizeScans looks for tap label or all node scans
+// followed by one or more filters:
+//
+// Filter
+//     Node By Label Scan
+//
+// such scans can be split into ranges of node IDs, each scanned and filtered
+// independently by a different thread
+// an Exchange operation is introduced on top of the filters to merge the
+// output of the parallel scan:
+//
+// Exchange
+//     Filter
+//         Node By Label Scan
+//
+// scans without filters aren't parallelized as the work of producing records
+// is performed by the exchange, unless the scan feeds an aggregation
+// which can be split into partial aggregations:
+//
+// Aggregate
+//     Exchange
+//         Node By Label Scan
+//
+// in which case each thread aggregates the records it scans
+// plans which modify the graph aren't parallelized
+
+// returns true if op or any of its descendants modifies the graph
+static bool _writes(OpBase *op) {
+	if(OpBase_IsWriter(op)) return true;
+
+	for(uint i = 0; i < op->childCount; i++) {
+		if(_writes(op->children[i])) return true;
+	}
+
+	return false;
+}
+
+void parallelizeScans(ExecutionPlan *plan) {
+	ASSERT(plan != NULL);
+
+	uint64_t workers = 0;
+	Config_Option_get(Config_PARALLEL_SCAN_WORKERS, &workers);
+	if(workers <= 1) return;
+
+	// workers must not race the query's own modifications
+	if(_writes(plan->root)) return;
+
+	const OPType types[] = {
+		OPType_ALL_NODE_SCAN,
+		OPType_NODE_BY_LABEL_SCAN,
+		OPType_NODE_BY_LABEL_AND_ID_SCAN
+	};
+
+	OpBase **scans = ExecutionPlan_CollectOpsMatchingTypes(plan->root, types,
+			sizeof(types) / sizeof(types[0]));
+
+	uint scan_count = array_len(scans);
+	for(uint i = 0; i < scan_count; i++) {
+		OpBase *scan = scans[i];
+		if(!Exchange_ParallelizableScan(scan)) continue;
+
+		// climb up the chain of filters applied to the scan
+		OpBase *top = scan;
+		while(top->parent != NULL                     &&
+			  OpBase_Type(top->parent) == OPType_FILTER &&
+			  top->parent->plan == scan->plan) {
+			top = top->parent;
+		}
+
+		// already parallelized
+		OpBase *parent = top->parent;
+		if(parent != NULL && OpBase_Type(parent) == OPType_EXCHANGE) {
+			continue;
+		}
+
+		// scan feeds a combinable aggregation
+		bool aggregate = (parent != NULL                           &&
+				OpBase_Type(parent) == OPType_AGGREGATE  &&
+				parent->plan == scan->plan               &&
+				AggregateParallelizable(parent));
+
+		// no filters
+		if(top == scan && !aggregate) continue;
+
+		OpBase *exchange = NewExchangeOp(scan->plan);
+		ExecutionPlan_PushBelow(top, exchange);
+	}
+
+	array_free(scans);
+}
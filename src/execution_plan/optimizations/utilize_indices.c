@@ -148,6 +148,13 @@ static bool _applicable_predicate(const char* filtered_entity,
 			break;
 		}
 
+		// a parameter's value is resolved once the index query is built
+		// such that the plan doesn't depend on the parameter's value
+		if(AR_EXP_IsParameter(exp)) {
+			res = true;
+			break;
+		}
+
 		// determine whether 'exp' represents a scalar
 		bool scalar = AR_EXP_ReduceToScalar(exp, true, &v);
 		if(scalar) {
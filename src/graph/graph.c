@@ -9,8 +9,14 @@
 #include "../util/arr.h"
 #include "../util/rmalloc.h"
 #include "rg_matrix/rg_matrix_iter.h"
+#include "../configuration/config.h"
 #include "../util/datablock/oo_datablock.h"
 
+// when delta matrices are flushed in the background, readers flush a matrix
+// only once its pending changes exceed DELTA_MAX_PENDING_CHANGES by this factor
+// bounding the size of deltas in case compaction falls behind
+#define BACKGROUND_FLUSH_BACKLOG 4
+
 //------------------------------------------------------------------------------
 // Forward declarations
 //------------------------------------------------------------------------------
@@ -66,6 +72,7 @@ void Graph_AcquireWriteLock(Graph *g) {
 
 	pthread_rwlock_wrlock(&g->_rwlock);
 	g->_writelocked = true;
+	g->write_epoch++;
 }
 
 // Release the held lock
@@ -218,7 +225,19 @@ void _MatrixSynchronize
 	// we need to call 'RG_Matrix_isDirty' again
 	// as 'RG_Matrix_resize' might require 'wait' for HyperSparse matrices
 	if(RG_Matrix_isDirty(m)) {
-		info = RG_Matrix_wait(m, false);
+		bool background_flush;
+		Config_Option_get(Config_DELTA_BACKGROUND_FLUSH, &background_flush);
+
+		if(background_flush) {
+			// leave pending changes to the background compaction
+			uint64_t delta_max_pending_changes;
+			Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES,
+					&delta_max_pending_changes);
+			info = RG_Matrix_waitThreshold(m,
+					delta_max_pending_changes * BACKGROUND_FLUSH_BACKLOG);
+		} else {
+			info = RG_Matrix_wait(m, false);
+		}
 		ASSERT(info == GrB_SUCCESS);
 	}
 
@@ -331,10 +350,6 @@ void Graph_ApplyAllPending
 	M = Graph_GetAdjacencyMatrix(g, false);
 	RG_Matrix_wait(M, force_flush);
 
-	// sync node labels matrix
-	M = Graph_GetNodeLabelMatrix(g);
-	RG_Matrix_wait(M, force_flush);
-
 	// sync the zero matrix
 	M = Graph_GetZeroMatrix(g);
 	RG_Matrix_wait(M, force_flush);
@@ -381,17 +396,6 @@ bool Graph_Pending
 		return true;
 	}
 
-	//--------------------------------------------------------------------------
-	// see if node_labels matrix contains pending changes
-	//--------------------------------------------------------------------------
-
-	M = g->node_labels;
-	info = RG_Matrix_pending(M, &pending);
-	ASSERT(info == GrB_SUCCESS);
-	if(pending) {
-		return true;
-	}
-
 	//--------------------------------------------------------------------------
 	// see if the zero matrix contains pending changes
 	//--------------------------------------------------------------------------
@@ -434,6 +438,90 @@ bool Graph_Pending
 	return false;
 }
 
+// returns the graph's idx'th modifiable matrix, NULL if idx is out of range
+// matrices are ordered: adjacency, labels, relations
+static RG_Matrix _Graph_GetMatrixByIdx
+(
+	const Graph *g,
+	uint idx
+) {
+	if(idx == 0) return g->adjacency_matrix;
+	idx -= 1;
+
+	uint n = array_len(g->labels);
+	if(idx < n) return g->labels[idx];
+	idx -= n;
+
+	n = array_len(g->relations);
+	if(idx < n) return g->relations[idx];
+
+	return NULL;
+}
+
+void Graph_CompactMatrices
+(
+	Graph *g,
+	uint64_t delta_max_pending_changes
+) {
+	ASSERT(g != NULL);
+	ASSERT(g->_writelocked == false);
+
+	for(uint i = 0;; i++) {
+		//----------------------------------------------------------------------
+		// build compacted matrix under read lock
+		//----------------------------------------------------------------------
+
+		Graph_AcquireReadLock(g);
+
+		RG_Matrix M = _Graph_GetMatrixByIdx(g, i);
+		if(M == NULL) {
+			Graph_ReleaseLock(g);
+			break;
+		}
+
+		// writers are excluded, M's pending changes are stable
+		uint64_t   epoch   = g->write_epoch;
+		GrB_Matrix m       = NULL;
+		GrB_Matrix tm      = NULL;
+		bool       compact = false;
+
+		// exclude readers synchronizing M
+		RG_Matrix_Lock(M);
+
+		// materialize M without flushing, same as readers do
+		if(RG_Matrix_isDirty(M)) {
+			RG_Matrix_waitThreshold(M, UINT64_MAX);
+		}
+
+		if(RG_Matrix_requiresCompaction(M, delta_max_pending_changes)) {
+			RG_Matrix_compact(M, &m, &tm);
+			compact = true;
+		}
+
+		RG_Matrix_Unlock(M);
+		Graph_ReleaseLock(g);
+
+		if(!compact) continue;
+
+		//----------------------------------------------------------------------
+		// swap compacted matrix in under write lock
+		//----------------------------------------------------------------------
+
+		Graph_AcquireWriteLock(g);
+
+		// discard compacted matrix if the graph was modified in the meantime
+		// acquiring the write lock bumps the epoch by one
+		if(g->write_epoch == epoch + 1 && _Graph_GetMatrixByIdx(g, i) == M) {
+			RG_Matrix_swapCompacted(M, &m, &tm);
+		} else {
+			GrB_Matrix_free(&m);
+			GrB_Matrix_free(&tm);
+		}
+
+		Graph_ReleaseLock(g);
+	}
+}
+
 //------------------------------------------------------------------------------
 // Graph API
 //------------------------------------------------------------------------------
@@ -456,11 +544,13 @@ Graph *Graph_New
 	UNUSED(info);
 
 	GrB_Index n = Graph_RequiredMatrixDim(g);
-	RG_Matrix_new(&g->node_labels, GrB_BOOL, n, n);
 	RG_Matrix_new(&g->adjacency_matrix, GrB_BOOL, n, n);
 	RG_Matrix_new(&g->adjacency_matrix->transposed, GrB_BOOL, n, n);
 	RG_Matrix_new(&g->_zero_matrix, GrB_BOOL, n, n);
 
+	// init node labels mapping
+	NodeLabels_Init(&g->node_labels);
+
 	// init graph statistics
 	GraphStatistics_init(&g->stats);
 
@@ -723,7 +813,6 @@ void Graph_LabelNode
 	GrB_Info info;
 	UNUSED(info);
 
-	RG_Matrix nl = Graph_GetNodeLabelMatrix(g);
 	for(uint i = 0; i < lbl_count; i++) {
 		LabelID l = lbls[i];
 		RG_Matrix L = Graph_GetLabelMatrix(g, l);
@@ -733,8 +822,7 @@ void Graph_LabelNode
 		ASSERT(info == GrB_SUCCESS);
 
 		// map this label in this node's set of labels
-		info = RG_Matrix_setElement_BOOL(nl, id, l);
-		ASSERT(info == GrB_SUCCESS);
+		NodeLabels_Set(&g->node_labels, id, l);
 
 		// update labels statistics
 		GraphStatistics_IncNodeCount(&g->stats, l, 1);
@@ -751,12 +839,8 @@ bool Graph_IsNodeLabeled
 	ASSERT(g  != NULL);
 	ASSERT(id != INVALID_ENTITY_ID);
 
-	bool x;
-	// consult with labels matrix
-	RG_Matrix nl = Graph_GetNodeLabelMatrix(g);
-	GrB_Info info = RG_Matrix_extractElement_BOOL(&x, nl, id, l);
-	ASSERT(info == GrB_SUCCESS || info == GrB_NO_VALUE);
-	return info == GrB_SUCCESS;
+	// consult with node labels mapping
+	return NodeLabels_Test(&g->node_labels, id, l);
 }
 
 // dissociates each label in 'lbls' from given node
@@ -775,7 +859,6 @@ void Graph_RemoveNodeLabels
 	GrB_Info info;
 	UNUSED(info);
 
-	RG_Matrix nl = Graph_GetNodeLabelMatrix(g);
 	for(uint i = 0; i < lbl_count; i++) {
 		LabelID   l = lbls[i];
 		RG_Matrix M = Graph_GetLabelMatrix(g, l);
@@ -785,8 +868,7 @@ void Graph_RemoveNodeLabels
 		ASSERT(info == GrB_SUCCESS);
 
 		// remove this label from node's set of labels
-		info = RG_Matrix_removeElement_BOOL(nl, id, l);
-		ASSERT(info == GrB_SUCCESS);
+		NodeLabels_Unset(&g->node_labels, id, l);
 
 		// a label was removed from node, update statistics
 		GraphStatistics_DecNodeCount(&g->stats, l, 1);
@@ -1060,30 +1142,8 @@ uint Graph_GetNodeLabels
 	ASSERT(n      != NULL);
 	ASSERT(labels != NULL);
 
-	GrB_Info res;
-	UNUSED(res);
-
-	// GrB_Col_extract will iterate over the range of the output size
-	RG_Matrix M = Graph_GetNodeLabelMatrix(g);
-
 	EntityID id = ENTITY_GET_ID(n);
-	RG_MatrixTupleIter iter = {0};
-	res = RG_MatrixTupleIter_AttachRange(&iter, M, id, id);
-	ASSERT(res == GrB_SUCCESS);
-
-	uint i = 0;
-
-	for(; i < label_count; i++) {
-		GrB_Index col;
-		res = RG_MatrixTupleIter_next_BOOL(&iter, NULL, &col, NULL);
-		labels[i] = col;
-
-		if(res == GxB_EXHAUSTED) break;
-	}
-
-	RG_MatrixTupleIter_detach(&iter);
-
-	return i;
+	return NodeLabels_Get(&g->node_labels, id, labels, label_count);
 }
 
 // removes edges from Graph and updates graph relevant matrices
@@ -1328,19 +1388,6 @@ bool Graph_RelationshipContainsMultiEdge
 	return (Graph_RelationEdgeCount(g, r) > nvals);
 }
 
-RG_Matrix Graph_GetNodeLabelMatrix
-(
-	const Graph *g
-) {
-	ASSERT(g != NULL);
-
-	RG_Matrix m = g->node_labels;
-
-	g->SynchronizeMatrix(g, m);
-
-	return m;
-}
-
 RG_Matrix Graph_GetZeroMatrix
 (
 	const Graph *g
@@ -1378,7 +1425,7 @@ static void _Graph_Free
 	uint32_t labelCount = array_len(g->labels);
 	for(int i = 0; i < labelCount; i++) RG_Matrix_free(&g->labels[i]);
 	array_free(g->labels);
-	RG_Matrix_free(&g->node_labels);
+	NodeLabels_Free(&g->node_labels);
 
 	it = is_full_graph ? Graph_ScanNodes(g) : DataBlock_FullScan(g->nodes);
 	while((set = (AttributeSet *)DataBlockIterator_Next(it, NULL)) != NULL) {
@@ -12,6 +12,7 @@
 #include "entities/node.h"
 #include "entities/edge.h"
 #include "../redismodule.h"
+#include "node_labels.h"
 #include "graph_statistics.h"
 #include "rg_matrix/rg_matrix.h"
 #include "../util/datablock/datablock.h"
@@ -49,11 +50,12 @@ struct Graph {
 	DataBlock *edges;                  // graph edges stored in blocks
 	RG_Matrix adjacency_matrix;        // adjacency matrix, holds all graph connections
 	RG_Matrix *labels;                 // label matrices
-	RG_Matrix node_labels;             // mapping of all node IDs to all labels possessed by each node
+	NodeLabels node_labels;            // mapping of all node IDs to all labels possessed by each node
 	RG_Matrix *relations;              // relation matrices
 	RG_Matrix _zero_matrix;            // zero matrix
 	pthread_rwlock_t _rwlock;          // read-write lock scoped to this specific graph
 	bool _writelocked;                 // true if the read-write lock was acquired by a writer
+	uint64_t write_epoch;              // number of write lock acquisitions
 	SyncMatrixFunc SynchronizeMatrix;  // function pointer to matrix synchronization routine
 	GraphStatistics stats;             // graph related statistics
 };
@@ -86,6 +88,18 @@ void Graph_ApplyAllPending
 	bool force_flush    // force sync of delta matrices
 );
 
+// flush pending changes of every matrix holding at least
+// delta_max_pending_changes pending changes, and convert matrices whose
+// storage format no longer fits their density, see RG_Matrix_selectFormat
+// each matrix is compacted off to the side under the graph's read lock
+// and swapped in under the graph's write lock, unless the graph was modified
+// in the meantime, expecting the caller to hold no lock
+void Graph_CompactMatrices
+(
+	Graph *g,                           // graph to compact
+	uint64_t delta_max_pending_changes  // compaction threshold
+);
+
 // Retrieve graph matrix synchronization policy
 MATRIX_POLICY Graph_GetMatrixPolicy
 (
@@ -408,13 +422,6 @@ RG_Matrix Graph_GetRelationMatrix
 	bool transposed
 );
 
-// retrieves the node-label mapping matrix,
-// matrix is resized if its size doesn't match graph's node count.
-RG_Matrix Graph_GetNodeLabelMatrix
-(
-	const Graph *g
-);
-
 // retrieves the zero matrix
 // the function will resize it to match all other
 // internal matrices, caller mustn't modify it in any way
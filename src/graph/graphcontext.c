@@ -16,6 +16,8 @@
 #include "../constraint/constraint.h"
 #include "../serializers/graphcontext_type.h"
 #include "../commands/execution_ctx.h"
+#include "../commands/prepared_statements.h"
+#include "../arithmetic/algebraic_expression.h"
 
 #include <sys/param.h>
 #include <pthread.h>
@@ -131,6 +133,16 @@ GraphContext *GraphContext_New
 	gc->cache = Cache_New(cache_size, (CacheEntryFreeFunc)ExecutionCtx_Free,
 						  (CacheEntryCopyFunc)ExecutionCtx_Clone);
 
+	// build the intermediate products cache, disabled if size is 0
+	uint64_t products_size;
+	Config_Option_get(Config_PRODUCT_CACHE_SIZE, &products_size);
+	gc->products = (products_size > 0) ?
+		AlgebraicExpression_NewProductCache(products_size) : NULL;
+
+	gc->prepared = PreparedStatements_New();
+	gc->plan_reuses = 0;
+	gc->flush_scheduled = false;
+
 	Graph_SetMatrixPolicy(gc->g, SYNC_POLICY_FLUSH_RESIZE);
 
 	return gc;
@@ -844,6 +856,82 @@ Cache *GraphContext_GetCache(const GraphContext *gc) {
 	return gc->cache;
 }
 
+// return prepared statements associated with graph context
+PreparedStatements *GraphContext_GetPreparedStatements
+(
+	const GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	return gc->prepared;
+}
+
+// count an execution which reused a previously executed plan
+void GraphContext_PlanReused
+(
+	GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	__atomic_fetch_add(&gc->plan_reuses, 1, __ATOMIC_RELAXED);
+}
+
+// return number of executions which reused a previously executed plan
+uint64_t GraphContext_PlanReuses
+(
+	const GraphContext *gc
+) {
+	ASSERT(gc != NULL);
+	return __atomic_load_n(&gc->plan_reuses, __ATOMIC_RELAXED);
+}
+
+//------------------------------------------------------------------------------
+// Background flush API
+//------------------------------------------------------------------------------
+
+// flush graph's delta matrices, executed on the writer thread
+static void _GraphContext_Flush
+(
+	void *arg  // graph context
+) {
+	GraphContext *gc = (GraphContext *)arg;
+
+	// clear flag prior to flushing
+	// modifications made while flushing schedule an additional flush
+	__atomic_store_n(&gc->flush_scheduled, false, __ATOMIC_RELAXED);
+
+	uint64_t delta_max_pending_changes;
+	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES,
+			&delta_max_pending_changes);
+
+	Graph_CompactMatrices(gc->g, delta_max_pending_changes);
+
+	// release reference acquired by GraphContext_ScheduleFlush
+	GraphContext_DecreaseRefCount(gc);
+}
+
+void GraphContext_ScheduleFlush
+(
+	GraphContext *gc  // graph context
+) {
+	ASSERT(gc != NULL);
+
+	bool background_flush;
+	Config_Option_get(Config_DELTA_BACKGROUND_FLUSH, &background_flush);
+	if(!background_flush) return;
+
+	// flush already scheduled
+	if(__atomic_exchange_n(&gc->flush_scheduled, true, __ATOMIC_RELAXED)) {
+		return;
+	}
+
+	// make sure graph context outlives the flush task
+	GraphContext_IncreaseRefCount(gc);
+	int res = ThreadPools_AddWorkWriter(_GraphContext_Flush, gc, 1);
+	if(res != 0) {
+		__atomic_store_n(&gc->flush_scheduled, false, __ATOMIC_RELAXED);
+		GraphContext_DecreaseRefCount(gc);
+	}
+}
+
 //------------------------------------------------------------------------------
 // Free routine
 //------------------------------------------------------------------------------
@@ -965,6 +1053,8 @@ static void _GraphContext_Free(void *arg) {
 	//--------------------------------------------------------------------------
 
 	if(gc->cache) Cache_Free(gc->cache);
+	if(gc->products) Cache_Free(gc->products);
+	if(gc->prepared) PreparedStatements_Free(gc->prepared);
 
 	GraphEncodeContext_Free(gc->encoding_context);
 	GraphDecodeContext_Free(gc->decoding_context);
@@ -16,6 +16,8 @@
 #include "../serializers/encode_context.h"
 #include "../serializers/decode_context.h"
 
+struct PreparedStatements;
+
 // GraphContext holds refrences to various elements of a graph object
 // It is the value sitting behind a Redis graph key
 //
@@ -41,8 +43,12 @@ typedef struct {
 	GraphEncodeContext *encoding_context;  // encode context of the graph
 	GraphDecodeContext *decoding_context;  // decode context of the graph
 	Cache *cache;                          // global cache of execution plans
+	Cache *products;                       // cache of intermediate algebraic products
+	struct PreparedStatements *prepared;   // prepared statements
+	uint64_t plan_reuses;                  // executions which reused an executed plan
 	XXH32_hash_t version;                  // graph version
 	RedisModuleString *telemetry_stream;   // telemetry stream name
+	bool flush_scheduled;                  // background flush of deltas is pending
 } GraphContext;
 
 //------------------------------------------------------------------------------
@@ -380,3 +386,36 @@ Cache *GraphContext_GetCache
 	const GraphContext *gc
 );
 
+// return prepared statements associated with graph context
+struct PreparedStatements *GraphContext_GetPreparedStatements
+(
+	const GraphContext *gc
+);
+
+// count an execution which reused a previously executed plan
+void GraphContext_PlanReused
+(
+	GraphContext *gc
+);
+
+// return number of executions which reused a previously executed plan
+uint64_t GraphContext_PlanReuses
+(
+	const GraphContext *gc
+);
+
+
+//------------------------------------------------------------------------------
+// Background flush API
+//------------------------------------------------------------------------------
+
+// schedule a background flush of the graph's delta matrices
+// the flush runs on the writer thread, compacting every matrix holding at least
+// DELTA_MAX_PENDING_CHANGES pending changes or stored in a format which no
+// longer fits its density, see Graph_CompactMatrices
+// does nothing if DELTA_BACKGROUND_FLUSH is disabled
+// or if a flush is already scheduled
+void GraphContext_ScheduleFlush
+(
+	GraphContext *gc  // graph context
+);
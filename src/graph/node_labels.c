@@ -0,0 +1,166 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "node_labels.h"
+#include "../util/rmalloc.h"
+
+#include <string.h>
+
+// minimum number of nodes allocated
+#define NODE_LABELS_MIN_CAP 1024
+
+#define WORD_IDX(l) ((l) >> 6)
+#define BIT_MASK(l) ((uint64_t)1 << ((l) & 63))
+
+// address of node's first word
+#define NODE_WORDS(nl, id) ((nl)->bits + (id) * (nl)->words)
+
+// make sure bitset can hold node 'id' labeled as 'l'
+static void _NodeLabels_Ensure
+(
+	NodeLabels *nl,
+	NodeID id,
+	LabelID l
+) {
+	uint     words    = nl->words;
+	uint64_t node_cap = nl->node_cap;
+
+	if(WORD_IDX(l) >= words) {
+		words = WORD_IDX(l) + 1;
+	}
+
+	if(id >= node_cap) {
+		node_cap = node_cap * 2;
+		if(node_cap <= id) node_cap = id + 1;
+		if(node_cap < NODE_LABELS_MIN_CAP) node_cap = NODE_LABELS_MIN_CAP;
+	}
+
+	// bitset is large enough
+	if(words == nl->words && node_cap == nl->node_cap) return;
+
+	nl->bits = rm_realloc(nl->bits, node_cap * words * sizeof(uint64_t));
+
+	// spread out existing nodes, going backwards as nodes only move forward
+	if(words != nl->words) {
+		for(uint64_t i = nl->node_cap; i > 0; i--) {
+			uint64_t *src = nl->bits + (i - 1) * nl->words;
+			uint64_t *dst = nl->bits + (i - 1) * words;
+			memmove(dst, src, nl->words * sizeof(uint64_t));
+			memset(dst + nl->words, 0, (words - nl->words) * sizeof(uint64_t));
+		}
+	}
+
+	// clear newly added nodes
+	memset(nl->bits + nl->node_cap * words, 0,
+			(node_cap - nl->node_cap) * words * sizeof(uint64_t));
+
+	nl->words    = words;
+	nl->node_cap = node_cap;
+}
+
+void NodeLabels_Init
+(
+	NodeLabels *nl  // bitset to initialize
+) {
+	ASSERT(nl != NULL);
+
+	nl->bits     = NULL;
+	nl->words    = 1;
+	nl->node_cap = 0;
+}
+
+void NodeLabels_Set
+(
+	NodeLabels *nl,  // bitset to update
+	NodeID id,       // node ID
+	LabelID l        // label
+) {
+	ASSERT(nl != NULL);
+	ASSERT(l  >= 0);
+
+	_NodeLabels_Ensure(nl, id, l);
+	NODE_WORDS(nl, id)[WORD_IDX(l)] |= BIT_MASK(l);
+}
+
+void NodeLabels_Unset
+(
+	NodeLabels *nl,  // bitset to update
+	NodeID id,       // node ID
+	LabelID l        // label
+) {
+	ASSERT(nl != NULL);
+	ASSERT(l  >= 0);
+
+	if(id >= nl->node_cap || WORD_IDX(l) >= nl->words) return;
+
+	NODE_WORDS(nl, id)[WORD_IDX(l)] &= ~BIT_MASK(l);
+}
+
+void NodeLabels_Clear
+(
+	NodeLabels *nl,  // bitset to update
+	NodeID id        // node ID
+) {
+	ASSERT(nl != NULL);
+
+	if(id >= nl->node_cap) return;
+
+	memset(NODE_WORDS(nl, id), 0, nl->words * sizeof(uint64_t));
+}
+
+bool NodeLabels_Test
+(
+	const NodeLabels *nl,  // bitset to query
+	NodeID id,             // node ID
+	LabelID l              // label
+) {
+	ASSERT(nl != NULL);
+	ASSERT(l  >= 0);
+
+	if(id >= nl->node_cap || WORD_IDX(l) >= nl->words) return false;
+
+	return (NODE_WORDS(nl, id)[WORD_IDX(l)] & BIT_MASK(l)) != 0;
+}
+
+uint NodeLabels_Get
+(
+	const NodeLabels *nl,  // bitset to query
+	NodeID id,             // node ID
+	LabelID *labels,       // [output] node's labels
+	uint n                 // size of labels array
+) {
+	ASSERT(nl     != NULL);
+	ASSERT(labels != NULL);
+
+	if(id >= nl->node_cap) return 0;
+
+	uint count = 0;
+	const uint64_t *words = NODE_WORDS(nl, id);
+
+	for(uint i = 0; i < nl->words && count < n; i++) {
+		uint64_t w = words[i];
+		while(w != 0 && count < n) {
+			labels[count++] = (i << 6) + __builtin_ctzll(w);
+			w &= w - 1;  // clear lowest set bit
+		}
+	}
+
+	return count;
+}
+
+void NodeLabels_Free
+(
+	NodeLabels *nl  // bitset to free
+) {
+	ASSERT(nl != NULL);
+
+	if(nl->bits != NULL) {
+		rm_free(nl->bits);
+	}
+
+	NodeLabels_Init(nl);
+}
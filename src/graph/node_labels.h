@@ -0,0 +1,88 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "entities/node.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+
+// packed per-node label bitset
+// maps each node ID to the set of labels the node possesses
+//
+// every node owns `words` consecutive 64 bit words
+// bit l of node i is set if node i is labeled as l
+//
+//            words
+//          <------->
+// node 0   [ w0 w1 ]
+// node 1   [ w0 w1 ]
+// ...
+//
+// the bitset is modified only under the graph's write lock
+//
+// the bitset only answers per-node label queries, label matrices
+// (Graph.labels) remain diagonal matrices which algebraic expressions
+// multiply by, label scans and index population iterate
+typedef struct {
+	uint64_t *bits;     // bitset, node_cap * words words
+	uint64_t node_cap;  // number of nodes the bitset can hold
+	uint words;         // number of words per node
+} NodeLabels;
+
+// initialize an empty bitset
+void NodeLabels_Init
+(
+	NodeLabels *nl  // bitset to initialize
+);
+
+// label node 'id' as 'l'
+void NodeLabels_Set
+(
+	NodeLabels *nl,  // bitset to update
+	NodeID id,       // node ID
+	LabelID l        // label
+);
+
+// remove label 'l' from node 'id'
+void NodeLabels_Unset
+(
+	NodeLabels *nl,  // bitset to update
+	NodeID id,       // node ID
+	LabelID l        // label
+);
+
+// remove all labels from node 'id'
+void NodeLabels_Clear
+(
+	NodeLabels *nl,  // bitset to update
+	NodeID id        // node ID
+);
+
+// return true if node 'id' is labeled as 'l'
+bool NodeLabels_Test
+(
+	const NodeLabels *nl,  // bitset to query
+	NodeID id,             // node ID
+	LabelID l              // label
+);
+
+// populate 'labels' with up to 'n' labels of node 'id' in ascending order
+// returns number of labels written
+uint NodeLabels_Get
+(
+	const NodeLabels *nl,  // bitset to query
+	NodeID id,             // node ID
+	LabelID *labels,       // [output] node's labels
+	uint n                 // size of labels array
+);
+
+// free bitset
+void NodeLabels_Free
+(
+	NodeLabels *nl  // bitset to free
+);
@@ -0,0 +1,177 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "rg_matrix.h"
+
+// compaction applies a matrix pending changes without modifying it
+// the merged matrix is built off to the side, while readers keep using the
+// matrix, and later replaces the matrix main matrix in a single step
+// compaction is also used to convert a matrix to a different storage format
+
+bool RG_Matrix_requiresCompaction
+(
+	const RG_Matrix C,                  // matrix to query
+	uint64_t delta_max_pending_changes  // compaction threshold
+) {
+	ASSERT(C != NULL);
+
+	GrB_Index dp_nvals;
+	GrB_Index dm_nvals;
+
+	// C's transpose mirrors C's changes, no need to inspect its deltas
+	GrB_Info info = GrB_Matrix_nvals(&dp_nvals, RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nvals(&dm_nvals, RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	if(dp_nvals >= delta_max_pending_changes ||
+	   dm_nvals >= delta_max_pending_changes) {
+		return true;
+	}
+
+	// storage format mismatch
+	if(RG_Matrix_selectFormat(C) != RG_Matrix_format(C)) {
+		return true;
+	}
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		RG_Matrix T = C->transposed;
+		return RG_Matrix_selectFormat(T) != RG_Matrix_format(T);
+	}
+
+	return false;
+}
+
+// returns M with DM's entries removed and DP's entries added
+static GrB_Matrix _RG_Matrix_compact
+(
+	const RG_Matrix C
+) {
+	ASSERT(C != NULL);
+
+	GrB_Matrix m  = RG_MATRIX_M(C);
+	GrB_Matrix dp = RG_MATRIX_DELTA_PLUS(C);
+	GrB_Matrix dm = RG_MATRIX_DELTA_MINUS(C);
+
+	int        sparsity;
+	GrB_Info   info;
+	GrB_Type   type;
+	GrB_Index  nrows;
+	GrB_Index  ncols;
+	GrB_Matrix compacted;
+
+	info = GxB_Matrix_type(&type, m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nrows(&nrows, m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, m);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_new(&compacted, type, nrows, ncols);
+	ASSERT(info == GrB_SUCCESS);
+
+	// pin the compacted matrix to its selected storage format
+	sparsity = RG_Matrix_selectFormat(C);
+	info = GxB_set(compacted, GxB_SPARSITY_CONTROL, sparsity);
+	ASSERT(info == GrB_SUCCESS);
+
+	// compacted<!DM> = M
+	info = GrB_transpose(compacted, dm, GrB_NULL, m, GrB_DESC_RSCT0);
+	ASSERT(info == GrB_SUCCESS);
+
+	// compacted<DP> = DP
+	info = GrB_Matrix_assign(compacted, dp, NULL, dp, GrB_ALL, nrows, GrB_ALL,
+			ncols, GrB_DESC_S);
+	ASSERT(info == GrB_SUCCESS);
+
+	info = GrB_wait(compacted, GrB_MATERIALIZE);
+	ASSERT(info == GrB_SUCCESS);
+
+	return compacted;
+}
+
+void RG_Matrix_compact
+(
+	const RG_Matrix C,  // matrix to compact
+	GrB_Matrix *M,      // [output] compacted main matrix
+	GrB_Matrix *TM      // [output] compacted transposed main matrix
+) {
+	ASSERT(C  != NULL);
+	ASSERT(M  != NULL);
+	ASSERT(TM != NULL);
+	ASSERT(!RG_Matrix_isDirty(C));
+
+	*M  = _RG_Matrix_compact(C);
+	*TM = NULL;
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		*TM = _RG_Matrix_compact(C->transposed);
+	}
+}
+
+// install compacted main matrix M, clearing C's deltas
+static void _RG_Matrix_swapCompacted
+(
+	RG_Matrix C,
+	GrB_Matrix *M
+) {
+	GrB_Info info = GrB_Matrix_free(&RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	RG_MATRIX_M(C) = *M;
+	*M = NULL;
+
+	info = GrB_Matrix_clear(RG_MATRIX_DELTA_PLUS(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_clear(RG_MATRIX_DELTA_MINUS(C));
+	ASSERT(info == GrB_SUCCESS);
+
+	C->dirty = false;
+}
+
+bool RG_Matrix_swapCompacted
+(
+	RG_Matrix C,        // matrix to update
+	GrB_Matrix *M,      // compacted main matrix
+	GrB_Matrix *TM      // compacted transposed main matrix
+) {
+	ASSERT(C  != NULL);
+	ASSERT(M  != NULL && *M != NULL);
+	ASSERT(TM != NULL);
+	ASSERT((*TM != NULL) == (RG_MATRIX_MAINTAIN_TRANSPOSE(C)));
+
+	GrB_Info  info;
+	GrB_Index nrows;
+	GrB_Index ncols;
+	GrB_Index m_nrows;
+	GrB_Index m_ncols;
+
+	info = GrB_Matrix_nrows(&nrows, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&ncols, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_nrows(&m_nrows, *M);
+	ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_ncols(&m_ncols, *M);
+	ASSERT(info == GrB_SUCCESS);
+
+	// C was resized after compaction, discard compacted matrices
+	if(nrows != m_nrows || ncols != m_ncols) {
+		GrB_Matrix_free(M);
+		GrB_Matrix_free(TM);
+		return false;
+	}
+
+	// multi-edge arrays are owned by the compacted matrix
+	// freeing the old main matrix doesn't free them
+	_RG_Matrix_swapCompacted(C, M);
+
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		_RG_Matrix_swapCompacted(C->transposed, TM);
+	}
+
+	return true;
+}
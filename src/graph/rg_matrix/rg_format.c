@@ -0,0 +1,117 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "rg_matrix.h"
+
+// storage format policy
+//
+// a matrix main matrix is stored either as:
+// bitmap      - dense matrices, memory proportional to nrows * ncols
+// sparse      - memory proportional to nrows + nvals
+// hypersparse - most rows are empty, memory proportional to nvals
+//
+// switching back and forth between formats requires rebuilding the matrix
+// as such each switch uses a different threshold depending on the current
+// format, preventing a matrix on the verge of a threshold from flipping
+
+// a bitmap spends a byte per cell in addition to the cell's value
+// while a sparse matrix spends a column index per entry in addition to its
+// value, switch to bitmap once it consumes no more memory than sparse
+// e.g. at a density of 2/9 for BOOL matrices and 9/16 for UINT64 matrices
+#define BITMAP_DENSITY_ON(size) \
+	((1.0 + (size)) / (sizeof(GrB_Index) + (size)))
+// switch back from bitmap once the density drops to half of the above
+#define BITMAP_DENSITY_OFF(size) (BITMAP_DENSITY_ON(size) / 2)
+// switch to hypersparse once nvals <= nrows / 16
+#define HYPERSPARSE_RATIO_ON 16
+// switch back from hypersparse once nvals > nrows / 8
+#define HYPERSPARSE_RATIO_OFF 8
+
+static int _RG_Matrix_selectFormat
+(
+	int current,      // current format
+	GrB_Index nvals,  // number of entries
+	GrB_Index nrows,  // number of rows
+	GrB_Index ncols,  // number of columns
+	size_t size       // size of an entry's value
+) {
+	double cells   = (double)nrows * (double)ncols;
+	double density = (cells > 0) ? nvals / cells : 0;
+
+	bool dense = (current == GxB_BITMAP || current == GxB_FULL);
+	if(density >= (dense ? BITMAP_DENSITY_OFF(size) : BITMAP_DENSITY_ON(size))) {
+		return GxB_BITMAP;
+	}
+
+	// nvals bounds the number of non-empty rows
+	bool hyper = (current == GxB_HYPERSPARSE);
+	GrB_Index ratio = hyper ? HYPERSPARSE_RATIO_OFF : HYPERSPARSE_RATIO_ON;
+	if(nvals <= nrows / ratio) {
+		return GxB_HYPERSPARSE;
+	}
+
+	return GxB_SPARSE;
+}
+
+int RG_Matrix_format
+(
+	const RG_Matrix C  // matrix to query
+) {
+	ASSERT(C != NULL);
+
+	int sparsity;
+	GrB_Info info = GxB_get(RG_MATRIX_M(C), GxB_SPARSITY_STATUS, &sparsity);
+	ASSERT(info == GrB_SUCCESS);
+
+	return sparsity;
+}
+
+int RG_Matrix_selectFormat
+(
+	const RG_Matrix C  // matrix to query
+) {
+	ASSERT(C != NULL);
+
+	GrB_Info  info;
+	GrB_Type  type;
+	size_t    size;
+	GrB_Index nvals;
+	GrB_Index nrows;
+	GrB_Index ncols;
+
+	info = RG_Matrix_nvals(&nvals, C);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_nrows(&nrows, C);
+	ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_ncols(&ncols, C);
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Matrix_type(&type, RG_MATRIX_M(C));
+	ASSERT(info == GrB_SUCCESS);
+	info = GxB_Type_size(&size, type);
+	ASSERT(info == GrB_SUCCESS);
+
+	return _RG_Matrix_selectFormat(RG_Matrix_format(C), nvals, nrows, ncols,
+			size);
+}
+
+const char *RG_Matrix_formatName
+(
+	int format  // matrix format
+) {
+	switch(format) {
+		case GxB_HYPERSPARSE:
+			return "hypersparse";
+		case GxB_SPARSE:
+			return "sparse";
+		case GxB_BITMAP:
+			return "bitmap";
+		case GxB_FULL:
+			return "full";
+		default:
+			return "unknown";
+	}
+}
@@ -14,7 +14,11 @@ void RG_Matrix_setDirty
 ) {
 	ASSERT(C);
 	C->dirty = true;
-	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) C->transposed->dirty = true;
+	C->version++;
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(C)) {
+		C->transposed->dirty = true;
+		C->transposed->version++;
+	}
 }
 
 RG_Matrix RG_Matrix_getTranspose
@@ -25,6 +29,14 @@ RG_Matrix RG_Matrix_getTranspose
 	return C->transposed;
 }
 
+uint64_t RG_Matrix_version
+(
+	const RG_Matrix C
+) {
+	ASSERT(C != NULL);
+	return __atomic_load_n(&C->version, __ATOMIC_RELAXED);
+}
+
 bool RG_Matrix_isDirty
 (
 	const RG_Matrix C
@@ -166,7 +178,11 @@ GrB_Info RG_Matrix_clear
 	ASSERT(info == GrB_SUCCESS);
 
 	A->dirty = false;
-	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) A->transposed->dirty = false;
+	A->version++;
+	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) {
+		A->transposed->dirty = false;
+		A->transposed->version++;
+	}
 
 	return info;
 }
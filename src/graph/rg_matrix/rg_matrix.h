@@ -124,6 +124,7 @@ struct _RG_Matrix {
 	GrB_Matrix delta_plus;              // Pending additions
 	GrB_Matrix delta_minus;             // Pending deletions
 	RG_Matrix transposed;               // Transposed matrix
+	uint64_t version;                   // Number of modifications
 	pthread_mutex_t mutex;              // Lock
 };
 
@@ -152,6 +153,13 @@ bool RG_Matrix_isDirty
 	const RG_Matrix C
 );
 
+// returns C's version, which advances every time C's entries are modified
+// merging pending changes doesn't modify the version
+uint64_t RG_Matrix_version
+(
+	const RG_Matrix C  // matrix to inquery
+);
+
 // checks if C is fully synced
 // a synced delta matrix does not contains any entries in
 // either its delta-plus and delta-minus internal matrices
@@ -300,6 +308,66 @@ GrB_Info RG_Matrix_wait
 	bool force_sync
 );
 
+// same as RG_Matrix_wait without forcing a sync
+// pending changes are flushed only once their number reaches
+// delta_max_pending_changes, regardless of DELTA_MAX_PENDING_CHANGES
+GrB_Info RG_Matrix_waitThreshold
+(
+	RG_Matrix C,
+	uint64_t delta_max_pending_changes
+);
+
+// storage format of C's main matrix
+// one of GxB_HYPERSPARSE, GxB_SPARSE, GxB_BITMAP or GxB_FULL
+int RG_Matrix_format
+(
+	const RG_Matrix C  // matrix to query
+);
+
+// storage format best suited for C's main matrix
+// once C's pending changes are applied, see rg_format.c
+int RG_Matrix_selectFormat
+(
+	const RG_Matrix C  // matrix to query
+);
+
+// human readable name of a storage format
+const char *RG_Matrix_formatName
+(
+	int format  // matrix format
+);
+
+// checks if C should be compacted, either of C's delta matrices holds at least
+// delta_max_pending_changes entries or C's storage format doesn't match
+// the format selected by RG_Matrix_selectFormat
+bool RG_Matrix_requiresCompaction
+(
+	const RG_Matrix C,                  // matrix to query
+	uint64_t delta_max_pending_changes  // compaction threshold
+);
+
+// build a compacted version of C off to the side
+// the compacted matrix is C's main matrix with C's pending changes applied
+// stored in the format selected by RG_Matrix_selectFormat
+// C itself is not modified, expecting C to be synced and not to be modified
+// while compacting
+void RG_Matrix_compact
+(
+	const RG_Matrix C,  // matrix to compact
+	GrB_Matrix *M,      // [output] compacted main matrix
+	GrB_Matrix *TM      // [output] compacted transposed main matrix
+);
+
+// replace C's main matrix with its compacted version and clear C's deltas
+// returns false and discards the compacted matrices
+// in case C's dimensions changed since they were built
+bool RG_Matrix_swapCompacted
+(
+	RG_Matrix C,        // matrix to update
+	GrB_Matrix *M,      // compacted main matrix
+	GrB_Matrix *TM      // compacted transposed main matrix
+);
+
 // get the type of the M matrix
 GrB_Info RG_Matrix_type
 (
@@ -22,9 +22,21 @@ GrB_Info RG_mxm                     // C = A * B
 	// A * B
 	// where A is fully synced!
 	//
-	// it is possible for either 'delta-plus' or 'delta-minus' to be empty
+	// B's pending changes are applied on the fly, without merging them into B
+	// B = (M - 'delta-minus') + 'delta-plus'
+	// where 'delta-minus' entries are a subset of M's entries
+	// and 'delta-plus' entries are disjoint of M's entries
+	//
 	// this operation performs: A * B by computing:
-	// (A * (M + 'delta-plus'))<!'delta-minus'>
+	// (A * M)<!Z> + (A * 'delta-plus')
+	//
+	// entry C[i,k] is reachable via every j for which A[i,j] and M[j,k] exist
+	// C[i,k] is removed only if all of these go through an entry pending
+	// deletion, Z marks these entries by comparing the number of paths
+	// going through 'delta-minus' with the overall number of paths, counting
+	// is restricted to entries reachable via 'delta-minus':
+	// D = A * 'delta-minus'
+	// Z = ((A * M)<D> == D)
 
 	// validate A doesn't contains entries in either delta-plus or delta-minus
 	ASSERT(RG_Matrix_Synced(A));
@@ -43,27 +55,54 @@ GrB_Info RG_mxm                     // C = A * B
 	GrB_Matrix  _C     =  RG_MATRIX_M(C);
 	GrB_Matrix  dp     =  RG_MATRIX_DELTA_PLUS(B);
 	GrB_Matrix  dm     =  RG_MATRIX_DELTA_MINUS(B);
+	GrB_Matrix  D      =  NULL;  // number of paths through deleted entries
+	GrB_Matrix  paths  =  NULL;  // number of paths through M
 	GrB_Matrix  mask   =  NULL;  // entities removed
 	GrB_Matrix  accum  =  NULL;  // entities added
 
 	RG_Matrix_nrows(&nrows, C);
 	RG_Matrix_ncols(&ncols, C);
+
 	GrB_Matrix_nvals(&dp_nvals, dp);
 	GrB_Matrix_nvals(&dm_nvals, dm);
 
+	// 'A' might be 'C', compute all terms depending on 'A' before 'C' is
+	// overwritten
+
 	if(dm_nvals > 0) {
-		// compute A * 'delta-minus'
-		info = GrB_Matrix_new(&mask, GrB_BOOL, nrows, ncols);
+		// compute D = A * 'delta-minus'
+		info = GrB_Matrix_new(&D, GrB_UINT64, nrows, ncols);
 		ASSERT(info == GrB_SUCCESS);
 
-		info = GrB_mxm(mask, NULL, NULL, GxB_ANY_PAIR_BOOL, _A, dm, NULL);
+		info = GrB_mxm(D, NULL, NULL, GxB_PLUS_PAIR_UINT64, _A, dm, NULL);
 		ASSERT(info == GrB_SUCCESS);
 
 		// update 'dm_nvals'
-		info = GrB_Matrix_nvals(&dm_nvals, mask);
+		info = GrB_Matrix_nvals(&dm_nvals, D);
 		ASSERT(info == GrB_SUCCESS);
 	}
 
+	if(dm_nvals > 0) {
+		// count paths through M, only for entries reachable via 'delta-minus'
+		info = GrB_Matrix_new(&paths, GrB_UINT64, nrows, ncols);
+		ASSERT(info == GrB_SUCCESS);
+
+		info = GrB_mxm(paths, D, NULL, GxB_PLUS_PAIR_UINT64, _A, _B,
+				GrB_DESC_S);
+		ASSERT(info == GrB_SUCCESS);
+
+		// Z = (paths == D)
+		info = GrB_Matrix_new(&mask, GrB_BOOL, nrows, ncols);
+		ASSERT(info == GrB_SUCCESS);
+
+		info = GrB_eWiseMult(mask, NULL, NULL, GrB_EQ_UINT64, paths, D, NULL);
+		ASSERT(info == GrB_SUCCESS);
+
+		GrB_free(&paths);
+	}
+
+	if(D != NULL) GrB_free(&D);
+
 	if(dp_nvals > 0) {
 		// compute A * 'delta-plus'
 		info = GrB_Matrix_new(&accum, GrB_BOOL, nrows, ncols);
@@ -77,18 +116,10 @@ GrB_Info RG_mxm                     // C = A * B
 		ASSERT(info == GrB_SUCCESS);
 	}
 
-	GrB_Descriptor  desc       =  NULL;
-	bool            additions  =  dp_nvals  >  0;
-	bool            deletions  =  dm_nvals  >  0;
+	GrB_Descriptor  desc       =  (mask != NULL) ? GrB_DESC_RC : NULL;
+	bool            additions  =  dp_nvals > 0;
 
-	if (deletions) {
-		desc = GrB_DESC_RSC;
-	} else {
-		GrB_free(&mask);
-		mask = NULL;
-	}
-
-	// compute (A * B)<!mask>
+	// compute (A * M)<!Z>
 	info = GrB_mxm(_C, mask, NULL, semiring, _A, _B, desc);
 	ASSERT(info == GrB_SUCCESS);
 
@@ -103,4 +134,3 @@ GrB_Info RG_mxm                     // C = A * B
 
 	return info;
 }
-
@@ -25,6 +25,15 @@ GrB_Info RG_Matrix_resize       // change the size of a matrix
 	GrB_Matrix  delta_plus   =  RG_MATRIX_DELTA_PLUS(C);
 	GrB_Matrix  delta_minus  =  RG_MATRIX_DELTA_MINUS(C);
 
+	// dense formats scale with the matrix dimensions rather than with its
+	// number of entries, fall back to sparse storage
+	// the format is re-selected once the matrix is compacted
+	int format = RG_Matrix_format(C);
+	if(format == GxB_BITMAP || format == GxB_FULL) {
+		info = GxB_set(m, GxB_SPARSITY_CONTROL, GxB_SPARSE | GxB_HYPERSPARSE);
+		ASSERT(info == GrB_SUCCESS);
+	}
+
 	info = GrB_Matrix_resize(m, nrows_new, ncols_new);
 	ASSERT(info == GrB_SUCCESS);
 
@@ -33,7 +42,10 @@ GrB_Info RG_Matrix_resize       // change the size of a matrix
 	
 	info = GrB_Matrix_resize(delta_minus, nrows_new, ncols_new);
 	ASSERT(info == GrB_SUCCESS);
-	
+
+	// matrices are resized by readers as well, under the matrix's lock
+	__atomic_fetch_add(&C->version, 1, __ATOMIC_RELAXED);
+
 	return info;
 }
 
@@ -122,23 +122,46 @@ static void RG_Matrix_sync
 	ASSERT(info == GrB_SUCCESS);
 }
 
-GrB_Info RG_Matrix_wait
+static void _RG_Matrix_wait
 (
 	RG_Matrix A,
-	bool force_sync
+	bool force_sync,
+	uint64_t delta_max_pending_changes
 ) {
 	ASSERT(A != NULL);
 	if(RG_MATRIX_MAINTAIN_TRANSPOSE(A)) {
-		RG_Matrix_wait(A->transposed, force_sync);
+		_RG_Matrix_wait(A->transposed, force_sync, delta_max_pending_changes);
 	}
 
+	RG_Matrix_sync(A, force_sync, delta_max_pending_changes);
+
+	_SetUndirty(A);
+}
+
+GrB_Info RG_Matrix_wait
+(
+	RG_Matrix A,
+	bool force_sync
+) {
+	ASSERT(A != NULL);
+
 	uint64_t delta_max_pending_changes;
 	Config_Option_get(Config_DELTA_MAX_PENDING_CHANGES,
 			&delta_max_pending_changes);
 
-	RG_Matrix_sync(A, force_sync, delta_max_pending_changes);
+	_RG_Matrix_wait(A, force_sync, delta_max_pending_changes);
 
-	_SetUndirty(A);
+	return GrB_SUCCESS;
+}
+
+GrB_Info RG_Matrix_waitThreshold
+(
+	RG_Matrix A,
+	uint64_t delta_max_pending_changes
+) {
+	ASSERT(A != NULL);
+
+	_RG_Matrix_wait(A, false, delta_max_pending_changes);
 
 	return GrB_SUCCESS;
 }
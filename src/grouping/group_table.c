@@ -0,0 +1,314 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "group_table.h"
+#include "../util/arr.h"
+#include "../datatypes/set.h"
+#include "../util/rmalloc.h"
+#include "../arithmetic/aggregate_funcs/agg_funcs.h"
+
+// number of groups in the first state block, must be a power of 2
+#define GROUP_TABLE_FIRST_BLOCK_SHIFT 6
+#define GROUP_TABLE_FIRST_BLOCK (1 << GROUP_TABLE_FIRST_BLOCK_SHIFT)
+
+// keep group state members 16 bytes aligned
+#define GROUP_TABLE_ALIGN(n) (((n) + 15) & ~(size_t)15)
+
+// returns the index of the block holding group
+// block b holds groups [FIRST * (2^b - 1), FIRST * (2^(b+1) - 1))
+static inline uint _GroupTable_Block
+(
+	uint32_t group
+) {
+	uint64_t x = ((uint64_t)group >> GROUP_TABLE_FIRST_BLOCK_SHIFT) + 1;
+	return 63 - __builtin_clzll(x);
+}
+
+// returns the first group held by block
+static inline uint32_t _GroupTable_BlockStart
+(
+	uint block
+) {
+	return (uint32_t)(((1ULL << block) - 1) << GROUP_TABLE_FIRST_BLOCK_SHIFT);
+}
+
+// returns group's state
+static inline char *_GroupTable_State
+(
+	const GroupTable *t,
+	uint32_t group
+) {
+	uint b = _GroupTable_Block(group);
+	ASSERT(b < array_len(t->blocks));
+
+	size_t offset = group - _GroupTable_BlockStart(b);
+	return t->blocks[b] + offset * t->state_size;
+}
+
+// initialize the aggregation contexts of a newly created group
+static void _GroupTable_InitState
+(
+	GroupTable *t,
+	uint32_t group
+) {
+	if(t->state_size == 0) return;
+
+	// allocate a new block if group is the first in its block
+	uint b = _GroupTable_Block(group);
+	if(b == array_len(t->blocks)) {
+		size_t n = (size_t)GROUP_TABLE_FIRST_BLOCK << b;
+		array_append(t->blocks, rm_malloc(n * t->state_size));
+	}
+
+	char *state = _GroupTable_State(t, group);
+	uint agg_count = array_len(t->aggs);
+	for(uint i = 0; i < agg_count; i++) {
+		GroupTableAgg *agg = t->aggs + i;
+		Aggregate_InitCtx(agg->func, (AggregateCtx *)(state + agg->offset));
+		if(agg->distinct) {
+			*(set **)(state + agg->set_offset) = Set_New();
+		}
+	}
+}
+
+// release the aggregation contexts of every group
+static void _GroupTable_ReleaseStates
+(
+	GroupTable *t
+) {
+	uint32_t n = TupleTable_Count(t->keys);
+	uint agg_count = array_len(t->aggs);
+
+	for(uint32_t g = 0; g < n; g++) {
+		char *state = _GroupTable_State(t, g);
+		for(uint i = 0; i < agg_count; i++) {
+			GroupTableAgg *agg = t->aggs + i;
+			Aggregate_ReleaseCtx(agg->func, (AggregateCtx *)(state + agg->offset));
+			if(agg->distinct) {
+				Set_Free(*(set **)(state + agg->set_offset));
+			}
+		}
+	}
+}
+
+// create a new group table
+GroupTable *GroupTable_New
+(
+	uint key_count,     // number of group keys
+	AR_ExpNode **exps,  // aggregate expressions
+	uint exp_count      // number of aggregate expressions
+) {
+	GroupTable *t = rm_malloc(sizeof(GroupTable));
+
+	t->keys       = TupleTable_New(key_count);
+	t->exps       = exps;
+	t->exp_aggs   = array_new(uint, exp_count + 1);
+	t->aggs       = array_new(GroupTableAgg, exp_count);
+	t->blocks     = array_new(char *, 0);
+	t->state_size = 0;
+
+	// lay out group state
+	AR_ExpNode **nodes = array_new(AR_ExpNode *, 1);
+	for(uint i = 0; i < exp_count; i++) {
+		array_append(t->exp_aggs, array_len(t->aggs));
+
+		array_clear(nodes);
+		AR_EXP_CollectAggregations(exps[i], &nodes);
+
+		uint n = array_len(nodes);
+		for(uint j = 0; j < n; j++) {
+			GroupTableAgg agg;
+			agg.node       = nodes[j];
+			agg.func       = nodes[j]->op.f;
+			agg.distinct   = AR_EXP_PerformsDistinct(nodes[j]);
+			agg.offset     = t->state_size;
+			agg.set_offset = 0;
+
+			t->state_size += GROUP_TABLE_ALIGN(Aggregate_CtxSize(agg.func));
+			if(agg.distinct) {
+				agg.set_offset = t->state_size;
+				t->state_size += GROUP_TABLE_ALIGN(sizeof(set *));
+			}
+
+			array_append(t->aggs, agg);
+		}
+	}
+	array_append(t->exp_aggs, array_len(t->aggs));
+	array_free(nodes);
+
+	return t;
+}
+
+// returns the ID of the group identified by keys, creating it if missing
+uint32_t GroupTable_GetGroup
+(
+	GroupTable *t,        // group table
+	const SIValue *keys,  // group keys
+	bool *added           // [output] group created
+) {
+	ASSERT(t     != NULL);
+	ASSERT(added != NULL);
+
+	XXH64_hash_t hash = TupleTable_Hash(keys, t->keys->arity);
+	uint32_t group = TupleTable_FindOrAdd(t->keys, keys, hash, added);
+
+	if(*added) _GroupTable_InitState(t, group);
+
+	return group;
+}
+
+// aggregate record into group
+void GroupTable_Aggregate
+(
+	GroupTable *t,   // group table
+	uint32_t group,  // group ID
+	const Record r   // record to aggregate
+) {
+	ASSERT(t != NULL);
+	ASSERT(group < TupleTable_Count(t->keys));
+
+	char *state = _GroupTable_State(t, group);
+	uint agg_count = array_len(t->aggs);
+
+	for(uint i = 0; i < agg_count; i++) {
+		GroupTableAgg *agg = t->aggs + i;
+		set *distinct = NULL;
+		if(agg->distinct) distinct = *(set **)(state + agg->set_offset);
+
+		AR_EXP_AggregateCtx(agg->node, r,
+				(AggregateCtx *)(state + agg->offset), distinct);
+	}
+}
+
+// returns true if partial group tables can be merged
+bool GroupTable_Combinable
+(
+	const GroupTable *t  // group table
+) {
+	ASSERT(t != NULL);
+
+	uint agg_count = array_len(t->aggs);
+	for(uint i = 0; i < agg_count; i++) {
+		const GroupTableAgg *agg = t->aggs + i;
+		// distinct sets can't be combined
+		if(agg->distinct || !Aggregate_Combinable(agg->func)) return false;
+	}
+
+	return true;
+}
+
+// merge the groups of src into dst
+void GroupTable_Merge
+(
+	GroupTable *dst,  // table to merge into
+	GroupTable *src   // table to merge
+) {
+	ASSERT(src != NULL);
+	ASSERT(dst != NULL);
+	ASSERT(src->state_size == dst->state_size);
+	ASSERT(array_len(src->aggs) == array_len(dst->aggs));
+
+	uint agg_count = array_len(dst->aggs);
+	uint32_t n = TupleTable_Count(src->keys);
+
+	for(uint32_t g = 0; g < n; g++) {
+		bool added;
+		const SIValue *keys = TupleTable_Get(src->keys, g);
+		uint32_t dst_g = GroupTable_GetGroup(dst, keys, &added);
+
+		char *src_state = _GroupTable_State(src, g);
+		char *dst_state = _GroupTable_State(dst, dst_g);
+
+		for(uint i = 0; i < agg_count; i++) {
+			GroupTableAgg *agg = dst->aggs + i;
+			ASSERT(agg->func == src->aggs[i].func);
+			Aggregate_Combine(agg->func,
+					(AggregateCtx *)(dst_state + agg->offset),
+					(AggregateCtx *)(src_state + agg->offset));
+		}
+	}
+}
+
+// returns group keys
+const SIValue *GroupTable_Keys
+(
+	const GroupTable *t,  // group table
+	uint32_t group        // group ID
+) {
+	ASSERT(t != NULL);
+	return TupleTable_Get(t->keys, group);
+}
+
+// finalize and evaluate a group's aggregate expression
+SIValue GroupTable_Finalize
+(
+	GroupTable *t,   // group table
+	uint32_t group,  // group ID
+	uint exp_idx,    // aggregate expression index
+	const Record r   // record to evaluate against
+) {
+	ASSERT(t != NULL);
+	ASSERT(exp_idx + 1 < array_len(t->exp_aggs));
+
+	char *state = _GroupTable_State(t, group);
+	uint first  = t->exp_aggs[exp_idx];
+	uint n      = t->exp_aggs[exp_idx + 1] - first;
+	ASSERT(n > 0);
+
+	AggregateCtx *ctxs[n];
+	for(uint i = 0; i < n; i++) {
+		ctxs[i] = (AggregateCtx *)(state + t->aggs[first + i].offset);
+	}
+
+	return AR_EXP_FinalizeAggregationsCtx(t->exps[exp_idx], r, ctxs);
+}
+
+// returns number of groups
+uint32_t GroupTable_Count
+(
+	const GroupTable *t  // group table
+) {
+	ASSERT(t != NULL);
+	return TupleTable_Count(t->keys);
+}
+
+// removes all groups
+void GroupTable_Clear
+(
+	GroupTable *t  // group table
+) {
+	ASSERT(t != NULL);
+
+	// state blocks are kept for reuse
+	_GroupTable_ReleaseStates(t);
+	TupleTable_Clear(t->keys);
+}
+
+// free group table
+void GroupTable_Free
+(
+	GroupTable **t  // group table to free
+) {
+	ASSERT(t != NULL);
+
+	GroupTable *_t = *t;
+	if(_t == NULL) return;
+
+	_GroupTable_ReleaseStates(_t);
+	TupleTable_Free(&_t->keys);
+
+	uint nblocks = array_len(_t->blocks);
+	for(uint i = 0; i < nblocks; i++) {
+		rm_free(_t->blocks[i]);
+	}
+	array_free(_t->blocks);
+	array_free(_t->exp_aggs);
+	array_free(_t->aggs);
+
+	rm_free(_t);
+	*t = NULL;
+}
@@ -0,0 +1,119 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../value.h"
+#include "../util/tuple_table.h"
+#include "../execution_plan/record.h"
+#include "../arithmetic/arithmetic_expression.h"
+
+// GroupTable maps group keys to aggregation states
+//
+// group keys are stored in a TupleTable, a group's ID is its key tuple ID
+// each group owns a fixed size state holding an aggregation context
+// for every aggregation node of every aggregate expression
+// states are laid out back to back in blocks which never move
+// block sizes double, the first block holds GROUP_TABLE_FIRST_BLOCK groups
+//
+// aggregate expressions are shared by all groups
+// when aggregating or finalizing a group, its contexts are swapped into the
+// expression tree, as such no per group expression clone is required
+
+// aggregation node within a group state
+typedef struct {
+	AR_ExpNode *node;         // aggregation node
+	const AR_FuncDesc *func;  // aggregation function
+	size_t offset;            // context offset within group state
+	size_t set_offset;        // distinct set offset within group state
+	bool distinct;            // aggregation operates on distinct values
+} GroupTableAgg;
+
+typedef struct {
+	TupleTable *keys;     // group keys
+	AR_ExpNode **exps;    // aggregate expressions, not owned
+	uint *exp_aggs;       // first aggregation node of each expression
+	GroupTableAgg *aggs;  // aggregation nodes of all expressions
+	size_t state_size;    // size of a group state
+	char **blocks;        // group states
+} GroupTable;
+
+// create a new group table
+GroupTable *GroupTable_New
+(
+	uint key_count,     // number of group keys
+	AR_ExpNode **exps,  // aggregate expressions
+	uint exp_count      // number of aggregate expressions
+);
+
+// returns the ID of the group identified by keys, creating it if missing
+// keys remain owned by the caller
+uint32_t GroupTable_GetGroup
+(
+	GroupTable *t,        // group table
+	const SIValue *keys,  // group keys
+	bool *added           // [output] group created
+);
+
+// aggregate record into group
+void GroupTable_Aggregate
+(
+	GroupTable *t,   // group table
+	uint32_t group,  // group ID
+	const Record r   // record to aggregate
+);
+
+// returns true if partial group tables can be merged
+// i.e. every aggregation can be combined and none operates on distinct values
+bool GroupTable_Combinable
+(
+	const GroupTable *t  // group table
+);
+
+// merge the groups of src into dst
+// both tables must be built from the same aggregate expressions
+// src is left intact and should be freed by the caller
+void GroupTable_Merge
+(
+	GroupTable *dst,  // table to merge into
+	GroupTable *src   // table to merge
+);
+
+// returns group keys
+// the returned values are owned by the table
+const SIValue *GroupTable_Keys
+(
+	const GroupTable *t,  // group table
+	uint32_t group        // group ID
+);
+
+// finalize and evaluate a group's aggregate expression
+// should be called at most once per group and expression
+SIValue GroupTable_Finalize
+(
+	GroupTable *t,   // group table
+	uint32_t group,  // group ID
+	uint exp_idx,    // aggregate expression index
+	const Record r   // record to evaluate against
+);
+
+// returns number of groups
+uint32_t GroupTable_Count
+(
+	const GroupTable *t  // group table
+);
+
+// removes all groups
+void GroupTable_Clear
+(
+	GroupTable *t  // group table
+);
+
+// free group table
+void GroupTable_Free
+(
+	GroupTable **t  // group table to free
+);
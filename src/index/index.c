@@ -29,6 +29,18 @@ struct _Index {
 	uint _Atomic pending_changes;  // number of pending changes
 };
 
+// index epoch, advanced whenever an index changes state
+static uint64_t _Atomic _index_epoch = ATOMIC_VAR_INIT(0);
+
+static inline void _Index_AdvanceEpoch(void) {
+	atomic_fetch_add(&_index_epoch, 1);
+}
+
+// returns the current index epoch
+uint64_t Index_Epoch(void) {
+	return atomic_load(&_index_epoch);
+}
+
 static void _Index_ConstructFullTextStructure
 (
 	Index idx,
@@ -136,6 +148,8 @@ void Index_ConstructStructure
 	// set RediSearch index
 	ASSERT(idx->rsIdx == NULL);
 	idx->rsIdx = rsIdx;
+
+	_Index_AdvanceEpoch();
 }
 
 RSDoc *Index_IndexGraphEntity
@@ -359,6 +373,7 @@ void Index_Disable
 	ASSERT(idx != NULL);
 
 	idx->pending_changes++;
+	_Index_AdvanceEpoch();
 
 	// drop index if exists
 	if(idx->rsIdx != NULL) {
@@ -381,6 +396,7 @@ void Index_Enable
 	ASSERT(idx->pending_changes > 0);
 
 	idx->pending_changes--;
+	_Index_AdvanceEpoch();
 }
 
 // adds field to index
@@ -590,6 +606,8 @@ void Index_Free
 ) {
 	ASSERT(idx != NULL);
 
+	_Index_AdvanceEpoch();
+
 	if(idx->rsIdx) {
 		RediSearch_DropIndex(idx->rsIdx);
 	}
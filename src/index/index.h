@@ -254,3 +254,8 @@ void Index_Free
 	Index idx  // index being freed
 );
 
+// returns the current index epoch
+// the epoch advances whenever an index is created, changes state or is freed
+// execution plans built under one epoch might reference stale indices
+// under another
+uint64_t Index_Epoch(void);
@@ -226,6 +226,15 @@ void QueryCtx_SetParams
 	ctx->query_data.params = params;
 }
 
+// record every parameter evaluated from here on into bindings
+void QueryCtx_RecordBindings
+(
+	PlanBinding **bindings
+) {
+	QueryCtx *ctx = _QueryCtx_GetCreateCtx();
+	ctx->query_data.bindings = bindings;
+}
+
 // retrieve the AST
 AST *QueryCtx_GetAST(void) {
 	QueryCtx *ctx = _QueryCtx_GetCtx();
@@ -373,6 +382,7 @@ bool QueryCtx_LockForCommit(void) {
 
 	// acquire graph write lock
 	Graph_AcquireWriteLock(gc->g);
+	ctx->internal_exec_ctx.graph_locked = true;
 	ctx->internal_exec_ctx.locked_for_commit = true;
 
 	return true;
@@ -396,8 +406,13 @@ static void _QueryCtx_UnlockCommit
 	GraphContext *gc = ctx->gc;
 
 	ctx->internal_exec_ctx.locked_for_commit = false;
-	// release graph R/W lock
-	Graph_ReleaseLock(gc->g);
+	// release graph R/W lock, unless already released
+	if(ctx->internal_exec_ctx.graph_locked) {
+		ctx->internal_exec_ctx.graph_locked = false;
+		Graph_ReleaseLock(gc->g);
+		// flush pending changes in the background, if needed
+		GraphContext_ScheduleFlush(gc);
+	}
 
 	// close Key
 	RedisModule_CloseKey(ctx->internal_exec_ctx.key);
@@ -425,6 +440,19 @@ void QueryCtx_UnlockCommit() {
 	_QueryCtx_UnlockCommit(ctx);
 }
 
+void QueryCtx_ReleaseGraphLock(void) {
+	QueryCtx *ctx = _QueryCtx_GetCtx();
+	if(!ctx) return;
+
+	// graph isn't locked
+	if(!ctx->internal_exec_ctx.graph_locked) return;
+
+	ctx->internal_exec_ctx.graph_locked = false;
+	Graph_ReleaseLock(ctx->gc->g);
+	// flush pending changes in the background, if needed
+	GraphContext_ScheduleFlush(ctx->gc);
+}
+
 // replicate command to AOF/Replicas
 void QueryCtx_Replicate
 (
@@ -462,6 +490,11 @@ void QueryCtx_Free(void) {
 		ctx->query_data.params = NULL;
 	}
 
+	if(ctx->query_data.query_normalized != NULL) {
+		rm_free(ctx->query_data.query_normalized);
+		ctx->query_data.query_normalized = NULL;
+	}
+
 	rm_free(ctx);
 
 	// NULL-set the context for reuse the next time this thread receives a query
@@ -17,6 +17,7 @@
 #include "execution_plan/ops/op.h"
 #include "undo_log/undo_log.h"
 #include "effects/effects.h"
+#include "execution_plan/execution_plan_bindings.h"
 #include <pthread.h>
 
 extern pthread_key_t _tlsQueryCtxKey;  // Thread local storage query context key.
@@ -52,12 +53,15 @@ typedef struct {
 	rax *params;                  // query parameters
 	const char *query;            // query string
 	const char *query_no_params;  // query string without parameters part
+	char *query_normalized;       // query with literals replaced by parameters
+	PlanBinding **bindings;       // [optional] records evaluated parameters
 } QueryCtx_QueryData;
 
 typedef struct {
 	RedisModuleKey *key;     // graph open key, for later extraction and closing
 	ResultSet *result_set;   // execution result set
 	bool locked_for_commit;  // indicates if QueryCtx_LockForCommit been called
+	bool graph_locked;       // indicates if the graph write lock is held
 } QueryCtx_InternalExecCtx;
 
 typedef struct {
@@ -164,6 +168,13 @@ void QueryCtx_SetParams
 	rax *params
 );
 
+// record every parameter evaluated from here on into bindings
+// recording stops once bindings is NULL
+void QueryCtx_RecordBindings
+(
+	PlanBinding **bindings  // [optional] bindings to record into
+);
+
 //------------------------------------------------------------------------------
 // getters
 //------------------------------------------------------------------------------
@@ -224,6 +235,13 @@ bool QueryCtx_LockForCommit(void);
 // 4. unlock GIL
 void QueryCtx_UnlockCommit(void);
 
+// releases the graph R/W lock acquired by QueryCtx_LockForCommit
+// ahead of QueryCtx_UnlockCommit
+// the GIL and graph key remain locked, such that commits are replicated
+// in order, the write lock isn't held while replicating
+// note readers still wait for the write lock while the writer executes
+void QueryCtx_ReleaseGraphLock(void);
+
 // replicate command to AOF/Replicas
 void QueryCtx_Replicate
 (
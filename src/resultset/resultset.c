@@ -7,6 +7,8 @@
 #include "resultset.h"
 #include "RG.h"
 #include "../value.h"
+#include "../datatypes/map.h"
+#include "../datatypes/array.h"
 #include "../util/arr.h"
 #include "../query_ctx.h"
 #include "../util/rmalloc.h"
@@ -56,6 +58,38 @@ static void _ResultSet_SetColumns
 	}
 }
 
+// returns true if v is or contains a graph entity
+static bool _SIValue_ReferencesGraph
+(
+	SIValue v
+) {
+	switch(SI_TYPE(v)) {
+		case T_NODE:
+		case T_EDGE:
+		case T_PATH:
+			return true;
+		case T_ARRAY: {
+			uint n = SIArray_Length(v);
+			for(uint i = 0; i < n; i++) {
+				if(_SIValue_ReferencesGraph(SIArray_Get(v, i))) return true;
+			}
+			return false;
+		}
+		case T_MAP: {
+			uint n = Map_KeyCount(v);
+			for(uint i = 0; i < n; i++) {
+				SIValue key;
+				SIValue val;
+				Map_GetIdx(v, i, &key, &val);
+				if(_SIValue_ReferencesGraph(val)) return true;
+			}
+			return false;
+		}
+		default:
+			return false;
+	}
+}
+
 // create a new result set
 ResultSet *NewResultSet
 (
@@ -72,6 +106,7 @@ ResultSet *NewResultSet
 	set->formatter           =  ResultSetFormatter_GetFormatter(format);
 	set->column_count        =  0;
 	set->cells_allocation    =  M_NONE;
+	set->references_graph    =  false;
 	set->columns_record_map  =  NULL;
 
 	// init resultset statistics
@@ -127,6 +162,15 @@ uint64_t ResultSet_RowCount
 	return DataBlock_ItemCount(set->cells) / set->column_count;
 }
 
+// returns true if resultset cells reference graph entities
+bool ResultSet_ReferencesGraph
+(
+	const ResultSet *set  // resultset to inquery
+) {
+	ASSERT(set != NULL);
+	return set->references_graph;
+}
+
 // add a new row to resultset
 int ResultSet_AddRecord
 (
@@ -143,6 +187,9 @@ int ResultSet_AddRecord
 		*cell = Record_Get(r, idx);
 		SIValue_Persist(cell);
 		set->cells_allocation |= SI_ALLOCATION(cell);
+		if(!set->references_graph) {
+			set->references_graph = _SIValue_ReferencesGraph(*cell);
+		}
 	}
 
 	// remove entry from record in a second pass
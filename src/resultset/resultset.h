@@ -27,6 +27,7 @@ typedef struct {
 	ResultSetFormatterType format;  // result set format; compact/verbose/nop
 	ResultSetFormatter *formatter;  // result set data formatter
 	SIAllocation cells_allocation;  // encountered values allocation
+	bool references_graph;          // cells reference graph entities
 } ResultSet;
 
 // map each column to a record index
@@ -51,6 +52,13 @@ uint64_t ResultSet_RowCount
 	const ResultSet *set  // resultset to inquery
 );
 
+// returns true if resultset cells reference graph entities
+// in which case the graph must remain locked while replying
+bool ResultSet_ReferencesGraph
+(
+	const ResultSet *set  // resultset to inquery
+);
+
 // add a new row to resultset
 int ResultSet_AddRecord
 (
@@ -258,6 +258,9 @@ GraphContext *RdbLoadGraphContext_v13
 
 		GraphDecodeContext_Reset(gc->decoding_context);
 
+		// select matrices storage formats in the background
+		GraphContext_ScheduleFlush(gc);
+
 		RedisModuleCtx *ctx = RedisModule_GetContextFromIO(rdb);
 		RedisModule_Log(ctx, "notice", "Done decoding graph %s", gc->graph_name);
 	}
@@ -6,6 +6,7 @@
 
 #include "graph_extensions.h"
 #include "../RG.h"
+#include "../util/rmalloc.h"
 #include "../util/datablock/oo_datablock.h"
 
 // functions declerations - implemented in graph.c
@@ -25,9 +26,6 @@ void Graph_EnsureNodeCap
 	M = Graph_GetAdjacencyMatrix(g, false);
 	RG_Matrix_resize(M, dim, dim);
 
-	M = Graph_GetNodeLabelMatrix(g);
-	RG_Matrix_resize(M, dim, dim);
-
 	n = array_len(g->labels);
 	for(int i = 0; i < n; i ++) {
 		M = Graph_GetLabelMatrix(g, i);
@@ -90,8 +88,8 @@ void Serializer_Graph_SetNode
 	}
 }
 
-// computes NodeLabelMarix out of label matrices
-// NodeLabelMatrix[:i] = diag(LabelMatrix[i])
+// computes node labels mapping out of label matrices
+// node_labels[id] = { i | LabelMatrix[i][id,id] }
 // must be called once after all virtual keys loaded for perf
 void Serializer_Graph_SetNodeLabels
 (
@@ -100,16 +98,9 @@ void Serializer_Graph_SetNodeLabels
 	ASSERT(g);
 
 	GrB_Vector v;
-	int node_count           = Graph_RequiredMatrixDim(g);
-	int label_count          = Graph_LabelTypeCount(g);
-	RG_Matrix node_labels    = Graph_GetNodeLabelMatrix(g);
-	GrB_Matrix node_labels_m = RG_MATRIX_M(node_labels);
-
-#if RG_DEBUG
-	GrB_Index nvals;
-	RG_Matrix_nvals(&nvals, node_labels);
-	ASSERT(nvals == 0);
-#endif
+	GrB_Index  *ids          = NULL;
+	GrB_Index  node_count    = Graph_RequiredMatrixDim(g);
+	int        label_count   = Graph_LabelTypeCount(g);
 
 	GrB_Vector_new(&v, GrB_BOOL, node_count);
 
@@ -117,13 +108,20 @@ void Serializer_Graph_SetNodeLabels
 		RG_Matrix  M  =  Graph_GetLabelMatrix(g, i);
 		GrB_Matrix m  =  RG_MATRIX_M(M);
 
+		// extract labeled node IDs from the label matrix diagonal
+		GrB_Index nvals;
 		GxB_Vector_diag(v, m, 0, NULL);
+		GrB_Vector_nvals(&nvals, v);
 
-		GxB_Row_subassign(node_labels_m, NULL, NULL, v, i, GrB_ALL, 0, NULL);
-	}
+		ids = rm_realloc(ids, sizeof(GrB_Index) * (nvals + 1));
+		GrB_Vector_extractTuples_BOOL(ids, NULL, &nvals, v);
 
-	GrB_transpose(node_labels_m, NULL, NULL, node_labels_m, NULL);
+		for(GrB_Index j = 0; j < nvals; j++) {
+			NodeLabels_Set(&g->node_labels, ids[j], i);
+		}
+	}
 
+	rm_free(ids);
 	GrB_Vector_free(&v);
 }
 
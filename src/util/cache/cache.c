@@ -6,100 +6,373 @@
 
 #include "cache.h"
 #include "RG.h"
+#include "xxhash.h"
+#include "../arr.h"
 #include "../rmalloc.h"
-#include "cache_array.h"
+
+#include <string.h>
 #include <pthread.h>
 
-static CacheEntry *_CacheEvictLRU(Cache *cache) {
-	CacheEntry *entry = CacheArray_FindMinLRU(cache->arr, cache->cap);
-	// Remove evicted element from the rax.
-	raxRemove(cache->lookup, (unsigned  char *)entry->key,
-	  strlen(entry->key), NULL);
-	CacheArray_CleanEntry(entry, cache->free_item);
+//------------------------------------------------------------------------------
+// reclamation
+//------------------------------------------------------------------------------
+
+// lookups don't take a lock, a removed entry might still be read
+// by lookups which started before it was removed
+//
+// every thread performing lookups owns a slot announcing the global epoch
+// observed when its current lookup started, 0 when idle
+// a removed entry is tagged with a newer epoch and is freed once
+// all in progress lookups announced an epoch at least as new
+
+// maximum number of threads performing lock free lookups
+// additional threads fall back to locking
+#define CACHE_MAX_READERS 512
+
+// marks a removed hash table slot
+#define CACHE_TOMBSTONE ((CacheEntry *)1)
+
+// announced epoch, padded to a cache line
+typedef struct {
+	uint64_t epoch;  // epoch observed by current lookup, 0 when idle
+	char pad[56];    // pad to a cache line
+} CacheReader;
+
+static CacheReader _readers[CACHE_MAX_READERS];
+static uint32_t _reader_count = 0;  // number of assigned reader slots
+static uint64_t _epoch = 1;         // global epoch
+
+// calling thread reader slot
+// -1 when unassigned, -2 when no slot is available
+static __thread int _reader_id = -1;
+
+// announce a lookup is in progress
+// returns the calling thread reader slot, -1 if thread has no slot
+static inline int _Cache_ReaderEnter(void) {
+	if(unlikely(_reader_id == -1)) {
+		uint32_t id = __atomic_fetch_add(&_reader_count, 1, __ATOMIC_SEQ_CST);
+		_reader_id = (id < CACHE_MAX_READERS) ? (int)id : -2;
+	}
 
-	return entry;
+	int id = _reader_id;
+	if(unlikely(id < 0)) return -1;
+
+	uint64_t epoch = __atomic_load_n(&_epoch, __ATOMIC_SEQ_CST);
+	__atomic_store_n(&_readers[id].epoch, epoch, __ATOMIC_SEQ_CST);
+	// make sure the announcement is visible before reading the hash table
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+
+	return id;
+}
+
+// announce lookup is done
+static inline void _Cache_ReaderExit
+(
+	int id
+) {
+	__atomic_store_n(&_readers[id].epoch, 0, __ATOMIC_RELEASE);
+}
+
+// oldest epoch announced by an in progress lookup, UINT64_MAX if none
+static uint64_t _Cache_OldestReader(void) {
+	uint64_t oldest = UINT64_MAX;
+	uint32_t n = __atomic_load_n(&_reader_count, __ATOMIC_SEQ_CST);
+	if(n > CACHE_MAX_READERS) n = CACHE_MAX_READERS;
+
+	for(uint32_t i = 0; i < n; i++) {
+		uint64_t epoch = __atomic_load_n(&_readers[i].epoch, __ATOMIC_SEQ_CST);
+		if(epoch != 0 && epoch < oldest) oldest = epoch;
+	}
+
+	return oldest;
 }
 
-static bool _Cache_SetValue(Cache *cache, const char *key, void *value,
-  		size_t key_len) {
+static void _Cache_FreeEntry
+(
+	Cache *cache,
+	CacheEntry *entry
+) {
+	cache->free_item(entry->value);
+	rm_free(entry->key);
+	rm_free(entry);
+}
+
+// free retired entries which are no longer observable
+// expecting cache lock to be held
+static void _Cache_Reclaim
+(
+	Cache *cache
+) {
+	uint n = array_len(cache->retired);
+	if(n == 0) return;
+
+	uint64_t oldest = _Cache_OldestReader();
+	for(int i = n - 1; i >= 0; i--) {
+		CacheEntry *entry = cache->retired[i];
+		if(entry->retired <= oldest) {
+			_Cache_FreeEntry(cache, entry);
+			array_del_fast(cache->retired, i);
+		}
+	}
+}
+
+//------------------------------------------------------------------------------
+// hash table
+//------------------------------------------------------------------------------
+
+static CacheEntry *_Cache_Find
+(
+	const Cache *cache,
+	const char *key,
+	uint64_t hash
+) {
+	for(uint64_t i = 0; i <= cache->mask; i++) {
+		CacheEntry *entry = __atomic_load_n(
+				cache->slots + ((hash + i) & cache->mask), __ATOMIC_ACQUIRE);
+
+		if(entry == NULL) break;
+		if(entry == CACHE_TOMBSTONE) continue;
+		if(entry->hash == hash && strcmp(entry->key, key) == 0) return entry;
+	}
+
+	return NULL;
+}
+
+// expecting cache lock to be held
+static void _Cache_InsertSlot
+(
+	Cache *cache,
+	CacheEntry *entry
+) {
+	for(uint64_t i = 0; i <= cache->mask; i++) {
+		CacheEntry **slot = cache->slots + ((entry->hash + i) & cache->mask);
+		if(*slot == NULL || *slot == CACHE_TOMBSTONE) {
+			if(*slot == CACHE_TOMBSTONE) cache->tombstones--;
+			__atomic_store_n(slot, entry, __ATOMIC_RELEASE);
+			return;
+		}
+	}
+
+	ASSERT(false && "cache hash table is full");
+}
+
+// rebuilds the hash table dropping tombstones
+// concurrent lookups might miss entries while the table is rebuilt
+// expecting cache lock to be held
+static void _Cache_Rehash
+(
+	Cache *cache
+) {
+	for(uint64_t i = 0; i <= cache->mask; i++) {
+		__atomic_store_n(cache->slots + i, NULL, __ATOMIC_RELEASE);
+	}
+	cache->tombstones = 0;
+
+	uint n = array_len(cache->entries);
+	for(uint i = 0; i < n; i++) _Cache_InsertSlot(cache, cache->entries[i]);
+}
+
+// removes the idx'th entry from the cache
+// expecting cache lock to be held
+static void _Cache_Remove
+(
+	Cache *cache,
+	uint idx
+) {
+	CacheEntry *entry = cache->entries[idx];
+
+	for(uint64_t i = 0; i <= cache->mask; i++) {
+		CacheEntry **slot = cache->slots + ((entry->hash + i) & cache->mask);
+		if(*slot == entry) {
+			__atomic_store_n(slot, CACHE_TOMBSTONE, __ATOMIC_RELEASE);
+			cache->tombstones++;
+			break;
+		}
+	}
+
+	array_del_fast(cache->entries, idx);
+	cache->size--;
+	cache->weight -= entry->weight;
+
+	// entry might be observed by in progress lookups, defer its release
+	entry->retired = __atomic_add_fetch(&_epoch, 1, __ATOMIC_SEQ_CST);
+	array_append(cache->retired, entry);
+
+	if(cache->tombstones > (cache->mask + 1) / 4) _Cache_Rehash(cache);
+}
+
+//------------------------------------------------------------------------------
+// eviction
+//------------------------------------------------------------------------------
+
+// returns the index of the least frequently used entry
+// ties are broken in favour of the oldest entry
+static uint _Cache_Victim
+(
+	const Cache *cache,
+	uint8_t *freq
+) {
+	uint victim = 0;
+	uint8_t min = UINT8_MAX;
+	uint64_t min_seq = UINT64_MAX;
+
+	uint n = array_len(cache->entries);
+	for(uint i = 0; i < n; i++) {
+		CacheEntry *entry = cache->entries[i];
+		uint8_t f = CacheSketch_Estimate(&cache->sketch, entry->hash);
+		if(f < min || (f == min && entry->seq < min_seq)) {
+			victim = i;
+			min = f;
+			min_seq = entry->seq;
+		}
+	}
+
+	*freq = min;
+	return victim;
+}
+
+// stores value under key
+// returns the new entry, NULL if key is already cached or denied admission
+// expecting cache lock to be held
+static CacheEntry *_Cache_SetValue
+(
+	Cache *cache,
+	const char *key,
+	void *value
+) {
 	ASSERT(key != NULL);
 	ASSERT(cache != NULL);
 
-	/* in case that another working thread had already inserted the item to the
-	 * cache, no need to re-insert it */
-	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
-	if(entry != raxNotFound) {
-		return false;
+	uint64_t hash = XXH64(key, strlen(key), 0);
+
+	// in case that another working thread had already inserted the item to the
+	// cache, no need to re-insert it
+	if(_Cache_Find(cache, key, hash) != NULL) return NULL;
+
+	// the access leading to this insertion was already counted by the lookup
+	// which missed the key, don't count it twice
+
+	uint64_t weight = 0;
+	if(cache->weigh_item != NULL) {
+		weight = cache->weigh_item(value);
+		if(weight > cache->max_weight) {
+			cache->rejections++;
+			return NULL;
+		}
 	}
 
-	// key is not in cache! test to see if cache is full?
-	if(cache->size == cache->cap) {
-		/* the cache is full, evict the least-recently-used element
-		 * and reuse its space for the new element */
-		entry = _CacheEvictLRU(cache);
-	} else {
-		// the array has space left in it, use the next available entry
-		entry = cache->arr + cache->size++;
+	// make room for the new entry
+	bool admitted = false;
+	while(cache->size == cache->cap ||
+		  (cache->weigh_item != NULL &&
+		   cache->weight + weight > cache->max_weight)) {
+		// the cache is full, admit key only if it's accessed
+		// at least as frequently as the least frequently used entry
+		uint8_t victim_freq;
+		uint victim = _Cache_Victim(cache, &victim_freq);
+		if(!admitted) {
+			if(CacheSketch_Estimate(&cache->sketch, hash) < victim_freq) {
+				cache->rejections++;
+				return NULL;
+			}
+			admitted = true;
+		}
+
+		_Cache_Remove(cache, victim);
+		cache->evictions++;
 	}
 
-	// populate the entry
-	char *k = rm_strdup(key);
-	cache->counter++;
-	CacheArray_PopulateEntry(cache->counter, entry, k, value);
+	CacheEntry *entry = rm_malloc(sizeof(CacheEntry));
+	entry->key     = rm_strdup(key);
+	entry->hash    = hash;
+	entry->value   = value;
+	entry->seq     = cache->seq++;
+	entry->weight  = weight;
+	entry->retired = 0;
 
+	_Cache_InsertSlot(cache, entry);
+	array_append(cache->entries, entry);
+	cache->size++;
+	cache->weight += weight;
 
-	// Add the new entry to the rax.
-	raxInsert(cache->lookup, (unsigned char *)key, key_len, entry, NULL);
+	_Cache_Reclaim(cache);
 
-	return true;
+	return entry;
 }
 
+//------------------------------------------------------------------------------
+// cache API
+//------------------------------------------------------------------------------
+
 Cache *Cache_New(uint cap, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copyFunc) {
 	ASSERT(cap > 0);
 	ASSERT(copyFunc != NULL);
 
-	Cache *cache     = rm_malloc(sizeof(Cache));
-	cache->cap       = cap;
-	cache->size      = 0;
-	cache->lookup    = raxNew();       // Instantiate key entry mapping.
-	cache->counter   = 0;             // Initialize counter to zero.
-	cache->copy_item = copyFunc;
-	cache->free_item = freeFunc;
-	cache->arr = rm_calloc(cap, sizeof(CacheEntry)); // Array of cached values.
-
-	// Initialize the read-write lock to protect access to the cache.
-	int res = pthread_rwlock_init(&cache->_cache_rwlock, NULL);
+	// keep the hash table at most half full
+	uint64_t n_slots = 4;
+	while(n_slots < (uint64_t)cap * 2) n_slots <<= 1;
+
+	Cache *cache      = rm_calloc(1, sizeof(Cache));
+	cache->cap        = cap;
+	cache->size       = 0;
+	cache->seq        = 0;
+	cache->mask       = n_slots - 1;
+	cache->slots      = rm_calloc(n_slots, sizeof(CacheEntry *));
+	cache->entries    = array_new(CacheEntry *, cap);
+	cache->retired    = array_new(CacheEntry *, 0);
+	cache->copy_item  = copyFunc;
+	cache->free_item  = freeFunc;
+
+	CacheSketch_Init(&cache->sketch, cap);
+
+	int res = pthread_mutex_init(&cache->_cache_lock, NULL);
 	UNUSED(res);
 	ASSERT(res == 0);
 
 	return cache;
 }
 
-void *Cache_GetValue(Cache *cache, const char *key) {
-	void *item = NULL;
-
+void Cache_SetMaxWeight
+(
+	Cache *cache,
+	uint64_t max_weight,
+	CacheEntryWeightFunc weighFunc
+) {
 	ASSERT(cache != NULL);
+	ASSERT(weighFunc != NULL);
+	ASSERT(cache->size == 0);
 
-	int res = pthread_rwlock_rdlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	cache->max_weight = max_weight;
+	cache->weigh_item = weighFunc;
+}
 
-	size_t key_len = strlen(key);
-	CacheEntry *entry = raxFind(cache->lookup, (unsigned char *)key, key_len);
+void *Cache_GetValue(Cache *cache, const char *key) {
+	ASSERT(cache != NULL);
 
-	if(entry == raxNotFound) goto cleanup;
+	void *item = NULL;
+	uint64_t hash = XXH64(key, strlen(key), 0);
 
-	// element is now the most recently used; update its LRU
-	// note that multiple threads can be here simultaneously
-	cache->counter++;
-	entry->LRU = cache->counter;
+	int reader = _Cache_ReaderEnter();
+	if(unlikely(reader < 0)) pthread_mutex_lock(&cache->_cache_lock);
 
 	// return a copy of element
-	item = cache->copy_item(entry->value);
+	// entry can't be freed while the lookup is announced
+	CacheEntry *entry = _Cache_Find(cache, key, hash);
+	if(entry != NULL) item = cache->copy_item(entry->value);
+
+	if(unlikely(reader < 0)) pthread_mutex_unlock(&cache->_cache_lock);
+	else _Cache_ReaderExit(reader);
+
+	CacheSketch_Increment(&cache->sketch, hash);
+
+	CacheCounters *counters =
+		cache->counters + ((reader < 0 ? 0 : reader) % CACHE_COUNTER_STRIPES);
+	if(item != NULL) {
+		__atomic_fetch_add(&counters->hits, 1, __ATOMIC_RELAXED);
+	} else {
+		__atomic_fetch_add(&counters->misses, 1, __ATOMIC_RELAXED);
+	}
 
-cleanup:
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
 	return item;
 }
 
@@ -107,61 +380,97 @@ void Cache_SetValue(Cache *cache, const char *key, void *value) {
 	ASSERT(key != NULL);
 	ASSERT(cache != NULL);
 
-	size_t key_len = strlen(key);
+	pthread_mutex_lock(&cache->_cache_lock);
 
-	// Acquire WRITE lock
-	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	// insert the value to the cache
+	CacheEntry *entry = _Cache_SetValue(cache, key, value);
 
-	// Insert the value to the cache.
-	_Cache_SetValue(cache, key, value, key_len);
+	pthread_mutex_unlock(&cache->_cache_lock);
 
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
+	if(entry == NULL) cache->free_item(value);
 }
 
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value) {
 	ASSERT(key != NULL);
 	ASSERT(cache != NULL);
 
-	size_t key_len = strlen(key);
 	void *value_to_return = value;
 
-	// acquire WRITE lock
-	int res = pthread_rwlock_wrlock(&cache->_cache_rwlock);
-	UNUSED(res);
-	ASSERT(res == 0);
+	pthread_mutex_lock(&cache->_cache_lock);
 
-	// return true if value was added, false if value already in cache
-	if(_Cache_SetValue(cache, key, value, key_len)) {
-		// return a copy of original value
+	// return a copy of the value if it was added
+	// the copy is made under the lock, as the entry might get evicted
+	if(_Cache_SetValue(cache, key, value) != NULL) {
 		value_to_return = cache->copy_item(value);
 	}
 
-	res = pthread_rwlock_unlock(&cache->_cache_rwlock);
-	ASSERT(res == 0);
+	pthread_mutex_unlock(&cache->_cache_lock);
 
 	return value_to_return;
 }
 
+void Cache_RemoveValue(Cache *cache, const char *key) {
+	ASSERT(key != NULL);
+	ASSERT(cache != NULL);
+
+	uint64_t hash = XXH64(key, strlen(key), 0);
+
+	pthread_mutex_lock(&cache->_cache_lock);
+
+	CacheEntry *entry = _Cache_Find(cache, key, hash);
+	if(entry != NULL) {
+		uint n = array_len(cache->entries);
+		for(uint i = 0; i < n; i++) {
+			if(cache->entries[i] == entry) {
+				_Cache_Remove(cache, i);
+				break;
+			}
+		}
+		_Cache_Reclaim(cache);
+	}
+
+	pthread_mutex_unlock(&cache->_cache_lock);
+}
+
+void Cache_GetStats(Cache *cache, CacheStats *stats) {
+	ASSERT(cache != NULL);
+	ASSERT(stats != NULL);
+
+	stats->hits   = 0;
+	stats->misses = 0;
+	for(uint i = 0; i < CACHE_COUNTER_STRIPES; i++) {
+		stats->hits   += __atomic_load_n(&cache->counters[i].hits, __ATOMIC_RELAXED);
+		stats->misses += __atomic_load_n(&cache->counters[i].misses, __ATOMIC_RELAXED);
+	}
+
+	pthread_mutex_lock(&cache->_cache_lock);
+
+	stats->size       = cache->size;
+	stats->weight     = cache->weight;
+	stats->evictions  = cache->evictions;
+	stats->rejections = cache->rejections;
+
+	pthread_mutex_unlock(&cache->_cache_lock);
+}
+
 void Cache_Free(Cache *cache) {
 	ASSERT(cache != NULL);
 
 	// free cache entries
-	for(size_t i = 0; i < cache->size; i++) {
-		CacheEntry *entry = cache->arr + i;
-		rm_free(entry->key);
-		cache->free_item(entry->value);
-	}
+	uint n = array_len(cache->entries);
+	for(uint i = 0; i < n; i++) _Cache_FreeEntry(cache, cache->entries[i]);
 
-	rm_free(cache->arr);
-	raxFree(cache->lookup);
+	n = array_len(cache->retired);
+	for(uint i = 0; i < n; i++) _Cache_FreeEntry(cache, cache->retired[i]);
 
-	int res = pthread_rwlock_destroy(&cache->_cache_rwlock);
+	array_free(cache->entries);
+	array_free(cache->retired);
+	rm_free(cache->slots);
+	CacheSketch_Free(&cache->sketch);
+
+	int res = pthread_mutex_destroy(&cache->_cache_lock);
 	UNUSED(res);
 	ASSERT(res == 0);
 
 	rm_free(cache);
 }
-
@@ -6,22 +6,88 @@
 
 #pragma once
 
-#include "cache_array.h"
-#include "rax.h"
+#include "cache_sketch.h"
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <pthread.h>
+#include <sys/types.h>
+
+// number of hit/miss counters stripes
+#define CACHE_COUNTER_STRIPES 16
+
+//------------------------------------------------------------------------------
+// function pointers
+//------------------------------------------------------------------------------
+
+// cache entry free function
+typedef void (*CacheEntryFreeFunc)(void *);
+
+// cache entry duplicate function
+typedef void *(*CacheEntryCopyFunc)(void *);
+
+// cache entry weight function
+typedef uint64_t (*CacheEntryWeightFunc)(const void *);
+
+// cached key/value
+typedef struct CacheEntry {
+	char *key;          // entry key
+	uint64_t hash;      // key hash
+	void *value;        // entry stored value
+	uint64_t seq;       // insertion order, breaks eviction ties
+	uint64_t weight;    // entry weight, 0 if the cache isn't weighted
+	uint64_t retired;   // epoch at which entry was removed from the cache
+} CacheEntry;
+
+// lookup counters, padded to avoid false sharing between stripes
+typedef struct {
+	uint64_t hits;    // number of lookups which found their key
+	uint64_t misses;  // number of lookups which didn't find their key
+	char pad[48];     // pad to a cache line
+} CacheCounters;
+
+// cache statistics
+typedef struct {
+	uint size;            // number of cached entries
+	uint64_t weight;      // total weight of cached entries
+	uint64_t hits;        // number of lookups which found their key
+	uint64_t misses;      // number of lookups which didn't find their key
+	uint64_t evictions;   // number of entries evicted to make room
+	uint64_t rejections;  // number of entries denied admission
+} CacheStats;
 
 /**
- * @brief Key-value cache, uses LRU policy for eviction.
+ * @brief Key-value cache, evicts the least frequently used entry.
  * Assumes owership over stored objects.
+ *
+ * Lookups take no lock, entries are kept in an open addressing hash table
+ * which is only modified under a lock, removed entries are freed once no
+ * lookup which might have observed them is in progress.
+ *
+ * Access frequencies are tracked by a sketch, once the cache is full a new
+ * entry is admitted only if it was accessed at least as frequently as the
+ * entry it replaces, such that a burst of one-off keys doesn't evict
+ * frequently used entries.
  */
 typedef struct Cache {
-	uint cap;                          // Cache capacity.
-	uint size;                         // Cache current size.
-	long long counter;                 // Atomic counter for number of reads.
-	rax *lookup;                       // Mapping between keys to entries, for fast lookups.
-	CacheEntry *arr;                   // Array of cache elements.
-	CacheEntryFreeFunc free_item;      // Callback function that free cached value.
-	CacheEntryCopyFunc copy_item;      // Callback function that copies cached value.
-	pthread_rwlock_t _cache_rwlock;    // Read-write lock to protect access to the cache.
+	uint cap;                                         // Cache capacity.
+	uint size;                                        // Cache current size.
+	uint64_t seq;                                     // Number of insertions.
+	CacheEntry **slots;                               // Hash table.
+	uint64_t mask;                                    // Number of slots - 1.
+	uint tombstones;                                  // Number of removed slots.
+	CacheEntry **entries;                             // Cached entries.
+	CacheEntry **retired;                             // Entries pending free.
+	CacheSketch sketch;                               // Access frequencies.
+	CacheCounters counters[CACHE_COUNTER_STRIPES];    // Lookup counters.
+	uint64_t evictions;                               // Number of evictions.
+	uint64_t rejections;                              // Number of rejections.
+	uint64_t weight;                                  // Total weight of cached entries.
+	uint64_t max_weight;                              // Max total weight, 0 if unbounded.
+	CacheEntryWeightFunc weigh_item;                  // Callback function that weighs cached value.
+	CacheEntryFreeFunc free_item;                     // Callback function that free cached value.
+	CacheEntryCopyFunc copy_item;                     // Callback function that copies cached value.
+	pthread_mutex_t _cache_lock;                      // Serializes cache modifications.
 } Cache;
 
 /**
@@ -33,8 +99,21 @@ typedef struct Cache {
  */
 Cache *Cache_New(uint size, CacheEntryFreeFunc freeFunc, CacheEntryCopyFunc copyFunc);
 
+/**
+ * @brief  Bounds the total weight of cached entries, in addition to their number.
+ * @note   Must be called before any value is stored.
+ *         Entries are evicted until a new entry fits, an entry heavier than
+ *         max_weight is never admitted.
+ * @param  *cache: cache pointer.
+ * @param  max_weight: max total weight of cached entries.
+ * @param  weighFunc: callback for weighing the stored values.
+ */
+void Cache_SetMaxWeight(Cache *cache, uint64_t max_weight,
+		CacheEntryWeightFunc weighFunc);
+
 /**
  * @brief  Returns a copy of value if it is cached, NULL otherwise.
+ * @note   Doesn't take a lock.
  * @param  *cache: cache pointer.
  * @param  *key: Key to look for.
  * @retval  pointer with the cached answer, NULL if the key isn't cached.
@@ -44,6 +123,7 @@ void *Cache_GetValue(Cache *cache, const char *key);
 /**
  * @brief  Stores value under key within the cache.
  * @note   In case the cache is full, this operation causes a cache eviction.
+ *         In case value isn't stored, it is freed.
  * @param  *cache: cache pointer.
  * @param  *key: Key for associating with value.
  * @param  *value: pointer with the relevant value.
@@ -56,13 +136,29 @@ void Cache_SetValue(Cache *cache, const char *key, void *item);
  * @param  *cache: cache pointer.
  * @param  *key: Key for associating with value.
  * @param  *value: pointer with the relevant value.
- * @retval A copy of the given value if a new item was added to the cache, the original value if it was already exist.
+ * @retval A copy of the given value if a new item was added to the cache,
+ *         the original value if it was already exist or denied admission.
  */
 void *Cache_SetGetValue(Cache *cache, const char *key, void *value);
 
+/**
+ * @brief  Removes key from the cache, if cached.
+ * @note   The removed value is freed once no lookup may observe it.
+ * @param  *cache: cache pointer.
+ * @param  *key: Key to remove.
+ */
+void Cache_RemoveValue(Cache *cache, const char *key);
+
+/**
+ * @brief  Collects cache statistics.
+ * @param  *cache: cache pointer.
+ * @param  *stats: [output] cache statistics.
+ */
+void Cache_GetStats(Cache *cache, CacheStats *stats);
+
 /**
  * @brief  Destroys the cache and free all stored items.
+ * @note   No lookups may be in progress.
  * @param  *cache: cache pointer
  */
 void Cache_Free(Cache *cache);
-
@@ -0,0 +1,115 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "cache_sketch.h"
+#include "../rmalloc.h"
+
+// row width bounds
+#define CACHE_SKETCH_MIN_WIDTH (1 << 8)
+#define CACHE_SKETCH_MAX_WIDTH (1 << 20)
+
+// number of counters per cached entry
+#define CACHE_SKETCH_WIDTH_FACTOR 16
+
+// number of accesses per counter triggering aging
+#define CACHE_SKETCH_SAMPLE_FACTOR 10
+
+// returns the position of key's counter within row
+static inline uint64_t _CacheSketch_Idx
+(
+	const CacheSketch *sketch,
+	uint64_t hash,
+	uint row
+) {
+	// derive a hash per row from two halves of the key's hash
+	uint64_t h1 = hash;
+	uint64_t h2 = (hash >> 32) | 1;
+	return (row * (sketch->mask + 1)) + ((h1 + row * h2) & sketch->mask);
+}
+
+// halve all counters
+static void _CacheSketch_Age
+(
+	CacheSketch *sketch
+) {
+	uint64_t n = (sketch->mask + 1) * CACHE_SKETCH_DEPTH;
+	for(uint64_t i = 0; i < n; i++) {
+		uint8_t c = __atomic_load_n(sketch->counters + i, __ATOMIC_RELAXED);
+		__atomic_store_n(sketch->counters + i, c >> 1, __ATOMIC_RELAXED);
+	}
+}
+
+void CacheSketch_Init
+(
+	CacheSketch *sketch,
+	uint cap
+) {
+	ASSERT(sketch != NULL);
+
+	uint64_t width = CACHE_SKETCH_MIN_WIDTH;
+	uint64_t target = (uint64_t)cap * CACHE_SKETCH_WIDTH_FACTOR;
+	while(width < target && width < CACHE_SKETCH_MAX_WIDTH) width <<= 1;
+
+	sketch->mask        = width - 1;
+	sketch->samples     = 0;
+	sketch->sample_size = width * CACHE_SKETCH_SAMPLE_FACTOR;
+	sketch->counters    = rm_calloc(width * CACHE_SKETCH_DEPTH, sizeof(uint8_t));
+}
+
+void CacheSketch_Increment
+(
+	CacheSketch *sketch,
+	uint64_t hash
+) {
+	ASSERT(sketch != NULL);
+
+	bool incremented = false;
+	for(uint row = 0; row < CACHE_SKETCH_DEPTH; row++) {
+		uint8_t *c = sketch->counters + _CacheSketch_Idx(sketch, hash, row);
+		// avoid writing to saturated counters
+		if(__atomic_load_n(c, __ATOMIC_RELAXED) < CACHE_SKETCH_MAX) {
+			__atomic_fetch_add(c, 1, __ATOMIC_RELAXED);
+			incremented = true;
+		}
+	}
+
+	if(!incremented) return;
+
+	uint64_t samples = __atomic_add_fetch(&sketch->samples, 1, __ATOMIC_RELAXED);
+	if(samples == sketch->sample_size) {
+		// a single thread reaches the sample size and ages the sketch
+		_CacheSketch_Age(sketch);
+		__atomic_sub_fetch(&sketch->samples, samples / 2, __ATOMIC_RELAXED);
+	}
+}
+
+uint8_t CacheSketch_Estimate
+(
+	const CacheSketch *sketch,
+	uint64_t hash
+) {
+	ASSERT(sketch != NULL);
+
+	uint8_t min = CACHE_SKETCH_MAX;
+	for(uint row = 0; row < CACHE_SKETCH_DEPTH; row++) {
+		uint8_t c = __atomic_load_n(
+				sketch->counters + _CacheSketch_Idx(sketch, hash, row),
+				__ATOMIC_RELAXED);
+		if(c < min) min = c;
+	}
+
+	return min;
+}
+
+void CacheSketch_Free
+(
+	CacheSketch *sketch
+) {
+	ASSERT(sketch != NULL);
+	rm_free(sketch->counters);
+	sketch->counters = NULL;
+}
@@ -0,0 +1,60 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include <stdint.h>
+#include <sys/types.h>
+
+// number of rows in the sketch
+#define CACHE_SKETCH_DEPTH 4
+
+// maximum value of a counter
+#define CACHE_SKETCH_MAX 15
+
+// frequency sketch
+// estimates how many times a key was accessed recently
+//
+// a count-min sketch with small saturating counters
+// once enough accesses were recorded all counters are halved
+// such that old accesses fade away
+//
+// recording and estimating are lock free
+// a saturated counter is never written to, as such frequently accessed keys
+// don't contend over the sketch
+typedef struct {
+	uint8_t *counters;     // CACHE_SKETCH_DEPTH rows of counters
+	uint64_t mask;         // row width - 1
+	uint64_t samples;      // number of accesses recorded since last aging
+	uint64_t sample_size;  // number of accesses triggering aging
+} CacheSketch;
+
+// initialize sketch for a cache of capacity cap
+void CacheSketch_Init
+(
+	CacheSketch *sketch,  // sketch to initialize
+	uint cap              // cache capacity
+);
+
+// record an access to key
+void CacheSketch_Increment
+(
+	CacheSketch *sketch,  // sketch
+	uint64_t hash         // key hash
+);
+
+// estimate the number of recent accesses to key
+uint8_t CacheSketch_Estimate
+(
+	const CacheSketch *sketch,  // sketch
+	uint64_t hash               // key hash
+);
+
+// free sketch internals
+void CacheSketch_Free
+(
+	CacheSketch *sketch  // sketch to free
+);
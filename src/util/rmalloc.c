@@ -51,6 +51,11 @@ static inline void _nmalloc_increment(int64_t n_bytes) {
 	}
 }
 
+void rm_add_n_alloced(int64_t n_bytes) {
+	// memory consumption is tracked only when a memory capacity is set
+	if(mem_capacity > 0) _nmalloc_increment(n_bytes);
+}
+
 void *rm_alloc_with_capacity(size_t n_bytes) {
 	void *p = RedisModule_Alloc_Orig(n_bytes);
 	_nmalloc_increment(n_bytes);
@@ -84,6 +89,14 @@ void rm_free_with_capacity(void *ptr) {
 	RedisModule_Free_Orig(ptr);
 }
 
+int64_t rm_get_mem_capacity(void) {
+	return mem_capacity;
+}
+
+int64_t rm_get_n_alloced(void) {
+	return n_alloced;
+}
+
 void rm_set_mem_capacity(int64_t cap) {
 	bool is_capped = (mem_capacity > 0); // current allocator applies memory cap
 	bool should_cap = (cap > 0); // should we use a memory capped allocator
@@ -121,9 +134,20 @@ void rm_set_mem_capacity(int64_t cap) {
 void rm_reset_n_alloced() {
 }
 
+void rm_add_n_alloced(int64_t n_bytes) {
+}
+
 void rm_set_mem_capacity(int64_t cap) {
 }
 
+int64_t rm_get_mem_capacity(void) {
+	return 0;
+}
+
+int64_t rm_get_n_alloced(void) {
+	return 0;
+}
+
 #endif // REDIS_MODULE_TARGET
 
 /* Redefine the allocator functions to use the malloc family.
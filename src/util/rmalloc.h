@@ -18,6 +18,10 @@ void rm_set_mem_capacity(int64_t cap);
 // reset thread memory consumption counter to 0 (no memory consumed)
 void rm_reset_n_alloced();
 
+// charges n_bytes to the calling thread's memory consumption
+// used to account for memory allocated on behalf of the thread by others
+void rm_add_n_alloced(int64_t n_bytes);
+
 static inline void *rm_malloc(size_t n) {
 	return RedisModule_Alloc(n);
 }
@@ -57,6 +61,13 @@ static inline char *rm_strndup(const char *s, size_t n) {
 
 #define rm_new(x) rm_malloc(sizeof(x))
 
+// returns the current memory capacity, 0 if memory consumption isn't capped
+int64_t rm_get_mem_capacity(void);
+
+// returns the amount of memory consumed by the calling thread
+// memory consumption is tracked only when a memory capacity is set
+int64_t rm_get_n_alloced(void);
+
 /* Revert the allocator patches so that
  * the stdlib malloc functions will be used
  * for use when executing code from non-Redis
@@ -0,0 +1,216 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "arr.h"
+#include "sort_key.h"
+#include "../datatypes/point.h"
+#include "../datatypes/array.h"
+#include "../graph/entities/graph_entity.h"
+
+#include <math.h>
+#include <string.h>
+
+// terminates an encoded array, ordered before every type tag
+#define SORT_KEY_END 0
+
+// returns the type tag of v
+// tags follow the order of the SIType enum, which is Cypher's global order
+// integers and floating points share the same tag
+static inline unsigned char _SortKey_Tag
+(
+	SIType t
+) {
+	if(t == T_DOUBLE) t = T_INT64;
+	// skip SORT_KEY_END
+	return (unsigned char)(__builtin_ctz(t) + 1);
+}
+
+static inline void _SortKey_Write
+(
+	unsigned char **key,
+	const void *src,
+	size_t n
+) {
+	array_ensure_append(*key, src, n, unsigned char);
+}
+
+// writes an unsigned 64 bit integer in big endian order
+static inline void _SortKey_WriteU64
+(
+	unsigned char **key,
+	uint64_t v
+) {
+	unsigned char buf[8];
+	for(int i = 7; i >= 0; i--) {
+		buf[i] = (unsigned char)(v & 0xFF);
+		v >>= 8;
+	}
+	_SortKey_Write(key, buf, sizeof(buf));
+}
+
+// writes a signed 64 bit integer such that byte order agrees with value order
+static inline void _SortKey_WriteI64
+(
+	unsigned char **key,
+	int64_t v
+) {
+	_SortKey_WriteU64(key, (uint64_t)v ^ (1ULL << 63));
+}
+
+// writes a double such that byte order agrees with numeric order
+// NaN is ordered after +inf, -0.0 is treated as 0.0
+static inline void _SortKey_WriteDouble
+(
+	unsigned char **key,
+	double d
+) {
+	uint64_t bits;
+
+	if(isnan(d)) {
+		bits = UINT64_MAX;
+	} else {
+		if(d == 0) d = 0;  // normalize -0.0
+		memcpy(&bits, &d, sizeof(bits));
+		// flip all bits of negatives, the sign bit of positives
+		bits = (bits & (1ULL << 63)) ? ~bits : bits | (1ULL << 63);
+	}
+
+	_SortKey_WriteU64(key, bits);
+}
+
+// clamp a double to the int64 range
+static inline int64_t _SortKey_DoubleToI64
+(
+	double d
+) {
+	if(isnan(d) || d >= 9223372036854775807.0) return INT64_MAX;
+	if(d <= -9223372036854775808.0) return INT64_MIN;
+	return (int64_t)d;
+}
+
+bool SortKey_Supported
+(
+	SIValue v
+) {
+	switch(SI_TYPE(v)) {
+		case T_NULL:
+		case T_BOOL:
+		case T_INT64:
+		case T_DOUBLE:
+		case T_STRING:
+		case T_NODE:
+		case T_EDGE:
+		case T_POINT:
+			return true;
+		case T_ARRAY: {
+			uint32_t n = SIArray_Length(v);
+			for(uint32_t i = 0; i < n; i++) {
+				if(!SortKey_Supported(SIArray_Get(v, i))) return false;
+			}
+			return true;
+		}
+		default:
+			return false;
+	}
+}
+
+// appends the encoding of v to key, without inversion
+static bool _SortKey_Encode
+(
+	unsigned char **key,
+	SIValue v
+) {
+	SIType t = SI_TYPE(v);
+	unsigned char tag = _SortKey_Tag(t);
+
+	switch(t) {
+		case T_NULL:
+			_SortKey_Write(key, &tag, 1);
+			break;
+		case T_BOOL: {
+			unsigned char b = v.longval != 0;
+			_SortKey_Write(key, &tag, 1);
+			_SortKey_Write(key, &b, 1);
+			break;
+		}
+		case T_INT64:
+			// order by numeric value, ties broken by the exact integer
+			// as large integers lose precision when converted
+			_SortKey_Write(key, &tag, 1);
+			_SortKey_WriteDouble(key, (double)v.longval);
+			_SortKey_WriteI64(key, v.longval);
+			break;
+		case T_DOUBLE:
+			_SortKey_Write(key, &tag, 1);
+			_SortKey_WriteDouble(key, v.doubleval);
+			_SortKey_WriteI64(key, _SortKey_DoubleToI64(v.doubleval));
+			break;
+		case T_STRING:
+			// strings never contain a NULL byte, use it as a terminator
+			_SortKey_Write(key, &tag, 1);
+			_SortKey_Write(key, v.stringval, strlen(v.stringval) + 1);
+			break;
+		case T_NODE:
+		case T_EDGE:
+			_SortKey_Write(key, &tag, 1);
+			_SortKey_WriteU64(key, ENTITY_GET_ID((GraphEntity *)v.ptrval));
+			break;
+		case T_POINT:
+			_SortKey_Write(key, &tag, 1);
+			_SortKey_WriteDouble(key, Point_lon(v));
+			_SortKey_WriteDouble(key, Point_lat(v));
+			break;
+		case T_ARRAY: {
+			// arrays are ordered element by element, shorter arrays first
+			_SortKey_Write(key, &tag, 1);
+			uint32_t n = SIArray_Length(v);
+			for(uint32_t i = 0; i < n; i++) {
+				if(!_SortKey_Encode(key, SIArray_Get(v, i))) return false;
+			}
+			unsigned char end = SORT_KEY_END;
+			_SortKey_Write(key, &end, 1);
+			break;
+		}
+		default:
+			return false;
+	}
+
+	return true;
+}
+
+bool SortKey_Append
+(
+	unsigned char **key,
+	SIValue v,
+	bool descending
+) {
+	ASSERT(key != NULL && *key != NULL);
+
+	uint32_t start = array_len(*key);
+	if(!_SortKey_Encode(key, v)) return false;
+
+	if(descending) {
+		unsigned char *k = *key;
+		uint32_t end = array_len(k);
+		for(uint32_t i = start; i < end; i++) k[i] = ~k[i];
+	}
+
+	return true;
+}
+
+int SortKey_Compare
+(
+	const unsigned char *a,
+	uint32_t a_len,
+	const unsigned char *b,
+	uint32_t b_len
+) {
+	uint32_t n = (a_len < b_len) ? a_len : b_len;
+	int res = memcmp(a, b, n);
+	if(res != 0) return res;
+	return (a_len > b_len) - (a_len < b_len);
+}
@@ -0,0 +1,54 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../value.h"
+
+#include <stdint.h>
+
+// sort keys are byte strings encoding a tuple of SIValues
+// such that comparing two keys using memcmp agrees with comparing
+// their tuples value by value using SIValue_Compare
+//
+// every value is encoded as a type tag followed by its payload
+// tags follow Cypher's global type order, integers and floating points
+// share a tag and are ordered by their numeric value
+// each encoded value is self delimiting, as such keys can be concatenated
+// values sorted in descending order have their encoding inverted
+//
+// the encoding refines SIValue_Compare:
+// values SIValue_Compare considers equal might be ordered, e.g. 1 and 1.0
+// while NaN is ordered after all other numerics
+//
+// maps, paths and temporal values aren't supported
+
+// returns true if v can be encoded
+bool SortKey_Supported
+(
+	SIValue v  // value to inspect
+);
+
+// appends the encoding of v to key
+// key is an arr.h byte array
+// returns false if v can't be encoded, in which case key is left partially
+// written and should be discarded
+bool SortKey_Append
+(
+	unsigned char **key,  // [input/output] key to extend
+	SIValue v,            // value to encode
+	bool descending       // invert encoding
+);
+
+// compares two keys
+// return value similar to strcmp
+int SortKey_Compare
+(
+	const unsigned char *a,  // first key
+	uint32_t a_len,          // first key length
+	const unsigned char *b,  // second key
+	uint32_t b_len           // second key length
+);
@@ -206,6 +206,21 @@ void **ThreadPools_GetTasksByHandler
 	return tasks;
 }
 
+// removes queued write tasks from the front of the writers queue
+// as long as they're handled by handler and accepted by pred
+void ThreadPools_PullWorkWriter
+(
+	void (*handler)(void *),               // task handler to match
+	bool (*pred)(void *arg, void *pdata),  // task filter
+	void *pdata,                           // filter private data
+	void **tasks,                          // removed tasks
+	uint32_t *n                            // [in/out] max/actual number of tasks
+) {
+	ASSERT(_writers_thpool != NULL);
+
+	thpool_pull_tasks(_writers_thpool, tasks, n, handler, pred, pdata);
+}
+
 void ThreadPools_Destroy
 (
 	void
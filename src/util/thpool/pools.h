@@ -74,6 +74,18 @@ void **ThreadPools_GetTasksByHandler
 	uint32_t *n               // number of tasks returned
 );
 
+// removes queued write tasks from the front of the writers queue
+// as long as they're handled by handler and accepted by pred
+// up to *n tasks are removed, the removed tasks are the caller's to execute
+void ThreadPools_PullWorkWriter
+(
+	void (*handler)(void *),               // task handler to match
+	bool (*pred)(void *arg, void *pdata),  // task filter
+	void *pdata,                           // filter private data
+	void **tasks,                          // removed tasks
+	uint32_t *n                            // [in/out] max/actual number of tasks
+);
+
 // destroies all threadpools, allows threads to exit gracefully
 void ThreadPools_Destroy
 (
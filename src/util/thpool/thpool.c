@@ -348,6 +348,52 @@ void thpool_get_tasks
 	*num_tasks = i;
 }
 
+// removes tasks from the front of the queue, as long as they're handled by
+// handler and accepted by pred, up to *num_tasks tasks are removed
+void thpool_pull_tasks
+(
+	threadpool thpool_p,                  // thread pool
+	void **tasks,                         // array of removed tasks
+	uint32_t *num_tasks,                  // [in/out] max/actual number of tasks
+	void (*handler)(void *),              // handler function
+	bool (*pred)(void *arg, void *pdata), // task filter
+	void *pdata                           // filter private data
+) {
+	// validations
+	ASSERT(pred      != NULL);
+	ASSERT(tasks     != NULL);
+	ASSERT(handler   != NULL);
+	ASSERT(thpool_p  != NULL);
+	ASSERT(num_tasks != NULL);
+
+	jobqueue *jobqueue_p = &thpool_p->jobqueue;
+
+	// lock job queue
+	pthread_mutex_lock(&jobqueue_p->rwmutex);
+
+	// stop at the first rejected task, preserving queue order
+	uint32_t i = 0;
+	while(i < *num_tasks && jobqueue_p->len > 0) {
+		job *job_p = jobqueue_p->front;
+		if(job_p->function != handler || !pred(job_p->arg, pdata)) break;
+
+		tasks[i++] = job_p->arg;
+
+		// detach job from queue
+		jobqueue_p->front = job_p->prev;
+		jobqueue_p->len--;
+		if(jobqueue_p->len == 0) jobqueue_p->rear = NULL;
+
+		rm_free(job_p);
+	}
+
+	// release lock
+	pthread_mutex_unlock(&jobqueue_p->rwmutex);
+
+	// set number of tasks removed
+	*num_tasks = i;
+}
+
 /* ============================ THREAD ============================== */
 
 /* Initialize a thread in the thread pool
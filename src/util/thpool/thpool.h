@@ -254,6 +254,18 @@ void thpool_get_tasks
 	void (*match)(void*)      // [optional] executed on every match task
 );
 
+// removes tasks from the front of the queue, as long as they're handled by
+// handler and accepted by pred, up to *num_tasks tasks are removed
+void thpool_pull_tasks
+(
+	threadpool thpool_p,                  // thread pool
+	void **tasks,                         // array of removed tasks
+	uint32_t *num_tasks,                  // [in/out] max/actual number of tasks
+	void (*handler)(void *),              // handler function
+	bool (*pred)(void *arg, void *pdata), // task filter
+	void *pdata                           // filter private data
+);
+
 #ifdef __cplusplus
 }
 #endif
@@ -0,0 +1,296 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "RG.h"
+#include "arr.h"
+#include "rmalloc.h"
+#include "tuple_table.h"
+#include "../graph/entities/node.h"
+#include "../graph/entities/edge.h"
+
+#define TUPLE_TABLE_INITIAL_CAP 16           // initial number of slots
+#define TUPLE_TABLE_BLOCK_SIZE  (64 * 1024)  // arena block size
+
+//------------------------------------------------------------------------------
+// arena
+//------------------------------------------------------------------------------
+
+// allocates n bytes from the table's arena
+// returns NULL if n is too large for an arena block
+static void *_TupleTable_ArenaAlloc
+(
+	TupleTable *t,
+	size_t n
+) {
+	// keep allocations 8 bytes aligned
+	n = (n + 7) & ~(size_t)7;
+	if(n > TUPLE_TABLE_BLOCK_SIZE / 4) return NULL;
+
+	uint32_t nblocks = array_len(t->blocks);
+	if(nblocks == 0 || t->block_used + n > TUPLE_TABLE_BLOCK_SIZE) {
+		array_append(t->blocks, rm_malloc(TUPLE_TABLE_BLOCK_SIZE));
+		nblocks++;
+		t->block_used = 0;
+	}
+
+	void *p = t->blocks[nblocks - 1] + t->block_used;
+	t->block_used += n;
+	return p;
+}
+
+// returns a copy of v owned by the table
+static SIValue _TupleTable_StoreValue
+(
+	TupleTable *t,
+	SIValue v
+) {
+	void *p = NULL;
+	size_t n = 0;
+
+	switch(SI_TYPE(v)) {
+		case T_STRING:
+			n = strlen(v.stringval) + 1;
+			p = _TupleTable_ArenaAlloc(t, n);
+			if(p == NULL) break;
+			memcpy(p, v.stringval, n);
+			// stored values are released along with the table
+			// mark as volatile such that persisting them creates a copy
+			return (SIValue) {
+				.stringval = p, .type = T_STRING, .allocation = M_VOLATILE
+			};
+		case T_NODE:
+		case T_EDGE:
+			n = (SI_TYPE(v) == T_NODE) ? sizeof(Node) : sizeof(Edge);
+			p = _TupleTable_ArenaAlloc(t, n);
+			ASSERT(p != NULL);
+			memcpy(p, v.ptrval, n);
+			return (SIValue) {
+				.ptrval = p, .type = SI_TYPE(v), .allocation = M_VOLATILE
+			};
+		default:
+			break;
+	}
+
+	// owned allocation
+	return SI_CloneValue(v);
+}
+
+//------------------------------------------------------------------------------
+// slots
+//------------------------------------------------------------------------------
+
+// returns true if tuples a and b are equal
+static inline bool _TupleTable_TupleEqual
+(
+	const SIValue *a,
+	const SIValue *b,
+	uint arity
+) {
+	for(uint i = 0; i < arity; i++) {
+		// NULLs are considered equal to one another
+		if(SIValue_Compare(a[i], b[i], NULL) != 0) return false;
+	}
+	return true;
+}
+
+// returns position of the slot holding tuple
+// or the position of the empty slot it should be placed in
+static inline uint32_t _TupleTable_Probe
+(
+	const TupleTable *t,
+	const SIValue *tuple,
+	XXH64_hash_t hash
+) {
+	uint32_t pos = hash & t->mask;
+	while(true) {
+		const TupleTableSlot *s = t->slots + pos;
+		if(s->id == 0) return pos;
+		if(s->hash == hash &&
+		   _TupleTable_TupleEqual(TupleTable_Get(t, s->id - 1), tuple,
+			   t->arity)) {
+			return pos;
+		}
+		pos = (pos + 1) & t->mask;
+	}
+}
+
+// doubles the number of slots
+static void _TupleTable_Grow
+(
+	TupleTable *t
+) {
+	uint32_t old_cap = t->mask + 1;
+	uint32_t new_cap = old_cap * 2;
+	TupleTableSlot *old_slots = t->slots;
+
+	t->slots = rm_calloc(new_cap, sizeof(TupleTableSlot));
+	t->mask  = new_cap - 1;
+
+	// re-insert slots, stored tuples are known to be distinct
+	for(uint32_t i = 0; i < old_cap; i++) {
+		TupleTableSlot s = old_slots[i];
+		if(s.id == 0) continue;
+
+		uint32_t pos = s.hash & t->mask;
+		while(t->slots[pos].id != 0) pos = (pos + 1) & t->mask;
+		t->slots[pos] = s;
+	}
+
+	rm_free(old_slots);
+}
+
+//------------------------------------------------------------------------------
+// API
+//------------------------------------------------------------------------------
+
+// create a new tuple table
+TupleTable *TupleTable_New
+(
+	uint arity  // number of values per tuple
+) {
+	TupleTable *t = rm_malloc(sizeof(TupleTable));
+
+	t->arity      = arity;
+	t->count      = 0;
+	t->mask       = TUPLE_TABLE_INITIAL_CAP - 1;
+	t->slots      = rm_calloc(TUPLE_TABLE_INITIAL_CAP, sizeof(TupleTableSlot));
+	t->keys       = array_new(SIValue, TUPLE_TABLE_INITIAL_CAP * arity);
+	t->blocks     = array_new(char *, 1);
+	t->block_used = 0;
+
+	return t;
+}
+
+// computes tuple hash
+XXH64_hash_t TupleTable_Hash
+(
+	const SIValue *tuple,  // tuple to hash
+	uint arity             // number of values in tuple
+) {
+	XXH64_state_t state;
+	XXH_errorcode res = XXH64_reset(&state, 0);
+	UNUSED(res);
+	ASSERT(res != XXH_ERROR);
+
+	for(uint i = 0; i < arity; i++) {
+		SIValue_HashUpdate(tuple[i], &state);
+	}
+
+	return XXH64_digest(&state);
+}
+
+// returns the ID of tuple, TUPLE_TABLE_NOT_FOUND if missing
+uint32_t TupleTable_Find
+(
+	const TupleTable *t,   // table
+	const SIValue *tuple,  // tuple to look up
+	XXH64_hash_t hash      // tuple hash
+) {
+	ASSERT(t     != NULL);
+	ASSERT(tuple != NULL);
+
+	uint32_t pos = _TupleTable_Probe(t, tuple, hash);
+	uint32_t id  = t->slots[pos].id;
+	return (id == 0) ? TUPLE_TABLE_NOT_FOUND : id - 1;
+}
+
+// returns the ID of tuple, adding a copy of it if missing
+uint32_t TupleTable_FindOrAdd
+(
+	TupleTable *t,         // table
+	const SIValue *tuple,  // tuple to look up
+	XXH64_hash_t hash,     // tuple hash
+	bool *added            // [output] tuple added
+) {
+	ASSERT(t     != NULL);
+	ASSERT(tuple != NULL);
+	ASSERT(added != NULL);
+
+	uint32_t pos = _TupleTable_Probe(t, tuple, hash);
+	if(t->slots[pos].id != 0) {
+		*added = false;
+		return t->slots[pos].id - 1;
+	}
+
+	// store tuple
+	uint32_t id = t->count++;
+	for(uint i = 0; i < t->arity; i++) {
+		array_append(t->keys, _TupleTable_StoreValue(t, tuple[i]));
+	}
+
+	t->slots[pos].hash = hash;
+	t->slots[pos].id   = id + 1;
+	*added = true;
+
+	// keep load factor under 0.75
+	if(t->count * 4 > (t->mask + 1) * 3) _TupleTable_Grow(t);
+
+	return id;
+}
+
+// returns stored tuple by ID
+const SIValue *TupleTable_Get
+(
+	const TupleTable *t,  // table
+	uint32_t id           // tuple ID
+) {
+	ASSERT(t != NULL);
+	ASSERT(id < t->count);
+
+	return t->keys + (size_t)id * t->arity;
+}
+
+// returns number of tuples in table
+uint32_t TupleTable_Count
+(
+	const TupleTable *t  // table
+) {
+	ASSERT(t != NULL);
+	return t->count;
+}
+
+// removes all tuples
+void TupleTable_Clear
+(
+	TupleTable *t  // table to clear
+) {
+	ASSERT(t != NULL);
+
+	// free owned values, arena values are released with their blocks
+	uint32_t n = array_len(t->keys);
+	for(uint32_t i = 0; i < n; i++) {
+		SIValue_Free(t->keys[i]);
+	}
+	array_clear(t->keys);
+
+	uint32_t nblocks = array_len(t->blocks);
+	for(uint32_t i = 0; i < nblocks; i++) {
+		rm_free(t->blocks[i]);
+	}
+	array_clear(t->blocks);
+	t->block_used = 0;
+
+	memset(t->slots, 0, sizeof(TupleTableSlot) * (t->mask + 1));
+	t->count = 0;
+}
+
+// free table
+void TupleTable_Free
+(
+	TupleTable **t  // table to free
+) {
+	ASSERT(t != NULL && *t != NULL);
+
+	TupleTable *_t = *t;
+
+	TupleTable_Clear(_t);
+	array_free(_t->keys);
+	array_free(_t->blocks);
+	rm_free(_t->slots);
+	rm_free(_t);
+
+	*t = NULL;
+}
@@ -0,0 +1,96 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#pragma once
+
+#include "../value.h"
+
+#include <stdint.h>
+
+// TupleTable maps fixed arity tuples of SIValues to dense IDs
+//
+// IDs are assigned in insertion order starting at 0
+// tuples are stored contiguously, `arity` values per ID
+// lookups use an open addressing table of (hash, ID) slots with
+// linear probing, candidates sharing a hash are verified against the
+// stored values, such that hash collisions never merge distinct tuples
+//
+// strings and graph entities are copied into an arena owned by the table
+// avoiding an allocation per stored value
+
+#define TUPLE_TABLE_NOT_FOUND UINT32_MAX
+
+typedef struct {
+	XXH64_hash_t hash;  // tuple hash
+	uint32_t id;        // tuple ID + 1, 0 marks an empty slot
+} TupleTableSlot;
+
+typedef struct {
+	uint arity;             // number of values per tuple
+	uint32_t count;         // number of tuples
+	uint32_t mask;          // number of slots - 1
+	TupleTableSlot *slots;  // open addressing slots
+	SIValue *keys;          // stored tuples
+	char **blocks;          // arena blocks
+	size_t block_used;      // number of bytes used in last block
+} TupleTable;
+
+// create a new tuple table
+TupleTable *TupleTable_New
+(
+	uint arity  // number of values per tuple
+);
+
+// computes tuple hash
+XXH64_hash_t TupleTable_Hash
+(
+	const SIValue *tuple,  // tuple to hash
+	uint arity             // number of values in tuple
+);
+
+// returns the ID of tuple, TUPLE_TABLE_NOT_FOUND if missing
+uint32_t TupleTable_Find
+(
+	const TupleTable *t,   // table
+	const SIValue *tuple,  // tuple to look up
+	XXH64_hash_t hash      // tuple hash
+);
+
+// returns the ID of tuple, adding a copy of it if missing
+// `added` is set to true if tuple was added
+uint32_t TupleTable_FindOrAdd
+(
+	TupleTable *t,         // table
+	const SIValue *tuple,  // tuple to look up
+	XXH64_hash_t hash,     // tuple hash
+	bool *added            // [output] tuple added
+);
+
+// returns stored tuple by ID
+// the returned values are owned by the table
+const SIValue *TupleTable_Get
+(
+	const TupleTable *t,  // table
+	uint32_t id           // tuple ID
+);
+
+// returns number of tuples in table
+uint32_t TupleTable_Count
+(
+	const TupleTable *t  // table
+);
+
+// removes all tuples
+void TupleTable_Clear
+(
+	TupleTable *t  // table to clear
+);
+
+// free table
+void TupleTable_Free
+(
+	TupleTable **t  // table to free
+);
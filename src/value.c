@@ -740,6 +740,15 @@ void SIValue_HashUpdate(SIValue v, XXH64_state_t *state) {
 			inner_hash = SIPath_HashCode(v);
 			XXH64_update(state, &inner_hash, sizeof(inner_hash));
 			return;
+		case T_POINT: {
+			XXH64_update(state, &t, sizeof(t));
+			// normalize -0.0 to 0.0, points are compared by value
+			float lat = Point_lat(v) + 0.0f;
+			float lon = Point_lon(v) + 0.0f;
+			XXH64_update(state, &lat, sizeof(lat));
+			XXH64_update(state, &lon, sizeof(lon));
+			return;
+		}
 			// TODO: Implement for temporal types once we support them.
 		default:
 			ASSERT(false);
@@ -762,6 +771,60 @@ XXH64_hash_t SIValue_HashCode(SIValue v) {
 	return XXH64_digest(&state);
 }
 
+// writes a binary representation of v to stream
+void SIValue_ToBinary
+(
+	FILE *stream,     // stream to write value to
+	const SIValue *v  // value to write
+) {
+	ASSERT(v      != NULL);
+	ASSERT(stream != NULL);
+
+	// format:
+	//    type
+	//    value
+	bool b;
+	SIType t = SI_TYPE(*v);
+
+	// write type
+	fwrite_assert(&t, sizeof(SIType), stream);
+
+	// write value
+	switch(t) {
+		case T_POINT:
+			fwrite_assert(&v->point, sizeof(v->point), stream);
+			break;
+		case T_ARRAY:
+			SIArray_ToBinary(stream, v);
+			break;
+		case T_STRING:
+			fwrite_string(v->stringval, stream);
+			break;
+		case T_BOOL:
+			b = SIValue_IsTrue(*v);
+			fwrite_assert(&b, sizeof(b), stream);
+			break;
+		case T_INT64:
+		case T_DATETIME:
+		case T_LOCALDATETIME:
+		case T_DATE:
+		case T_TIME:
+		case T_LOCALTIME:
+		case T_DURATION:
+			// temporal values share the 'longval' representation
+			fwrite_assert(&v->longval, sizeof(v->longval), stream);
+			break;
+		case T_DOUBLE:
+			fwrite_assert(&v->doubleval, sizeof(v->doubleval), stream);
+			break;
+		case T_NULL:
+			// no additional data is required to represent NULL
+			break;
+		default:
+			assert(false && "unknown SIValue type");
+	}
+}
+
 // reads SIValue off of binary stream
 SIValue SIValue_FromBinary
 (
@@ -810,6 +873,17 @@ SIValue SIValue_FromBinary
 			fread_assert(&i, sizeof(i), stream);
 			v = SI_LongVal(i);
 			break;
+		case T_DATETIME:
+		case T_LOCALDATETIME:
+		case T_DATE:
+		case T_TIME:
+		case T_LOCALTIME:
+		case T_DURATION:
+			// read temporal value from stream
+			fread_assert(&i, sizeof(i), stream);
+			v = SI_LongVal(i);
+			v.type = t;
+			break;
 		case T_DOUBLE:
 			// read double from stream
 			fread_assert(&d, sizeof(d), stream);
@@ -207,6 +207,15 @@ void SIValue_HashUpdate(SIValue v, XXH64_state_t *state);
 /* Returns a hash code for a given SIValue. */
 XXH64_hash_t SIValue_HashCode(SIValue v);
 
+// writes a binary representation of v to stream
+// only property value types (see SI_VALID_PROPERTY_VALUE) and NULL
+// are supported
+void SIValue_ToBinary
+(
+	FILE *stream,     // stream to write value to
+	const SIValue *v  // value to write
+);
+
 // reads SIValue off of binary stream
 SIValue SIValue_FromBinary
 (
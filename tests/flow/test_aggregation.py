@@ -133,4 +133,29 @@ class testAggregations():
 
         query = 'MATCH (n:L) WHERE (null <> false) XOR true RETURN COUNT(n)'
         expected = [[0]]
-        self.get_res_and_assertAlmostEquals(query, expected)
\ No newline at end of file
+        self.get_res_and_assertAlmostEquals(query, expected)
+    def test10_ManyGroups(self):
+        # aggregate into many groups, each with multiple aggregation states
+        query = """UNWIND range(0, 9999) AS x
+                   WITH x % 3000 AS k, x
+                   RETURN k, count(x), count(DISTINCT x % 2), sum(x) + count(x),
+                   collect(x)[0], avg(x)
+                   ORDER BY k"""
+        res = graph.query(query).result_set
+        self.env.assertEquals(len(res), 3000)
+        for row in res:
+            k = row[0]
+            xs = list(range(k, 10000, 3000))
+            self.env.assertEquals(row[1], len(xs))
+            self.env.assertEquals(row[2], len(set(x % 2 for x in xs)))
+            self.env.assertEquals(row[3], sum(xs) + len(xs))
+            self.env.assertEquals(row[4], k)
+            self.env.assertAlmostEqual(row[5], sum(xs) / len(xs), 0.0001)
+
+    def test11_StringGroupKeys(self):
+        # group by string keys, keys are handed off intact
+        query = """UNWIND range(0, 999) AS x
+                   RETURN 'key_' + toString(x % 10) AS k, count(x)
+                   ORDER BY k"""
+        expected = [['key_' + str(i), 100] for i in range(10)]
+        self.get_res_and_assertEquals(query, expected)
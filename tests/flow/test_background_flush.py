@@ -0,0 +1,90 @@
+from common import *
+import time
+
+GRAPH_ID = "background_flush"
+
+
+class testBackgroundFlush(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+
+        # flush deltas frequently
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_MAX_PENDING_CHANGES", 10)
+
+    def __del__(self):
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_MAX_PENDING_CHANGES", 10000)
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_BACKGROUND_FLUSH", "yes")
+
+    def populate_and_validate(self, label):
+        # create a chain of 100 nodes, one link at a time
+        self.graph.query("UNWIND range(0, 99) AS x CREATE (:%s {v: x})" % label)
+        for i in range(0, 99, 3):
+            q = """MATCH (a:%s {v: $a}), (b:%s {v: $b}), (c:%s {v: $c})
+                   CREATE (a)-[:R]->(b), (b)-[:R]->(c)""" % (label, label, label)
+            self.graph.query(q, {'a': i, 'b': i + 1, 'c': i + 2})
+
+        q = "MATCH (:%s)-[e:R]->(:%s) RETURN count(e)" % (label, label)
+        self.env.assertEqual(self.graph.query(q).result_set, [[66]])
+
+        # delete every other edge and some of the nodes
+        self.graph.query("MATCH (a:%s)-[e:R]->() WHERE a.v %% 3 = 0 DELETE e" % label)
+        self.graph.query("MATCH (a:%s) WHERE a.v >= 90 DETACH DELETE a" % label)
+
+        self.env.assertEqual(self.graph.query(q).result_set, [[30]])
+
+        q = "MATCH (a:%s) RETURN count(a)" % label
+        self.env.assertEqual(self.graph.query(q).result_set, [[90]])
+
+        # traversals are consistent in both directions
+        q = "MATCH (a:%s)-[:R]->(b) RETURN a.v, b.v ORDER BY a.v" % label
+        outgoing = self.graph.query(q).result_set
+        q = "MATCH (b)<-[:R]-(a:%s) RETURN a.v, b.v ORDER BY a.v" % label
+        incoming = self.graph.query(q).result_set
+        self.env.assertEqual(outgoing, incoming)
+        self.env.assertEqual(outgoing, [[i + 1, i + 2] for i in range(0, 88, 3)])
+
+    def test01_background_flush(self):
+        self.populate_and_validate("A")
+
+    def test02_inline_flush(self):
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_BACKGROUND_FLUSH", "no")
+        self.populate_and_validate("B")
+
+    def test03_config(self):
+        for v in ["yes", "no"]:
+            self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_BACKGROUND_FLUSH", v)
+            res = self.conn.execute_command("GRAPH.CONFIG", "GET", "DELTA_BACKGROUND_FLUSH")
+            self.env.assertEqual(res, ["DELTA_BACKGROUND_FLUSH", int(v == "yes")])
+
+    def matrices(self):
+        res = self.conn.execute_command("GRAPH.INFO", "Matrices")
+        self.env.assertEqual(res[0], "# Matrices")
+        matrices = [dict(zip(e[::2], e[1::2])) for e in res[1]]
+        return [m for m in matrices if m['Graph name'] == GRAPH_ID]
+
+    def test04_matrix_formats(self):
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_BACKGROUND_FLUSH", "yes")
+        self.graph.query("CREATE (:C)-[:S]->(:C)")
+
+        # tiny relationship-type on a large matrix is stored as hypersparse
+        # once the background flush selected its format
+        for _ in range(50):
+            matrices = self.matrices()
+            s = [m for m in matrices if m['Type'] == 'relation' and m['Name'] == 'S']
+            self.env.assertEqual(len(s), 1)
+            if s[0]['Format'] == 'hypersparse':
+                break
+            time.sleep(0.1)
+
+        self.env.assertEqual(s[0]['Entries'], 1)
+        self.env.assertEqual(s[0]['Format'], 'hypersparse')
+
+        # every matrix is reported
+        types = [m['Type'] for m in matrices]
+        self.env.assertEqual(types.count('adjacency'), 1)
+        self.env.assertEqual(types.count('label'), 3)
+        self.env.assertEqual(types.count('relation'), 2)
+        for m in matrices:
+            self.env.assertContains(m['Format'], ['hypersparse', 'sparse', 'bitmap', 'full'])
@@ -0,0 +1,100 @@
+from common import *
+
+GRAPH_ID = "batch"
+
+
+class testBatch(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})")
+
+    def batch(self, q, sets, *flags, cmd="GRAPH.QUERY"):
+        res = self.conn.execute_command(cmd, GRAPH_ID, q, "BATCH", len(sets),
+                                        *sets, *flags)
+        return [query_result.QueryResult(self.graph, r) for r in res]
+
+    def expect_error(self, f, err):
+        try:
+            f()
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains(err, str(e))
+
+    def test01_read(self):
+        q = "MATCH (n:N) WHERE n.v >= $min AND n.v < $max RETURN n.v ORDER BY n.v"
+        bounds = [(0, 3), (5, 9), (7, 100), (3, 3)]
+        sets = ["CYPHER min=%d max=%d" % b for b in bounds]
+
+        for cmd in ["GRAPH.QUERY", "GRAPH.RO_QUERY"]:
+            results = self.batch(q, sets, cmd=cmd)
+            self.env.assertEqual(len(results), len(bounds))
+            for (lo, hi), res in zip(bounds, results):
+                expected = self.graph.query(q, {'min': lo, 'max': hi}).result_set
+                self.env.assertEqual(res.result_set, expected)
+
+    def test02_query_parameters(self):
+        # parameters specified by the query take precedence
+        results = self.batch("CYPHER b=0 RETURN $a, $b",
+                             ["CYPHER a=1 b=2", "CYPHER a='x'"])
+        self.env.assertEqual(results[0].result_set, [[1, 0]])
+        self.env.assertEqual(results[1].result_set, [['x', 0]])
+
+    def test03_write(self):
+        results = self.batch("CREATE (:W {v: $v})",
+                             ["CYPHER v=%d" % i for i in range(3)], "TIMEOUT", 1000)
+        for res in results:
+            self.env.assertEqual(res.nodes_created, 1)
+            self.env.assertEqual(res.properties_set, 1)
+
+        res = self.graph.query("MATCH (w:W) RETURN w.v ORDER BY w.v")
+        self.env.assertEqual(res.result_set, [[0], [1], [2]])
+
+    def test04_entities_serialized_after_batch(self):
+        # result sets are serialized once the entire batch executed
+        # entities returned by a set reflect the modifications of later sets
+        self.graph.query("CREATE (:B {v: 0})")
+        results = self.batch("MATCH (b:B) SET b.v = $v RETURN b, b.v",
+                             ["CYPHER v=%d" % i for i in range(1, 4)])
+
+        for i, res in enumerate(results):
+            b, v = res.result_set[0]
+            self.env.assertEqual(v, i + 1)
+            self.env.assertEqual(b.properties['v'], 3)
+
+    def test05_atomic(self):
+        # the last set fails, none of the sets is committed
+        q = "CREATE (:A {v: $v}) WITH 1 AS x RETURN 1 / $d"
+        self.expect_error(lambda: self.batch(q, ["CYPHER v=1 d=1", "CYPHER v=2 d=0"]),
+                          "Division by zero")
+
+        res = self.graph.query("MATCH (a:A) RETURN count(a)")
+        self.env.assertEqual(res.result_set, [[0]])
+
+    def test06_errors(self):
+        q = "RETURN $a"
+
+        # invalid parameter sets
+        for s in ["CYPHER a=", "CYPHER a=1 RETURN 1", "a=1"]:
+            self.expect_error(lambda: self.batch(q, ["CYPHER a=1", s]), "")
+
+        # invalid batch size
+        for sets in [[], ["CYPHER a=1"]]:
+            for n in [0, -1, len(sets) + 1, "x"]:
+                self.expect_error(lambda: self.conn.execute_command(
+                    "GRAPH.QUERY", GRAPH_ID, q, "BATCH", n, *sets),
+                    "Failed to parse batch size value")
+
+        # BATCH is supported by GRAPH.QUERY and GRAPH.RO_QUERY only
+        for cmd in ["GRAPH.EXPLAIN", "GRAPH.PROFILE"]:
+            self.expect_error(lambda: self.batch(q, ["CYPHER a=1"], cmd=cmd),
+                              "BATCH is supported only by")
+
+        # index operations can't be batched
+        self.expect_error(lambda: self.batch("CREATE INDEX FOR (n:N) ON (n.v)",
+                                             ["CYPHER a=1"]),
+                          "Index operations can't be batched")
+
+        # server is still operational
+        self.env.assertEqual(self.batch(q, ["CYPHER a=1"])[0].result_set, [[1]])
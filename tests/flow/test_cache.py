@@ -13,6 +13,15 @@ class testCache():
         global redis_con
         redis_con = self.env.getConnection()
 
+    def restart_env(self):
+        # test_14_cache_eviction restarts the server with a single cache slot
+        # restore the default cache size
+        global redis_con
+        self.env.flush()
+        self.env.stop()
+        self.env = Env(decodeResponses=True, moduleArgs='THREAD_COUNT 8 CACHE_SIZE {CACHE_SIZE}'.format(CACHE_SIZE = CACHE_SIZE))
+        redis_con = self.env.getConnection()
+
     def compare_uncached_to_cached_query_plans(self, query, params=None):
         global redis_con
         plan_graph = Graph(redis_con, 'Cache_Test_plans')
@@ -23,17 +32,26 @@ class testCache():
         self.env.assertEqual(uncached_plan, cached_plan)
         plan_graph.delete()
 
+    def plan_reuses(self, graph_name):
+        # number of executions which reused a previously executed plan
+        res = redis_con.execute_command("GRAPH.INFO", "PlanCache")
+        stats = [dict(zip(e[::2], e[1::2])) for e in res[1]]
+        stats = [s for s in stats if s['Graph name'] == graph_name]
+        return stats[0]['Reused plans']
+
     def test_01_sanity_check(self):
+        # literals are replaced by parameters, vary the attribute name
+        # to produce distinct queries
         graph = Graph(redis_con, 'Cache_Sanity_Check')
         for i in range(CACHE_SIZE + 1):
-            result = graph.query("MATCH (n) WHERE n.value = {val} RETURN n".format(val=i))
+            result = graph.query("MATCH (n) WHERE n.value{val} = 1 RETURN n".format(val=i))
             self.env.assertFalse(result.cached_execution)
         
         for i in range(1, CACHE_SIZE + 1):
-            result = graph.query("MATCH (n) WHERE n.value = {val} RETURN n".format(val=i))
+            result = graph.query("MATCH (n) WHERE n.value{val} = 1 RETURN n".format(val=i))
             self.env.assertTrue(result.cached_execution)
         
-        result = graph.query("MATCH (n) WHERE n.value = 0 RETURN n")
+        result = graph.query("MATCH (n) WHERE n.value0 = 1 RETURN n")
         self.env.assertFalse(result.cached_execution)
 
         graph.delete()
@@ -287,3 +305,282 @@ class testCache():
 
         loop.run_until_complete(asyncio.wait(tasks))
 
+
+    def test_15_plan_reuse(self):
+        # executed read-only plans are reused by following executions
+        # make sure reused plans start from a clean state
+        graph = Graph(redis_con, 'Cache_plan_reuse')
+        graph.query("UNWIND range(1, 10) AS x CREATE (:L {v: x})")
+
+        queries = [
+            ("MATCH (n:L) WHERE n.v > 5 RETURN count(n)", [[5]]),
+            ("MATCH (n:L) RETURN n.v ORDER BY n.v DESC LIMIT 3", [[10], [9], [8]]),
+            ("MATCH (n:L) RETURN n.v ORDER BY n.v SKIP 8", [[9], [10]]),
+            ("MATCH (n:L) RETURN n.v % 2 AS k, sum(n.v) ORDER BY k", [[0, 30], [1, 25]]),
+            ("MATCH (n:L) RETURN DISTINCT n.v % 3 AS k ORDER BY k", [[0], [1], [2]]),
+        ]
+
+        for q, expected in queries:
+            for i in range(4):
+                result = graph.query(q)
+                self.env.assertEqual(result.result_set, expected)
+
+        # literals are turned into parameters, plans are reused nonetheless
+        self.env.assertEqual(self.plan_reuses('Cache_plan_reuse'), 3 * len(queries))
+
+        # reused plans observe modifications
+        graph.query("CREATE (:L {v: 11})")
+        result = graph.query("MATCH (n:L) WHERE n.v > 5 RETURN count(n)")
+        self.env.assertEqual(result.result_set, [[6]])
+
+        # a failing execution doesn't affect following ones
+        q = "MATCH (n:L) RETURN toInteger(n.v) ORDER BY n.v LIMIT 1"
+        self.env.assertEqual(graph.query(q).result_set, [[1]])
+        graph.query("CREATE (:L {v: 'a'})")
+        try:
+            graph.query("MATCH (n:L) RETURN 1 / (n.v - n.v)")
+        except ResponseError:
+            pass
+        self.env.assertEqual(graph.query(q).result_set, [[1]])
+
+    def test_16_plan_reuse_index(self):
+        # reused plans are discarded once indices change
+        graph = Graph(redis_con, 'Cache_plan_reuse_index')
+        graph.query("UNWIND range(1, 10) AS x CREATE (:L {v: x})")
+
+        q = "MATCH (n:L) WHERE n.v = 3 RETURN n.v"
+        for i in range(3):
+            self.env.assertEqual(graph.query(q).result_set, [[3]])
+
+        create_node_exact_match_index(graph, 'L', 'v', sync=True)
+        for i in range(3):
+            self.env.assertEqual(graph.query(q).result_set, [[3]])
+        self.env.assertIn("Index Scan", str(graph.execution_plan(q)))
+
+        drop_exact_match_index(graph, 'L', 'v')
+        for i in range(3):
+            self.env.assertEqual(graph.query(q).result_set, [[3]])
+        self.env.assertNotIn("Index Scan", str(graph.execution_plan(q)))
+
+    def test_17_auto_parameterization(self):
+        # queries which differ only by their literals share a cache entry
+        self.restart_env()
+        graph = Graph(redis_con, 'Cache_auto_params')
+        graph.query("UNWIND range(1, 10) AS x CREATE (:L {v: x, s: toString(x)})")
+
+        q = "MATCH (n:L) WHERE n.v > {v} AND n.s <> '{s}' RETURN count(n)"
+        result = graph.query(q.format(v=5, s='7'))
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[4]])
+
+        result = graph.query(q.format(v=2, s='10'))
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[7]])
+
+        result = graph.query(q.format(v=2.5, s='x'))
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[8]])
+
+        # executions with different literals reuse the pooled plan
+        reuses = self.plan_reuses('Cache_auto_params')
+        for v, expected in [(5, 4), (8, 1), (5, 4)]:
+            result = graph.query(q.format(v=v, s='7'))
+            self.env.assertEqual(result.result_set, [[expected]])
+        self.env.assertEqual(self.plan_reuses('Cache_auto_params'), reuses + 3)
+
+        # literals within RETURN determine column names and are kept as is
+        q = "MATCH (n:L) WHERE n.v = {v} RETURN n.v + {d}"
+        result = graph.query(q.format(v=1, d=1))
+        self.env.assertEqual(result.header[0][1], "n.v + 1")
+        self.env.assertEqual(result.result_set, [[2]])
+
+        result = graph.query(q.format(v=2, d=1))
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[3]])
+
+        result = graph.query(q.format(v=2, d=2))
+        self.env.assertFalse(result.cached_execution)
+        self.env.assertEqual(result.header[0][1], "n.v + 2")
+        self.env.assertEqual(result.result_set, [[4]])
+
+        # LIMIT, SKIP and variable length ranges are kept as is
+        graph.query("MATCH (a:L {v: 1}), (b:L {v: 2}), (c:L {v: 3}) CREATE (a)-[:R]->(b)-[:R]->(c)")
+        q = "MATCH (a:L {{v: {v}}})-[*{h}]->(b) WITH b ORDER BY b.v SKIP {s} LIMIT {l} RETURN b.v"
+        result = graph.query(q.format(v=1, h=2, s=0, l=1))
+        self.env.assertEqual(result.result_set, [[3]])
+        result = graph.query(q.format(v=1, h='1..2', s=1, l=1))
+        self.env.assertEqual(result.result_set, [[3]])
+        result = graph.query(q.format(v=2, h=1, s=0, l=5))
+        self.env.assertEqual(result.result_set, [[3]])
+
+        # user provided parameters are combined with hidden ones
+        q = "MATCH (n:L) WHERE n.v > $v AND n.v < 8 RETURN count(n)"
+        result = graph.query(q, {'v': 5})
+        self.env.assertEqual(result.result_set, [[2]])
+        result = graph.query(q, {'v': 6})
+        self.env.assertTrue(result.cached_execution)
+        self.env.assertEqual(result.result_set, [[1]])
+
+        # errors are reported in terms of the original query
+        try:
+            graph.query("MATCH (n:L) WHERE n.v = 1 RETURN m")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("'m' not defined", str(e))
+
+    def test_18_cache_admission(self):
+        # one-off queries don't evict frequently used plans
+        self.restart_env()
+        graph = Graph(redis_con, 'Cache_admission')
+
+        hot = "MATCH (n) WHERE n.v = 1 RETURN count(n)"
+        for i in range(5):
+            graph.query(hot)
+
+        for i in range(CACHE_SIZE * 2):
+            graph.query("MATCH (n) WHERE n.v{i} = 1 RETURN count(n)".format(i=i))
+
+        self.env.assertTrue(graph.query(hot).cached_execution)
+
+        # validate cache statistics
+        res = redis_con.execute_command("GRAPH.INFO", "PlanCache")
+        self.env.assertEqual(res[0], "# Plan cache")
+        stats = [dict(zip(e[::2], e[1::2])) for e in res[1]]
+        stats = [s for s in stats if s['Graph name'] == 'Cache_admission']
+        self.env.assertEqual(len(stats), 1)
+
+        stats = stats[0]
+        self.env.assertEqual(stats['Size'], CACHE_SIZE)
+        self.env.assertEqual(stats['Hits'], 5)
+        self.env.assertEqual(stats['Misses'], 1 + CACHE_SIZE * 2)
+        self.env.assertEqual(stats['Evictions'], CACHE_SIZE + 1)
+        self.env.assertEqual(stats['Rejections'], 0)
+
+    def test_19_plan_reuse_graph_growth(self):
+        # reused plans scan nodes created after their last execution
+        # even when the graph outgrows the matrices dimensions
+        graph = Graph(redis_con, 'Cache_plan_reuse_growth')
+        graph.query("UNWIND range(1, 10) AS x CREATE (:L {v: x})")
+
+        queries = [
+            "MATCH (n:L) RETURN count(n)",
+            "MATCH (n:L) WHERE id(n) >= 5 RETURN count(n)",
+            "MATCH (n) WHERE id(n) >= 5 RETURN count(n)",
+            "MATCH (n) WHERE n.v > 0 RETURN count(n)",
+        ]
+        expected = [[[10]], [[5]], [[5]], [[10]]]
+
+        for q, e in zip(queries, expected):
+            for i in range(3):
+                self.env.assertEqual(graph.query(q).result_set, e)
+
+        # grow the graph past its initial capacity
+        graph.query("UNWIND range(1, 40000) AS x CREATE (:L {v: x})")
+
+        expected = [[[40010]], [[40005]], [[40005]], [[40010]]]
+        for q, e in zip(queries, expected):
+            for i in range(3):
+                self.env.assertEqual(graph.query(q).result_set, e)
+
+    def test_20_plan_reuse_parameters(self):
+        # executed plans of parameterized queries are reused
+        # with different parameter values
+        name = 'Cache_plan_reuse_params'
+        graph = Graph(redis_con, name)
+        graph.query("UNWIND range(1, 10) AS x CREATE (:L {v: x})")
+
+        q = "MATCH (n:L) WHERE n.v > $v RETURN count(n)"
+        self.env.assertEqual(graph.query(q, {'v': 5}).result_set, [[5]])
+
+        reuses = self.plan_reuses(name)
+        for v, expected in [(2, 8), (8, 2), (5, 5), (2.5, 8), ('a', 0)]:
+            result = graph.query(q, {'v': v})
+            self.env.assertEqual(result.result_set, [[expected]])
+        self.env.assertEqual(self.plan_reuses(name), reuses + 5)
+
+        # parameters consumed while optimizing the plan
+        # restrict reuse to executions with the same values
+        q = "MATCH (n) WHERE id(n) = $id RETURN n.v"
+        for id in [0, 3, 0, 3, 'a', 3]:
+            expected = [] if id == 'a' else [[id + 1]]
+            self.env.assertEqual(graph.query(q, {'id': id}).result_set, expected)
+
+        q = "MATCH (n:L) RETURN n.v ORDER BY n.v LIMIT $l"
+        for l in [2, 4, 2, 0]:
+            expected = [[x] for x in range(1, l + 1)]
+            self.env.assertEqual(graph.query(q, {'l': l}).result_set, expected)
+
+        q = "UNWIND $list AS x RETURN x"
+        for l in [[1, 2], [3], [], [1, 2]]:
+            expected = [[x] for x in l]
+            self.env.assertEqual(graph.query(q, {'list': l}).result_set, expected)
+
+        # index lookups
+        create_node_exact_match_index(graph, 'L', 'v', sync=True)
+        q = "MATCH (n:L) WHERE n.v = $v RETURN n.v"
+        graph.query(q, {'v': 1})
+        self.env.assertIn("Index Scan", str(graph.execution_plan(q, {'v': 1})))
+
+        reuses = self.plan_reuses(name)
+        for v in [3, 7, 7, 11, 'a', [1]]:
+            expected = [[v]] if v in range(1, 11) else []
+            self.env.assertEqual(graph.query(q, {'v': v}).result_set, expected)
+        self.env.assertEqual(self.plan_reuses(name), reuses + 6)
+
+    def test_21_plan_reuse_traversals(self):
+        # reused traversals observe edges and nodes created after
+        # their last execution
+        graph = Graph(redis_con, 'Cache_plan_reuse_traversals')
+        graph.query("UNWIND range(1, 3) AS x CREATE (:X {v: x})-[:R]->(:Y {v: x})")
+
+        expand_into = "MATCH (a:X), (b:Y) WHERE (a)-[:R]->(b) RETURN count(*)"
+        self.env.assertIn("Expand Into", str(graph.execution_plan(expand_into)))
+
+        queries = [
+            expand_into,
+            "MATCH (a:X)-[:R]->(b:Y) RETURN count(*)",
+            "MATCH (a:X)-[:R]->(b:Y) WHERE a.v = b.v RETURN count(*)",
+        ]
+
+        for q in queries:
+            for i in range(3):
+                self.env.assertEqual(graph.query(q).result_set, [[3]])
+
+        # grow the graph past its matrices dimensions
+        # and connect the new nodes
+        graph.query("UNWIND range(1, 40000) AS x CREATE ()")
+        graph.query("UNWIND range(4, 6) AS x CREATE (:X {v: x})-[:R]->(:Y {v: x})")
+
+        for q in queries:
+            for i in range(3):
+                self.env.assertEqual(graph.query(q).result_set, [[6]])
+
+        # multi-edges introduced after the plan was pooled
+        # each path is reported
+        q = "MATCH (a:X {v: 1})-[:R*1..2]->(b) RETURN count(b)"
+        for i in range(3):
+            self.env.assertEqual(graph.query(q).result_set, [[1]])
+
+        graph.query("MATCH (a:X {v: 1})-[:R]->(b) CREATE (a)-[:R]->(b)")
+        for i in range(3):
+            self.env.assertEqual(graph.query(q).result_set, [[2]])
+
+    def test_22_plan_reuse_traversal_mode(self):
+        # reused traversals switch between direct traversal and
+        # matrix multiplication as the graph's fan-out changes
+        graph = Graph(redis_con, 'Cache_plan_reuse_traversal_mode')
+        graph.query("CREATE (:X)-[:R]->(:Y)")
+
+        q = "MATCH (a:X)-[:R]->(b:Y) RETURN count(*)"
+        for i in range(3):
+            self.env.assertEqual(graph.query(q).result_set, [[1]])
+
+        # raise the fan-out above the direct traversal threshold
+        graph.query("MATCH (a:X), (b:Y) UNWIND range(1, 200) AS x CREATE (a)-[:R]->(b)")
+        for i in range(3):
+            self.env.assertEqual(graph.query(q).result_set, [[201]])
+
+        # lower the fan-out back below the threshold
+        graph.query("UNWIND range(1, 1000) AS x CREATE ()")
+        for i in range(3):
+            self.env.assertEqual(graph.query(q).result_set, [[201]])
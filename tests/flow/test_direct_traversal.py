@@ -0,0 +1,100 @@
+from common import *
+
+GRAPH_ID = "direct_traversal"
+
+
+# single hop traversals over a single relationship matrix
+# scan the source node row directly rather than multiplying matrices
+# validate both strategies produce the same results
+class testDirectTraversal():
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.redis_con = self.env.getConnection()
+        self.graph = Graph(self.redis_con, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # (a)-[:R]->(b_i) i in [0, 10)
+        # (a)-[:S]->(b_0) twice, multi-edge
+        # (b_i)-[:R]->(c) i in [0, 5)
+        self.graph.query("""CREATE (a:A {v: 'a'}), (c:C {v: 'c'})
+                            WITH a, c
+                            UNWIND range(0, 9) AS x
+                            CREATE (a)-[:R {v: x}]->(b:B {v: x})
+                            WITH a, b, c, x
+                            WHERE x < 5
+                            CREATE (b)-[:R {v: x}]->(c)""")
+        self.graph.query("""MATCH (a:A), (b:B {v: 0})
+                            CREATE (a)-[:S {v: 0}]->(b), (a)-[:S {v: 1}]->(b)""")
+
+    def test01_outgoing(self):
+        query = "MATCH (a:A)-[:R]->(b) RETURN b.v ORDER BY b.v"
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[x] for x in range(10)])
+
+        # unspecified relationship type
+        # (a) and (b_0) are connected via both R and S
+        query = "MATCH (a:A)-[]->(b) RETURN count(b)"
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[10]])
+
+        # edges are collected for every pair of endpoints
+        query = "MATCH (a:A)-[e]->(b) RETURN type(e), e.v ORDER BY type(e), e.v"
+        result = self.graph.query(query)
+        expected = [['R', x] for x in range(10)] + [['S', 0], ['S', 1]]
+        self.env.assertEquals(result.result_set, expected)
+
+    def test02_incoming(self):
+        query = "MATCH (c:C)<-[:R]-(b) RETURN b.v ORDER BY b.v"
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[x] for x in range(5)])
+
+        query = "MATCH (b:B)<-[e:S]-(a) RETURN b.v, a.v, e.v ORDER BY e.v"
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[0, 'a', 0], [0, 'a', 1]])
+
+    def test03_multiple_sources(self):
+        # every source is matched with its own neighbors
+        query = "MATCH (b:B)-[:R]->(c) RETURN b.v, c.v ORDER BY b.v"
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[x, 'c'] for x in range(5)])
+
+        # sources without neighbors produce no records
+        query = "MATCH (b:B)-[:R]->(c) WHERE b.v >= 5 RETURN count(c)"
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[0]])
+
+        # optional traversal
+        query = "MATCH (b:B) OPTIONAL MATCH (b)-[:R]->(c) RETURN b.v, c.v ORDER BY b.v"
+        result = self.graph.query(query)
+        expected = [[x, 'c' if x < 5 else None] for x in range(10)]
+        self.env.assertEquals(result.result_set, expected)
+
+    def test04_missing_relationship(self):
+        query = "MATCH (a:A)-[:Z]->(b) RETURN count(b)"
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[0]])
+
+    def test05_repeated_traversal(self):
+        # traversal op is reset for every input record
+        query = """UNWIND range(0, 2) AS x
+                   MATCH (a:A)-[:R]->(b)-[:R]->(c)
+                   RETURN x, count(c) ORDER BY x"""
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[0, 5], [1, 5], [2, 5]])
+
+    def test06_reused_plan_after_writes(self):
+        # the same query executed multiple times reuses its plan
+        # the traversed matrix must reflect writes performed in between
+        # including writes growing the graph beyond its initial capacity
+        query = "MATCH (a:A)-[:R]->(b) RETURN count(b)"
+        for _ in range(3):
+            self.env.assertEquals(self.graph.query(query).result_set, [[10]])
+
+        self.graph.query("""MATCH (a:A)
+                            UNWIND range(0, 19999) AS x
+                            CREATE (a)-[:R]->(:D {v: x})""")
+        self.env.assertEquals(self.graph.query(query).result_set, [[20010]])
+
+        self.graph.query("MATCH (:A)-[e:R]->(d:D) WHERE d.v >= 10000 DELETE e")
+        self.env.assertEquals(self.graph.query(query).result_set, [[10010]])
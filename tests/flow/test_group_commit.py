@@ -0,0 +1,134 @@
+from common import *
+from pathos.pools import ProcessPool as Pool
+from pathos.helpers import mp as pathos_multiprocess
+
+GRAPH_ID = "group_commit"
+CLIENT_COUNT = 16  # number of concurrent connections
+
+# slow write query, occupies the writer thread while other writes are queued
+SLOW_WRITE = "UNWIND range(0, 3000000) AS x WITH x WHERE x < 0 CREATE ()"
+
+
+def run_query(query, barrier):
+    env = Env(decodeResponses=True)
+    conn = env.getConnection()
+    graph = Graph(conn, GRAPH_ID)
+
+    barrier.wait()
+
+    try:
+        res = graph.query(query)
+        return res.nodes_created
+    except ResponseError as e:
+        return str(e)
+
+
+def run_query_node(query, barrier):
+    env = Env(decodeResponses=True)
+    conn = env.getConnection()
+    graph = Graph(conn, GRAPH_ID)
+
+    barrier.wait()
+
+    res = graph.query(query)
+    if len(res.result_set) == 0:
+        return None
+    return res.result_set[0][0].properties['v']
+
+
+def run_concurrent(queries, f=run_query):
+    pool = Pool(nodes=len(queries))
+    manager = pathos_multiprocess.Manager()
+    barrier = manager.Barrier(len(queries))
+
+    results = pool.map(f, queries, [barrier] * len(queries))
+    pool.clear()
+
+    return results
+
+
+class testGroupCommit(FlowTestsBase):
+    def __init__(self):
+        # skip test if we're running under Valgrind
+        if VALGRIND or SANITIZER != "":
+            Env.skip(None) # valgrind is not working correctly with replication
+
+        self.env = Env(decodeResponses=True, env='oss', useSlaves=True,
+                       moduleArgs="GROUP_COMMIT_SIZE 8")
+        self.conn = self.env.getConnection()
+        self.replica = self.env.getSlaveConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+
+        # enable write commands on replica, required as all RedisGraph
+        # commands are registered as write commands
+        self.replica.config_set("slave-read-only", "no")
+        self.conn.execute_command("WAIT", "1", "0")
+
+    def count(self, conn, q):
+        return Graph(conn, GRAPH_ID).query(q).result_set[0][0]
+
+    def test01_group_commit(self):
+        self.graph.query("CREATE (:G {v: -1})")
+
+        # small writes queued behind a slow write are committed in groups
+        queries = [SLOW_WRITE]
+        queries += ["CREATE (:G {v: %d})" % i for i in range(CLIENT_COUNT - 1)]
+        results = run_concurrent(queries)
+        self.env.assertEqual(results, [0] + [1] * (CLIENT_COUNT - 1))
+
+        q = "MATCH (n:G) RETURN count(n)"
+        self.env.assertEqual(self.count(self.conn, q), CLIENT_COUNT)
+
+        # replica applies the group's modifications
+        self.conn.execute_command("WAIT", "1", "0")
+        self.env.assertEqual(self.count(self.replica, q), CLIENT_COUNT)
+
+    def test02_member_failure(self):
+        # a failing query rolls back its own modifications only
+        queries = [SLOW_WRITE]
+        for i in range(CLIENT_COUNT - 1):
+            if i % 3 == 0:
+                queries.append("CREATE (:F {v: %d}) WITH 1 AS x RETURN 1 / 0" % i)
+            else:
+                queries.append("CREATE (:F {v: %d})" % i)
+
+        results = run_concurrent(queries)
+        expected = 0
+        for i, res in enumerate(results[1:]):
+            if i % 3 == 0:
+                self.env.assertContains("Division by zero", res)
+            else:
+                self.env.assertEqual(res, 1)
+                expected += 1
+
+        q = "MATCH (n:F) RETURN count(n)"
+        self.env.assertEqual(self.count(self.conn, q), expected)
+
+        self.conn.execute_command("WAIT", "1", "0")
+        self.env.assertEqual(self.count(self.replica, q), expected)
+
+    def test03_member_reply(self):
+        # each reply reflects the modifications of preceding queries only
+        self.graph.query("CREATE (:S {v: 0})")
+
+        queries = [SLOW_WRITE]
+        queries += ["MATCH (s:S) SET s.v = s.v + 1 RETURN s"] * (CLIENT_COUNT - 1)
+        results = run_concurrent(queries, run_query_node)
+        self.env.assertEqual(sorted(results[1:]), list(range(1, CLIENT_COUNT)))
+
+    def test04_disabled(self):
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "GROUP_COMMIT_SIZE", 1)
+
+        queries = [SLOW_WRITE]
+        queries += ["CREATE (:D)" for i in range(CLIENT_COUNT - 1)]
+        run_concurrent(queries)
+
+        q = "MATCH (n:D) RETURN count(n)"
+        self.env.assertEqual(self.count(self.conn, q), CLIENT_COUNT - 1)
+
+        # group size must be positive
+        try:
+            self.conn.execute_command("GRAPH.CONFIG", "SET", "GROUP_COMMIT_SIZE", 0)
+            self.env.assertTrue(False)
+        except ResponseError:
+            pass
@@ -35,3 +35,42 @@ class testHashJoin(FlowTestsBase):
 
         self.env.assertEquals(actual_result.result_set, expected_result)
 
+
+    def test_hashjoin_duplicates_and_nulls(self):
+        graph = Graph(self.env.getConnection(), "hashjoin_dups")
+        graph.query("UNWIND range(0, 99) AS x CREATE (:L {v: x % 10}), (:R {v: x % 5})")
+        graph.query("CREATE (:L), (:R)") # nodes missing the joined property
+
+        # values 0-4 appear 10 times on the left and 20 times on the right
+        q = "MATCH (a:L), (b:R) WHERE a.v = b.v RETURN count(*)"
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Value Hash Join", plan)
+        res = graph.query(q)
+        self.env.assertEquals(res.result_set, [[5 * 10 * 20]])
+
+        # integers and floats holding the same value are equal
+        q = "MATCH (a:L), (b:R) WHERE a.v = toFloat(b.v) RETURN count(*)"
+        res = graph.query(q)
+        self.env.assertEquals(res.result_set, [[5 * 10 * 20]])
+
+    def test_hashjoin_spill(self):
+        con = self.env.getConnection()
+        graph = Graph(con, "hashjoin_spill")
+        graph.query("UNWIND range(0, 99999) AS x CREATE (:A {v: x, s: toString(x)}), (:B {v: x})")
+
+        q = """MATCH (a:A), (b:B) WHERE a.v = b.v
+               RETURN count(*), sum(a.v), sum(toInteger(a.s) - b.v)"""
+        plan = graph.execution_plan(q)
+        self.env.assertIn("Value Hash Join", plan)
+
+        # join in memory
+        expected = graph.query(q).result_set
+        self.env.assertEquals(expected, [[100000, 4999950000, 0]])
+
+        # cap query memory, forcing the build side to spill
+        con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 10 * 1024 * 1024)
+        try:
+            actual = graph.query(q).result_set
+            self.env.assertEquals(actual, expected)
+        finally:
+            con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 0)
@@ -73,3 +73,67 @@ class testOrderBy(FlowTestsBase):
         # assert the order of the results
         self.env.assertEquals(res.result_set[0][0], Node(label='N', properties={'v': 1}))
         self.env.assertEquals(res.result_set[1][0], Node(label='N', properties={'v': 2}))
+
+    def test03_external_sort(self):
+        con = self.env.getConnection()
+        n = 200000
+        q = f"""UNWIND range(0, {n - 1}) AS x
+                WITH x, toString((x * 7919) % {n}) AS s
+                ORDER BY s DESC, x
+                SKIP {n - 5}
+                RETURN s, x"""
+
+        keys = sorted([(str((x * 7919) % n), x) for x in range(n)],
+                      key=lambda t: t[1])
+        keys = sorted(keys, key=lambda t: t[0], reverse=True)
+        expected = [[s, x] for s, x in keys[n - 5:]]
+
+        # sort in memory
+        actual = redis_graph.query(q).result_set
+        self.env.assertEquals(actual, expected)
+
+        # cap query memory, forcing sorted runs to spill
+        con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 32 * 1024 * 1024)
+        try:
+            actual = redis_graph.query(q).result_set
+            self.env.assertEquals(actual, expected)
+        finally:
+            con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 0)
+
+    def test04_mixed_types(self):
+        # values of different types are ordered by Cypher's global order
+        q = """UNWIND [3, 'b', 1.5, null, [1, 2], 'a', true, [1], -2, false] AS v
+               RETURN v ORDER BY v"""
+        asc = redis_graph.query(q).result_set
+
+        q = """UNWIND [3, 'b', 1.5, null, [1, 2], 'a', true, [1], -2, false] AS v
+               RETURN v ORDER BY v DESC"""
+        desc = redis_graph.query(q).result_set
+        self.env.assertEquals(desc, asc[::-1])
+
+        # top-k agrees with a full sort
+        q = """UNWIND [3, 'b', 1.5, null, [1, 2], 'a', true, [1], -2, false] AS v
+               RETURN v ORDER BY v LIMIT 4"""
+        actual = redis_graph.query(q).result_set
+        self.env.assertEquals(actual, asc[:4])
+
+        # numerics are ordered by value, regardless of their type
+        q = """UNWIND [3, 1.5, -2, 2.5, 0, -0.5] AS v
+               RETURN v ORDER BY v"""
+        actual = redis_graph.query(q).result_set
+        self.env.assertEquals(actual, [[-2], [-0.5], [0], [1.5], [2.5], [3]])
+
+    def test05_unencodable_values(self):
+        # maps can't be encoded into sort keys, records are compared by value
+        q = """UNWIND range(0, 9) AS x
+               RETURN x % 3 AS k, {v: x} AS m ORDER BY k DESC, m"""
+        actual = redis_graph.query(q).result_set
+        expected = sorted([[x % 3, {'v': x}] for x in range(10)],
+                          key=lambda r: (-r[0], r[1]['v']))
+        self.env.assertEquals(actual, expected)
+
+        q = """UNWIND range(0, 9) AS x
+               WITH x, {v: x} AS m
+               RETURN x, m ORDER BY m DESC LIMIT 3"""
+        actual = redis_graph.query(q).result_set
+        self.env.assertEquals(actual, [[9, {'v': 9}], [8, {'v': 8}], [7, {'v': 7}]])
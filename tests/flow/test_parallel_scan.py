@@ -0,0 +1,128 @@
+from common import *
+
+GRAPH_ID = "parallel_scan"
+NODE_COUNT = 100000
+
+class testParallelScan(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True, moduleArgs='THREAD_COUNT 8 PARALLEL_SCAN_WORKERS 4')
+        self.redis_con = self.env.getConnection()
+        self.graph = Graph(self.redis_con, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        q = "UNWIND range(0, $n - 1) AS x CREATE (:A {v: x})"
+        self.graph.query(q, {'n': NODE_COUNT})
+        q = "UNWIND range(0, $n - 1) AS x CREATE (:B {v: x})"
+        self.graph.query(q, {'n': NODE_COUNT})
+
+    def set_workers(self, workers):
+        self.redis_con.execute_command("GRAPH.CONFIG", "SET", "PARALLEL_SCAN_WORKERS", workers)
+
+    def test01_exchange_placement(self):
+        # filtered scans are merged by an exchange
+        plan = self.graph.execution_plan("MATCH (n:A) WHERE n.v > 10 RETURN n")
+        self.env.assertIn("Exchange", plan)
+
+        plan = self.graph.execution_plan("MATCH (n) WHERE n.v > 10 RETURN n")
+        self.env.assertIn("Exchange", plan)
+
+        # scans without filters are not parallelized
+        plan = self.graph.execution_plan("MATCH (n:A) RETURN n")
+        self.env.assertNotIn("Exchange", plan)
+
+    def test02_parallel_results(self):
+        queries = [
+            "MATCH (n:A) WHERE n.v % 3 = 0 RETURN count(n), sum(n.v)",
+            "MATCH (n) WHERE n.v % 7 = 1 RETURN count(n), sum(n.v)",
+            "MATCH (n:B) WHERE n.v >= $min AND n.v < $max RETURN count(n), min(n.v), max(n.v)",
+            "MATCH (n:A) WHERE id(n) > 500 AND n.v < 90000 RETURN count(n)",
+        ]
+        params = {'min': 1000, 'max': 80000}
+
+        # compute expected results serially
+        self.set_workers(0)
+        expected = [self.graph.query(q, params).result_set for q in queries]
+
+        self.set_workers(4)
+        for q, e in zip(queries, expected):
+            actual = self.graph.query(q, params).result_set
+            self.env.assertEqual(actual, e)
+
+    def test03_parallel_scan_limit(self):
+        self.set_workers(4)
+        res = self.graph.query("MATCH (n:A) WHERE n.v % 2 = 0 RETURN n.v LIMIT 10")
+        self.env.assertEqual(len(res.result_set), 10)
+        for row in res.result_set:
+            self.env.assertEqual(row[0] % 2, 0)
+
+    def test04_parallel_scan_error(self):
+        self.set_workers(4)
+        # a runtime error raised by a worker is reported
+        try:
+            self.graph.query("MATCH (n:A) WHERE n.v > 50000 AND toInteger(n) > 0 RETURN count(n)")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Type mismatch", str(e))
+
+    def test05_partial_aggregation_placement(self):
+        self.set_workers(4)
+
+        # unfiltered scans feeding a combinable aggregation are parallelized
+        plan = self.graph.execution_plan("MATCH (n:A) RETURN n.v % 10, count(n)")
+        self.env.assertIn("Exchange", plan)
+
+        # distinct aggregations can't be combined
+        plan = self.graph.execution_plan("MATCH (n:A) RETURN count(DISTINCT n.v % 10)")
+        self.env.assertNotIn("Exchange", plan)
+
+    def test06_partial_aggregation_results(self):
+        queries = [
+            "MATCH (n:A) RETURN n.v % 10 AS k, count(n), sum(n.v), min(n.v), max(n.v), avg(n.v) ORDER BY k",
+            "MATCH (n) RETURN labels(n) AS l, count(n), stDev(n.v), percentileDisc(n.v, 0.5) ORDER BY l",
+            "MATCH (n:B) WHERE n.v % 1000 = 0 RETURN n.v % 3 AS k, collect(n.v) AS c ORDER BY k",
+            "MATCH (n:A) WHERE n.v > 1000000 RETURN count(n), sum(n.v), collect(n.v)",
+        ]
+
+        # compute expected results serially
+        self.set_workers(0)
+        expected = [self.graph.query(q).result_set for q in queries]
+
+        self.set_workers(4)
+        for q, e in zip(queries, expected):
+            actual = self.graph.query(q).result_set
+            # collected values order depends on scheduling
+            actual = [[sorted(v) if isinstance(v, list) else v for v in row] for row in actual]
+            e = [[sorted(v) if isinstance(v, list) else v for v in row] for row in e]
+            self.env.assertEqual(len(actual), len(e))
+            for a_row, e_row in zip(actual, e):
+                for a, b in zip(a_row, e_row):
+                    if isinstance(a, float):
+                        self.env.assertAlmostEqual(a, b, 0.0001)
+                    else:
+                        self.env.assertEqual(a, b)
+
+    def test07_partial_aggregation_error(self):
+        self.set_workers(4)
+        # a runtime error raised while aggregating in a worker is reported
+        try:
+            self.graph.query("MATCH (n:A) RETURN sum(CASE WHEN n.v > 90000 THEN toInteger(n) ELSE 1 END)")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Type mismatch", str(e))
+
+    def test08_memory_capacity(self):
+        # memory allocated by workers counts towards the query's capacity
+        self.set_workers(4)
+        self.redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 1048576)
+        try:
+            self.graph.query("MATCH (n) RETURN collect(n.v)")
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertIn("Query's mem consumption exceeded capacity", str(e))
+        finally:
+            self.redis_con.execute_command("GRAPH.CONFIG", "SET", "QUERY_MEM_CAPACITY", 0)
+
+        # within capacity
+        res = self.graph.query("MATCH (n:A) WHERE n.v % 3 = 0 RETURN count(n)")
+        self.env.assertEqual(res.result_set, [[(NODE_COUNT + 2) // 3]])
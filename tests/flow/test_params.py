@@ -25,6 +25,44 @@ class testParams(FlowTestsBase):
             query_info = QueryInfo(query = query, description="Tests simple params", expected_result = expected_results)
             self._assert_resultset_equals_expected(redis_graph.query(query, {'param': param}), query_info)
 
+    def test_literal_params(self):
+        # parameters holding literals, parsed without libcypher-parser
+        # should evaluate to the same values as parameters holding expressions
+        literals = [
+            ("1", 1),
+            ("-7", -7),
+            ("2.5", 2.5),
+            ("-1.5e2", -150.0),
+            ("'a\\'b'", "a'b"),
+            ('"x\\ny"', "x\ny"),
+            ("true", True),
+            ("NULL", None),
+            ("[]", []),
+            ("[1, ['a', [false]], {k: -1}]", [1, ['a', [False]], {'k': -1}]),
+            ("{a: 1, 'b': [null, 2.0], c: {}}", {'a': 1, 'b': [None, 2.0], 'c': {}}),
+        ]
+
+        for literal, expected in literals:
+            q = "CYPHER p={literal} q=1+1 RETURN $p, $q".format(literal=literal)
+            slow = redis_graph.query(q).result_set
+            q = "CYPHER p={literal} q=2 RETURN $p, $q".format(literal=literal)
+            fast = redis_graph.query(q).result_set
+            self.env.assertEqual(fast, [[expected, 2]])
+            self.env.assertEqual(fast, slow)
+
+        # a large list of maps
+        batch = [{'id': i, 'name': 'n' + str(i)} for i in range(1000)]
+        q = "UNWIND $batch AS b RETURN count(b), sum(b.id), max(b.name)"
+        result = redis_graph.query(q, {'batch': batch}).result_set
+        self.env.assertEqual(result, [[1000, 499500, 'n999']])
+
+        # duplicated parameters are reported
+        try:
+            redis_graph.query("CYPHER a=1 a=2 RETURN $a")
+            self.env.assertTrue(False)
+        except redis.exceptions.ResponseError as e:
+            self.env.assertIn("Duplicated parameter", str(e))
+
     def test_invalid_param(self):
         invalid_queries = [
                 "CYPHER param=a RETURN $param",                            # 'a' is undefined
@@ -0,0 +1,48 @@
+from common import *
+
+GRAPH_ID = "pending_deletions"
+
+
+# traversals multiply by matrices with pending changes without merging them
+# make sure entries reachable via multiple paths survive the deletion of
+# some of these paths
+class testPendingDeletions():
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+
+        # keep deletions pending
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_BACKGROUND_FLUSH", "no")
+        self.populate_graph()
+
+    def __del__(self):
+        self.conn.execute_command("GRAPH.CONFIG", "SET", "DELTA_BACKGROUND_FLUSH", "yes")
+
+    def populate_graph(self):
+        # (a)-[:R]->(b_i)-[:R]->(c) i in [0, 3)
+        self.graph.query("""CREATE (a:A {v: 'a'}), (c:C {v: 'c'})
+                            WITH a, c
+                            UNWIND range(0, 2) AS x
+                            CREATE (a)-[:R]->(:B {v: x})-[:R]->(c)""")
+
+    def reachable(self):
+        query = """MATCH (:A)-[:R]->()-[:R]->(c)
+                   RETURN DISTINCT c.v"""
+        return self.graph.query(query).result_set
+
+    def test01_partial_deletion(self):
+        self.env.assertEquals(self.reachable(), [['c']])
+
+        # remove some of the paths leading to (c)
+        self.graph.query("MATCH (b:B)-[e:R]->(:C) WHERE b.v < 2 DELETE e")
+        self.env.assertEquals(self.reachable(), [['c']])
+
+    def test02_full_deletion(self):
+        # remove the last path leading to (c)
+        self.graph.query("MATCH (:B)-[e:R]->(:C) DELETE e")
+        self.env.assertEquals(self.reachable(), [])
+
+        # restore one of the paths
+        self.graph.query("MATCH (b:B {v: 1}), (c:C) CREATE (b)-[:R]->(c)")
+        self.env.assertEquals(self.reachable(), [['c']])
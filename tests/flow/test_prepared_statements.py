@@ -0,0 +1,137 @@
+import struct
+from common import *
+
+GRAPH_ID = "prepared_statements"
+
+
+# encodes value using GRAPH.EXECUTE binary parameters format
+def encode(v):
+    if v is None:
+        return struct.pack('<B', 0)
+    if isinstance(v, bool):
+        return struct.pack('<BB', 1, v)
+    if isinstance(v, int):
+        return struct.pack('<Bq', 2, v)
+    if isinstance(v, float):
+        return struct.pack('<Bd', 3, v)
+    if isinstance(v, str):
+        b = v.encode()
+        return struct.pack('<BI', 4, len(b)) + b
+    if isinstance(v, list):
+        return struct.pack('<BI', 5, len(v)) + b''.join(encode(e) for e in v)
+    if isinstance(v, dict):
+        payload = struct.pack('<BI', 6, len(v))
+        for k, e in v.items():
+            kb = k.encode()
+            payload += struct.pack('<I', len(kb)) + kb + encode(e)
+        return payload
+    raise TypeError(type(v))
+
+
+class testPreparedStatements(FlowTestsBase):
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.graph.query("UNWIND range(0, 9) AS x CREATE (:N {v: x})")
+
+    def prepare(self, q):
+        return self.conn.execute_command("GRAPH.PREPARE", GRAPH_ID, q)
+
+    def execute_raw(self, handle, payload, *flags):
+        res = self.conn.execute_command("GRAPH.EXECUTE", GRAPH_ID, handle,
+                                        payload, *flags)
+        return query_result.QueryResult(self.graph, res)
+
+    def execute(self, handle, *params):
+        return self.execute_raw(handle, b''.join(encode(p) for p in params))
+
+    def expect_error(self, f, err):
+        try:
+            f()
+            self.env.assertTrue(False)
+        except ResponseError as e:
+            self.env.assertContains(err, str(e))
+
+    def test01_prepare(self):
+        q = "MATCH (n:N) WHERE n.v >= $min AND n.v < $max AND n.v <> $min + 1 RETURN n.v ORDER BY n.v"
+        handle, params = self.prepare(q)
+        self.env.assertEqual(params, ['min', 'max'])
+
+        # preparing the same query returns the same handle
+        self.env.assertEqual(self.prepare(q), [handle, params])
+
+        # different queries get different handles
+        other, params = self.prepare("RETURN 1")
+        self.env.assertNotEqual(handle, other)
+        self.env.assertEqual(params, [])
+
+    def test02_execute(self):
+        q = "MATCH (n:N) WHERE n.v >= $min AND n.v < $max RETURN n.v ORDER BY n.v"
+        handle, _ = self.prepare(q)
+
+        for lo, hi in [(0, 3), (5, 9), (7, 100)]:
+            expected = self.graph.query(q, {'min': lo, 'max': hi}).result_set
+            res = self.execute(handle, lo, hi)
+            self.env.assertEqual(res.result_set, expected)
+            self.env.assertTrue(res.cached_execution)
+
+        # query without parameters
+        handle, _ = self.prepare("MATCH (n:N) RETURN count(n)")
+        self.env.assertEqual(self.execute(handle).result_set, [[10]])
+
+    def test03_parameter_types(self):
+        handle, params = self.prepare("RETURN $a, $b, $c, $d, $e, $f, $g")
+        self.env.assertEqual(params, ['a', 'b', 'c', 'd', 'e', 'f', 'g'])
+
+        values = [None, True, -42, 2.5, "prepared", [1, 'x', [False]],
+                  {'k': 1, 'l': [None, 'v']}]
+        res = self.execute(handle, *values)
+        self.env.assertEqual(res.result_set, [values])
+
+    def test04_write(self):
+        handle, _ = self.prepare("CREATE (:W {v: $v})")
+        for i in range(3):
+            res = self.execute(handle, i)
+            self.env.assertEqual(res.nodes_created, 1)
+            self.env.assertEqual(res.properties_set, 1)
+
+        res = self.graph.query("MATCH (w:W) RETURN w.v ORDER BY w.v")
+        self.env.assertEqual(res.result_set, [[0], [1], [2]])
+
+    def test05_flags(self):
+        handle, _ = self.prepare("MATCH (n:N) WHERE n.v = $v RETURN n.v")
+        res = self.execute_raw(handle, encode(3), "TIMEOUT", 1000)
+        self.env.assertEqual(res.result_set, [[3]])
+
+    def test06_errors(self):
+        handle, _ = self.prepare("RETURN $a")
+
+        # unknown handles
+        for h in [-1, 1000, "handle"]:
+            self.expect_error(lambda: self.execute(h, 1),
+                              "Unknown prepared statement")
+
+        # malformed parameters
+        for payload in [b'', encode(1)[:-1], encode(1) + encode(2), b'\x07',
+                        struct.pack('<BI', 5, 1000), struct.pack('<BB', 1, 2)]:
+            self.expect_error(lambda: self.execute_raw(handle, payload),
+                              "Failed to decode prepared statement parameters")
+
+        # parameter values can't be specified upon preparation
+        self.expect_error(lambda: self.prepare("CYPHER a=1 RETURN $a"),
+                          "Prepared statements can't specify parameter values")
+
+        # index operations can't be prepared
+        self.expect_error(lambda: self.prepare("CREATE INDEX FOR (n:N) ON (n.v)"),
+                          "Index operations can't be prepared")
+
+        # invalid queries
+        self.expect_error(lambda: self.prepare("RETURN x"), "'x' not defined")
+
+        # statements are scoped to an existing graph
+        self.expect_error(lambda: self.conn.execute_command("GRAPH.PREPARE",
+                          "missing_graph", "RETURN 1"), "empty key")
+
+        # server is still operational
+        self.env.assertEqual(self.execute(handle, 1).result_set, [[1]])
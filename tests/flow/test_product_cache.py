@@ -0,0 +1,68 @@
+from common import *
+
+GRAPH_ID = "product_cache"
+
+
+# products of graph matrices are cached across queries
+# make sure cached products are invalidated once their operands are modified
+class testProductCache():
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.conn = self.env.getConnection()
+        self.graph = Graph(self.conn, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # (p_i)-[:KNOWS]->(p_i+1) chain of 10 people
+        self.graph.query("""UNWIND range(0, 9) AS x
+                            CREATE (:Person {v: x})""")
+        self.graph.query("""MATCH (a:Person), (b:Person)
+                            WHERE b.v = a.v + 1
+                            CREATE (a)-[:KNOWS]->(b)""")
+
+    def two_hops(self):
+        query = """MATCH (a:Person)-[:KNOWS]->(:Person)-[:KNOWS]->(c:Person)
+                   RETURN a.v, c.v ORDER BY a.v, c.v"""
+        return self.graph.query(query).result_set
+
+    def test01_config(self):
+        res = self.conn.execute_command("GRAPH.CONFIG", "GET", "PRODUCT_CACHE_SIZE")
+        self.env.assertEqual(res, ["PRODUCT_CACHE_SIZE", 16])
+
+    def test02_repeated_queries(self):
+        expected = [[x, x + 2] for x in range(8)]
+        for _ in range(5):
+            self.env.assertEquals(self.two_hops(), expected)
+
+        # cached products and their memory are reported
+        res = self.conn.execute_command("GRAPH.INFO", "PlanCache")
+        stats = [dict(zip(s[::2], s[1::2])) for s in res[1]]
+        stats = [s for s in stats if s['Graph name'] == GRAPH_ID][0]
+        self.env.assertGreater(stats['Cached products'], 0)
+        self.env.assertGreater(stats['Cached products memory'], 0)
+
+    def test03_relationship_modified(self):
+        expected = [[x, x + 2] for x in range(8)]
+        self.env.assertEquals(self.two_hops(), expected)
+
+        # introduce a new edge
+        self.graph.query("""MATCH (a:Person {v: 9}), (b:Person {v: 0})
+                            CREATE (a)-[:KNOWS]->(b)""")
+        expected = sorted(expected + [[8, 0], [9, 1]])
+        self.env.assertEquals(self.two_hops(), expected)
+
+        # remove an edge
+        self.graph.query("MATCH (:Person {v: 4})-[e:KNOWS]->() DELETE e")
+        expected = [r for r in expected if r[0] not in [3, 4]]
+        self.env.assertEquals(self.two_hops(), expected)
+
+    def test04_label_modified(self):
+        before = self.two_hops()
+
+        # node in the middle of a path is no longer a Person
+        self.graph.query("MATCH (p:Person {v: 6}) REMOVE p:Person")
+        expected = [r for r in before if r[0] != 5 and r[0] != 6 and r[1] != 6]
+        self.env.assertEquals(self.two_hops(), expected)
+
+        self.graph.query("MATCH (p {v: 6}) SET p:Person")
+        self.env.assertEquals(self.two_hops(), before)
@@ -0,0 +1,96 @@
+from common import *
+from index_utils import *
+
+GRAPH_ID = "traversal_batching"
+
+# number of nodes in the graph
+# enough sources to grow traversal batches to their maximum size
+NODE_COUNT = 40000
+
+
+# traversal ops grow and shrink the number of records they process per batch
+# make sure results are not affected by the batch size
+class testTraversalBatching():
+    def __init__(self):
+        self.env = Env(decodeResponses=True)
+        self.redis_con = self.env.getConnection()
+        self.graph = Graph(self.redis_con, GRAPH_ID)
+        self.populate_graph()
+
+    def populate_graph(self):
+        # (n_i)-[:R]->(n_i+1) chain
+        # (n_i)-[:S]->(m_i%10) fan-in
+        self.graph.query("UNWIND range(0, %d) AS x CREATE (:N {v: x})" % (NODE_COUNT - 1))
+        self.graph.query("UNWIND range(0, 9) AS x CREATE (:M {v: x})")
+        create_node_exact_match_index(self.graph, 'N', 'v', sync=True)
+        create_node_exact_match_index(self.graph, 'M', 'v', sync=True)
+        self.graph.query("""UNWIND range(0, %d) AS x
+                            MATCH (a:N {v: x}), (b:N {v: x + 1})
+                            CREATE (a)-[:R]->(b)""" % (NODE_COUNT - 2))
+        self.graph.query("""UNWIND range(0, %d) AS x
+                            MATCH (a:N {v: x}), (m:M {v: x %% 10})
+                            CREATE (a)-[:S]->(m)""" % (NODE_COUNT - 1))
+
+    def test01_conditional_traverse(self):
+        # one hop
+        query = "MATCH (a:N)-[:R]->(b) RETURN count(b), sum(b.v - a.v)"
+        plan = self.graph.execution_plan(query)
+        self.env.assertIn("Conditional Traverse", plan)
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[NODE_COUNT - 1, NODE_COUNT - 1]])
+
+        # two hops
+        query = "MATCH (a:N)-[:R]->()-[:R]->(b) RETURN count(b), sum(b.v - a.v)"
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[NODE_COUNT - 2, 2 * (NODE_COUNT - 2)]])
+
+        # three hops with multiple destinations per source
+        query = "MATCH (a:N)-[:R]->()-[:R]->()-[:S]->(m) RETURN count(m), sum(m.v)"
+        result = self.graph.query(query)
+        expected = sum((x + 2) % 10 for x in range(NODE_COUNT - 2))
+        self.env.assertEquals(result.result_set, [[NODE_COUNT - 2, expected]])
+
+        # every record emitted is associated with its source
+        query = """MATCH (a:N)-[:R]->(b) WHERE b.v <> a.v + 1 RETURN count(1)"""
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[0]])
+
+    def test02_conditional_traverse_limit(self):
+        for limit in [1, 5, 16, 17, 100, 1000]:
+            query = "MATCH (a:N)-[:R]->(b) RETURN a.v, b.v LIMIT %d" % limit
+            result = self.graph.query(query)
+            self.env.assertEquals(len(result.result_set), limit)
+            for row in result.result_set:
+                self.env.assertEquals(row[1], row[0] + 1)
+
+    def test03_expand_into(self):
+        # both ends resolved, each pair connected via a two hop path
+        query = """MATCH (a:N)-[:R]->()-[:R]->(b)
+                   WITH a, b
+                   MATCH (a)-[:R]->()-[:R]->(b)
+                   RETURN count(1)"""
+        plan = self.graph.execution_plan(query)
+        self.env.assertIn("Expand Into", plan)
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[NODE_COUNT - 2]])
+
+        # both ends resolved, none of the pairs are connected
+        query = """MATCH (a:N)-[:R]->(b)
+                   WITH a, b
+                   MATCH (b)-[:R]->(a)
+                   RETURN count(1)"""
+        plan = self.graph.execution_plan(query)
+        self.env.assertIn("Expand Into", plan)
+        result = self.graph.query(query)
+        self.env.assertEquals(result.result_set, [[0]])
+
+    def test04_expand_into_limit(self):
+        for limit in [1, 16, 17, 1000]:
+            query = """MATCH (a:N)-[:R]->()-[:R]->(b)
+                       WITH a, b
+                       MATCH (a)-[:R]->()-[:R]->(b)
+                       RETURN a.v, b.v LIMIT %d""" % limit
+            result = self.graph.query(query)
+            self.env.assertEquals(len(result.result_set), limit)
+            for row in result.result_set:
+                self.env.assertEquals(row[1], row[0] + 2)
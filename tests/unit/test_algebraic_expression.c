@@ -692,6 +692,76 @@ void test_Exp_OP_MUL() {
 	AlgebraicExpression_Free(exp);
 }
 
+void test_Exp_OP_MUL_Chain() {
+	// Exp = A * B * C * D
+	// where C is a selective diagonal matrix, and D contains pending changes
+	// the evaluation order is chosen by the operands number of entries
+	// make sure result doesn't depend on the order
+	GrB_Index n = 64;
+	RG_Matrix A;
+	RG_Matrix B;
+	RG_Matrix C;
+	RG_Matrix D;
+	RG_Matrix res;
+
+	// A[0, j] = 1 for every j
+	RG_Matrix_new(&A, GrB_BOOL, n, n);
+	for(GrB_Index j = 0; j < n; j++) RG_Matrix_setElement_BOOL(A, 0, j);
+	RG_Matrix_wait(A, true); // force flush
+
+	// B[i, j] = 1 for every even j
+	RG_Matrix_new(&B, GrB_BOOL, n, n);
+	for(GrB_Index i = 0; i < n; i++) {
+		for(GrB_Index j = 0; j < n; j += 2) RG_Matrix_setElement_BOOL(B, i, j);
+	}
+	RG_Matrix_wait(B, true); // force flush
+
+	// C[4, 4] = 1
+	RG_Matrix_new(&C, GrB_BOOL, n, n);
+	RG_Matrix_setElement_BOOL(C, 4, 4);
+	RG_Matrix_wait(C, true); // force flush
+
+	// D[4, 7] = 1, D[5, 9] = 1, left pending
+	RG_Matrix_new(&D, GrB_BOOL, n, n);
+	RG_Matrix_setElement_BOOL(D, 4, 7);
+	RG_Matrix_setElement_BOOL(D, 5, 9);
+	TEST_ASSERT(!RG_Matrix_Synced(D));
+
+	rax *matrices = raxNew();
+	raxInsert(matrices, (unsigned char *)"A", strlen("A"), A, NULL);
+	raxInsert(matrices, (unsigned char *)"B", strlen("B"), B, NULL);
+	raxInsert(matrices, (unsigned char *)"C", strlen("C"), C, NULL);
+	raxInsert(matrices, (unsigned char *)"D", strlen("D"), D, NULL);
+	AlgebraicExpression *exp = AlgebraicExpression_FromString("A*B*C*D",
+			matrices);
+
+	RG_Matrix_new(&res, GrB_BOOL, n, n);
+	AlgebraicExpression_Eval(exp, res);
+
+	// A * B * C * D = [0, 7]
+	GrB_Matrix expected;
+	GrB_Matrix_new(&expected, GrB_BOOL, n, n);
+	GrB_Matrix_setElement_BOOL(expected, true, 0, 7);
+	TEST_ASSERT(_compare_matrices(expected, res));
+
+	// chain evaluates to an empty matrix
+	AlgebraicExpression_Free(exp);
+	exp = AlgebraicExpression_FromString("A*C*D*C", matrices);
+	AlgebraicExpression_Eval(exp, res);
+
+	GrB_Matrix_clear(expected);
+	TEST_ASSERT(_compare_matrices(expected, res));
+
+	raxFree(matrices);
+	RG_Matrix_free(&A);
+	RG_Matrix_free(&B);
+	RG_Matrix_free(&C);
+	RG_Matrix_free(&D);
+	RG_Matrix_free(&res);
+	GrB_Matrix_free(&expected);
+	AlgebraicExpression_Free(exp);
+}
+
 void test_Exp_OP_ADD_Transpose() {
 	// Exp = A + Transpose(A)
 	RG_Matrix res;
@@ -1800,6 +1870,7 @@ TEST_LIST = {
 	{"algebraicExpression_Transpose", test_algebraicExpression_Transpose},
 	{"Exp_OP_ADD", test_Exp_OP_ADD},
 	{"Exp_OP_MUL", test_Exp_OP_MUL},
+	{"Exp_OP_MUL_Chain", test_Exp_OP_MUL_Chain},
 	{"Exp_OP_ADD_Transpose", test_Exp_OP_ADD_Transpose},
 	{"Exp_OP_MUL_Transpose", test_Exp_OP_MUL_Transpose},
 	{"Exp_OP_A_MUL_B_Plus_C", test_Exp_OP_A_MUL_B_Plus_C},
@@ -0,0 +1,143 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/rmalloc.h"
+#include "src/ast/ast_parameterize.h"
+
+#include <string.h>
+
+void setup() {
+	Alloc_Reset();
+}
+#define TEST_INIT setup();
+#include "acutest.h"
+
+static void _free_param(void *p) {
+	SIValue *v = (SIValue *)p;
+	SIValue_Free(*v);
+	rm_free(v);
+}
+
+static SIValue _get_param(rax *params, const char *name) {
+	void *v = raxFind(params, (unsigned char *)name, strlen(name));
+	TEST_ASSERT(v != raxNotFound);
+	return *(SIValue *)v;
+}
+
+// normalizes q and compares the result against expected
+// expected is NULL if q should be left untouched
+static rax *_normalize(const char *q, const char *expected) {
+	rax *params = NULL;
+	char *normalized = AST_AutoParameterize(q, &params);
+
+	if(expected == NULL) {
+		TEST_ASSERT(normalized == NULL);
+		TEST_ASSERT(params == NULL);
+		return NULL;
+	}
+
+	TEST_ASSERT(normalized != NULL);
+	TEST_CHECK(strcmp(normalized, expected) == 0);
+	TEST_MSG("expected: %s, got: %s", expected, normalized);
+	rm_free(normalized);
+
+	return params;
+}
+
+void test_autoParamLiterals() {
+	rax *params = _normalize(
+		"MATCH (n:L {v: 1}) WHERE n.a = 'x' AND n.b > -2.5 RETURN n",
+		"MATCH (n:L {v: $__lit0}) WHERE n.a = $__lit1 AND n.b > -$__lit2 RETURN n");
+
+	TEST_ASSERT(raxSize(params) == 3);
+	TEST_ASSERT(SIValue_Compare(_get_param(params, "__lit0"), SI_LongVal(1), NULL) == 0);
+	TEST_ASSERT(SIValue_Compare(_get_param(params, "__lit1"), SI_ConstStringVal("x"), NULL) == 0);
+	TEST_ASSERT(SIValue_Compare(_get_param(params, "__lit2"), SI_DoubleVal(2.5), NULL) == 0);
+
+	raxFreeWithCallback(params, _free_param);
+}
+
+void test_autoParamKeepsStructure() {
+	rax *params;
+
+	// LIMIT, SKIP and variable length ranges
+	params = _normalize(
+		"MATCH (a)-[*1..3]->(b) WHERE a.v = 1 WITH b SKIP 2 LIMIT 5 RETURN b",
+		"MATCH (a)-[*1..3]->(b) WHERE a.v = $__lit0 WITH b SKIP 2 LIMIT 5 RETURN b");
+	raxFreeWithCallback(params, _free_param);
+
+	// RETURN and ORDER BY clauses
+	params = _normalize(
+		"WITH 1 AS x ORDER BY x + 2 WHERE x > 0 RETURN x + 3",
+		"WITH $__lit0 AS x ORDER BY x + 2 WHERE x > $__lit1 RETURN x + 3");
+	raxFreeWithCallback(params, _free_param);
+
+	// RETURN within a sub query
+	params = _normalize(
+		"CALL { RETURN 1 AS x } WITH x WHERE x = 1 RETURN x",
+		"CALL { RETURN 1 AS x } WITH x WHERE x = $__lit0 RETURN x");
+	raxFreeWithCallback(params, _free_param);
+
+	// identifiers, comments, hexadecimal and escaped strings
+	params = _normalize(
+		"MATCH (`n1`:L2) /* 3 */ WHERE n1.a2 = 0x1F AND n1.b = 'a\\'b' AND n1.c = 4 // 5",
+		"MATCH (`n1`:L2) /* 3 */ WHERE n1.a2 = 0x1F AND n1.b = 'a\\'b' AND n1.c = $__lit0 // 5");
+	raxFreeWithCallback(params, _free_param);
+
+	// attribute names which are also keywords
+	params = _normalize(
+		"MATCH (n) WHERE n.limit = 1 RETURN n",
+		"MATCH (n) WHERE n.limit = $__lit0 RETURN n");
+	raxFreeWithCallback(params, _free_param);
+}
+
+void test_autoParamUntouched() {
+	// no literals
+	_normalize("MATCH (n) RETURN n", NULL);
+	_normalize("MATCH (n) WHERE n.v = $v RETURN n", NULL);
+	_normalize("MATCH (n) RETURN n.v + 1 LIMIT 2", NULL);
+
+	// index operations and procedure calls
+	_normalize("CREATE INDEX FOR (n:L) ON (n.v)", NULL);
+	_normalize("CALL db.idx.fulltext.queryNodes('L', 'x') YIELD node RETURN node", NULL);
+
+	// hidden parameters referred by the query
+	_normalize("MATCH (n) WHERE n.v = $__lit0 AND n.x = 1 RETURN n", NULL);
+
+	// unterminated string
+	_normalize("MATCH (n) WHERE n.v = 'a RETURN n", NULL);
+
+	// integer overflow
+	_normalize("MATCH (n) WHERE n.v = 9223372036854775808 RETURN n", NULL);
+}
+
+void test_autoParamUserParams() {
+	// hidden parameters are added to existing parameters
+	rax *params = raxNew();
+	SIValue *v = rm_malloc(sizeof(SIValue));
+	*v = SI_LongVal(7);
+	raxInsert(params, (unsigned char *)"p", 1, v, NULL);
+
+	char *normalized =
+		AST_AutoParameterize("MATCH (n) WHERE n.v = $p OR n.v = 2 RETURN n",
+				&params);
+	TEST_ASSERT(normalized != NULL);
+	TEST_ASSERT(strcmp(normalized,
+				"MATCH (n) WHERE n.v = $p OR n.v = $__lit0 RETURN n") == 0);
+	TEST_ASSERT(raxSize(params) == 2);
+
+	rm_free(normalized);
+	raxFreeWithCallback(params, _free_param);
+}
+
+TEST_LIST = {
+	{"autoParamLiterals", test_autoParamLiterals},
+	{"autoParamKeepsStructure", test_autoParamKeepsStructure},
+	{"autoParamUntouched", test_autoParamUntouched},
+	{"autoParamUserParams", test_autoParamUserParams},
+	{NULL, NULL}
+};
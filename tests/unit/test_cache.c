@@ -90,17 +90,195 @@ void test_executionPlanCache() {
 	to_cache = (CacheObj*)Cache_SetGetValue(cache, key4, item4);
 	CacheObj_Free(to_cache);
 
-	// Verify that oldest entry do not exists - queue is [ 4 | 3 | 2 ].
+	// Verify that least frequently used entry do not exists, key3 was
+	// never looked up while key1 and key2 were looked up once.
+	TEST_ASSERT(Cache_GetValue(cache, key3) == NULL);
+	from_cache = (CacheObj*)Cache_GetValue(cache, key1);
+	TEST_ASSERT(CacheObj_EQ(item1, from_cache));
+	CacheObj_Free(from_cache);
+
+	Cache_Free(cache);
+
+	// Expecting CacheObjFree to be called 10 times.
+	TEST_ASSERT(free_count == 10);
+}
+
+void test_cacheAdmission() {
+	Cache *cache = Cache_New(2, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *hot1 = "MATCH (a) RETURN a";
+	const char *hot2 = "MATCH (b) RETURN b";
+
+	Cache_SetValue(cache, hot1, CacheObj_New("1"));
+	Cache_SetValue(cache, hot2, CacheObj_New("2"));
+
+	// frequently accessed entries
+	for(int i = 0; i < 5; i++) {
+		CacheObj_Free(Cache_GetValue(cache, hot1));
+		CacheObj_Free(Cache_GetValue(cache, hot2));
+	}
+
+	// a burst of one-off keys doesn't evict frequently accessed entries
+	char key[32];
+	for(int i = 0; i < 20; i++) {
+		sprintf(key, "RETURN %d", i);
+		TEST_ASSERT(Cache_GetValue(cache, key) == NULL);
+		CacheObj *obj = CacheObj_New("x");
+		CacheObj *res = Cache_SetGetValue(cache, key, obj);
+		// rejected value is returned to the caller
+		TEST_ASSERT(res == obj);
+		CacheObj_Free(res);
+	}
+
+	CacheObj *from_cache = Cache_GetValue(cache, hot1);
+	TEST_ASSERT(from_cache != NULL);
+	CacheObj_Free(from_cache);
+
+	from_cache = Cache_GetValue(cache, hot2);
+	TEST_ASSERT(from_cache != NULL);
+	CacheObj_Free(from_cache);
+
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+	TEST_ASSERT(stats.size == 2);
+	TEST_ASSERT(stats.hits == 12);
+	TEST_ASSERT(stats.misses == 20);
+	TEST_ASSERT(stats.evictions == 0);
+	TEST_ASSERT(stats.rejections == 20);
+
+	Cache_Free(cache);
+}
+
+void test_cacheAdmissionSingleCount() {
+	Cache *cache = Cache_New(1, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *key1 = "MATCH (a) RETURN a";
+	const char *key2 = "MATCH (b) RETURN b";
+
+	// key1 is accessed three times, a miss followed by two hits
+	TEST_ASSERT(Cache_GetValue(cache, key1) == NULL);
+	Cache_SetValue(cache, key1, CacheObj_New("1"));
+	CacheObj_Free(Cache_GetValue(cache, key1));
+	CacheObj_Free(Cache_GetValue(cache, key1));
+
+	// key2 is accessed twice, each access is a miss followed by an insertion
+	// attempt, insertion attempts aren't counted as additional accesses
+	for(int i = 0; i < 2; i++) {
+		TEST_ASSERT(Cache_GetValue(cache, key2) == NULL);
+		CacheObj *obj = CacheObj_New("2");
+		CacheObj *res = Cache_SetGetValue(cache, key2, obj);
+		TEST_ASSERT(res == obj);
+		CacheObj_Free(res);
+	}
+
+	CacheObj *from_cache = Cache_GetValue(cache, key1);
+	TEST_ASSERT(from_cache != NULL);
+	CacheObj_Free(from_cache);
+
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+	TEST_ASSERT(stats.evictions == 0);
+	TEST_ASSERT(stats.rejections == 2);
+
+	Cache_Free(cache);
+}
+
+void test_cacheRemove() {
+	Cache *cache = Cache_New(2, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+
+	const char *key1 = "MATCH (a) RETURN a";
+	const char *key2 = "MATCH (b) RETURN b";
+
+	Cache_SetValue(cache, key1, CacheObj_New("1"));
+	Cache_SetValue(cache, key2, CacheObj_New("2"));
+
+	// removing a missing key is a no-op
+	int freed = free_count;
+	Cache_RemoveValue(cache, "None existing");
+	TEST_ASSERT(free_count == freed);
+
+	// removed value is freed
+	Cache_RemoveValue(cache, key1);
+	TEST_ASSERT(free_count == freed + 1);
 	TEST_ASSERT(Cache_GetValue(cache, key1) == NULL);
 
+	CacheObj *from_cache = Cache_GetValue(cache, key2);
+	TEST_ASSERT(from_cache != NULL);
+	CacheObj_Free(from_cache);
+
+	// key can be cached again
+	CacheObj *obj = CacheObj_New("3");
+	CacheObj *res = Cache_SetGetValue(cache, key1, obj);
+	TEST_ASSERT(res != obj);
+	TEST_ASSERT(CacheObj_EQ(obj, res));
+	CacheObj_Free(res);
+
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+	TEST_ASSERT(stats.size == 2);
+
 	Cache_Free(cache);
+}
+
+static uint64_t CacheObj_Weight(const CacheObj *obj) {
+	return strlen(obj->str);
+}
 
-	// Expecting CacheObjFree to be called 9 times.
-	TEST_ASSERT(free_count == 9);
+void test_cacheWeight() {
+	Cache *cache = Cache_New(10, (CacheEntryFreeFunc)CacheObj_Free,
+			(CacheEntryCopyFunc)CacheObj_Dup);
+	Cache_SetMaxWeight(cache, 10, (CacheEntryWeightFunc)CacheObj_Weight);
+
+	const char *key1 = "MATCH (a) RETURN a";
+	const char *key2 = "MATCH (b) RETURN b";
+	const char *key3 = "MATCH (c) RETURN c";
+	const char *key4 = "MATCH (d) RETURN d";
+
+	Cache_SetValue(cache, key1, CacheObj_New("aaaa"));
+	Cache_SetValue(cache, key2, CacheObj_New("bbbb"));
+
+	CacheStats stats;
+	Cache_GetStats(cache, &stats);
+	TEST_ASSERT(stats.size == 2);
+	TEST_ASSERT(stats.weight == 8);
+
+	// entry doesn't fit, the oldest entry is evicted
+	Cache_SetValue(cache, key3, CacheObj_New("ccc"));
+
+	Cache_GetStats(cache, &stats);
+	TEST_ASSERT(stats.size == 2);
+	TEST_ASSERT(stats.weight == 7);
+	TEST_ASSERT(stats.evictions == 1);
+	TEST_ASSERT(Cache_GetValue(cache, key1) == NULL);
+
+	// entry heavier than the cache's max weight is never admitted
+	int freed = free_count;
+	Cache_SetValue(cache, key4, CacheObj_New("ddddddddddd"));
+	TEST_ASSERT(free_count == freed + 1);
+
+	Cache_GetStats(cache, &stats);
+	TEST_ASSERT(stats.size == 2);
+	TEST_ASSERT(stats.weight == 7);
+	TEST_ASSERT(stats.rejections == 1);
+
+	// removed entries no longer count towards the cache's weight
+	Cache_RemoveValue(cache, key2);
+	Cache_GetStats(cache, &stats);
+	TEST_ASSERT(stats.size == 1);
+	TEST_ASSERT(stats.weight == 3);
+
+	Cache_Free(cache);
 }
 
 TEST_LIST = {
 	{"executionPlanCache", test_executionPlanCache},
+	{"cacheAdmission", test_cacheAdmission},
+	{"cacheAdmissionSingleCount", test_cacheAdmissionSingleCount},
+	{"cacheRemove", test_cacheRemove},
+	{"cacheWeight", test_cacheWeight},
 	{NULL, NULL}
 };
 
@@ -0,0 +1,105 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/util/rmalloc.h"
+#include "src/graph/node_labels.h"
+
+void setup() {
+	Alloc_Reset();
+}
+#define TEST_INIT setup();
+#include "acutest.h"
+
+void test_nodeLabelsEmpty() {
+	NodeLabels nl;
+	NodeLabels_Init(&nl);
+
+	LabelID labels[4];
+	TEST_ASSERT(NodeLabels_Test(&nl, 0, 0) == false);
+	TEST_ASSERT(NodeLabels_Get(&nl, 0, labels, 4) == 0);
+	TEST_ASSERT(nl.bits == NULL);
+
+	// removing missing labels is a no-op
+	NodeLabels_Unset(&nl, 10, 3);
+	NodeLabels_Clear(&nl, 10);
+
+	NodeLabels_Free(&nl);
+}
+
+void test_nodeLabelsSetTest() {
+	NodeLabels nl;
+	NodeLabels_Init(&nl);
+
+	// label every third node as 1 and every node as 2
+	for(NodeID id = 0; id < 5000; id++) {
+		if(id % 3 == 0) NodeLabels_Set(&nl, id, 1);
+		NodeLabels_Set(&nl, id, 2);
+	}
+
+	for(NodeID id = 0; id < 5000; id++) {
+		TEST_ASSERT(NodeLabels_Test(&nl, id, 0) == false);
+		TEST_ASSERT(NodeLabels_Test(&nl, id, 1) == (id % 3 == 0));
+		TEST_ASSERT(NodeLabels_Test(&nl, id, 2));
+	}
+
+	// out of range node
+	TEST_ASSERT(NodeLabels_Test(&nl, 1000000, 2) == false);
+
+	NodeLabels_Unset(&nl, 3, 1);
+	TEST_ASSERT(NodeLabels_Test(&nl, 3, 1) == false);
+	TEST_ASSERT(NodeLabels_Test(&nl, 3, 2));
+
+	NodeLabels_Clear(&nl, 6);
+	TEST_ASSERT(NodeLabels_Test(&nl, 6, 1) == false);
+	TEST_ASSERT(NodeLabels_Test(&nl, 6, 2) == false);
+	TEST_ASSERT(NodeLabels_Test(&nl, 9, 1));
+
+	NodeLabels_Free(&nl);
+}
+
+void test_nodeLabelsWiden() {
+	NodeLabels nl;
+	NodeLabels_Init(&nl);
+
+	// populate single word
+	for(NodeID id = 0; id < 100; id++) {
+		NodeLabels_Set(&nl, id, id % 64);
+	}
+
+	// introduce labels beyond the first word, existing nodes are retained
+	NodeLabels_Set(&nl, 50, 130);
+	NodeLabels_Set(&nl, 99, 64);
+
+	LabelID labels[8];
+	for(NodeID id = 0; id < 100; id++) {
+		uint n = NodeLabels_Get(&nl, id, labels, 8);
+		if(id == 50) {
+			TEST_ASSERT(n == 2);
+			TEST_ASSERT(labels[0] == 50);
+			TEST_ASSERT(labels[1] == 130);
+		} else if(id == 99) {
+			TEST_ASSERT(n == 2);
+			TEST_ASSERT(labels[0] == 35);
+			TEST_ASSERT(labels[1] == 64);
+		} else {
+			TEST_ASSERT(n == 1);
+			TEST_ASSERT(labels[0] == (LabelID)(id % 64));
+		}
+	}
+
+	// output is bounded by array size
+	TEST_ASSERT(NodeLabels_Get(&nl, 50, labels, 1) == 1);
+	TEST_ASSERT(labels[0] == 50);
+
+	NodeLabels_Free(&nl);
+}
+
+TEST_LIST = {
+	{"nodeLabelsEmpty", test_nodeLabelsEmpty},
+	{"nodeLabelsSetTest", test_nodeLabelsSetTest},
+	{"nodeLabelsWiden", test_nodeLabelsWiden},
+	{NULL, NULL}
+};
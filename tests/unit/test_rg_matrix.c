@@ -1455,6 +1455,104 @@ void test_RGMatrix_mxm() {
 	TEST_ASSERT(C == NULL);
 }
 
+// entries reachable via multiple paths, some of which are pending deletion
+void test_RGMatrix_mxm_multiple_paths() {
+	GrB_Type    t                   =  GrB_BOOL;
+	RG_Matrix   A                   =  NULL;
+	RG_Matrix   B                   =  NULL;
+	RG_Matrix   C                   =  NULL;
+	RG_Matrix   D                   =  NULL;
+	GrB_Info    info                =  GrB_SUCCESS;
+	GrB_Index   nrows               =  100;
+	GrB_Index   ncols               =  100;
+	GrB_Index   nvals               =  0;
+	bool        v                   =  false;
+	bool        sync                =  true;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_new(&B, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_new(&C, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	info = RG_Matrix_new(&D, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// A: 0 -> 1, 0 -> 2
+	// B: 1 -> 3, 2 -> 3, 1 -> 4
+	info = RG_Matrix_setElement_BOOL(A, 0, 1);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_BOOL(A, 0, 2);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_BOOL(B, 1, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_BOOL(B, 2, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = RG_Matrix_setElement_BOOL(B, 1, 4);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	RG_Matrix_wait(A, sync);
+	RG_Matrix_wait(B, sync);
+
+	//--------------------------------------------------------------------------
+	// set pending changes
+	//--------------------------------------------------------------------------
+
+	// 0 -> 3 is still reachable via 2
+	info = RG_Matrix_removeElement_BOOL(B, 1, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// 0 -> 4 is no longer reachable
+	info = RG_Matrix_removeElement_BOOL(B, 1, 4);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// 0 -> 5 becomes reachable
+	info = RG_Matrix_setElement_BOOL(B, 2, 5);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	TEST_ASSERT(!RG_Matrix_Synced(B));
+
+	//--------------------------------------------------------------------------
+	// mxm matrix
+	//--------------------------------------------------------------------------
+
+	info = RG_mxm(C, GxB_ANY_PAIR_BOOL, A, B);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	RG_Matrix_wait(B, sync);
+
+	info = RG_mxm(D, GxB_ANY_PAIR_BOOL, A, B);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// validation
+	//--------------------------------------------------------------------------
+
+	ASSERT_GrB_Matrices_EQ(RG_MATRIX_M(C), RG_MATRIX_M(D));
+
+	info = GrB_Matrix_nvals(&nvals, RG_MATRIX_M(C));
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(nvals == 2);
+
+	info = GrB_Matrix_extractElement(&v, RG_MATRIX_M(C), 0, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	info = GrB_Matrix_extractElement(&v, RG_MATRIX_M(C), 0, 5);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// clean up
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+	RG_Matrix_free(&B);
+	TEST_ASSERT(B == NULL);
+	RG_Matrix_free(&C);
+	TEST_ASSERT(C == NULL);
+	RG_Matrix_free(&D);
+	TEST_ASSERT(D == NULL);
+}
+
 void test_RGMatrix_resize() {
 	RG_Matrix  A        =  NULL;
 	RG_Matrix  T        =  NULL;
@@ -1539,6 +1637,199 @@ void test_RGMatrix_resize() {
 	RG_Matrix_free(&A);
 }
 
+// compact matrix off to the side and swap it in
+void test_RGMatrix_compact() {
+	GrB_Type    t                   =  GrB_UINT64;
+	RG_Matrix   A                   =  NULL;
+	RG_Matrix   T                   =  NULL;
+	GrB_Matrix  M                   =  NULL;
+	GrB_Matrix  DP                  =  NULL;
+	GrB_Matrix  DM                  =  NULL;
+	GrB_Matrix  C                   =  NULL;  // compacted main matrix
+	GrB_Matrix  TC                  =  NULL;  // compacted transposed matrix
+	GrB_Info    info                =  GrB_SUCCESS;
+	GrB_Index   nvals               =  0;
+	GrB_Index   nrows               =  100;
+	GrB_Index   ncols               =  100;
+	uint64_t    x                   =  0;
+	bool        b                   =  false;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	T = RG_Matrix_getTranspose(A);
+
+	// M[0,1] = 1, M[2,3] = 2
+	RG_Matrix_setElement_UINT64(A, 1, 0, 1);
+	RG_Matrix_setElement_UINT64(A, 2, 2, 3);
+	RG_Matrix_wait(A, true);
+
+	// store A in its selected format
+	RG_Matrix_compact(A, &C, &TC);
+	TEST_ASSERT(RG_Matrix_swapCompacted(A, &C, &TC));
+
+	// DM[0,1], DP[4,5] = 3
+	RG_Matrix_removeElement_UINT64(A, 0, 1);
+	RG_Matrix_setElement_UINT64(A, 3, 4, 5);
+	RG_Matrix_wait(A, false);
+
+	// below threshold
+	TEST_ASSERT(!RG_Matrix_requiresCompaction(A, 2));
+	TEST_ASSERT(RG_Matrix_requiresCompaction(A, 1));
+
+	//--------------------------------------------------------------------------
+	// compact, A is not modified
+	//--------------------------------------------------------------------------
+
+	RG_Matrix_compact(A, &C, &TC);
+	TEST_ASSERT(C  != NULL);
+	TEST_ASSERT(TC != NULL);
+
+	M   =  RG_MATRIX_M(A);
+	DP  =  RG_MATRIX_DELTA_PLUS(A);
+	DM  =  RG_MATRIX_DELTA_MINUS(A);
+	DP_NOT_EMPTY();
+	DM_NOT_EMPTY();
+
+	GrB_Matrix_nvals(&nvals, M);
+	TEST_ASSERT(nvals == 2);
+
+	GrB_Matrix_nvals(&nvals, C);
+	TEST_ASSERT(nvals == 2);
+
+	//--------------------------------------------------------------------------
+	// swap compacted matrices in
+	//--------------------------------------------------------------------------
+
+	TEST_ASSERT(RG_Matrix_swapCompacted(A, &C, &TC));
+	TEST_ASSERT(C  == NULL);
+	TEST_ASSERT(TC == NULL);
+
+	// no pending changes, matrices are stored in their selected format
+	TEST_ASSERT(!RG_Matrix_requiresCompaction(A, 1));
+
+	M   =  RG_MATRIX_M(A);
+	DP  =  RG_MATRIX_DELTA_PLUS(A);
+	DM  =  RG_MATRIX_DELTA_MINUS(A);
+	DP_EMPTY();
+	DM_EMPTY();
+
+	GrB_Matrix_nvals(&nvals, M);
+	TEST_ASSERT(nvals == 2);
+
+	info = RG_Matrix_extractElement_UINT64(&x, A, 0, 1);
+	TEST_ASSERT(info == GrB_NO_VALUE);
+	info = RG_Matrix_extractElement_UINT64(&x, A, 2, 3);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(x == 2);
+	info = RG_Matrix_extractElement_UINT64(&x, A, 4, 5);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(x == 3);
+
+	// transposed matrix is compacted as well
+	M   =  RG_MATRIX_M(T);
+	DP  =  RG_MATRIX_DELTA_PLUS(T);
+	DM  =  RG_MATRIX_DELTA_MINUS(T);
+	DP_EMPTY();
+	DM_EMPTY();
+
+	info = RG_Matrix_extractElement_BOOL(&b, T, 1, 0);
+	TEST_ASSERT(info == GrB_NO_VALUE);
+	info = RG_Matrix_extractElement_BOOL(&b, T, 5, 4);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	//--------------------------------------------------------------------------
+	// compacted matrices are discarded once A is resized
+	//--------------------------------------------------------------------------
+
+	RG_Matrix_setElement_UINT64(A, 4, 6, 7);
+	RG_Matrix_wait(A, false);
+	RG_Matrix_compact(A, &C, &TC);
+
+	info = RG_Matrix_resize(A, nrows * 2, ncols * 2);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	TEST_ASSERT(!RG_Matrix_swapCompacted(A, &C, &TC));
+	TEST_ASSERT(C  == NULL);
+	TEST_ASSERT(TC == NULL);
+
+	// pending change is retained
+	info = RG_Matrix_extractElement_UINT64(&x, A, 6, 7);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(x == 4);
+
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+}
+
+// storage format follows matrix density
+void test_RGMatrix_format() {
+	GrB_Type    t                   =  GrB_BOOL;
+	RG_Matrix   A                   =  NULL;
+	GrB_Matrix  C                   =  NULL;  // compacted main matrix
+	GrB_Matrix  TC                  =  NULL;  // compacted transposed matrix
+	GrB_Info    info                =  GrB_SUCCESS;
+	GrB_Index   nrows               =  10;
+	GrB_Index   ncols               =  10;
+
+	info = RG_Matrix_new(&A, t, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// empty matrix
+	TEST_ASSERT(RG_Matrix_selectFormat(A) == GxB_HYPERSPARSE);
+
+	// set half of the matrix entries
+	for(GrB_Index i = 0; i < nrows; i++) {
+		for(GrB_Index j = 0; j < ncols; j += 2) {
+			RG_Matrix_setElement_BOOL(A, i, j);
+		}
+	}
+	RG_Matrix_wait(A, true);
+
+	// dense matrix is stored as a bitmap once compacted
+	TEST_ASSERT(RG_Matrix_selectFormat(A) == GxB_BITMAP);
+	TEST_ASSERT(RG_Matrix_requiresCompaction(A, 10000));
+
+	RG_Matrix_compact(A, &C, &TC);
+	TEST_ASSERT(RG_Matrix_swapCompacted(A, &C, &TC));
+	TEST_ASSERT(RG_Matrix_format(A) == GxB_BITMAP);
+	TEST_ASSERT(!RG_Matrix_requiresCompaction(A, 10000));
+	TEST_ASSERT(strcmp(RG_Matrix_formatName(GxB_BITMAP), "bitmap") == 0);
+
+	// growing a bitmap falls back to sparse storage
+	info = RG_Matrix_resize(A, nrows * 10, ncols * 10);
+	TEST_ASSERT(info == GrB_SUCCESS);
+	TEST_ASSERT(RG_Matrix_format(A) != GxB_BITMAP);
+	TEST_ASSERT(RG_Matrix_selectFormat(A) == GxB_SPARSE);
+
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+
+	// a bitmap of wider values pays off at a higher density
+	info = RG_Matrix_new(&A, GrB_UINT64, nrows, ncols);
+	TEST_ASSERT(info == GrB_SUCCESS);
+
+	// set half of the matrix entries
+	for(GrB_Index i = 0; i < nrows; i++) {
+		for(GrB_Index j = 0; j < ncols; j += 2) {
+			RG_Matrix_setElement_UINT64(A, i, i, j);
+		}
+	}
+	RG_Matrix_wait(A, true);
+	TEST_ASSERT(RG_Matrix_selectFormat(A) == GxB_SPARSE);
+
+	// set 7/10 of the matrix entries
+	for(GrB_Index i = 0; i < nrows; i++) {
+		for(GrB_Index j = 1; j < ncols / 2; j += 2) {
+			RG_Matrix_setElement_UINT64(A, i, i, j);
+		}
+	}
+	RG_Matrix_wait(A, true);
+	TEST_ASSERT(RG_Matrix_selectFormat(A) == GxB_BITMAP);
+
+	RG_Matrix_free(&A);
+	TEST_ASSERT(A == NULL);
+}
+
 TEST_LIST = {
 	{"RGMatrix_new", test_RGMatrix_new},
 	{"RGMatrix_simple_set", test_RGMatrix_simple_set},
@@ -1552,7 +1843,10 @@ TEST_LIST = {
 	{"RGMatrix_export_pending_changes", test_RGMatrix_export_pending_changes},
 	{"RGMatrix_copy", test_RGMatrix_copy},
 	{"RGMatrix_mxm", test_RGMatrix_mxm},
+	{"RGMatrix_mxm_multiple_paths", test_RGMatrix_mxm_multiple_paths},
 	{"RGMatrix_resize", test_RGMatrix_resize},
+	{"RGMatrix_compact", test_RGMatrix_compact},
+	{"RGMatrix_format", test_RGMatrix_format},
 	{NULL, NULL}
 };
 
@@ -0,0 +1,155 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/arr.h"
+#include "src/util/rmalloc.h"
+#include "src/util/sort_key.h"
+#include "src/datatypes/array.h"
+
+#include <math.h>
+
+void setup() {
+	Alloc_Reset();
+}
+#define TEST_INIT setup();
+#include "acutest.h"
+
+static int _sign(int x) {
+	return (x > 0) - (x < 0);
+}
+
+// compare a and b by their encoding
+static int _key_cmp(SIValue a, SIValue b, bool descending) {
+	unsigned char *ka = array_new(unsigned char, 16);
+	unsigned char *kb = array_new(unsigned char, 16);
+
+	TEST_ASSERT(SortKey_Append(&ka, a, descending));
+	TEST_ASSERT(SortKey_Append(&kb, b, descending));
+
+	int res = SortKey_Compare(ka, array_len(ka), kb, array_len(kb));
+
+	array_free(ka);
+	array_free(kb);
+	return _sign(res);
+}
+
+void test_sortKeyAgreesWithCompare() {
+	SIValue arr_a = SIArray_New(2);
+	SIArray_Append(&arr_a, SI_LongVal(1));
+	SIArray_Append(&arr_a, SI_ConstStringVal("a"));
+
+	SIValue arr_b = SIArray_New(1);
+	SIArray_Append(&arr_b, SI_LongVal(1));
+
+	SIValue arr_c = SIArray_New(1);
+	SIArray_Append(&arr_c, SI_DoubleVal(0.5));
+
+	SIValue values[] = {
+		SI_NullVal(),
+		SI_BoolVal(false),
+		SI_BoolVal(true),
+		SI_LongVal(-7),
+		SI_DoubleVal(-2.5),
+		SI_LongVal(0),
+		SI_DoubleVal(0.5),
+		SI_LongVal(3),
+		SI_DoubleVal(1e20),
+		SI_DoubleVal(INFINITY),
+		SI_DoubleVal(-INFINITY),
+		SI_ConstStringVal(""),
+		SI_ConstStringVal("a"),
+		SI_ConstStringVal("ab"),
+		SI_ConstStringVal("b"),
+		arr_a,
+		arr_b,
+		arr_c,
+	};
+
+	uint n = sizeof(values) / sizeof(SIValue);
+	for(uint i = 0; i < n; i++) {
+		for(uint j = 0; j < n; j++) {
+			int expected = _sign(SIValue_Compare(values[i], values[j], NULL));
+			TEST_ASSERT(_key_cmp(values[i], values[j], false) == expected);
+			TEST_ASSERT(_key_cmp(values[i], values[j], true) == -expected);
+		}
+	}
+
+	SIValue_Free(arr_a);
+	SIValue_Free(arr_b);
+	SIValue_Free(arr_c);
+}
+
+void test_sortKeyNumerics() {
+	// integers and floating points are ordered by value
+	TEST_ASSERT(_key_cmp(SI_LongVal(2), SI_DoubleVal(2.5), false) < 0);
+	TEST_ASSERT(_key_cmp(SI_DoubleVal(-0.5), SI_LongVal(0), false) < 0);
+
+	// -0.0 equals 0.0
+	TEST_ASSERT(_key_cmp(SI_DoubleVal(-0.0), SI_DoubleVal(0.0), false) == 0);
+
+	// large integers which share a double representation remain ordered
+	int64_t big = (1LL << 62) + 1;
+	TEST_ASSERT(_key_cmp(SI_LongVal(big - 1), SI_LongVal(big), false) < 0);
+
+	// extreme integers are ordered
+	TEST_ASSERT(_key_cmp(SI_LongVal(INT64_MIN), SI_LongVal(3), false) < 0);
+	TEST_ASSERT(_key_cmp(SI_LongVal(INT64_MAX), SI_LongVal(-3), false) > 0);
+	TEST_ASSERT(_key_cmp(SI_LongVal(INT64_MAX), SI_DoubleVal(INFINITY), false) < 0);
+
+	// NaN is ordered after all other numerics
+	TEST_ASSERT(_key_cmp(SI_DoubleVal(NAN), SI_DoubleVal(INFINITY), false) > 0);
+	TEST_ASSERT(_key_cmp(SI_DoubleVal(NAN), SI_ConstStringVal("a"), false) < 0);
+}
+
+void test_sortKeyMultipleValues() {
+	unsigned char *ka = array_new(unsigned char, 16);
+	unsigned char *kb = array_new(unsigned char, 16);
+
+	// ("a" ASC, 1 DESC) < ("a" ASC, 0 DESC)
+	TEST_ASSERT(SortKey_Append(&ka, SI_ConstStringVal("a"), false));
+	TEST_ASSERT(SortKey_Append(&ka, SI_LongVal(1), true));
+	TEST_ASSERT(SortKey_Append(&kb, SI_ConstStringVal("a"), false));
+	TEST_ASSERT(SortKey_Append(&kb, SI_LongVal(0), true));
+	TEST_ASSERT(SortKey_Compare(ka, array_len(ka), kb, array_len(kb)) < 0);
+
+	// ("a", ...) < ("ab", ...) regardless of following values
+	array_clear(ka);
+	array_clear(kb);
+	TEST_ASSERT(SortKey_Append(&ka, SI_ConstStringVal("a"), false));
+	TEST_ASSERT(SortKey_Append(&ka, SI_LongVal(100), false));
+	TEST_ASSERT(SortKey_Append(&kb, SI_ConstStringVal("ab"), false));
+	TEST_ASSERT(SortKey_Append(&kb, SI_LongVal(0), false));
+	TEST_ASSERT(SortKey_Compare(ka, array_len(ka), kb, array_len(kb)) < 0);
+
+	array_free(ka);
+	array_free(kb);
+}
+
+void test_sortKeyUnsupported() {
+	SIValue map = SI_Map(0);
+	SIValue arr = SIArray_New(1);
+	SIArray_Append(&arr, map);
+
+	TEST_ASSERT(SortKey_Supported(SI_LongVal(1)));
+	TEST_ASSERT(!SortKey_Supported(map));
+	TEST_ASSERT(!SortKey_Supported(arr));
+
+	unsigned char *k = array_new(unsigned char, 16);
+	TEST_ASSERT(!SortKey_Append(&k, arr, false));
+	array_free(k);
+
+	SIValue_Free(arr);
+	SIValue_Free(map);
+}
+
+TEST_LIST = {
+	{"sortKeyAgreesWithCompare", test_sortKeyAgreesWithCompare},
+	{"sortKeyNumerics", test_sortKeyNumerics},
+	{"sortKeyMultipleValues", test_sortKeyMultipleValues},
+	{"sortKeyUnsupported", test_sortKeyUnsupported},
+	{NULL, NULL}
+};
@@ -0,0 +1,112 @@
+/*
+ * Copyright Redis Ltd. 2018 - present
+ * Licensed under your choice of the Redis Source Available License 2.0 (RSALv2) or
+ * the Server Side Public License v1 (SSPLv1).
+ */
+
+#include "src/value.h"
+#include "src/util/rmalloc.h"
+#include "src/util/tuple_table.h"
+
+#include <stdio.h>
+
+void setup() {
+	Alloc_Reset();
+}
+#define TEST_INIT setup();
+#include "acutest.h"
+
+void test_tupleTableAdd() {
+	bool added;
+	TupleTable *t = TupleTable_New(2);
+
+	// add 1000 distinct tuples
+	for(int i = 0; i < 1000; i++) {
+		char s[16];
+		sprintf(s, "%d", i);
+		SIValue tuple[2] = {SI_LongVal(i), SI_ConstStringVal(s)};
+		XXH64_hash_t h = TupleTable_Hash(tuple, 2);
+		uint32_t id = TupleTable_FindOrAdd(t, tuple, h, &added);
+		TEST_ASSERT(added);
+		TEST_ASSERT(id == (uint32_t)i);
+	}
+	TEST_ASSERT(TupleTable_Count(t) == 1000);
+
+	// re-adding returns existing IDs
+	for(int i = 0; i < 1000; i++) {
+		char s[16];
+		sprintf(s, "%d", i);
+		SIValue tuple[2] = {SI_LongVal(i), SI_ConstStringVal(s)};
+		XXH64_hash_t h = TupleTable_Hash(tuple, 2);
+		TEST_ASSERT(TupleTable_FindOrAdd(t, tuple, h, &added) == (uint32_t)i);
+		TEST_ASSERT(!added);
+		TEST_ASSERT(TupleTable_Find(t, tuple, h) == (uint32_t)i);
+
+		// stored tuple is a copy
+		const SIValue *stored = TupleTable_Get(t, i);
+		TEST_ASSERT(stored[0].longval == i);
+		TEST_ASSERT(stored[1].stringval != s);
+		TEST_ASSERT(strcmp(stored[1].stringval, s) == 0);
+	}
+	TEST_ASSERT(TupleTable_Count(t) == 1000);
+
+	TupleTable_Free(&t);
+	TEST_ASSERT(t == NULL);
+}
+
+void test_tupleTableCollision() {
+	bool added;
+	TupleTable *t = TupleTable_New(1);
+
+	// distinct values forced to share a hash are kept apart
+	SIValue a = SI_LongVal(1);
+	SIValue b = SI_LongVal(2);
+	TEST_ASSERT(TupleTable_FindOrAdd(t, &a, 42, &added) == 0);
+	TEST_ASSERT(added);
+	TEST_ASSERT(TupleTable_FindOrAdd(t, &b, 42, &added) == 1);
+	TEST_ASSERT(added);
+	TEST_ASSERT(TupleTable_Find(t, &a, 42) == 0);
+	TEST_ASSERT(TupleTable_Find(t, &b, 42) == 1);
+
+	SIValue c = SI_LongVal(3);
+	TEST_ASSERT(TupleTable_Find(t, &c, 42) == TUPLE_TABLE_NOT_FOUND);
+
+	TupleTable_Free(&t);
+}
+
+void test_tupleTableEquality() {
+	bool added;
+	TupleTable *t = TupleTable_New(1);
+
+	// integers and doubles holding the same value are equal
+	SIValue i = SI_LongVal(5);
+	SIValue d = SI_DoubleVal(5.0);
+	TupleTable_FindOrAdd(t, &i, TupleTable_Hash(&i, 1), &added);
+	TEST_ASSERT(added);
+	TupleTable_FindOrAdd(t, &d, TupleTable_Hash(&d, 1), &added);
+	TEST_ASSERT(!added);
+
+	// NULLs are equal to one another
+	SIValue n = SI_NullVal();
+	TupleTable_FindOrAdd(t, &n, TupleTable_Hash(&n, 1), &added);
+	TEST_ASSERT(added);
+	TupleTable_FindOrAdd(t, &n, TupleTable_Hash(&n, 1), &added);
+	TEST_ASSERT(!added);
+
+	TEST_ASSERT(TupleTable_Count(t) == 2);
+
+	// clear table
+	TupleTable_Clear(t);
+	TEST_ASSERT(TupleTable_Count(t) == 0);
+	TEST_ASSERT(TupleTable_Find(t, &i, TupleTable_Hash(&i, 1)) ==
+			TUPLE_TABLE_NOT_FOUND);
+
+	TupleTable_Free(&t);
+}
+
+TEST_LIST = {
+	{"tupleTableAdd", test_tupleTableAdd},
+	{"tupleTableCollision", test_tupleTableCollision},
+	{"tupleTableEquality", test_tupleTableEquality},
+	{NULL, NULL}
+};
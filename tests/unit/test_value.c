@@ -448,6 +448,74 @@ void test_path() {
 	Path_Free(clone);
 }
 
+void test_binary() {
+	SIValue arr = SIArray_New(2);
+	SIArray_Append(&arr, SI_LongVal(7));
+	SIArray_Append(&arr, SI_ConstStringVal("nested"));
+
+	SIValue values[7] = {
+		SI_NullVal(),
+		SI_BoolVal(true),
+		SI_LongVal(-12),
+		SI_DoubleVal(3.5),
+		SI_ConstStringVal("value"),
+		SI_Point(32.1, 34.8),
+		arr
+	};
+
+	// write values to stream
+	FILE *stream = tmpfile();
+	TEST_ASSERT(stream != NULL);
+	for(int i = 0; i < 7; i++) {
+		SIValue_ToBinary(stream, values + i);
+	}
+
+	// read values back
+	rewind(stream);
+	for(int i = 0; i < 7; i++) {
+		SIValue v = SIValue_FromBinary(stream);
+		TEST_ASSERT(SI_TYPE(v) == SI_TYPE(values[i]));
+		if(i > 0) TEST_ASSERT(SIValue_Compare(v, values[i], NULL) == 0);
+		SIValue_Free(v);
+	}
+
+	fclose(stream);
+	SIValue_Free(arr);
+}
+
+void test_binaryTemporal() {
+	SIType types[6] = {T_DATETIME, T_LOCALDATETIME, T_DATE, T_TIME,
+		T_LOCALTIME, T_DURATION};
+
+	// write temporal values to stream
+	FILE *stream = tmpfile();
+	TEST_ASSERT(stream != NULL);
+	for(int i = 0; i < 6; i++) {
+		SIValue v = SI_LongVal(1000 + i);
+		v.type = types[i];
+		SIValue_ToBinary(stream, &v);
+	}
+
+	// read values back
+	rewind(stream);
+	for(int i = 0; i < 6; i++) {
+		SIValue v = SIValue_FromBinary(stream);
+		TEST_ASSERT(SI_TYPE(v) == types[i]);
+		TEST_ASSERT(v.longval == 1000 + i);
+	}
+
+	fclose(stream);
+}
+
+void test_hashPoint() {
+	SIValue a = SI_Point(32.1, 34.8);
+	SIValue b = SI_Point(32.1, 34.8);
+	SIValue c = SI_Point(34.8, 32.1);
+
+	TEST_ASSERT(SIValue_HashCode(a) == SIValue_HashCode(b));
+	TEST_ASSERT(SIValue_HashCode(a) != SIValue_HashCode(c));
+}
+
 TEST_LIST = {
 	{"numerics", test_numerics},
 	{"strings", test_strings},
@@ -463,5 +531,8 @@ TEST_LIST = {
 	{"edgeAndNode", test_edgeAndNode},
 	{"set", test_set},
 	{"path", test_path},
+	{"binary", test_binary},
+	{"binaryTemporal", test_binaryTemporal},
+	{"hashPoint", test_hashPoint},
 	{NULL, NULL}
 };